@@ -113,6 +113,11 @@ void *w_memset(void *out, int value, size_t n);
 /* Platform-specific checksum implementation */
 #define UIP_ARCH_IPCHKSUM        1
 
+/* Word-at-a-time sums do not pay off on a 16-bit CPU */
+#ifndef UIP_CHKSUM_CONF_IMPL
+#define UIP_CHKSUM_CONF_IMPL uip_chksum_bytes
+#endif
+
 #define BAUD2UBR(baud) ((F_CPU/baud))
 
 void msp430_add_lpm_req(int req);
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \addtogroup native_platform
+ * @{
+ *
+ * \file
+ *         AES-128 driver for the native platform, using AES-NI when the
+ *         host CPU has it
+ */
+#include "contiki.h"
+#include "native-aes-128.h"
+
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#if defined(__x86_64__) || defined(__i386__)
+#include <wmmintrin.h>
+#define WITH_AESNI 1
+#else
+#define WITH_AESNI 0
+#endif
+/*---------------------------------------------------------------------------*/
+#if WITH_AESNI
+/* Compiled for AES-NI, but only called once the CPU is known to have it */
+#define AESNI __attribute__((target("aes,sse2")))
+
+/* Blocks encrypted in parallel, to hide the latency of AESENC */
+#define PARALLEL 4
+
+static struct {
+  uint8_t key[AES_128_KEY_LENGTH];
+  __m128i round_keys[11];
+} keys[AES_128_KEY_CACHE_SIZE];
+static uint8_t keys_used;
+static uint8_t keys_next;
+static const __m128i *round_keys = keys[0].round_keys;
+static int8_t accelerated = -1;
+#endif /* WITH_AESNI */
+/*---------------------------------------------------------------------------*/
+bool
+native_aes_128_accelerated(void)
+{
+#if WITH_AESNI
+  if(accelerated < 0) {
+    __builtin_cpu_init();
+    accelerated = __builtin_cpu_supports("aes") ? 1 : 0;
+  }
+  return accelerated;
+#else /* WITH_AESNI */
+  return false;
+#endif /* WITH_AESNI */
+}
+/*---------------------------------------------------------------------------*/
+#if WITH_AESNI
+AESNI static __m128i
+expand_step(__m128i key, __m128i assist)
+{
+  assist = _mm_shuffle_epi32(assist, 0xff);
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, assist);
+}
+/*---------------------------------------------------------------------------*/
+#define EXPAND(k, i, rcon) \
+  k[i] = expand_step(k[i - 1], _mm_aeskeygenassist_si128(k[i - 1], rcon))
+
+AESNI static void
+expand_key(__m128i *k, const uint8_t *key)
+{
+  k[0] = _mm_loadu_si128((const __m128i *)key);
+  EXPAND(k, 1, 0x01);
+  EXPAND(k, 2, 0x02);
+  EXPAND(k, 3, 0x04);
+  EXPAND(k, 4, 0x08);
+  EXPAND(k, 5, 0x10);
+  EXPAND(k, 6, 0x20);
+  EXPAND(k, 7, 0x40);
+  EXPAND(k, 8, 0x80);
+  EXPAND(k, 9, 0x1b);
+  EXPAND(k, 10, 0x36);
+}
+/*---------------------------------------------------------------------------*/
+AESNI static void
+encrypt_blocks(uint8_t *blocks, uint16_t count)
+{
+  __m128i b[PARALLEL];
+  int round;
+  int i;
+
+  for(; count >= PARALLEL; count -= PARALLEL) {
+    for(i = 0; i < PARALLEL; i++) {
+      b[i] = _mm_xor_si128(
+        _mm_loadu_si128((const __m128i *)&blocks[i * AES_128_BLOCK_SIZE]),
+        round_keys[0]);
+    }
+    for(round = 1; round < 10; round++) {
+      for(i = 0; i < PARALLEL; i++) {
+        b[i] = _mm_aesenc_si128(b[i], round_keys[round]);
+      }
+    }
+    for(i = 0; i < PARALLEL; i++) {
+      _mm_storeu_si128((__m128i *)&blocks[i * AES_128_BLOCK_SIZE],
+                       _mm_aesenclast_si128(b[i], round_keys[10]));
+    }
+    blocks += PARALLEL * AES_128_BLOCK_SIZE;
+  }
+
+  for(; count > 0; count--) {
+    b[0] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)blocks),
+                         round_keys[0]);
+    for(round = 1; round < 10; round++) {
+      b[0] = _mm_aesenc_si128(b[0], round_keys[round]);
+    }
+    _mm_storeu_si128((__m128i *)blocks,
+                     _mm_aesenclast_si128(b[0], round_keys[10]));
+    blocks += AES_128_BLOCK_SIZE;
+  }
+}
+#endif /* WITH_AESNI */
+/*---------------------------------------------------------------------------*/
+static void
+set_key(const uint8_t *key)
+{
+#if WITH_AESNI
+  uint8_t i;
+
+  if(native_aes_128_accelerated()) {
+    for(i = 0; i < keys_used; i++) {
+      if(!memcmp(keys[i].key, key, AES_128_KEY_LENGTH)) {
+        round_keys = keys[i].round_keys;
+        return;
+      }
+    }
+
+    /* Replace the oldest entry once the cache is full */
+    if(keys_used < AES_128_KEY_CACHE_SIZE) {
+      i = keys_used++;
+    } else {
+      i = keys_next;
+      keys_next = (keys_next + 1) % AES_128_KEY_CACHE_SIZE;
+    }
+    memcpy(keys[i].key, key, AES_128_KEY_LENGTH);
+    expand_key(keys[i].round_keys, key);
+    round_keys = keys[i].round_keys;
+    return;
+  }
+#endif /* WITH_AESNI */
+  aes_128_driver.set_key(key);
+}
+/*---------------------------------------------------------------------------*/
+static void
+ecb_encrypt(uint8_t *blocks, uint16_t count)
+{
+#if WITH_AESNI
+  if(native_aes_128_accelerated()) {
+    encrypt_blocks(blocks, count);
+    return;
+  }
+#endif /* WITH_AESNI */
+  aes_128_driver.ecb_encrypt(blocks, count);
+}
+/*---------------------------------------------------------------------------*/
+static void
+encrypt(uint8_t *plaintext_and_result)
+{
+  ecb_encrypt(plaintext_and_result, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+ctr_crypt(uint8_t *counter, uint8_t *data, uint16_t len)
+{
+#if WITH_AESNI
+  uint8_t stream[PARALLEL * AES_128_BLOCK_SIZE];
+  uint16_t n;
+  uint16_t i;
+
+  if(native_aes_128_accelerated()) {
+    while(len > 0) {
+      /* Key stream for up to PARALLEL blocks at once */
+      n = 0;
+      for(i = 0; i < PARALLEL && n < len; i++) {
+        memcpy(&stream[n], counter, AES_128_BLOCK_SIZE);
+        aes_128_ctr_increment(counter);
+        n += AES_128_BLOCK_SIZE;
+      }
+      encrypt_blocks(stream, i);
+
+      n = MIN(n, len);
+      for(i = 0; i < n; i++) {
+        data[i] ^= stream[i];
+      }
+      data += n;
+      len -= n;
+    }
+    return;
+  }
+#endif /* WITH_AESNI */
+  aes_128_driver.ctr_crypt(counter, data, len);
+}
+/*---------------------------------------------------------------------------*/
+const struct aes_128_driver native_aes_128_driver = {
+  set_key,
+  encrypt,
+  ecb_encrypt,
+  ctr_crypt
+};
+/*---------------------------------------------------------------------------*/
+
+/** @} */
@@ -31,18 +31,25 @@
 /*---------------------------------------------------------------------------*/
 #include "contiki.h"
 #include "sys/int-master.h"
+#include "sys/rtimer.h"
 
+#include <signal.h>
 #include <stdbool.h>
 /*---------------------------------------------------------------------------*/
+/*
+ * The rtimer runs from the SIGALRM handler. While interrupts are
+ * disabled, the handler defers the rtimer until they are enabled again.
+ */
 #define DISABLED 0
 #define ENABLED  1
 /*---------------------------------------------------------------------------*/
-static int_master_status_t stat = DISABLED;
+static volatile sig_atomic_t stat = ENABLED;
 /*---------------------------------------------------------------------------*/
 void
 int_master_enable(void)
 {
   stat = ENABLED;
+  rtimer_arch_run_deferred();
 }
 /*---------------------------------------------------------------------------*/
 int_master_status_t
@@ -56,7 +63,11 @@ int_master_read_and_disable(void)
 void
 int_master_status_set(int_master_status_t status)
 {
-  stat = status;
+  if(status == ENABLED) {
+    int_master_enable();
+  } else {
+    stat = DISABLED;
+  }
 }
 /*---------------------------------------------------------------------------*/
 bool
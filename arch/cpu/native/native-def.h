@@ -35,5 +35,23 @@
 #define GPIO_HAL_CONF_ARCH_SW_TOGGLE     1
 #define GPIO_HAL_CONF_PORT_PIN_NUMBERING 0
 /*---------------------------------------------------------------------------*/
+#define memory_barrier() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+/*---------------------------------------------------------------------------*/
+/* AES-NI where the host has it, and fast software AES otherwise */
+#ifndef AES_128_CONF
+#define AES_128_CONF native_aes_128_driver
+#endif
+#ifndef AES_128_CONF_WITH_TTABLES
+#define AES_128_CONF_WITH_TTABLES 1
+#endif
+#ifndef AES_128_CONF_KEY_CACHE_SIZE
+#define AES_128_CONF_KEY_CACHE_SIZE 4
+#endif
+/*---------------------------------------------------------------------------*/
+/* SIMD Internet checksum, picked at runtime */
+#ifndef UIP_CHKSUM_CONF_IMPL
+#define UIP_CHKSUM_CONF_IMPL native_chksum
+#endif
+/*---------------------------------------------------------------------------*/
 #endif /* NATIVE_DEF_H_ */
 /*---------------------------------------------------------------------------*/
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \addtogroup native_platform
+ * @{
+ *
+ * \file
+ *         SIMD Internet checksum for the native platform
+ */
+#include "contiki.h"
+#include "native-chksum.h"
+#include "net/ipv6/uip-chksum.h"
+/*---------------------------------------------------------------------------*/
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define WITH_SIMD 1
+#else
+#define WITH_SIMD 0
+#endif
+/*---------------------------------------------------------------------------*/
+static uint16_t dispatch(uint16_t sum, const uint8_t *data, uint16_t len);
+
+static uint16_t (* impl)(uint16_t sum, const uint8_t *data, uint16_t len) =
+  dispatch;
+/*---------------------------------------------------------------------------*/
+bool
+native_chksum_sse2_ok(void)
+{
+#if WITH_SIMD
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("sse2");
+#else /* WITH_SIMD */
+  return false;
+#endif /* WITH_SIMD */
+}
+/*---------------------------------------------------------------------------*/
+bool
+native_chksum_avx2_ok(void)
+{
+#if WITH_SIMD
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+#else /* WITH_SIMD */
+  return false;
+#endif /* WITH_SIMD */
+}
+/*---------------------------------------------------------------------------*/
+#if WITH_SIMD
+/* Adds the sum of the vector part to sum, and the rest of the data */
+static uint16_t
+finish(uint16_t sum, uint64_t acc, const uint8_t *rest, uint16_t len)
+{
+  uint16_t result;
+
+  /* The vectors were summed as little-endian words */
+  result = uip_chksum_fold(acc);
+  result = (result << 8) | (result >> 8);
+  result += sum;
+  if(result < sum) {
+    result++;      /* carry */
+  }
+  return uip_chksum_words(result, rest, len);
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * The 16-bit words are zero-extended into 32-bit lanes. Each lane gains
+ * at most 2 * 0xffff per vector, so for packets of up to 64 kB the
+ * lanes cannot overflow.
+ */
+__attribute__((target("sse2"))) uint16_t
+native_chksum_sse2(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  const __m128i zero = _mm_setzero_si128();
+  __m128i acc = zero;
+  __m128i v;
+  uint32_t lanes[4];
+
+  for(; len >= 16; len -= 16) {
+    v = _mm_loadu_si128((const __m128i *)data);
+    acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(v, zero));
+    acc = _mm_add_epi32(acc, _mm_unpackhi_epi16(v, zero));
+    data += 16;
+  }
+
+  _mm_storeu_si128((__m128i *)lanes, acc);
+  return finish(sum, (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3],
+                data, len);
+}
+/*---------------------------------------------------------------------------*/
+__attribute__((target("avx2"))) uint16_t
+native_chksum_avx2(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i acc = zero;
+  __m256i v;
+  uint32_t lanes[8];
+
+  for(; len >= 32; len -= 32) {
+    v = _mm256_loadu_si256((const __m256i *)data);
+    acc = _mm256_add_epi32(acc, _mm256_unpacklo_epi16(v, zero));
+    acc = _mm256_add_epi32(acc, _mm256_unpackhi_epi16(v, zero));
+    data += 32;
+  }
+
+  _mm256_storeu_si256((__m256i *)lanes, acc);
+  return finish(sum, (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+                lanes[4] + lanes[5] + lanes[6] + lanes[7], data, len);
+}
+#else /* WITH_SIMD */
+/*---------------------------------------------------------------------------*/
+uint16_t
+native_chksum_sse2(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  return uip_chksum_words(sum, data, len);
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+native_chksum_avx2(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  return uip_chksum_words(sum, data, len);
+}
+#endif /* WITH_SIMD */
+/*---------------------------------------------------------------------------*/
+static uint16_t
+dispatch(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  if(native_chksum_avx2_ok()) {
+    impl = native_chksum_avx2;
+  } else if(native_chksum_sse2_ok()) {
+    impl = native_chksum_sse2;
+  } else {
+    impl = uip_chksum_words;
+  }
+  return impl(sum, data, len);
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+native_chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  return impl(sum, data, len);
+}
+/*---------------------------------------------------------------------------*/
+
+/** @} */
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \addtogroup native_platform
+ * @{
+ *
+ * \file
+ *         Header file of the SIMD Internet checksum for the native
+ *         platform
+ */
+#ifndef NATIVE_CHKSUM_H_
+#define NATIVE_CHKSUM_H_
+
+#include "contiki.h"
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Adds data to a checksum with the fastest implementation the
+ *        host CPU supports, see uip_chksum_bytes().
+ *
+ *        The implementation is picked on the first call: AVX2, SSE2, or
+ *        uip_chksum_words() on hosts without either.
+ */
+uint16_t native_chksum(uint16_t sum, const uint8_t *data, uint16_t len);
+
+/**
+ * \brief The SSE2 implementation. Only call it if native_chksum_sse2_ok().
+ */
+uint16_t native_chksum_sse2(uint16_t sum, const uint8_t *data, uint16_t len);
+
+/**
+ * \brief The AVX2 implementation. Only call it if native_chksum_avx2_ok().
+ */
+uint16_t native_chksum_avx2(uint16_t sum, const uint8_t *data, uint16_t len);
+
+/** \brief Tells whether the host CPU supports native_chksum_sse2(). */
+bool native_chksum_sse2_ok(void);
+
+/** \brief Tells whether the host CPU supports native_chksum_avx2(). */
+bool native_chksum_avx2_ok(void);
+/*---------------------------------------------------------------------------*/
+#endif /* NATIVE_CHKSUM_H_ */
+
+/** @} */
@@ -79,14 +79,18 @@ static void (* tun_input_callback)(void);
 #define MIN_MTU_SIZE 1500
 static int config_mtu = MIN_MTU_SIZE;
 
+/* The maximum number of packets read from the tun per main loop wakeup */
+#ifdef TUN6_NET_CONF_INPUT_BATCH
+#define TUN6_NET_INPUT_BATCH TUN6_NET_CONF_INPUT_BATCH
+#else
+#define TUN6_NET_INPUT_BATCH 32
+#endif
+
 static int tunfd = -1;
+/* Size of the last packet read, 0 once the tun has no more */
+static int input_size;
 
-static int set_fd(fd_set *rset, fd_set *wset);
-static void handle_fd(fd_set *rset, fd_set *wset);
-static const struct select_callback tun_select_callback = {
-  set_fd,
-  handle_fd
-};
+static void handle_event(int fd, int events);
 
 static int ssystem(const char *fmt, ...)
      __attribute__((__format__ (__printf__, 1, 2)));
@@ -405,7 +409,12 @@ tun6_net_init(void (* tun_input)(void))
 
   LOG_INFO("Tun open:%d\n", tunfd);
 
-  select_set_callback(tunfd, &tun_select_callback);
+  /* Input is read in batches, until the tun would block */
+  if(fcntl(tunfd, F_SETFL, fcntl(tunfd, F_GETFL) | O_NONBLOCK) == -1) {
+    err(EXIT_FAILURE, "tun6_net_init: fcntl");
+  }
+
+  select_set_event_callback(tunfd, SELECT_EVENT_READ, handle_event);
 
   fprintf(stderr, "opened %s device ``/dev/%s''\n",
           "tun", config_tundev);
@@ -458,6 +467,11 @@ tun6_net_input(uint8_t *data, int maxlen)
   }
 
   if((size = read(tunfd, data, maxlen)) == -1) {
+    if(errno == EAGAIN || errno == EWOULDBLOCK) {
+      /* No more packets for now */
+      input_size = 0;
+      return 0;
+    }
     err(EXIT_FAILURE, "tun6_net_input: read");
   }
 
@@ -473,33 +487,26 @@ tun6_net_input(uint8_t *data, int maxlen)
 #undef UTUN_HEADER_LEN
 #endif /* __APPLE__ */
 
+  input_size = size;
   return size;
 }
 
 /*---------------------------------------------------------------------------*/
 /* tun select callback                                                       */
 /*---------------------------------------------------------------------------*/
-static int
-set_fd(fd_set *rset, fd_set *wset)
-{
-  if(tunfd == -1) {
-    return 0;
-  }
-
-  FD_SET(tunfd, rset);
-  return 1;
-}
-/*---------------------------------------------------------------------------*/
 static void
-handle_fd(fd_set *rset, fd_set *wset)
+handle_event(int fd, int events)
 {
-  if(tunfd == -1) {
-    /* tun is not open */
-    return;
-  }
+  int i;
 
-  if(FD_ISSET(tunfd, rset)) {
+  /* Read the packets queued in the tun, up to a batch to let other
+   * processes run in between. The input callback may also not read. */
+  for(i = 0; i < TUN6_NET_INPUT_BATCH && tunfd != -1; i++) {
+    input_size = 0;
     tun_input_callback();
+    if(input_size <= 0) {
+      break;
+    }
   }
 }
 
@@ -511,6 +518,9 @@ tun_input(void)
 {
   int size = tun6_net_input(uip_buf, sizeof(uip_buf));
   LOG_DBG("TUN data incoming read:%d\n", size);
+  if(size <= 0) {
+    return;
+  }
   uip_len = size;
   tcpip_input();
 }
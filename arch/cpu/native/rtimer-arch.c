@@ -43,6 +43,7 @@
 
 #include "sys/rtimer.h"
 #include "sys/clock.h"
+#include "sys/int-master.h"
 
 #define DEBUG 0
 #if DEBUG
@@ -52,15 +53,30 @@
 #define PRINTF(...)
 #endif
 
+/*---------------------------------------------------------------------------*/
+static volatile sig_atomic_t deferred;
 /*---------------------------------------------------------------------------*/
 static void
 interrupt(int sig)
 {
   signal(sig, interrupt);
+  if(!int_master_is_enabled()) {
+    deferred = 1;
+    return;
+  }
   rtimer_run_next();
 }
 /*---------------------------------------------------------------------------*/
 void
+rtimer_arch_run_deferred(void)
+{
+  while(deferred) {
+    deferred = 0;
+    rtimer_run_next();
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
 rtimer_arch_init(void)
 {
   signal(SIGALRM, interrupt);
@@ -70,12 +86,17 @@ void
 rtimer_arch_schedule(rtimer_clock_t t)
 {
   struct itimerval val;
+  rtimer_clock_t now = clock_time();
   rtimer_clock_t c;
 
-  c = t - clock_time();
-  
+  /* A zero value would disarm the timer: fire at once if already due */
+  c = RTIMER_CLOCK_LT(now, t) ? t - now : 0;
+
   val.it_value.tv_sec = c / CLOCK_SECOND;
   val.it_value.tv_usec = (c % CLOCK_SECOND) * CLOCK_SECOND;
+  if(c == 0) {
+    val.it_value.tv_usec = 1;
+  }
 
   PRINTF("rtimer_arch_schedule time %"PRIu32 " %"PRIu32 " in %ld.%ld seconds\n",
          t, c, (long)val.it_value.tv_sec, (long)val.it_value.tv_usec);
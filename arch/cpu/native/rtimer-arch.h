@@ -46,4 +46,7 @@
 
 #define rtimer_arch_now() clock_time()
 
+/* Runs the rtimer that fired while interrupts were disabled, if any */
+void rtimer_arch_run_deferred(void);
+
 #endif /* RTIMER_ARCH_H_ */
@@ -54,6 +54,7 @@
 #if NRF_HARDFAULT_HANDLER_EXTENDED
 /*---------------------------------------------------------------------------*/
 #include "sys/log.h"
+#include "sys/stack-check.h"
 
 #define LOG_MODULE "NRF HARDFAULT"
 #define LOG_LEVEL LOG_LEVEL_INFO
@@ -156,6 +157,8 @@ HardFault_c_handler(uint32_t *p_stack_address)
     LOG_INFO("Bus Fault Address: 0x%08lX\n", SCB->BFAR);
   }
 
+  stack_check_report();
+
   HardFault_process();
 }
 /*---------------------------------------------------------------------------*/
@@ -43,6 +43,7 @@
 #include "lib/list.h"
 #include "sys/cc.h"
 #include "sys/cooja_mt.h"
+#include "sys/stack-check.h"
 
 /* The main function, implemented in contiki-main.c */
 int main(void);
@@ -89,6 +90,10 @@ cooja_add_post_tick_action(struct cooja_tick_action *handler)
 static struct cooja_mt_thread cooja_thread;
 static struct cooja_mt_thread rtimer_thread;
 static struct cooja_mt_thread process_run_thread;
+#if STACK_CHECK_WITH_REGIONS
+static struct stack_check_region rtimer_stack;
+static struct stack_check_region process_run_stack;
+#endif /* STACK_CHECK_WITH_REGIONS */
 /*---------------------------------------------------------------------------*/
 #ifdef __APPLE__
 extern int macos_data_start __asm("section$start$__DATA$__data");
@@ -164,6 +169,14 @@ cooja_init(void)
   if((rv = cooja_mt_init(&cooja_thread))) {
     return rv;
   }
+#if STACK_CHECK_WITH_REGIONS
+  /* Contiki-NG runs on the thread stacks, track their usage */
+  stack_check_region_add(&rtimer_stack, "rtimer", rtimer_thread.stack,
+                         sizeof(rtimer_thread.stack));
+  stack_check_region_add(&process_run_stack, "main",
+                         process_run_thread.stack,
+                         sizeof(process_run_thread.stack));
+#endif /* STACK_CHECK_WITH_REGIONS */
   cooja_mt_start(&cooja_thread, &rtimer_thread, rtimer_thread_loop);
   cooja_mt_start(&cooja_thread, &process_run_thread, process_run_thread_loop);
   return 0;
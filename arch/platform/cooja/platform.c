@@ -129,6 +129,11 @@ platform_main_loop()
       process_run();
     }
     simProcessRunValue = process_nevents();
+#if LOG_WITH_BINARY
+    if(simProcessRunValue == 0 && log_binary_drain()) {
+      simProcessRunValue = 1;
+    }
+#endif /* LOG_WITH_BINARY */
 
     /* Check if we must stay awake */
     if(simDontFallAsleep) {
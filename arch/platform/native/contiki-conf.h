@@ -49,6 +49,23 @@ struct select_callback {
 };
 int select_set_callback(int fd, const struct select_callback *callback);
 
+#define SELECT_EVENT_READ  0x01
+#define SELECT_EVENT_WRITE 0x02
+/*
+ * Monitors a file descriptor without fd_sets, which works beyond FD_SETSIZE
+ * with the epoll main loop. The handler is called with the events that are
+ * ready. A NULL handler or no events stops monitoring.
+ */
+int select_set_event_callback(int fd, int events,
+                              void (*handler)(int fd, int events));
+
+/* The rtimer only counts milliseconds, too coarse to profile processes */
+uint32_t native_clock_usecs(void);
+#ifndef PROCESS_CONF_PROFILE_NOW
+#define PROCESS_CONF_PROFILE_NOW()  native_clock_usecs()
+#define PROCESS_CONF_PROFILE_SECOND 1000000
+#endif /* PROCESS_CONF_PROFILE_NOW */
+
 #define CC_CONF_VA_ARGS                1
 
 #ifndef EEPROM_CONF_SIZE
@@ -43,8 +43,10 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <signal.h>
 #include <sys/select.h>
 #include <errno.h>
 
@@ -85,9 +87,22 @@
  * @{
  */
 
+/*
+ * Uses epoll rather than select in the platform main loop. The loop then
+ * sleeps until the next etimer expiration, through a timer fd, and the
+ * number of monitored file descriptors is not limited by SELECT_MAX.
+ */
+#ifdef SELECT_CONF_EPOLL
+#define SELECT_EPOLL SELECT_CONF_EPOLL
+#elif defined(__linux__)
+#define SELECT_EPOLL 1
+#else
+#define SELECT_EPOLL 0
+#endif
+
 /*
  * Defines the maximum number of file descriptors monitored by the platform
- * main loop.
+ * main loop, without epoll.
  */
 #ifdef SELECT_CONF_MAX
 #define SELECT_MAX SELECT_CONF_MAX
@@ -97,7 +112,9 @@
 
 /*
  * Defines the timeout (in msec) of the select operation if no monitored file
- * descriptors becomes ready.
+ * descriptors becomes ready. With epoll, this is the longest time to sleep
+ * while no etimer expires, for select callbacks that depend on time to
+ * decide what to monitor. Zero means no limit with epoll.
  */
 #ifdef SELECT_CONF_TIMEOUT
 #define SELECT_TIMEOUT SELECT_CONF_TIMEOUT
@@ -113,10 +130,46 @@
 #else
 #define SELECT_STDIN 1
 #endif
+
+/*
+ * The maximum number of ready file descriptors handled per epoll wait.
+ */
+#ifdef SELECT_CONF_EPOLL_EVENTS
+#define SELECT_EPOLL_EVENTS SELECT_CONF_EPOLL_EVENTS
+#else
+#define SELECT_EPOLL_EVENTS 32
+#endif
 /** @} */
 /*---------------------------------------------------------------------------*/
 
-static const struct select_callback *select_callback[SELECT_MAX];
+#if SELECT_EPOLL
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#endif /* SELECT_EPOLL */
+
+struct select_entry {
+  const struct select_callback *callback;
+  void (*handler)(int fd, int events);
+  uint8_t events;
+#if SELECT_EPOLL
+  uint8_t monitored; /* The events currently in the epoll set */
+  uint8_t always_ready; /* Not pollable, e.g. a regular file */
+#endif /* SELECT_EPOLL */
+};
+
+#if SELECT_EPOLL
+/* Grown on demand, indexed by file descriptor */
+static struct select_entry *select_entries;
+static int select_entries_len;
+static int epoll_fd = -1;
+static int timer_fd = -1;
+static clock_time_t timer_deadline;
+static uint8_t timer_armed;
+/* The number of monitored file descriptors that epoll does not support */
+static int always_ready_count;
+#else /* SELECT_EPOLL */
+static struct select_entry select_entries[SELECT_MAX];
+#endif /* SELECT_EPOLL */
 static int select_max = 0;
 
 #ifdef PLATFORM_CONF_MAC_ADDR
@@ -126,36 +179,269 @@ static uint8_t mac_addr[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 };
 #endif /* PLATFORM_CONF_MAC_ADDR */
 
 /*---------------------------------------------------------------------------*/
-int
-select_set_callback(int fd, const struct select_callback *callback)
+static struct select_entry *
+get_entry(int fd)
+{
+#if SELECT_EPOLL
+  if(fd >= select_entries_len) {
+    struct select_entry *entries;
+    int len = select_entries_len > 0 ? select_entries_len : 16;
+
+    while(len <= fd) {
+      len *= 2;
+    }
+    entries = realloc(select_entries, len * sizeof(struct select_entry));
+    if(entries == NULL) {
+      return NULL;
+    }
+    memset(&entries[select_entries_len], 0,
+           (len - select_entries_len) * sizeof(struct select_entry));
+    select_entries = entries;
+    select_entries_len = len;
+  }
+  return &select_entries[fd];
+#else /* SELECT_EPOLL */
+  return fd < SELECT_MAX ? &select_entries[fd] : NULL;
+#endif /* SELECT_EPOLL */
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_select_max(int fd, int added)
 {
   int i;
-  if(fd >= 0 && fd < SELECT_MAX) {
-    /* Check that the callback functions are set */
-    if(callback != NULL &&
-       (callback->set_fd == NULL || callback->handle_fd == NULL)) {
-      callback = NULL;
+
+  if(added) {
+    if(fd > select_max) {
+      select_max = fd;
     }
+  } else if(fd == select_max) {
+    select_max = 0;
+    for(i = fd - 1; i > 0; i--) {
+      if(select_entries[i].callback != NULL ||
+         select_entries[i].handler != NULL) {
+        select_max = i;
+        break;
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+#if SELECT_EPOLL
+static int
+epoll_init(void)
+{
+  struct epoll_event ev;
 
-    select_callback[fd] = callback;
+  if(epoll_fd != -1) {
+    return 1;
+  }
 
-    /* Update fd max */
-    if(callback != NULL) {
-      if(fd > select_max) {
-        select_max = fd;
-      }
-    } else {
-      select_max = 0;
-      for(i = SELECT_MAX - 1; i > 0; i--) {
-        if(select_callback[i] != NULL) {
-          select_max = i;
-          break;
-        }
-      }
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if(epoll_fd == -1) {
+    perror("epoll_create1");
+    return 0;
+  }
+
+  timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if(timer_fd == -1) {
+    perror("timerfd_create");
+    return 0;
+  }
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.fd = timer_fd;
+  if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev) == -1) {
+    perror("epoll_ctl");
+    return 0;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Updates the events monitored for a file descriptor in the epoll set */
+static int
+epoll_monitor(int fd, struct select_entry *e, uint8_t events)
+{
+  struct epoll_event ev;
+  int ret;
+
+  if(events == e->monitored) {
+    return 1;
+  }
+  if(!epoll_init()) {
+    return 0;
+  }
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = ((events & SELECT_EVENT_READ) ? EPOLLIN : 0) |
+    ((events & SELECT_EVENT_WRITE) ? EPOLLOUT : 0);
+  ev.data.fd = fd;
+
+  if(e->always_ready) {
+    if(events == 0) {
+      e->always_ready = 0;
+      always_ready_count--;
     }
+    e->monitored = events;
+    return 1;
+  }
+
+  if(events == 0) {
+    /* The file descriptor may already be closed, and thereby removed */
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, &ev);
+    e->monitored = 0;
     return 1;
   }
-  return 0;
+
+  if(e->monitored == 0) {
+    ret = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+    if(ret == -1 && errno == EEXIST) {
+      ret = epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev);
+    } else if(ret == -1 && errno == EPERM) {
+      /* Like select, consider it ready at all times */
+      e->always_ready = 1;
+      always_ready_count++;
+      ret = 0;
+    }
+  } else {
+    ret = epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev);
+    if(ret == -1 && errno == ENOENT) {
+      /* Closed and reopened since it was added */
+      ret = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+    }
+  }
+  if(ret == -1) {
+    perror("epoll_ctl");
+    return 0;
+  }
+  e->monitored = events;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Arms the timer fd for the next etimer expiration, bounded by
+ * SELECT_TIMEOUT */
+static void
+timer_update(void)
+{
+  struct itimerspec its;
+  clock_time_t now = clock_time();
+  clock_time_t deadline;
+  clock_time_t left;
+  int has_deadline = 0;
+
+  if(etimer_pending()) {
+    deadline = etimer_next_expiration_time();
+    has_deadline = 1;
+  }
+  if(SELECT_TIMEOUT > 0) {
+    clock_time_t limit = now + (clock_time_t)SELECT_TIMEOUT * CLOCK_SECOND / 1000;
+    if(!has_deadline || CLOCK_LT(limit, deadline)) {
+      deadline = limit;
+      has_deadline = 1;
+    }
+  }
+
+  if(!has_deadline) {
+    if(timer_armed) {
+      memset(&its, 0, sizeof(its));
+      timerfd_settime(timer_fd, 0, &its, NULL);
+      timer_armed = 0;
+    }
+    return;
+  }
+
+  /* Waking up earlier than needed is harmless */
+  if(timer_armed && !CLOCK_LT(deadline, timer_deadline)) {
+    return;
+  }
+
+  memset(&its, 0, sizeof(its));
+  left = CLOCK_LT(now, deadline) ? deadline - now : 0;
+  its.it_value.tv_sec = left / CLOCK_SECOND;
+  its.it_value.tv_nsec = (left % CLOCK_SECOND) * (1000000000 / CLOCK_SECOND);
+  if(left == 0) {
+    /* A zero value would disarm the timer */
+    its.it_value.tv_nsec = 1;
+  }
+  if(timerfd_settime(timer_fd, 0, &its, NULL) == -1) {
+    perror("timerfd_settime");
+    return;
+  }
+  timer_deadline = deadline;
+  timer_armed = 1;
+}
+#endif /* SELECT_EPOLL */
+/*---------------------------------------------------------------------------*/
+int
+select_set_callback(int fd, const struct select_callback *callback)
+{
+  struct select_entry *e;
+
+  if(fd < 0 || fd >= FD_SETSIZE) {
+    return 0;
+  }
+
+  /* Check that the callback functions are set */
+  if(callback != NULL &&
+     (callback->set_fd == NULL || callback->handle_fd == NULL)) {
+    callback = NULL;
+  }
+
+  e = get_entry(fd);
+  if(e == NULL) {
+    return 0;
+  }
+  e->callback = callback;
+  e->handler = NULL;
+  e->events = 0;
+#if SELECT_EPOLL
+  if(callback == NULL) {
+    epoll_monitor(fd, e, 0);
+  }
+#endif /* SELECT_EPOLL */
+
+  /* Update fd max */
+  update_select_max(fd, callback != NULL);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+select_set_event_callback(int fd, int events, void (*handler)(int fd, int events))
+{
+  struct select_entry *e;
+
+  events &= SELECT_EVENT_READ | SELECT_EVENT_WRITE;
+  if(handler == NULL || events == 0) {
+    handler = NULL;
+    events = 0;
+  }
+
+#if !SELECT_EPOLL
+  if(fd >= FD_SETSIZE) {
+    return 0;
+  }
+#endif /* !SELECT_EPOLL */
+  if(fd < 0) {
+    return 0;
+  }
+
+  e = get_entry(fd);
+  if(e == NULL) {
+    return 0;
+  }
+  e->callback = NULL;
+  e->handler = handler;
+  e->events = events;
+#if SELECT_EPOLL
+  if(!epoll_monitor(fd, e, events)) {
+    e->handler = NULL;
+    e->events = 0;
+    update_select_max(fd, 0);
+    return 0;
+  }
+#endif /* SELECT_EPOLL */
+
+  update_select_max(fd, handler != NULL);
+  return 1;
 }
 /*---------------------------------------------------------------------------*/
 #if SELECT_STDIN
@@ -230,6 +516,44 @@ set_global_address(void)
 }
 #endif
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_PROFILE
+static volatile sig_atomic_t profile_dump_requested;
+/*---------------------------------------------------------------------------*/
+static void
+profile_dump_signal(int signum)
+{
+  profile_dump_requested = 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Prints the process profile on SIGUSR1, and resets it */
+static void
+profile_dump(void)
+{
+  if(!profile_dump_requested) {
+    return;
+  }
+  profile_dump_requested = 0;
+
+  printf("Process profile (us): calls run max-run events avg-delay max-delay\n");
+  for(struct process *p = PROCESS_LIST(); p != NULL; p = p->next) {
+    const struct process_profile *pr = &p->profile;
+    printf("%-24s %8"PRIu32" %10"PRIu64" %8"PRIu64" %8"PRIu32
+           " %8"PRIu64" %8"PRIu64"\n",
+           PROCESS_NAME_STRING(p), pr->calls,
+           (uint64_t)pr->run_time * 1000000 / PROCESS_PROFILE_SECOND,
+           (uint64_t)pr->max_run_time * 1000000 / PROCESS_PROFILE_SECOND,
+           pr->events,
+           pr->events == 0 ? 0 :
+           (uint64_t)pr->event_delay * 1000000 / PROCESS_PROFILE_SECOND
+           / pr->events,
+           (uint64_t)pr->max_event_delay * 1000000 / PROCESS_PROFILE_SECOND);
+  }
+  process_profile_reset();
+}
+#else /* PROCESS_CONF_PROFILE */
+#define profile_dump()
+#endif /* PROCESS_CONF_PROFILE */
+/*---------------------------------------------------------------------------*/
 void
 platform_init_stage_one()
 {
@@ -269,8 +593,168 @@ platform_init_stage_three()
 
   /* Make standard output unbuffered. */
   setvbuf(stdout, (char *)NULL, _IONBF, 0);
+
+#if PROCESS_CONF_PROFILE
+  signal(SIGUSR1, profile_dump_signal);
+#endif /* PROCESS_CONF_PROFILE */
 }
 /*---------------------------------------------------------------------------*/
+#if SELECT_EPOLL
+/* Asks the select callbacks what to monitor, and updates the epoll set */
+static void
+update_callback_events(void)
+{
+  fd_set fdr;
+  fd_set fdw;
+  int max = select_max < FD_SETSIZE ? select_max : FD_SETSIZE - 1;
+  int i;
+
+  FD_ZERO(&fdr);
+  FD_ZERO(&fdw);
+  for(i = 0; i <= max; i++) {
+    if(select_entries[i].callback != NULL) {
+      select_entries[i].callback->set_fd(&fdr, &fdw);
+    }
+  }
+  for(i = 0; i <= max; i++) {
+    if(select_entries[i].callback != NULL) {
+      epoll_monitor(i, &select_entries[i],
+                    (FD_ISSET(i, &fdr) ? SELECT_EVENT_READ : 0) |
+                    (FD_ISSET(i, &fdw) ? SELECT_EVENT_WRITE : 0));
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+dispatch_events(int fd, int events)
+{
+  struct select_entry *e = &select_entries[fd];
+
+  if(e->handler != NULL) {
+    e->handler(fd, events);
+  } else if(e->callback != NULL) {
+    fd_set fdr;
+    fd_set fdw;
+    FD_ZERO(&fdr);
+    FD_ZERO(&fdw);
+    if(events & SELECT_EVENT_READ) {
+      FD_SET(fd, &fdr);
+    }
+    if(events & SELECT_EVENT_WRITE) {
+      FD_SET(fd, &fdw);
+    }
+    e->callback->handle_fd(&fdr, &fdw);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_epoll_event(const struct epoll_event *ev)
+{
+  struct select_entry *e;
+  int fd = ev->data.fd;
+  int events;
+
+  if(fd == timer_fd) {
+    uint64_t expirations;
+    if(read(timer_fd, &expirations, sizeof(expirations)) > 0) {
+      timer_armed = 0;
+    }
+    return;
+  }
+
+  if(fd >= select_entries_len) {
+    return;
+  }
+  e = &select_entries[fd];
+  if(ev->events & (EPOLLERR | EPOLLHUP)) {
+    /* Let the handler find out through read or write */
+    events = e->monitored;
+  } else {
+    events = ((ev->events & EPOLLIN) ? SELECT_EVENT_READ : 0) |
+      ((ev->events & EPOLLOUT) ? SELECT_EVENT_WRITE : 0);
+  }
+  dispatch_events(fd, events);
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_always_ready(void)
+{
+  int i;
+
+  for(i = 0; i <= select_max && i < select_entries_len; i++) {
+    if(select_entries[i].always_ready && select_entries[i].monitored) {
+      dispatch_events(i, select_entries[i].monitored);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+platform_main_loop()
+{
+  struct epoll_event events[SELECT_EPOLL_EVENTS];
+  sigset_t alarm_mask;
+  sigset_t wait_mask;
+
+#if SELECT_STDIN
+  select_set_callback(STDIN_FILENO, &stdin_fd);
+#endif /* SELECT_STDIN */
+  if(!epoll_init()) {
+    exit(EXIT_FAILURE);
+  }
+
+  sigemptyset(&alarm_mask);
+  sigaddset(&alarm_mask, SIGALRM);
+
+  while(1) {
+    int timeout;
+    int retval;
+    int i;
+
+    process_run();
+    profile_dump();
+#if LOG_WITH_BINARY
+    if(process_nevents() == 0) {
+      log_binary_flush();
+    }
+#endif /* LOG_WITH_BINARY */
+
+    update_callback_events();
+
+    if(process_nevents() > 0 || always_ready_count > 0) {
+      /* More to do: only check the file descriptors */
+      retval = epoll_wait(epoll_fd, events, SELECT_EPOLL_EVENTS, 0);
+    } else {
+      /* Hold the rtimer signal until the wait, so that a poll requested by
+       * an rtimer callback cannot go unnoticed while sleeping */
+      sigprocmask(SIG_BLOCK, &alarm_mask, &wait_mask);
+      if(process_nevents() > 0) {
+        timeout = 0;
+      } else {
+        timer_update();
+        timeout = -1;
+      }
+      retval = epoll_pwait(epoll_fd, events, SELECT_EPOLL_EVENTS, timeout,
+                           &wait_mask);
+      sigprocmask(SIG_SETMASK, &wait_mask, NULL);
+    }
+
+    if(retval < 0) {
+      if(errno != EINTR) {
+        perror("epoll_wait");
+      }
+    } else {
+      for(i = 0; i < retval; i++) {
+        handle_epoll_event(&events[i]);
+      }
+    }
+    if(always_ready_count > 0) {
+      handle_always_ready();
+    }
+
+    etimer_request_poll();
+  }
+}
+#else /* SELECT_EPOLL */
 void
 platform_main_loop()
 {
@@ -286,6 +770,12 @@ platform_main_loop()
     struct timeval tv;
 
     retval = process_run();
+    profile_dump();
+#if LOG_WITH_BINARY
+    if(retval == 0) {
+      log_binary_flush();
+    }
+#endif /* LOG_WITH_BINARY */
 
     tv.tv_sec = retval ? 0 : SELECT_TIMEOUT / 1000;
     tv.tv_usec = retval ? 1 : (SELECT_TIMEOUT * 1000) % 1000000;
@@ -294,7 +784,16 @@ platform_main_loop()
     FD_ZERO(&fdw);
     maxfd = 0;
     for(i = 0; i <= select_max; i++) {
-      if(select_callback[i] != NULL && select_callback[i]->set_fd(&fdr, &fdw)) {
+      struct select_entry *e = &select_entries[i];
+      if(e->callback != NULL && e->callback->set_fd(&fdr, &fdw)) {
+        maxfd = i;
+      } else if(e->handler != NULL) {
+        if(e->events & SELECT_EVENT_READ) {
+          FD_SET(i, &fdr);
+        }
+        if(e->events & SELECT_EVENT_WRITE) {
+          FD_SET(i, &fdw);
+        }
         maxfd = i;
       }
     }
@@ -307,8 +806,15 @@ platform_main_loop()
     } else if(retval > 0) {
       /* timeout => retval == 0 */
       for(i = 0; i <= maxfd; i++) {
-        if(select_callback[i] != NULL) {
-          select_callback[i]->handle_fd(&fdr, &fdw);
+        struct select_entry *e = &select_entries[i];
+        if(e->callback != NULL) {
+          e->callback->handle_fd(&fdr, &fdw);
+        } else if(e->handler != NULL) {
+          int events = (FD_ISSET(i, &fdr) ? SELECT_EVENT_READ : 0) |
+            (FD_ISSET(i, &fdw) ? SELECT_EVENT_WRITE : 0);
+          if(events) {
+            e->handler(i, events);
+          }
         }
       }
     }
@@ -316,5 +822,6 @@ platform_main_loop()
     etimer_request_poll();
   }
 }
+#endif /* SELECT_EPOLL */
 /*---------------------------------------------------------------------------*/
 /** @} */
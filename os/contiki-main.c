@@ -198,6 +198,9 @@ main(void)
   rtimer_init();
   process_init();
   process_start(&etimer_process, NULL);
+#if LOG_WITH_BINARY
+  log_binary_init();
+#endif /* LOG_WITH_BINARY */
   ctimer_init();
   watchdog_init();
 
@@ -299,6 +302,12 @@ main(void)
       watchdog_periodic();
     } while(r > 0);
 
+#if LOG_WITH_BINARY
+    if(log_binary_drain()) {
+      continue;
+    }
+#endif /* LOG_WITH_BINARY */
+
     platform_idle();
   }
 #endif
@@ -32,7 +32,7 @@
 #include "dev/serial-line.h"
 #include <string.h> /* for memcpy() */
 
-#include "lib/ringbuf.h"
+#include "lib/ringbuf-spsc.h"
 
 #ifdef SERIAL_LINE_CONF_BUFSIZE
 #define BUFSIZE SERIAL_LINE_CONF_BUFSIZE
@@ -52,7 +52,7 @@
 #define END2 0x0d
 #endif
 
-static struct ringbuf rxbuf;
+static struct ringbuf_spsc rxbuf;
 static uint8_t rxbuf_data[BUFSIZE];
 
 PROCESS(serial_line_process, "Serial driver");
@@ -67,14 +67,14 @@ serial_line_input_byte(unsigned char c)
   
   if(!overflow) {
     /* Add character */
-    if(ringbuf_put(&rxbuf, c) == 0) {
+    if(ringbuf_spsc_put(&rxbuf, &c) == 0) {
       /* Buffer overflow: ignore the rest of the line */
       overflow = 1;
     }
   } else {
     /* Buffer overflowed:
      * Only (try to) add terminator characters, otherwise skip */
-    if((c == END || c == END2) && ringbuf_put(&rxbuf, c) != 0) {
+    if((c == END || c == END2) && ringbuf_spsc_put(&rxbuf, &c) != 0) {
       overflow = 0;
     }
   }
@@ -96,19 +96,31 @@ PROCESS_THREAD(serial_line_process, ev, data)
 
   while(1) {
     /* Fill application buffer until newline or empty */
-    int c = ringbuf_get(&rxbuf);
-    
-    if(c == -1) {
+    const void *span;
+    const uint8_t *chars;
+    int len = ringbuf_spsc_peek_get(&rxbuf, &span);
+    int i;
+
+    if(len == 0) {
       /* Buffer empty, wait for poll */
       PROCESS_YIELD();
     } else {
-      if((c != END && c != END2)) {
-        if(ptr < BUFSIZE-1) {
-          buf[ptr++] = (uint8_t)c;
-        } else {
-          /* Ignore character (wait for EOL) */
-        }
+      chars = span;
+      for(i = 0; i < len && chars[i] != END && chars[i] != END2; i++);
+      /* Characters that do not fit are ignored (wait for EOL) */
+      if(i > BUFSIZE - 1 - ptr) {
+        memcpy(&buf[ptr], chars, BUFSIZE - 1 - ptr);
+        ptr = BUFSIZE - 1;
+      } else {
+        memcpy(&buf[ptr], chars, i);
+        ptr += i;
+      }
+
+      if(i == len) {
+        ringbuf_spsc_commit_get(&rxbuf, len);
       } else {
+        ringbuf_spsc_commit_get(&rxbuf, i + 1);
+
         /* Terminate */
         buf[ptr++] = (uint8_t)'\0';
 
@@ -131,7 +143,7 @@ PROCESS_THREAD(serial_line_process, ev, data)
 void
 serial_line_init(void)
 {
-  ringbuf_init(&rxbuf, rxbuf_data, sizeof(rxbuf_data));
+  ringbuf_spsc_init(&rxbuf, rxbuf_data, 1, sizeof(rxbuf_data));
   process_start(&serial_line_process, NULL);
 }
 /*---------------------------------------------------------------------------*/
@@ -31,6 +31,7 @@
 #include "contiki.h"
 #include "net/ipv6/uip.h"
 #include "dev/slip.h"
+#include "lib/ringbuf-spsc.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -43,36 +44,51 @@
 PROCESS(slip_process, "SLIP driver");
 /*---------------------------------------------------------------------------*/
 #if SLIP_CONF_WITH_STATS
-static uint16_t slip_rubbish, slip_twopackets, slip_overflow, slip_ip_drop;
+static uint16_t slip_rubbish, slip_overflow, slip_ip_drop;
 #define SLIP_STATISTICS(statement) statement
 #else
 #define SLIP_STATISTICS(statement)
 #endif
 /*---------------------------------------------------------------------------*/
-/* Must be at least one byte larger than UIP_BUFSIZE! */
-#define RX_BUFSIZE (UIP_BUFSIZE + 16)
+/*
+ * Size of the receive buffer, a power of two. Must be larger than
+ * UIP_BUFSIZE, as it holds the packets still SLIP encoded.
+ */
+#ifdef SLIP_CONF_RX_BUFSIZE
+#define RX_BUFSIZE SLIP_CONF_RX_BUFSIZE
+#elif UIP_BUFSIZE + 16 <= 256
+#define RX_BUFSIZE 256
+#elif UIP_BUFSIZE + 16 <= 512
+#define RX_BUFSIZE 512
+#elif UIP_BUFSIZE + 16 <= 1024
+#define RX_BUFSIZE 1024
+#elif UIP_BUFSIZE + 16 <= 2048
+#define RX_BUFSIZE 2048
+#else
+#define RX_BUFSIZE 4096
+#endif
+
+#if (RX_BUFSIZE & (RX_BUFSIZE - 1)) != 0
+#error SLIP_CONF_RX_BUFSIZE must be a power of two
+#endif
 /*---------------------------------------------------------------------------*/
 enum {
-  STATE_TWOPACKETS = 0, /* We have 2 packets and drop incoming data. */
+  STATE_INIT = 0, /* The buffer is not initialized yet, drop incoming data. */
   STATE_OK = 1,
   STATE_ESC = 2,
   STATE_RUBBISH = 3,
 };
 /*---------------------------------------------------------------------------*/
 /*
- * Variables begin and end manage the buffer space in a cyclic
- * fashion. The first used byte is at begin and end is one byte past
- * the last. I.e. [begin, end) is the actively used space.
- *
- * If begin != pkt_end we have a packet at [begin, pkt_end),
- * furthermore, if state == STATE_TWOPACKETS we have one more packet at
- * [pkt_end, end). If more bytes arrive in state STATE_TWOPACKETS
- * they are discarded.
+ * The interrupt handler stages the bytes of a packet in rxbuf as they
+ * arrive, and publishes them once the closing SLIP_END is received.
+ * slip_process therefore only ever sees complete packets, each of them
+ * ending with SLIP_END. A packet that does not fit, or that contains a
+ * bad escape sequence, is discarded before it is published.
  */
-static uint8_t state = STATE_TWOPACKETS;
-static uint16_t begin, next_free;
-static uint8_t rxbuf[RX_BUFSIZE];
-static uint16_t pkt_end;    /* SLIP_END tracker. */
+static uint8_t state = STATE_INIT;
+static struct ringbuf_spsc rxbuf;
+static uint8_t rxbuf_data[RX_BUFSIZE];
 
 static void (*input_callback)(void) = NULL;
 /*---------------------------------------------------------------------------*/
@@ -115,124 +131,52 @@ slip_write(const void *_ptr, int len)
 static void
 rxbuf_init(void)
 {
-  begin = next_free = pkt_end = 0;
+  ringbuf_spsc_init(&rxbuf, rxbuf_data, 1, sizeof(rxbuf_data));
   state = STATE_OK;
 }
 /*---------------------------------------------------------------------------*/
 static uint16_t
 slip_poll_handler(uint8_t *outbuf, uint16_t blen)
 {
-  /*
-   * Interrupt can not change begin but may change pkt_end.
-   * If pkt_end != begin it will not change again.
-   */
-  if(begin != pkt_end) {
-    uint16_t len;
-    uint16_t cur_next_free;
-    uint16_t cur_ptr;
-    int esc = 0;
+  const void *span;
+  const uint8_t *p;
+  uint16_t len = 0;
+  int esc = 0;
+  int n;
+  int i;
+  int run;
 
-    if(begin < pkt_end) {
-      uint16_t i;
-      len = 0;
-      for(i = begin; i < pkt_end; ++i) {
-        if(len > blen) {
-          len = 0;
-          break;
-        }
-        if(esc) {
-          if(rxbuf[i] == SLIP_ESC_ESC) {
-            outbuf[len] = SLIP_ESC;
-            len++;
-          } else if(rxbuf[i] == SLIP_ESC_END) {
-            outbuf[len] = SLIP_END;
-            len++;
-          }
-          esc = 0;
-        } else if(rxbuf[i] == SLIP_ESC) {
-          esc = 1;
-        } else {
-          outbuf[len] = rxbuf[i];
-          len++;
-        }
-      }
-    } else {
-      uint16_t i;
-      len = 0;
-      for(i = begin; i < RX_BUFSIZE; ++i) {
-        if(len > blen) {
-          len = 0;
-          break;
-        }
-        if(esc) {
-          if(rxbuf[i] == SLIP_ESC_ESC) {
-            outbuf[len] = SLIP_ESC;
-            len++;
-          } else if(rxbuf[i] == SLIP_ESC_END) {
-            outbuf[len] = SLIP_END;
-            len++;
-          }
-          esc = 0;
-        } else if(rxbuf[i] == SLIP_ESC) {
-          esc = 1;
-        } else {
-          outbuf[len] = rxbuf[i];
-          len++;
-        }
-      }
-      for(i = 0; i < pkt_end; ++i) {
-        if(len > blen) {
-          len = 0;
-          break;
-        }
-        if(esc) {
-          if(rxbuf[i] == SLIP_ESC_ESC) {
-            outbuf[len] = SLIP_ESC;
-            len++;
-          } else if(rxbuf[i] == SLIP_ESC_END) {
-            outbuf[len] = SLIP_END;
-            len++;
-          }
-          esc = 0;
-        } else if(rxbuf[i] == SLIP_ESC) {
-          esc = 1;
-        } else {
-          outbuf[len] = rxbuf[i];
-          len++;
+  /* Decode the first packet, one contiguous part of rxbuf at a time */
+  while((n = ringbuf_spsc_peek_get(&rxbuf, &span)) > 0) {
+    p = span;
+    for(i = 0; i < n; i++) {
+      if(esc) {
+        if(len < blen) {
+          outbuf[len] = p[i] == SLIP_ESC_END ? SLIP_END : SLIP_ESC;
         }
-      }
-    }
-
-    /* Remove data from buffer together with the copied packet. */
-    pkt_end = pkt_end + 1;
-    if(pkt_end == RX_BUFSIZE) {
-      pkt_end = 0;
-    }
-    if(pkt_end != next_free) {
-      cur_next_free = next_free;
-      cur_ptr = pkt_end;
-      while(cur_ptr != cur_next_free) {
-        if(rxbuf[cur_ptr] == SLIP_END) {
-          uint16_t tmp_begin = pkt_end;
-          pkt_end = cur_ptr;
-          begin = tmp_begin;
+        len++;
+        esc = 0;
+      } else if(p[i] == SLIP_ESC) {
+        esc = 1;
+      } else if(p[i] == SLIP_END) {
+        ringbuf_spsc_commit_get(&rxbuf, i + 1);
+        if(!ringbuf_spsc_empty(&rxbuf)) {
           /* One more packet is buffered, need to be polled again! */
           process_poll(&slip_process);
-          break;
         }
-        cur_ptr++;
-        if(cur_ptr == RX_BUFSIZE) {
-          cur_ptr = 0;
+        return len <= blen ? len : 0;
+      } else {
+        /* Copy the bytes up to the next special one at once */
+        for(run = i + 1;
+            run < n && p[run] != SLIP_ESC && p[run] != SLIP_END; run++);
+        if(len + (run - i) <= blen) {
+          memcpy(&outbuf[len], &p[i], run - i);
         }
+        len += run - i;
+        i = run - 1;
       }
-      if(cur_ptr == cur_next_free) {
-        /* no more pending full packet found */
-        begin = pkt_end;
-      }
-    } else {
-      begin = pkt_end;
     }
-    return len;
+    ringbuf_spsc_commit_get(&rxbuf, n);
   }
 
   return 0;
@@ -263,8 +207,10 @@ PROCESS_THREAD(slip_process, ev, data)
 int
 slip_input_byte(unsigned char c)
 {
-  uint16_t cur_end;
   switch(state) {
+  case STATE_INIT:
+    return 0;
+
   case STATE_RUBBISH:
     if(c == SLIP_END) {
       state = STATE_OK;
@@ -275,7 +221,7 @@ slip_input_byte(unsigned char c)
     if(c != SLIP_ESC_END && c != SLIP_ESC_ESC) {
       state = STATE_RUBBISH;
       SLIP_STATISTICS(slip_rubbish++);
-      next_free = pkt_end;    /* remove rubbish */
+      ringbuf_spsc_discard(&rxbuf);    /* remove rubbish */
       return 0;
     }
     state = STATE_OK;
@@ -286,39 +232,23 @@ slip_input_byte(unsigned char c)
     state = STATE_ESC;
   }
 
-  /* add_char: */
-  cur_end = next_free;
-  next_free = next_free + 1;
-  if(next_free == RX_BUFSIZE) {
-    next_free = 0;
+  if(c == SLIP_END && ringbuf_spsc_staged(&rxbuf) == 0) {
+    /* Empty packet */
+    return 0;
   }
-  if(next_free == begin) {         /* rxbuf is full */
-    state = STATE_RUBBISH;
+
+  if(!ringbuf_spsc_stage(&rxbuf, &c)) {  /* rxbuf is full */
+    state = c == SLIP_END ? STATE_OK : STATE_RUBBISH;
     SLIP_STATISTICS(slip_overflow++);
-    next_free = pkt_end;            /* remove rubbish */
+    ringbuf_spsc_discard(&rxbuf);        /* remove rubbish */
     return 0;
   }
-  rxbuf[cur_end] = c;
 
   if(c == SLIP_END) {
-    /*
-     * We have a new packet, possibly of zero length.
-     *
-     * There may already be one packet buffered.
-     */
-    if(cur_end != pkt_end) {  /* Non zero length. */
-      if(begin == pkt_end) {  /* None buffered. */
-        pkt_end = cur_end;
-      } else {
-        SLIP_STATISTICS(slip_twopackets++);
-      }
-      process_poll(&slip_process);
-      return 1;
-    } else {
-      /* Empty packet, reset the pointer */
-      next_free = cur_end;
-    }
-    return 0;
+    /* We have a new packet */
+    ringbuf_spsc_publish(&rxbuf);
+    process_poll(&slip_process);
+    return 1;
   }
 
   return 0;
@@ -82,7 +82,75 @@ static const uint8_t sbox[256] = {
   0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68,
   0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
 };
-static uint8_t round_keys[11][AES_128_KEY_LENGTH];
+#if AES_128_WITH_TTABLES
+/*
+ * te[x] is the MixColumns contribution of the state byte x in row 0,
+ * after SubBytes. Columns are stored with row i in bits 8i..8i+7, and
+ * the contributions of rows 1 to 3 are te[x] rotated by 8, 16 and 24
+ * bits.
+ */
+static const uint32_t te[256] = {
+  0xa56363c6, 0x847c7cf8, 0x997777ee, 0x8d7b7bf6, 0x0df2f2ff, 0xbd6b6bd6,
+  0xb16f6fde, 0x54c5c591, 0x50303060, 0x03010102, 0xa96767ce, 0x7d2b2b56,
+  0x19fefee7, 0x62d7d7b5, 0xe6abab4d, 0x9a7676ec, 0x45caca8f, 0x9d82821f,
+  0x40c9c989, 0x877d7dfa, 0x15fafaef, 0xeb5959b2, 0xc947478e, 0x0bf0f0fb,
+  0xecadad41, 0x67d4d4b3, 0xfda2a25f, 0xeaafaf45, 0xbf9c9c23, 0xf7a4a453,
+  0x967272e4, 0x5bc0c09b, 0xc2b7b775, 0x1cfdfde1, 0xae93933d, 0x6a26264c,
+  0x5a36366c, 0x413f3f7e, 0x02f7f7f5, 0x4fcccc83, 0x5c343468, 0xf4a5a551,
+  0x34e5e5d1, 0x08f1f1f9, 0x937171e2, 0x73d8d8ab, 0x53313162, 0x3f15152a,
+  0x0c040408, 0x52c7c795, 0x65232346, 0x5ec3c39d, 0x28181830, 0xa1969637,
+  0x0f05050a, 0xb59a9a2f, 0x0907070e, 0x36121224, 0x9b80801b, 0x3de2e2df,
+  0x26ebebcd, 0x6927274e, 0xcdb2b27f, 0x9f7575ea, 0x1b090912, 0x9e83831d,
+  0x742c2c58, 0x2e1a1a34, 0x2d1b1b36, 0xb26e6edc, 0xee5a5ab4, 0xfba0a05b,
+  0xf65252a4, 0x4d3b3b76, 0x61d6d6b7, 0xceb3b37d, 0x7b292952, 0x3ee3e3dd,
+  0x712f2f5e, 0x97848413, 0xf55353a6, 0x68d1d1b9, 0x00000000, 0x2cededc1,
+  0x60202040, 0x1ffcfce3, 0xc8b1b179, 0xed5b5bb6, 0xbe6a6ad4, 0x46cbcb8d,
+  0xd9bebe67, 0x4b393972, 0xde4a4a94, 0xd44c4c98, 0xe85858b0, 0x4acfcf85,
+  0x6bd0d0bb, 0x2aefefc5, 0xe5aaaa4f, 0x16fbfbed, 0xc5434386, 0xd74d4d9a,
+  0x55333366, 0x94858511, 0xcf45458a, 0x10f9f9e9, 0x06020204, 0x817f7ffe,
+  0xf05050a0, 0x443c3c78, 0xba9f9f25, 0xe3a8a84b, 0xf35151a2, 0xfea3a35d,
+  0xc0404080, 0x8a8f8f05, 0xad92923f, 0xbc9d9d21, 0x48383870, 0x04f5f5f1,
+  0xdfbcbc63, 0xc1b6b677, 0x75dadaaf, 0x63212142, 0x30101020, 0x1affffe5,
+  0x0ef3f3fd, 0x6dd2d2bf, 0x4ccdcd81, 0x140c0c18, 0x35131326, 0x2fececc3,
+  0xe15f5fbe, 0xa2979735, 0xcc444488, 0x3917172e, 0x57c4c493, 0xf2a7a755,
+  0x827e7efc, 0x473d3d7a, 0xac6464c8, 0xe75d5dba, 0x2b191932, 0x957373e6,
+  0xa06060c0, 0x98818119, 0xd14f4f9e, 0x7fdcdca3, 0x66222244, 0x7e2a2a54,
+  0xab90903b, 0x8388880b, 0xca46468c, 0x29eeeec7, 0xd3b8b86b, 0x3c141428,
+  0x79dedea7, 0xe25e5ebc, 0x1d0b0b16, 0x76dbdbad, 0x3be0e0db, 0x56323264,
+  0x4e3a3a74, 0x1e0a0a14, 0xdb494992, 0x0a06060c, 0x6c242448, 0xe45c5cb8,
+  0x5dc2c29f, 0x6ed3d3bd, 0xefacac43, 0xa66262c4, 0xa8919139, 0xa4959531,
+  0x37e4e4d3, 0x8b7979f2, 0x32e7e7d5, 0x43c8c88b, 0x5937376e, 0xb76d6dda,
+  0x8c8d8d01, 0x64d5d5b1, 0xd24e4e9c, 0xe0a9a949, 0xb46c6cd8, 0xfa5656ac,
+  0x07f4f4f3, 0x25eaeacf, 0xaf6565ca, 0x8e7a7af4, 0xe9aeae47, 0x18080810,
+  0xd5baba6f, 0x887878f0, 0x6f25254a, 0x722e2e5c, 0x241c1c38, 0xf1a6a657,
+  0xc7b4b473, 0x51c6c697, 0x23e8e8cb, 0x7cdddda1, 0x9c7474e8, 0x211f1f3e,
+  0xdd4b4b96, 0xdcbdbd61, 0x868b8b0d, 0x858a8a0f, 0x907070e0, 0x423e3e7c,
+  0xc4b5b571, 0xaa6666cc, 0xd8484890, 0x05030306, 0x01f6f6f7, 0x120e0e1c,
+  0xa36161c2, 0x5f35356a, 0xf95757ae, 0xd0b9b969, 0x91868617, 0x58c1c199,
+  0x271d1d3a, 0xb99e9e27, 0x38e1e1d9, 0x13f8f8eb, 0xb398982b, 0x33111122,
+  0xbb6969d2, 0x70d9d9a9, 0x898e8e07, 0xa7949433, 0xb69b9b2d, 0x221e1e3c,
+  0x92878715, 0x20e9e9c9, 0x49cece87, 0xff5555aa, 0x78282850, 0x7adfdfa5,
+  0x8f8c8c03, 0xf8a1a159, 0x80898909, 0x170d0d1a, 0xdabfbf65, 0x31e6e6d7,
+  0xc6424284, 0xb86868d0, 0xc3414182, 0xb0999929, 0x772d2d5a, 0x110f0f1e,
+  0xcbb0b07b, 0xfc5454a8, 0xd6bbbb6d, 0x3a16162c
+
+};
+#define ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+#endif /* AES_128_WITH_TTABLES */
+
+struct expanded_key {
+  uint8_t key[AES_128_KEY_LENGTH];
+#if AES_128_WITH_TTABLES
+  /* Round key columns, with row i in bits 8i..8i+7 */
+  uint32_t round_keys[44];
+#else /* AES_128_WITH_TTABLES */
+  uint8_t round_keys[11][AES_128_KEY_LENGTH];
+#endif /* AES_128_WITH_TTABLES */
+};
+static struct expanded_key keys[AES_128_KEY_CACHE_SIZE];
+static uint8_t keys_used;
+static uint8_t keys_next;
+static struct expanded_key *current = &keys[0];
 
 /*---------------------------------------------------------------------------*/
 /* multiplies by 2 in GF(2) */
@@ -93,15 +161,111 @@ galois_mul2(uint8_t value)
   return ((value << 1) ^ xor_val);
 }
 /*---------------------------------------------------------------------------*/
+#if AES_128_WITH_TTABLES
+static uint32_t
+load_column(const uint8_t *p)
+{
+  return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+    ((uint32_t)p[3] << 24);
+}
+/*---------------------------------------------------------------------------*/
 static void
-set_key(const uint8_t *key)
+store_column(uint8_t *p, uint32_t column)
+{
+  p[0] = column;
+  p[1] = column >> 8;
+  p[2] = column >> 16;
+  p[3] = column >> 24;
+}
+/*---------------------------------------------------------------------------*/
+static void
+expand_key(struct expanded_key *k)
+{
+  uint32_t *w = k->round_keys;
+  uint32_t t;
+  uint8_t rcon;
+  uint8_t i;
+
+  for(i = 0; i < 4; i++) {
+    w[i] = load_column(&k->key[4 * i]);
+  }
+  rcon = 0x01;
+  for(i = 4; i < 44; i++) {
+    t = w[i - 1];
+    if(i % 4 == 0) {
+      /* RotWord, SubWord and Rcon */
+      t = (sbox[(t >> 8) & 0xff] ^ rcon) |
+        ((uint32_t)sbox[(t >> 16) & 0xff] << 8) |
+        ((uint32_t)sbox[t >> 24] << 16) |
+        ((uint32_t)sbox[t & 0xff] << 24);
+      rcon = galois_mul2(rcon);
+    }
+    w[i] = w[i - 4] ^ t;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+encrypt(uint8_t *state)
 {
+  const uint32_t *rk = current->round_keys;
+  uint32_t s0, s1, s2, s3;
+  uint32_t t0, t1, t2, t3;
+  uint8_t round;
+
+  /* round 0 */
+  s0 = load_column(state) ^ rk[0];
+  s1 = load_column(state + 4) ^ rk[1];
+  s2 = load_column(state + 8) ^ rk[2];
+  s3 = load_column(state + 12) ^ rk[3];
+
+  /* SubBytes, ShiftRows, MixColumns and AddRoundKey at once */
+  for(round = 1; round < 10; round++) {
+    rk += 4;
+    t0 = te[s0 & 0xff] ^ ROTL(te[(s1 >> 8) & 0xff], 8) ^
+      ROTL(te[(s2 >> 16) & 0xff], 16) ^ ROTL(te[s3 >> 24], 24) ^ rk[0];
+    t1 = te[s1 & 0xff] ^ ROTL(te[(s2 >> 8) & 0xff], 8) ^
+      ROTL(te[(s3 >> 16) & 0xff], 16) ^ ROTL(te[s0 >> 24], 24) ^ rk[1];
+    t2 = te[s2 & 0xff] ^ ROTL(te[(s3 >> 8) & 0xff], 8) ^
+      ROTL(te[(s0 >> 16) & 0xff], 16) ^ ROTL(te[s1 >> 24], 24) ^ rk[2];
+    t3 = te[s3 & 0xff] ^ ROTL(te[(s0 >> 8) & 0xff], 8) ^
+      ROTL(te[(s1 >> 16) & 0xff], 16) ^ ROTL(te[s2 >> 24], 24) ^ rk[3];
+    s0 = t0;
+    s1 = t1;
+    s2 = t2;
+    s3 = t3;
+  }
+
+  /* last round skips MixColumn */
+  rk += 4;
+  store_column(state, (sbox[s0 & 0xff] |
+                       ((uint32_t)sbox[(s1 >> 8) & 0xff] << 8) |
+                       ((uint32_t)sbox[(s2 >> 16) & 0xff] << 16) |
+                       ((uint32_t)sbox[s3 >> 24] << 24)) ^ rk[0]);
+  store_column(state + 4, (sbox[s1 & 0xff] |
+                           ((uint32_t)sbox[(s2 >> 8) & 0xff] << 8) |
+                           ((uint32_t)sbox[(s3 >> 16) & 0xff] << 16) |
+                           ((uint32_t)sbox[s0 >> 24] << 24)) ^ rk[1]);
+  store_column(state + 8, (sbox[s2 & 0xff] |
+                           ((uint32_t)sbox[(s3 >> 8) & 0xff] << 8) |
+                           ((uint32_t)sbox[(s0 >> 16) & 0xff] << 16) |
+                           ((uint32_t)sbox[s1 >> 24] << 24)) ^ rk[2]);
+  store_column(state + 12, (sbox[s3 & 0xff] |
+                            ((uint32_t)sbox[(s0 >> 8) & 0xff] << 8) |
+                            ((uint32_t)sbox[(s1 >> 16) & 0xff] << 16) |
+                            ((uint32_t)sbox[s2 >> 24] << 24)) ^ rk[3]);
+}
+#else /* AES_128_WITH_TTABLES */
+/*---------------------------------------------------------------------------*/
+static void
+expand_key(struct expanded_key *k)
+{
+  uint8_t (*round_keys)[AES_128_KEY_LENGTH] = k->round_keys;
   uint8_t i;
   uint8_t j;
   uint8_t rcon;
 
   rcon = 0x01;
-  memcpy(round_keys[0], key, AES_128_KEY_LENGTH);
+  memcpy(round_keys[0], k->key, AES_128_KEY_LENGTH);
   for(i = 1; i <= 10; i++) {
     round_keys[i][0] = sbox[round_keys[i - 1][13]] ^ round_keys[i - 1][0]
         ^ rcon;
@@ -118,6 +282,7 @@ set_key(const uint8_t *key)
 static void
 encrypt(uint8_t *state)
 {
+  uint8_t (*round_keys)[AES_128_KEY_LENGTH] = current->round_keys;
   uint8_t buf1, buf2, buf3, buf4, round, i;
 
   /* round 0 */
@@ -184,10 +349,99 @@ encrypt(uint8_t *state)
     }
   }
 }
+#endif /* AES_128_WITH_TTABLES */
+/*---------------------------------------------------------------------------*/
+static void
+set_key(const uint8_t *key)
+{
+  uint8_t i;
+
+  for(i = 0; i < keys_used; i++) {
+    if(!memcmp(keys[i].key, key, AES_128_KEY_LENGTH)) {
+      current = &keys[i];
+      return;
+    }
+  }
+
+  /* Replace the oldest entry once the cache is full */
+  if(keys_used < AES_128_KEY_CACHE_SIZE) {
+    current = &keys[keys_used++];
+  } else {
+    current = &keys[keys_next];
+    keys_next = (keys_next + 1) % AES_128_KEY_CACHE_SIZE;
+  }
+  memcpy(current->key, key, AES_128_KEY_LENGTH);
+  expand_key(current);
+}
+/*---------------------------------------------------------------------------*/
+static void
+ctr_crypt_with(void (* encrypt_block)(uint8_t *),
+               uint8_t *counter, uint8_t *data, uint16_t len)
+{
+  uint8_t stream[AES_128_BLOCK_SIZE];
+  uint8_t i;
+
+  while(len > 0) {
+    memcpy(stream, counter, AES_128_BLOCK_SIZE);
+    encrypt_block(stream);
+    aes_128_ctr_increment(counter);
+    for(i = 0; i < AES_128_BLOCK_SIZE && len > 0; i++, len--) {
+      *data++ ^= stream[i];
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+ecb_encrypt(uint8_t *blocks, uint16_t count)
+{
+  for(; count > 0; count--) {
+    encrypt(blocks);
+    blocks += AES_128_BLOCK_SIZE;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+ctr_crypt(uint8_t *counter, uint8_t *data, uint16_t len)
+{
+  ctr_crypt_with(encrypt, counter, data, len);
+}
+/*---------------------------------------------------------------------------*/
+void
+aes_128_ctr_increment(uint8_t *counter)
+{
+  uint8_t i = AES_128_BLOCK_SIZE;
+
+  while(i > 0 && ++counter[--i] == 0);
+}
+/*---------------------------------------------------------------------------*/
+void
+aes_128_ecb_encrypt(uint8_t *blocks, uint16_t count)
+{
+  if(AES_128.ecb_encrypt) {
+    AES_128.ecb_encrypt(blocks, count);
+    return;
+  }
+  for(; count > 0; count--) {
+    AES_128.encrypt(blocks);
+    blocks += AES_128_BLOCK_SIZE;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+aes_128_ctr_crypt(uint8_t *counter, uint8_t *data, uint16_t len)
+{
+  if(AES_128.ctr_crypt) {
+    AES_128.ctr_crypt(counter, data, len);
+    return;
+  }
+  ctr_crypt_with(AES_128.encrypt, counter, data, len);
+}
 /*---------------------------------------------------------------------------*/
 const struct aes_128_driver aes_128_driver = {
   set_key,
-  encrypt
+  encrypt,
+  ecb_encrypt,
+  ctr_crypt
 };
 /*---------------------------------------------------------------------------*/
 
@@ -53,6 +53,29 @@
 #define AES_128            aes_128_driver
 #endif /* AES_128_CONF */
 
+/**
+ * Whether the software driver uses a 1 kB lookup table that merges
+ * SubBytes and MixColumns ("T-table"), instead of computing them byte
+ * by byte. This is several times faster, but on CPUs with a data cache
+ * the table lookups leak timing information about the key.
+ */
+#ifdef AES_128_CONF_WITH_TTABLES
+#define AES_128_WITH_TTABLES AES_128_CONF_WITH_TTABLES
+#else /* AES_128_CONF_WITH_TTABLES */
+#define AES_128_WITH_TTABLES 0
+#endif /* AES_128_CONF_WITH_TTABLES */
+
+/**
+ * The number of expanded keys the software driver keeps. Setting a key
+ * that is in the cache only selects it, so alternating between the
+ * keys of a few links does not redo the key schedule for every frame.
+ */
+#ifdef AES_128_CONF_KEY_CACHE_SIZE
+#define AES_128_KEY_CACHE_SIZE AES_128_CONF_KEY_CACHE_SIZE
+#else /* AES_128_CONF_KEY_CACHE_SIZE */
+#define AES_128_KEY_CACHE_SIZE 1
+#endif /* AES_128_CONF_KEY_CACHE_SIZE */
+
 /**
  * Structure of AES drivers.
  */
@@ -67,10 +90,55 @@ struct aes_128_driver {
    * \brief Encrypts.
    */
   void (* encrypt)(uint8_t *plaintext_and_result);
+
+  /**
+   * \brief        Encrypts consecutive blocks in ECB mode.
+   * \param blocks The blocks, encrypted in place
+   * \param count  The number of blocks
+   *
+   *               Optional, use aes_128_ecb_encrypt() to call it.
+   */
+  void (* ecb_encrypt)(uint8_t *blocks, uint16_t count);
+
+  /**
+   * \brief         Encrypts or decrypts in CTR mode.
+   * \param counter The initial counter block, left incremented past
+   *                the last block used
+   * \param data    The data, XORed in place with the key stream
+   * \param len     The length of the data, need not be a multiple of
+   *                the block size
+   *
+   *                The counter block is incremented as a 128-bit
+   *                big-endian number. Optional, use aes_128_ctr_crypt()
+   *                to call it.
+   */
+  void (* ctr_crypt)(uint8_t *counter, uint8_t *data, uint16_t len);
 };
 
+extern const struct aes_128_driver aes_128_driver;
 extern const struct aes_128_driver AES_128;
 
+/**
+ * \brief Encrypts blocks in ECB mode with AES_128.
+ *
+ *        Uses the driver's ecb_encrypt() if it has one, and encrypts
+ *        block by block otherwise.
+ */
+void aes_128_ecb_encrypt(uint8_t *blocks, uint16_t count);
+
+/**
+ * \brief Encrypts or decrypts in CTR mode with AES_128.
+ *
+ *        Uses the driver's ctr_crypt() if it has one, and encrypts
+ *        the counter block by block otherwise.
+ */
+void aes_128_ctr_crypt(uint8_t *counter, uint8_t *data, uint16_t len);
+
+/**
+ * \brief Increments a counter block as a 128-bit big-endian number.
+ */
+void aes_128_ctr_increment(uint8_t *counter);
+
 #endif /* AES_128_H_ */
 
 /** @} */
@@ -28,6 +28,7 @@
  *
  */
 #include "lib/assert.h"
+#include "sys/stack-check.h"
 
 #include <stdio.h>
 
@@ -35,6 +36,7 @@ void
 _xassert(const char *file, int lineno)
 {
   printf("Assertion failed: file %s, line %d.\n", file, lineno);
+  stack_check_report();
 
 #if !ASSERT_RETURNS
   printf("The firmware will stop running\n");
@@ -134,11 +134,11 @@ mic(const uint8_t *nonce,
 static void
 ctr(const uint8_t *nonce, uint8_t *m, uint16_t m_len)
 {
-  uint16_t counter = 1;
-  /* 32-bit pos to reach the end of the loop if m_len is large */
-  for(uint32_t pos = 0; pos < m_len; pos += AES_128_BLOCK_SIZE) {
-    ctr_step(nonce, pos, m, m_len, counter++);
-  }
+  uint8_t counter[AES_128_BLOCK_SIZE];
+
+  /* The key stream of all blocks at once, for drivers that pipeline */
+  set_iv(counter, CCM_STAR_ENCRYPTION_FLAGS, nonce, 1);
+  aes_128_ctr_crypt(counter, m, m_len);
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -55,6 +55,25 @@
 #ifndef CRC16_H_
 #define CRC16_H_
 
+#include "contiki.h"
+
+/**
+ * The number of 256-entry lookup tables used, trading flash for speed.
+ * 0 computes the CRC bit by bit without a table. 1 uses a byte-wise
+ * table (512 bytes). 4 and 8 additionally let crc16_data() process 4
+ * or 8 bytes per step ("slice-by-N", 2 and 4 kB of tables).
+ */
+#ifdef CRC16_CONF_SLICES
+#define CRC16_SLICES CRC16_CONF_SLICES
+#else
+#define CRC16_SLICES 0
+#endif
+
+#if CRC16_SLICES != 0 && CRC16_SLICES != 1 && CRC16_SLICES != 4 && \
+  CRC16_SLICES != 8
+#error "CRC16_CONF_SLICES must be 0, 1, 4 or 8"
+#endif
+
 /**
  * \brief      Update an accumulated CRC16 checksum with one byte.
  * \param b    The byte to be added to the checksum
@@ -65,10 +84,9 @@
  *             with one byte. It can be used as a running checksum, or
  *             to checksum an entire data block.
  *
- *             \note The algorithm used in this implementation is
- *             tailored for a running checksum and does not perform as
- *             well as a table-driven algorithm when checksumming an
- *             entire data block.
+ *             \note Use crc16_data() for data blocks; with
+ *             CRC16_CONF_SLICES set to 4 or 8 it processes several
+ *             bytes per step.
  *
  */
 unsigned short crc16_add(unsigned char b, unsigned short crc);
@@ -80,12 +98,14 @@ unsigned short crc16_add(unsigned char b, unsigned short crc);
  * \param acc  The accumulated CRC that is to be updated (or zero).
  * \return     The CRC16 checksum.
  *
- *             This function calculates the CRC16 checksum of a data area.
+ *             This function calculates the CRC16 checksum of a data
+ *             area. The checksum of a block split in several parts is
+ *             obtained by passing the result for each part as \p acc
+ *             for the next one.
  *
- *             \note The algorithm used in this implementation is
- *             tailored for a running checksum and does not perform as
- *             well as a table-driven algorithm when checksumming an
- *             entire data block.
+ *             The CRC is CRC-16/KERMIT: the CCITT polynomial 0x1021 in
+ *             bit-reflected form, starting from \p acc with no final
+ *             XOR. "123456789" gives 0x2189.
  */
 unsigned short crc16_data(const unsigned char *data, int datalen,
 			  unsigned short acc);
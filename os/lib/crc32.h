@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Header file for the CRC32 calculation
+ */
+
+/** \addtogroup lib
+ * @{ */
+
+/**
+ * \defgroup crc32 CRC32 calculation
+ *
+ * The IEEE 802.3 CRC32, as used by Ethernet, zlib and PNG, for longer
+ * blocks where CRC16 is too weak. The interface mirrors the CRC16
+ * module: checksums can be updated byte by byte or over a data block.
+ *
+ * @{
+ */
+
+#ifndef CRC32_H_
+#define CRC32_H_
+
+#include "contiki.h"
+
+/**
+ * The number of 256-entry lookup tables used, trading flash for speed.
+ * 0 computes the CRC bit by bit without a table. 1 uses a byte-wise
+ * table (1 kB). 4 and 8 additionally let crc32_data() process 4 or 8
+ * bytes per step ("slice-by-N", 4 and 8 kB of tables).
+ */
+#ifdef CRC32_CONF_SLICES
+#define CRC32_SLICES CRC32_CONF_SLICES
+#else
+#define CRC32_SLICES 0
+#endif
+
+#if CRC32_SLICES != 0 && CRC32_SLICES != 1 && CRC32_SLICES != 4 && \
+  CRC32_SLICES != 8
+#error "CRC32_CONF_SLICES must be 0, 1, 4 or 8"
+#endif
+
+/**
+ * \brief      Update a CRC32 checksum with one byte.
+ * \param b    The byte to be added to the checksum
+ * \param crc  The CRC of the preceding data (or zero).
+ * \return     The updated CRC checksum.
+ */
+uint32_t crc32_add(uint8_t b, uint32_t crc);
+
+/**
+ * \brief      Calculate the CRC32 over a data area
+ * \param data Pointer to the data
+ * \param len  The length of the data
+ * \param crc  The CRC of the preceding data (or zero).
+ * \return     The CRC32 checksum.
+ *
+ *             The pre- and post-inversion of the standard CRC32 is
+ *             done internally, so the checksum of a block split in
+ *             several parts is obtained by passing the result for each
+ *             part as \p crc for the next one, starting from zero.
+ *             "123456789" gives 0xcbf43926.
+ */
+uint32_t crc32_data(const uint8_t *data, int len, uint32_t crc);
+
+#endif /* CRC32_H_ */
+
+/** @} */
+/** @} */
@@ -36,6 +36,7 @@
  * 	Nicolas Tsiftes <nvt@acm.org>
  */
 
+#include <limits.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
@@ -86,6 +87,23 @@
 #define HEAPMEM_REALLOC 1
 #endif /* HEAPMEM_CONF_REALLOC */
 
+/*
+ * The HEAPMEM_CONF_SEGREGATED_FIT parameter determines whether free
+ * chunks are kept in segregated free lists indexed by size class
+ * (non-zero value), or in a single free list (zero value). With
+ * segregated free lists, a suitable chunk is found in constant time
+ * through a two-level bitmap of the non-empty size classes, in the
+ * manner of the TLSF allocator. This costs a few hundred bytes of RAM
+ * for the list heads, but avoids the bounded search of the single free
+ * list, which may give up and extend the heap although a suitable
+ * chunk exists.
+ */
+#ifdef HEAPMEM_CONF_SEGREGATED_FIT
+#define HEAPMEM_SEGREGATED_FIT HEAPMEM_CONF_SEGREGATED_FIT
+#else
+#define HEAPMEM_SEGREGATED_FIT 0
+#endif /* HEAPMEM_CONF_SEGREGATED_FIT */
+
 #if __STDC_VERSION__ >= 201112L
 #include <stdalign.h>
 #define HEAPMEM_DEFAULT_ALIGNMENT alignof(max_align_t)
@@ -178,7 +196,26 @@ static char heap_base[HEAPMEM_ARENA_SIZE] CC_ALIGN(HEAPMEM_ALIGNMENT);
 static size_t heap_usage;
 static size_t max_heap_usage;
 
+#if HEAPMEM_SEGREGATED_FIT
+/*
+ * Each first-level class covers a power-of-two size range, which is
+ * linearly subdivided into SL_COUNT second-level classes. All sizes
+ * below SMALL_SIZE belong to the first first-level class. Chunks that
+ * are larger than the last class can describe are kept in the last
+ * class.
+ */
+#define SL_LOG2   2
+#define SL_COUNT  (1 << SL_LOG2)
+#define FL_SHIFT  6
+#define FL_COUNT  24
+#define SMALL_SIZE ((size_t)1 << FL_SHIFT)
+
+static chunk_t *free_lists[FL_COUNT][SL_COUNT];
+static uint32_t fl_bitmap;
+static uint8_t sl_bitmap[FL_COUNT];
+#else
 static chunk_t *free_list;
+#endif /* HEAPMEM_SEGREGATED_FIT */
 
 #define IN_HEAP(ptr) ((ptr) != NULL && \
                      (char *)(ptr) >= (char *)heap_base) && \
@@ -202,26 +239,115 @@ extend_space(size_t size)
   return old_usage;
 }
 
-/* free_chunk: Mark a chunk as being free, and put it on the free list. */
-static void
-free_chunk(chunk_t * const chunk)
+#if HEAPMEM_SEGREGATED_FIT
+/* floor_log2: Return the base-2 logarithm of a non-zero size,
+   rounded down. */
+static inline unsigned
+floor_log2(size_t size)
 {
-  chunk->flags &= ~CHUNK_FLAG_ALLOCATED;
+#ifdef __GNUC__
+  return sizeof(unsigned long) * CHAR_BIT - 1 -
+    __builtin_clzl((unsigned long)size);
+#else
+  unsigned log2 = 0;
+  while(size >>= 1) {
+    log2++;
+  }
+  return log2;
+#endif /* __GNUC__ */
+}
 
-  if(IS_LAST_CHUNK(chunk)) {
-    /* Release the chunk back into the wilderness. */
-    heap_usage -= sizeof(chunk_t) + chunk->size;
+/* find_first_set: Return the index of the least significant set bit
+   in a non-zero word. */
+static inline unsigned
+find_first_set(uint32_t word)
+{
+#ifdef __GNUC__
+  return __builtin_ctzl((unsigned long)word);
+#else
+  unsigned index = 0;
+  while(!(word & 1)) {
+    word >>= 1;
+    index++;
+  }
+  return index;
+#endif /* __GNUC__ */
+}
+
+/* size_class: Map a chunk size to its first- and second-level
+   size class. */
+static void
+size_class(size_t size, unsigned *fl, unsigned *sl)
+{
+  if(size < SMALL_SIZE) {
+    *fl = 0;
+    *sl = size / (SMALL_SIZE / SL_COUNT);
   } else {
-    /* Put the chunk on the free list. */
-    chunk->prev = NULL;
-    chunk->next = free_list;
-    if(free_list != NULL) {
-      free_list->prev = chunk;
+    unsigned log2 = floor_log2(size);
+    *fl = log2 - FL_SHIFT + 1;
+    *sl = (size >> (log2 - SL_LOG2)) & (SL_COUNT - 1);
+    if(*fl >= FL_COUNT) {
+      *fl = FL_COUNT - 1;
+      *sl = SL_COUNT - 1;
     }
-    free_list = chunk;
   }
 }
 
+/* add_chunk_to_free_list: Put a free chunk on the list of its
+   size class. */
+static void
+add_chunk_to_free_list(chunk_t * const chunk)
+{
+  unsigned fl, sl;
+
+  size_class(chunk->size, &fl, &sl);
+  chunk->prev = NULL;
+  chunk->next = free_lists[fl][sl];
+  if(chunk->next != NULL) {
+    chunk->next->prev = chunk;
+  }
+  free_lists[fl][sl] = chunk;
+  fl_bitmap |= (uint32_t)1 << fl;
+  sl_bitmap[fl] |= 1 << sl;
+}
+
+/* remove_chunk_from_free_list: Remove a chunk from the list of its
+   size class. */
+static void
+remove_chunk_from_free_list(chunk_t * const chunk)
+{
+  unsigned fl, sl;
+
+  size_class(chunk->size, &fl, &sl);
+  if(chunk == free_lists[fl][sl]) {
+    free_lists[fl][sl] = chunk->next;
+    if(chunk->next == NULL) {
+      sl_bitmap[fl] &= ~(1 << sl);
+      if(sl_bitmap[fl] == 0) {
+        fl_bitmap &= ~((uint32_t)1 << fl);
+      }
+    }
+  } else {
+    chunk->prev->next = chunk->next;
+  }
+
+  if(chunk->next != NULL) {
+    chunk->next->prev = chunk->prev;
+  }
+}
+#else /* HEAPMEM_SEGREGATED_FIT */
+/* add_chunk_to_free_list: Put a free chunk on the free list. */
+static void
+add_chunk_to_free_list(chunk_t * const chunk)
+{
+  chunk->prev = NULL;
+  chunk->next = free_list;
+  if(free_list != NULL) {
+    free_list->prev = chunk;
+  }
+  free_list = chunk;
+}
+
 /* remove_chunk_from_free_list: Mark a chunk as being allocated, and
    remove it from the free list. */
 static void
@@ -240,6 +366,31 @@ remove_chunk_from_free_list(chunk_t * const chunk)
     chunk->next->prev = chunk->prev;
   }
 }
+#endif /* HEAPMEM_SEGREGATED_FIT */
+
+static void coalesce_chunks(chunk_t *chunk);
+
+/* free_chunk: Mark a chunk as being free, and put it on the free list. */
+static void
+free_chunk(chunk_t * const chunk)
+{
+#if HEAPMEM_SEGREGATED_FIT
+  /* Merging with the following free chunks is cheap when the free
+     lists are segregated, so we do it right away while the chunk is
+     still marked as allocated and thus not expected to be on a list. */
+  coalesce_chunks(chunk);
+#endif /* HEAPMEM_SEGREGATED_FIT */
+
+  chunk->flags &= ~CHUNK_FLAG_ALLOCATED;
+
+  if(IS_LAST_CHUNK(chunk)) {
+    /* Release the chunk back into the wilderness. */
+    heap_usage -= sizeof(chunk_t) + chunk->size;
+  } else {
+    /* Put the chunk on the free list. */
+    add_chunk_to_free_list(chunk);
+  }
+}
 
 /*
  * split_chunk: When allocating a chunk, we may have found one that is
@@ -254,7 +405,8 @@ split_chunk(chunk_t * const chunk, size_t offset)
   if(offset + sizeof(chunk_t) < chunk->size) {
     chunk_t *new_chunk = (chunk_t *)(GET_PTR(chunk) + offset);
     new_chunk->size = chunk->size - sizeof(chunk_t) - offset;
-    new_chunk->flags = 0;
+    /* free_chunk() expects a chunk that is not on a free list. */
+    new_chunk->flags = CHUNK_FLAG_ALLOCATED;
     free_chunk(new_chunk);
 
     chunk->size = offset;
@@ -262,20 +414,114 @@ split_chunk(chunk_t * const chunk, size_t offset)
   }
 }
 
-/* coalesce_chunks: Coalesce a specific free chunk with as many
+/* coalesce_chunks: Coalesce a specific chunk with as many
    adjacent free chunks as possible. */
 static void
 coalesce_chunks(chunk_t *chunk)
 {
-  for(chunk_t *next = NEXT_CHUNK(chunk);
-      (char *)next < &heap_base[heap_usage] && CHUNK_FREE(next);
+  chunk_t *next = NEXT_CHUNK(chunk);
+
+  if((char *)next >= &heap_base[heap_usage] || CHUNK_ALLOCATED(next)) {
+    return;
+  }
+
+#if HEAPMEM_SEGREGATED_FIT
+  /* A free chunk may change its size class when growing, so it must
+     be moved to another free list. */
+  bool relink = CHUNK_FREE(chunk);
+  if(relink) {
+    remove_chunk_from_free_list(chunk);
+  }
+#endif /* HEAPMEM_SEGREGATED_FIT */
+
+  for(; (char *)next < &heap_base[heap_usage] && CHUNK_FREE(next);
       next = NEXT_CHUNK(next)) {
     chunk->size += sizeof(chunk_t) + next->size;
     LOG_DBG("Coalesce chunk of %zu bytes\n", next->size);
     remove_chunk_from_free_list(next);
   }
+
+#if HEAPMEM_SEGREGATED_FIT
+  if(relink) {
+    add_chunk_to_free_list(chunk);
+  }
+#endif /* HEAPMEM_SEGREGATED_FIT */
 }
 
+#if HEAPMEM_SEGREGATED_FIT
+/* defrag_chunks: Coalesce all adjacent free chunks in the heap. Free
+   chunks are merged with their successors when they are freed, so this
+   is only needed to merge free chunks with free successors that were
+   freed before them. */
+static void
+defrag_chunks(void)
+{
+  for(chunk_t *chunk = (chunk_t *)heap_base;
+      (char *)chunk < &heap_base[heap_usage];
+      chunk = NEXT_CHUNK(chunk)) {
+    if(CHUNK_FREE(chunk)) {
+      coalesce_chunks(chunk);
+    }
+  }
+}
+
+/* find_chunk_in_class: Search a size class for a chunk that can hold
+   an object of the requested size. */
+static chunk_t *
+find_chunk_in_class(unsigned fl, unsigned sl, const size_t size)
+{
+  /* Limit the time we spend on searching the free list. */
+  int i = CHUNK_SEARCH_MAX;
+  for(chunk_t *chunk = free_lists[fl][sl]; chunk != NULL; chunk = chunk->next) {
+    if(i-- == 0) {
+      break;
+    }
+    if(size <= chunk->size) {
+      return chunk;
+    }
+  }
+  return NULL;
+}
+
+/* get_free_chunk: Find a chunk in the smallest size class that can
+   satisfy an allocation request. */
+static chunk_t *
+get_free_chunk(const size_t size)
+{
+  unsigned fl, sl;
+  uint32_t map;
+  chunk_t *best;
+
+  /* The size class of the request may contain chunks that are large
+     enough, but we cannot check them all in constant time. */
+  size_class(size, &fl, &sl);
+  best = find_chunk_in_class(fl, sl, size);
+
+  if(best == NULL) {
+    /* Any chunk in a higher size class is large enough. */
+    map = sl_bitmap[fl] & (~0U << (sl + 1));
+    if(map == 0) {
+      map = fl + 1 < FL_COUNT ? fl_bitmap & (~(uint32_t)0 << (fl + 1)) : 0;
+      if(map == 0) {
+        return NULL;
+      }
+      fl = find_first_set(map);
+      map = sl_bitmap[fl];
+    }
+    sl = find_first_set(map);
+    best = find_chunk_in_class(fl, sl, size);
+  }
+
+  if(best != NULL) {
+    /* We found a chunk that can hold an object of the requested
+       allocation size. Split it if possible. */
+    remove_chunk_from_free_list(best);
+    split_chunk(best, size);
+  }
+
+  return best;
+}
+#else /* HEAPMEM_SEGREGATED_FIT */
 /* defrag_chunks: Scan the free list for chunks that can be coalesced,
    and stop within a bounded time. */
 static void
@@ -329,6 +575,7 @@ get_free_chunk(const size_t size)
 
   return best;
 }
+#endif /* HEAPMEM_SEGREGATED_FIT */
 
 /*
  * heapmem_zone_register: Register a new zone, which is essentially a
@@ -410,10 +657,18 @@ heapmem_zone_alloc(heapmem_zone_t zone, size_t size)
   chunk_t *chunk = get_free_chunk(size);
   if(chunk == NULL) {
     chunk = extend_space(sizeof(chunk_t) + size);
-    if(chunk == NULL) {
-      return NULL;
+    if(chunk != NULL) {
+      chunk->size = size;
+    } else {
+#if HEAPMEM_SEGREGATED_FIT
+      /* Merge all adjacent free chunks before giving up. */
+      defrag_chunks();
+      chunk = get_free_chunk(size);
+#endif /* HEAPMEM_SEGREGATED_FIT */
+      if(chunk == NULL) {
+        return NULL;
+      }
     }
-    chunk->size = size;
   }
 
   chunk->flags = CHUNK_FLAG_ALLOCATED;
@@ -629,9 +884,17 @@ heapmem_stats(heapmem_stats_t *stats)
     } else {
       coalesce_chunks(chunk);
       stats->available += chunk->size;
+      stats->free_chunks++;
+      if(chunk->size > stats->largest_free) {
+        stats->largest_free = chunk->size;
+      }
     }
   }
   stats->available += HEAPMEM_ARENA_SIZE - heap_usage;
+  if(HEAPMEM_ARENA_SIZE - heap_usage > sizeof(chunk_t) &&
+     HEAPMEM_ARENA_SIZE - heap_usage - sizeof(chunk_t) > stats->largest_free) {
+    stats->largest_free = HEAPMEM_ARENA_SIZE - heap_usage - sizeof(chunk_t);
+  }
   stats->footprint = heap_usage;
   stats->max_footprint = max_heap_usage;
   stats->chunks = stats->overhead / sizeof(chunk_t);
@@ -653,6 +916,10 @@ heapmem_print_debug_info(bool print_chunks)
   HEAPMEM_PRINTF("* Allocated chunks: %zu\n", stats.chunks);
   HEAPMEM_PRINTF("* Chunk size: %zu\n", sizeof(chunk_t));
   HEAPMEM_PRINTF("* Total chunk overhead: %zu\n", stats.overhead);
+  HEAPMEM_PRINTF("* Free chunks: %zu\n", stats.free_chunks);
+  HEAPMEM_PRINTF("* Largest free chunk: %zu\n", stats.largest_free);
+  HEAPMEM_PRINTF("* Fragmentation: %zu%%\n", stats.available == 0 ? 0 :
+                 100 - (100 * stats.largest_free) / stats.available);
 
   if(print_chunks) {
     HEAPMEM_PRINTF("* Allocated chunks:\n");
@@ -91,6 +91,11 @@ typedef struct heapmem_stats {
   size_t footprint;
   size_t max_footprint;
   size_t chunks;
+  /* The number of free chunks within the footprint. */
+  size_t free_chunks;
+  /* The largest allocation that can be satisfied. The available
+     memory that is not covered by it has been lost to fragmentation. */
+  size_t largest_free;
 } heapmem_stats_t;
 /*****************************************************************************/
 typedef uint8_t heapmem_zone_t;
@@ -53,11 +53,32 @@ memb_init(struct memb *m)
 {
   memset(m->used, 0, m->num);
   memset(m->mem, 0, m->size * m->num);
+#if MEMB_FREE_STACK
+  m->free_top = 0;
+  m->watermark = 0;
+#endif /* MEMB_FREE_STACK */
 }
 /*---------------------------------------------------------------------------*/
 void *
 memb_alloc(struct memb *m)
 {
+#if MEMB_FREE_STACK
+  unsigned short i;
+
+  /* Reuse the most recently freed block if there is one. Otherwise,
+     take the next block that has never been allocated, which lets a
+     statically zeroed memb work before memb_init() has been called. */
+  if(m->free_top > 0) {
+    i = m->free_stack[--m->free_top];
+  } else if(m->watermark < m->num) {
+    i = m->watermark++;
+  } else {
+    return NULL;
+  }
+
+  m->used[i] = true;
+  return (void *)((char *)m->mem + (i * m->size));
+#else /* MEMB_FREE_STACK */
   int i;
 
   for(i = 0; i < m->num; ++i) {
@@ -72,29 +93,37 @@ memb_alloc(struct memb *m)
   /* No free block was found, so we return NULL to indicate failure to
      allocate block. */
   return NULL;
+#endif /* MEMB_FREE_STACK */
 }
 /*---------------------------------------------------------------------------*/
 int
 memb_free(struct memb *m, void *ptr)
 {
-  int i;
-  char *ptr2;
+  size_t offset;
+  unsigned short i;
 
-  /* Walk through the list of blocks and try to find the block to
-     which the pointer "ptr" points to. */
-  ptr2 = (char *)m->mem;
-  for(i = 0; i < m->num; ++i) {
-    if(ptr2 == (char *)ptr) {
-      /* We've found the block to which "ptr" points, so we check the allocation
-         status to detect the double-free error and free the block. */
-      if (m->used[i] == false)
-        return -1;
-      m->used[i] = false;
-      return 0;
-    }
-    ptr2 += m->size;
+  if(!memb_inmemb(m, ptr)) {
+    return -1;
+  }
+
+  /* Compute the index of the block to which "ptr" points, and reject
+     pointers that do not point to the beginning of a block. */
+  offset = (char *)ptr - (char *)m->mem;
+  if(offset % m->size != 0) {
+    return -1;
+  }
+  i = offset / m->size;
+
+  /* Check the allocation status to detect the double-free error and
+     free the block. */
+  if(m->used[i] == false) {
+    return -1;
   }
-  return -1;
+  m->used[i] = false;
+#if MEMB_FREE_STACK
+  m->free_stack[m->free_top++] = i;
+#endif /* MEMB_FREE_STACK */
+  return 0;
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -107,6 +136,9 @@ memb_inmemb(struct memb *m, void *ptr)
 size_t
 memb_numfree(struct memb *m)
 {
+#if MEMB_FREE_STACK
+  return m->free_top + (m->num - m->watermark);
+#else /* MEMB_FREE_STACK */
   int i;
   size_t num_free = 0;
 
@@ -117,5 +149,6 @@ memb_numfree(struct memb *m)
   }
 
   return num_free;
+#endif /* MEMB_FREE_STACK */
 }
 /** @} */
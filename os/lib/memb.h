@@ -67,6 +67,22 @@
 #include <stdlib.h>
 #include "sys/cc.h"
 
+/**
+ * \brief Keep a stack of free block indices in each memory block.
+ *
+ * When enabled, every MEMB() declaration gets an additional array
+ * holding the indices of the free blocks, which makes memb_alloc()
+ * and memb_numfree() execute in constant time, at the cost of two
+ * bytes of RAM per block. Otherwise, memb_alloc() searches linearly
+ * for a free block. memb_free() always locates the block in constant
+ * time.
+ */
+#ifdef MEMB_CONF_FREE_STACK
+#define MEMB_FREE_STACK MEMB_CONF_FREE_STACK
+#else
+#define MEMB_FREE_STACK 0
+#endif
+
 /**
  * Declare a memory block.
  *
@@ -88,18 +104,36 @@ MEMB(connections, struct connection, 16);
  * \param num The total number of memory chunks in the block.
  *
  */
+#if MEMB_FREE_STACK
+#define MEMB(name, structure, num) \
+        static bool CC_CONCAT(name,_memb_used)[num]; \
+        static unsigned short CC_CONCAT(name,_memb_free)[num]; \
+        static structure CC_CONCAT(name,_memb_mem)[num]; \
+        static struct memb name = {sizeof(structure), num, \
+                                          CC_CONCAT(name,_memb_used), \
+                                          (void *)CC_CONCAT(name,_memb_mem), \
+                                          CC_CONCAT(name,_memb_free), 0, 0}
+#else /* MEMB_FREE_STACK */
 #define MEMB(name, structure, num) \
         static bool CC_CONCAT(name,_memb_used)[num]; \
         static structure CC_CONCAT(name,_memb_mem)[num]; \
         static struct memb name = {sizeof(structure), num, \
                                           CC_CONCAT(name,_memb_used), \
                                           (void *)CC_CONCAT(name,_memb_mem)}
+#endif /* MEMB_FREE_STACK */
 
 struct memb {
   unsigned short size;
   unsigned short num;
   bool *used;
   void *mem;
+#if MEMB_FREE_STACK
+  /* Indices of freed blocks, and the number of such indices. */
+  unsigned short *free_stack;
+  unsigned short free_top;
+  /* Blocks at this index and above have never been allocated. */
+  unsigned short watermark;
+#endif /* MEMB_FREE_STACK */
 };
 
 /**
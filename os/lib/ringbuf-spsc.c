@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Single-producer, single-consumer ring buffer implementation
+ */
+
+#include "lib/ringbuf-spsc.h"
+#include "sys/memory-barrier.h"
+
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+void
+ringbuf_spsc_init(struct ringbuf_spsc *r, void *a, uint16_t elem_size,
+                  uint16_t count)
+{
+  r->data = a;
+  r->elem_size = elem_size;
+  r->mask = count - 1;
+  r->put_idx = r->get_idx = r->stage_idx = 0;
+}
+/*---------------------------------------------------------------------------*/
+static void *
+element(struct ringbuf_spsc *r, uint16_t idx)
+{
+  return &r->data[(idx & r->mask) * r->elem_size];
+}
+/*---------------------------------------------------------------------------*/
+int
+ringbuf_spsc_peek_put(struct ringbuf_spsc *r, void **span)
+{
+  uint16_t stage_idx = r->stage_idx;
+  int space = r->mask + 1 -
+    (uint16_t)(stage_idx - CC_ACCESS_NOW(uint16_t, r->get_idx));
+  int contiguous = r->mask + 1 - (stage_idx & r->mask);
+
+  *span = element(r, stage_idx);
+  return MIN(space, contiguous);
+}
+/*---------------------------------------------------------------------------*/
+void
+ringbuf_spsc_publish(struct ringbuf_spsc *r)
+{
+  /* The elements must be in place before the consumer can see them */
+  memory_barrier();
+  CC_ACCESS_NOW(uint16_t, r->put_idx) = r->stage_idx;
+}
+/*---------------------------------------------------------------------------*/
+void
+ringbuf_spsc_commit_put(struct ringbuf_spsc *r, int count)
+{
+  r->stage_idx += count;
+  ringbuf_spsc_publish(r);
+}
+/*---------------------------------------------------------------------------*/
+int
+ringbuf_spsc_stage(struct ringbuf_spsc *r, const void *elem)
+{
+  void *span;
+
+  if(ringbuf_spsc_peek_put(r, &span) == 0) {
+    return 0;
+  }
+  memcpy(span, elem, r->elem_size);
+  r->stage_idx++;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+ringbuf_spsc_put(struct ringbuf_spsc *r, const void *elem)
+{
+  if(!ringbuf_spsc_stage(r, elem)) {
+    return 0;
+  }
+  ringbuf_spsc_publish(r);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+ringbuf_spsc_write(struct ringbuf_spsc *r, const void *elems, int count)
+{
+  const uint8_t *p = elems;
+  void *span;
+  int written = 0;
+  int n;
+
+  /* At most two spans, before and after the end of the array */
+  while(written < count && (n = ringbuf_spsc_peek_put(r, &span)) > 0) {
+    n = MIN(n, count - written);
+    memcpy(span, p, n * r->elem_size);
+    p += n * r->elem_size;
+    r->stage_idx += n;
+    written += n;
+  }
+  ringbuf_spsc_publish(r);
+  return written;
+}
+/*---------------------------------------------------------------------------*/
+int
+ringbuf_spsc_peek_get(struct ringbuf_spsc *r, const void **span)
+{
+  uint16_t get_idx = r->get_idx;
+  int used = (uint16_t)(CC_ACCESS_NOW(uint16_t, r->put_idx) - get_idx);
+  int contiguous = r->mask + 1 - (get_idx & r->mask);
+
+  /* Do not read the elements before the producer's index */
+  memory_barrier();
+  *span = element(r, get_idx);
+  return MIN(used, contiguous);
+}
+/*---------------------------------------------------------------------------*/
+void
+ringbuf_spsc_commit_get(struct ringbuf_spsc *r, int count)
+{
+  /* The elements must be read before the producer can overwrite them */
+  memory_barrier();
+  CC_ACCESS_NOW(uint16_t, r->get_idx) = r->get_idx + count;
+}
+/*---------------------------------------------------------------------------*/
+int
+ringbuf_spsc_get(struct ringbuf_spsc *r, void *elem)
+{
+  const void *span;
+
+  if(ringbuf_spsc_peek_get(r, &span) == 0) {
+    return 0;
+  }
+  memcpy(elem, span, r->elem_size);
+  ringbuf_spsc_commit_get(r, 1);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+ringbuf_spsc_read(struct ringbuf_spsc *r, void *elems, int count)
+{
+  uint8_t *p = elems;
+  const void *span;
+  int read = 0;
+  int n;
+
+  while(read < count && (n = ringbuf_spsc_peek_get(r, &span)) > 0) {
+    n = MIN(n, count - read);
+    memcpy(p, span, n * r->elem_size);
+    p += n * r->elem_size;
+    ringbuf_spsc_commit_get(r, n);
+    read += n;
+  }
+  return read;
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Header file for the single-producer, single-consumer ring buffer
+ */
+
+/** \addtogroup data
+ * @{ */
+
+/**
+ * \defgroup ringbuf-spsc Single-producer, single-consumer ring buffer
+ * @{
+ *
+ * A ring buffer of fixed-size elements, for passing data from one
+ * producer to one consumer without locking, e.g., from an interrupt
+ * handler to a process. Unlike the \ref ringbuf "ring buffer library",
+ * elements can be larger than a byte, the buffer can hold up to 32768
+ * elements and all of them can be used.
+ *
+ * The producer and the consumer each own one index. An index is only
+ * published after the element data it covers, with a memory barrier in
+ * between, see \ref memory-barrier. The indices are 16-bit quantities,
+ * which must be written atomically by the platform.
+ *
+ * Both sides can access the buffer in place, one contiguous span at a
+ * time, with the peek and commit functions. The producer can also
+ * stage elements, which only become visible to the consumer once
+ * published. A SLIP driver uses this to only hand over complete
+ * frames.
+ */
+
+#ifndef RINGBUF_SPSC_H_
+#define RINGBUF_SPSC_H_
+
+#include "contiki.h"
+
+/**
+ * \brief      Structure that holds the state of a ring buffer.
+ *
+ *             The actual buffer needs to be defined separately, with
+ *             room for the given number of elements.
+ */
+struct ringbuf_spsc {
+  uint8_t *data;
+  uint16_t elem_size;
+  uint16_t mask;
+  /* Free-running indices, written by the producer and the consumer */
+  uint16_t put_idx, get_idx;
+  /* The end of the elements staged by the producer */
+  uint16_t stage_idx;
+};
+
+/**
+ * \brief      Initialize a ring buffer
+ * \param r    A pointer to the state of the ring buffer
+ * \param a    A pointer to an array of count elements of elem_size bytes
+ * \param elem_size The size of an element in bytes
+ * \param count The number of elements, a power of two of at most 32768
+ */
+void ringbuf_spsc_init(struct ringbuf_spsc *r, void *a, uint16_t elem_size,
+                       uint16_t count);
+
+/**
+ * \brief      Insert an element into the ring buffer
+ * \param r    A pointer to the state of the ring buffer
+ * \param elem The element to copy into the buffer
+ * \return     Non-zero if the element was written, zero if the buffer was full
+ *
+ *             Elements staged before are published along with it.
+ */
+int ringbuf_spsc_put(struct ringbuf_spsc *r, const void *elem);
+
+/**
+ * \brief      Get an element from the ring buffer
+ * \param r    A pointer to the state of the ring buffer
+ * \param elem Where to copy the element to
+ * \return     Non-zero if an element was read, zero if the buffer was empty
+ */
+int ringbuf_spsc_get(struct ringbuf_spsc *r, void *elem);
+
+/**
+ * \brief      Insert elements into the ring buffer
+ * \param r    A pointer to the state of the ring buffer
+ * \param elems The elements to copy into the buffer
+ * \param count The number of elements
+ * \return     The number of elements written
+ */
+int ringbuf_spsc_write(struct ringbuf_spsc *r, const void *elems, int count);
+
+/**
+ * \brief      Get elements from the ring buffer
+ * \param r    A pointer to the state of the ring buffer
+ * \param elems Where to copy the elements to
+ * \param count The maximal number of elements to read
+ * \return     The number of elements read
+ */
+int ringbuf_spsc_read(struct ringbuf_spsc *r, void *elems, int count);
+
+/**
+ * \brief      Get the free space that can be written in place
+ * \param r    A pointer to the state of the ring buffer
+ * \param span Set to the first free element, after any staged ones
+ * \return     The number of contiguous free elements at span
+ */
+int ringbuf_spsc_peek_put(struct ringbuf_spsc *r, void **span);
+
+/**
+ * \brief      Publish elements written through ringbuf_spsc_peek_put()
+ * \param r    A pointer to the state of the ring buffer
+ * \param count The number of elements written
+ *
+ *             Elements staged before are published along with them.
+ */
+void ringbuf_spsc_commit_put(struct ringbuf_spsc *r, int count);
+
+/**
+ * \brief      Get the elements that can be read in place
+ * \param r    A pointer to the state of the ring buffer
+ * \param span Set to the first element
+ * \return     The number of contiguous elements at span
+ */
+int ringbuf_spsc_peek_get(struct ringbuf_spsc *r, const void **span);
+
+/**
+ * \brief      Remove elements read through ringbuf_spsc_peek_get()
+ * \param r    A pointer to the state of the ring buffer
+ * \param count The number of elements read
+ */
+void ringbuf_spsc_commit_get(struct ringbuf_spsc *r, int count);
+
+/**
+ * \brief      Add an element without making it visible to the consumer
+ * \param r    A pointer to the state of the ring buffer
+ * \param elem The element to copy into the buffer
+ * \return     Non-zero if the element was staged, zero if the buffer was full
+ */
+int ringbuf_spsc_stage(struct ringbuf_spsc *r, const void *elem);
+
+/**
+ * \brief      Make the staged elements visible to the consumer
+ * \param r    A pointer to the state of the ring buffer
+ */
+void ringbuf_spsc_publish(struct ringbuf_spsc *r);
+
+/**
+ * \brief      Drop the staged elements
+ * \param r    A pointer to the state of the ring buffer
+ */
+static inline void
+ringbuf_spsc_discard(struct ringbuf_spsc *r)
+{
+  r->stage_idx = r->put_idx;
+}
+
+/**
+ * \brief      Get the number of elements staged by the producer
+ * \param r    A pointer to the state of the ring buffer
+ */
+static inline int
+ringbuf_spsc_staged(const struct ringbuf_spsc *r)
+{
+  return (uint16_t)(r->stage_idx - r->put_idx);
+}
+
+/**
+ * \brief      Get the number of elements the ring buffer can hold
+ * \param r    A pointer to the state of the ring buffer
+ */
+static inline int
+ringbuf_spsc_size(const struct ringbuf_spsc *r)
+{
+  return r->mask + 1;
+}
+
+/**
+ * \brief      Get the number of elements available to the consumer
+ * \param r    A pointer to the state of the ring buffer
+ */
+static inline int
+ringbuf_spsc_elements(const struct ringbuf_spsc *r)
+{
+  return (uint16_t)(CC_ACCESS_NOW(uint16_t, r->put_idx) -
+                    CC_ACCESS_NOW(uint16_t, r->get_idx));
+}
+
+/**
+ * \brief      Is the ring buffer empty, as seen by the consumer?
+ * \param r    A pointer to the state of the ring buffer
+ */
+static inline int
+ringbuf_spsc_empty(const struct ringbuf_spsc *r)
+{
+  return ringbuf_spsc_elements(r) == 0;
+}
+
+#endif /* RINGBUF_SPSC_H_ */
+
+/** @}*/
+/** @}*/
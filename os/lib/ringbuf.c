@@ -38,7 +38,9 @@
  */
 
 #include "lib/ringbuf.h"
+#include "sys/memory-barrier.h"
 #include <sys/cc.h>
+#include <string.h>
 /*---------------------------------------------------------------------------*/
 int
 ringbuf_put(struct ringbuf *r, uint8_t c)
@@ -101,6 +103,80 @@ ringbuf_get(struct ringbuf *r)
 }
 /*---------------------------------------------------------------------------*/
 int
+ringbuf_peek_put(struct ringbuf *r, uint8_t **span)
+{
+  uint8_t put_ptr = r->put_ptr;
+  /* One byte is kept free to tell a full buffer from an empty one */
+  int space = r->mask - ((put_ptr - CC_ACCESS_NOW(uint8_t, r->get_ptr)) & r->mask);
+  int contiguous = r->mask + 1 - put_ptr;
+
+  *span = &r->data[put_ptr];
+  return MIN(space, contiguous);
+}
+/*---------------------------------------------------------------------------*/
+void
+ringbuf_commit_put(struct ringbuf *r, int len)
+{
+  /* The data must be in place before the reader can see it */
+  memory_barrier();
+  CC_ACCESS_NOW(uint8_t, r->put_ptr) = (r->put_ptr + len) & r->mask;
+}
+/*---------------------------------------------------------------------------*/
+int
+ringbuf_peek_get(struct ringbuf *r, const uint8_t **span)
+{
+  uint8_t get_ptr = r->get_ptr;
+  int used = (CC_ACCESS_NOW(uint8_t, r->put_ptr) - get_ptr) & r->mask;
+  int contiguous = r->mask + 1 - get_ptr;
+
+  /* Do not read the data before the writer's index */
+  memory_barrier();
+  *span = &r->data[get_ptr];
+  return MIN(used, contiguous);
+}
+/*---------------------------------------------------------------------------*/
+void
+ringbuf_commit_get(struct ringbuf *r, int len)
+{
+  /* The data must be read before the writer can overwrite it */
+  memory_barrier();
+  CC_ACCESS_NOW(uint8_t, r->get_ptr) = (r->get_ptr + len) & r->mask;
+}
+/*---------------------------------------------------------------------------*/
+int
+ringbuf_write(struct ringbuf *r, const uint8_t *data, int len)
+{
+  uint8_t *span;
+  int written = 0;
+  int n;
+
+  /* At most two spans, before and after the end of the array */
+  while(written < len && (n = ringbuf_peek_put(r, &span)) > 0) {
+    n = MIN(n, len - written);
+    memcpy(span, data + written, n);
+    ringbuf_commit_put(r, n);
+    written += n;
+  }
+  return written;
+}
+/*---------------------------------------------------------------------------*/
+int
+ringbuf_read(struct ringbuf *r, uint8_t *data, int len)
+{
+  const uint8_t *span;
+  int read = 0;
+  int n;
+
+  while(read < len && (n = ringbuf_peek_get(r, &span)) > 0) {
+    n = MIN(n, len - read);
+    memcpy(data + read, span, n);
+    ringbuf_commit_get(r, n);
+    read += n;
+  }
+  return read;
+}
+/*---------------------------------------------------------------------------*/
+int
 ringbuf_size(struct ringbuf *r)
 {
   return r->mask + 1;
@@ -120,6 +120,75 @@ int     ringbuf_put(struct ringbuf *r, uint8_t c);
  */
 int     ringbuf_get(struct ringbuf *r);
 
+/**
+ * \brief      Insert bytes into the ring buffer
+ * \param r    A pointer to a struct ringbuf to hold the state of the ring buffer
+ * \param data The bytes to be written to the buffer
+ * \param len  The number of bytes to write
+ * \return     The number of bytes written, which is less than len if the buffer got full.
+ *
+ *             This function copies as many bytes as fit into the
+ *             ring buffer. It is safe to call this function from an
+ *             interrupt handler, as long as there is a single writer.
+ *
+ */
+int     ringbuf_write(struct ringbuf *r, const uint8_t *data, int len);
+
+/**
+ * \brief      Get bytes from the ring buffer
+ * \param r    A pointer to a struct ringbuf to hold the state of the ring buffer
+ * \param data A buffer for the bytes read
+ * \param len  The maximal number of bytes to read
+ * \return     The number of bytes read, zero if the buffer was empty.
+ *
+ *             This function removes up to len bytes from the ring
+ *             buffer. It is safe to call this function from an
+ *             interrupt handler, as long as there is a single reader.
+ *
+ */
+int     ringbuf_read(struct ringbuf *r, uint8_t *data, int len);
+
+/**
+ * \brief      Get the free space of the ring buffer that can be written directly
+ * \param r    A pointer to a struct ringbuf to hold the state of the ring buffer
+ * \param span Set to the start of the free space
+ * \return     The number of bytes that can be written at span
+ *
+ *             The free space is contiguous, so it may be less than
+ *             the total free space when the buffer wraps around. The
+ *             bytes written become visible to the reader with
+ *             ringbuf_commit_put().
+ *
+ */
+int     ringbuf_peek_put(struct ringbuf *r, uint8_t **span);
+
+/**
+ * \brief      Add bytes written through ringbuf_peek_put() to the ring buffer
+ * \param r    A pointer to a struct ringbuf to hold the state of the ring buffer
+ * \param len  The number of bytes written, at most what ringbuf_peek_put() returned
+ */
+void    ringbuf_commit_put(struct ringbuf *r, int len);
+
+/**
+ * \brief      Get the data of the ring buffer that can be read directly
+ * \param r    A pointer to a struct ringbuf to hold the state of the ring buffer
+ * \param span Set to the start of the data
+ * \return     The number of bytes that can be read at span
+ *
+ *             The data is contiguous, so it may be less than all the
+ *             data in the buffer when the buffer wraps around. The
+ *             bytes stay in the buffer until ringbuf_commit_get().
+ *
+ */
+int     ringbuf_peek_get(struct ringbuf *r, const uint8_t **span);
+
+/**
+ * \brief      Remove bytes read through ringbuf_peek_get() from the ring buffer
+ * \param r    A pointer to a struct ringbuf to hold the state of the ring buffer
+ * \param len  The number of bytes read, at most what ringbuf_peek_get() returned
+ */
+void    ringbuf_commit_get(struct ringbuf *r, int len);
+
 /**
  * \brief      Get the size of a ring buffer
  * \param r    A pointer to a struct ringbuf to hold the state of the ring buffer
@@ -239,19 +239,77 @@ static uint16_t my_tag;
 /* Assuming that the worst growth for uncompression is 38 bytes */
 #define SICSLOWPAN_FIRST_FRAGMENT_SIZE (SICSLOWPAN_FRAGMENT_SIZE + 38)
 
+/* The number of hash buckets the reassembly contexts are spread over.
+ * The bucket is selected by the link-layer sender, so that all
+ * contexts of a sender are found on one short chain. */
+#ifdef SICSLOWPAN_CONF_REASS_BUCKETS
+#define SICSLOWPAN_REASS_BUCKETS SICSLOWPAN_CONF_REASS_BUCKETS
+#else
+#define SICSLOWPAN_REASS_BUCKETS SICSLOWPAN_REASS_CONTEXTS
+#endif
+
+/* Per-sender quotas on the reassembly resources. A node that receives
+ * fragments from many neighbors, such as a border router, can set
+ * these so that a single sender cannot hold all contexts or fragment
+ * buffers. By default, a sender may use all of them. */
+#ifdef SICSLOWPAN_CONF_REASS_SENDER_CONTEXTS
+#define SICSLOWPAN_REASS_SENDER_CONTEXTS SICSLOWPAN_CONF_REASS_SENDER_CONTEXTS
+#else
+#define SICSLOWPAN_REASS_SENDER_CONTEXTS SICSLOWPAN_REASS_CONTEXTS
+#endif
+
+#ifdef SICSLOWPAN_CONF_REASS_SENDER_BUFFERS
+#define SICSLOWPAN_REASS_SENDER_BUFFERS SICSLOWPAN_CONF_REASS_SENDER_BUFFERS
+#else
+#define SICSLOWPAN_REASS_SENDER_BUFFERS SICSLOWPAN_FRAGMENT_BUFFERS
+#endif
+
+/* Fragment forwarding with virtual reassembly buffers (RFC 8930): a
+ * router sends the fragments of a datagram on to the next hop as they
+ * arrive, instead of reassembling the datagram first. */
+#ifdef SICSLOWPAN_CONF_FRAG_FORWARDING
+#define SICSLOWPAN_FRAG_FORWARDING (SICSLOWPAN_CONF_FRAG_FORWARDING && UIP_CONF_ROUTER)
+#else
+#define SICSLOWPAN_FRAG_FORWARDING 0
+#endif
+
+/* The number of datagrams that can be forwarded at the same time */
+#ifdef SICSLOWPAN_CONF_VRB_ENTRIES
+#define SICSLOWPAN_VRB_ENTRIES SICSLOWPAN_CONF_VRB_ENTRIES
+#else
+#define SICSLOWPAN_VRB_ENTRIES 4
+#endif
+
+/* Contexts and fragment buffers are linked by 8-bit indices. */
+#define REASS_NONE 0xff
+
+#if SICSLOWPAN_REASS_CONTEXTS >= REASS_NONE || SICSLOWPAN_FRAGMENT_BUFFERS >= REASS_NONE
+#error Too many SICSLOWPAN_REASS_CONTEXTS or SICSLOWPAN_FRAGMENT_BUFFERS set.
+#endif
+
 /* all information needed for reassembly */
 struct sicslowpan_frag_info {
   /** When reassembling, the source address of the fragments being merged */
   linkaddr_t sender;
   /** When reassembling, the tag in the fragments being merged. */
   uint16_t tag;
-  /** Total length of the fragmented packet */
+  /** Total length of the fragmented packet (if zero this context is free) */
   uint16_t len;
   /** Current length of reassembled fragments */
   uint16_t reassembled_len;
   /** Reassembly %process %timer. */
   struct timer reass_timer;
 
+  /** Next context in the hash bucket, or in the free list */
+  uint8_t next;
+  /** Neighbors in the list of contexts ordered by their timeout */
+  uint8_t age_prev;
+  uint8_t age_next;
+  /** First of the fragment buffers held by this context */
+  uint8_t first_buf;
+  /** Number of fragment buffers held by this context */
+  uint8_t buffers;
+
   /** Fragment size of first fragment */
   uint16_t first_frag_len;
   /** First fragment - needs a larger buffer since the size is uncompressed size
@@ -262,146 +320,283 @@ struct sicslowpan_frag_info {
 static struct sicslowpan_frag_info frag_info[SICSLOWPAN_REASS_CONTEXTS];
 
 struct sicslowpan_frag_buf {
-  /* the index of the frag_info */
-  uint8_t index;
+  /* Next buffer of the same context, or in the free list */
+  uint8_t next;
   /* Fragment offset */
   uint8_t offset;
-  /* Length of this fragment (if zero this buffer is not allocated) */
+  /* Length of this fragment */
   uint8_t len;
   uint8_t data[SICSLOWPAN_FRAGMENT_SIZE];
 };
 
 static struct sicslowpan_frag_buf frag_buf[SICSLOWPAN_FRAGMENT_BUFFERS];
 
+/* Contexts in use, hashed by sender */
+static uint8_t reass_buckets[SICSLOWPAN_REASS_BUCKETS];
+/* Contexts in use, oldest first. All contexts get the same maximum
+ * age, so this is also the order in which they time out. */
+static uint8_t reass_oldest;
+static uint8_t reass_newest;
+/* Free lists of contexts and fragment buffers */
+static uint8_t free_contexts;
+static uint8_t free_bufs;
+/* The lists are set up on the first fragment, as the driver may be
+   used without being initialized, e.g. next to another network driver */
+static bool reass_initialized;
+
+#if SICSLOWPAN_REASS_STATS
+struct sicslowpan_reass_stats sicslowpan_reass_stat;
+#endif /* SICSLOWPAN_REASS_STATS */
+
 /*---------------------------------------------------------------------------*/
-static int
-clear_fragments(uint8_t frag_info_index)
+static void
+reass_init(void)
 {
-  int i, clear_count;
-  clear_count = 0;
-  frag_info[frag_info_index].len = 0;
+  int i;
+
+  for(i = 0; i < SICSLOWPAN_REASS_BUCKETS; i++) {
+    reass_buckets[i] = REASS_NONE;
+  }
+  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+    frag_info[i].len = 0;
+    frag_info[i].next = i + 1 < SICSLOWPAN_REASS_CONTEXTS ? i + 1 : REASS_NONE;
+  }
   for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    if(frag_buf[i].len > 0 && frag_buf[i].index == frag_info_index) {
-      /* deallocate the buffer */
-      frag_buf[i].len = 0;
-      clear_count++;
-    }
+    frag_buf[i].next = i + 1 < SICSLOWPAN_FRAGMENT_BUFFERS ? i + 1 : REASS_NONE;
   }
-  return clear_count;
+  free_contexts = 0;
+  free_bufs = 0;
+  reass_oldest = REASS_NONE;
+  reass_newest = REASS_NONE;
+  reass_initialized = true;
 }
 /*---------------------------------------------------------------------------*/
-static int
-timeout_fragments(int not_context)
+static uint8_t *
+sender_bucket(const linkaddr_t *sender)
 {
+  unsigned hash;
   int i;
-  int count = 0;
-  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
-    if(frag_info[i].len > 0 && i != not_context &&
-       timer_expired(&frag_info[i].reass_timer)) {
-      /* This context can be freed */
-      count += clear_fragments(i);
+
+  hash = 0;
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    hash = hash * 31 + sender->u8[i];
+  }
+  return &reass_buckets[hash % SICSLOWPAN_REASS_BUCKETS];
+}
+/*---------------------------------------------------------------------------*/
+static void
+clear_fragments(uint8_t frag_info_index)
+{
+  struct sicslowpan_frag_info *info = &frag_info[frag_info_index];
+  uint8_t *p;
+  uint8_t b;
+
+  if(info->len == 0) {
+    return;
+  }
+  info->len = 0;
+
+  /* Return the fragment buffers to the pool */
+  while(info->first_buf != REASS_NONE) {
+    b = info->first_buf;
+    info->first_buf = frag_buf[b].next;
+    frag_buf[b].next = free_bufs;
+    free_bufs = b;
+  }
+
+  /* Unlink the context from its bucket and from the age list */
+  for(p = sender_bucket(&info->sender); *p != frag_info_index;
+      p = &frag_info[*p].next);
+  *p = info->next;
+
+  if(info->age_prev == REASS_NONE) {
+    reass_oldest = info->age_next;
+  } else {
+    frag_info[info->age_prev].age_next = info->age_next;
+  }
+  if(info->age_next == REASS_NONE) {
+    reass_newest = info->age_prev;
+  } else {
+    frag_info[info->age_next].age_prev = info->age_prev;
+  }
+
+  info->next = free_contexts;
+  free_contexts = frag_info_index;
+}
+/*---------------------------------------------------------------------------*/
+static void
+timeout_fragments(void)
+{
+  while(reass_oldest != REASS_NONE &&
+        timer_expired(&frag_info[reass_oldest].reass_timer)) {
+    LOG_WARN("reassembly: timed out - tag: %d\n", frag_info[reass_oldest].tag);
+    SICSLOWPAN_REASS_STAT(sicslowpan_reass_stat.timed_out++);
+    clear_fragments(reass_oldest);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Find the context of the datagram identified by the sender, tag and
+   size of the current fragment. Also count the contexts and buffers
+   the sender holds. */
+static uint8_t
+find_context(uint16_t tag, uint16_t frag_size,
+             int *sender_contexts, int *sender_buffers)
+{
+  const linkaddr_t *sender = packetbuf_addr(PACKETBUF_ADDR_SENDER);
+  uint8_t found = REASS_NONE;
+  uint8_t i;
+
+  *sender_contexts = 0;
+  *sender_buffers = 0;
+  for(i = *sender_bucket(sender); i != REASS_NONE; i = frag_info[i].next) {
+    if(linkaddr_cmp(&frag_info[i].sender, sender)) {
+      (*sender_contexts)++;
+      *sender_buffers += frag_info[i].buffers;
+      if(frag_info[i].tag == tag && frag_info[i].len == frag_size) {
+        found = i;
+      }
     }
   }
-  return count;
+  return found;
 }
 /*---------------------------------------------------------------------------*/
 static int
 store_fragment(uint8_t index, uint8_t offset)
 {
-  int i;
+  uint8_t b;
   int len;
 
   len = packetbuf_datalen() - packetbuf_hdr_len;
 
   if(len <= 0 || len > SICSLOWPAN_FRAGMENT_SIZE) {
     /* Unacceptable fragment size. */
+    SICSLOWPAN_REASS_STAT(sicslowpan_reass_stat.invalid++);
     return -1;
   }
 
-  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    if(frag_buf[i].len == 0) {
-      /* copy over the data from packetbuf into the fragment buffer,
-         and store offset and len */
-      frag_buf[i].offset = offset; /* frag offset */
-      frag_buf[i].len = len;
-      frag_buf[i].index = index;
-      memcpy(frag_buf[i].data, packetbuf_ptr + packetbuf_hdr_len, len);
-      /* return the length of the stored fragment */
-      return len;
-    }
+  b = free_bufs;
+  if(b == REASS_NONE) {
+    SICSLOWPAN_REASS_STAT(sicslowpan_reass_stat.no_buffer++);
+    return -1;
   }
-  /* failed */
-  return -1;
+  free_bufs = frag_buf[b].next;
+
+  /* copy over the data from packetbuf into the fragment buffer,
+     and store offset and len */
+  frag_buf[b].offset = offset; /* frag offset */
+  frag_buf[b].len = len;
+  memcpy(frag_buf[b].data, packetbuf_ptr + packetbuf_hdr_len, len);
+  frag_buf[b].next = frag_info[index].first_buf;
+  frag_info[index].first_buf = b;
+  frag_info[index].buffers++;
+  /* return the length of the stored fragment */
+  return len;
 }
 /*---------------------------------------------------------------------------*/
 /* add a new fragment to the buffer */
-static int8_t
+static int
 add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
 {
-  int i;
+  struct sicslowpan_frag_info *info;
+  int sender_contexts;
+  int sender_buffers;
+  uint8_t *bucket;
+  uint8_t i;
   int len;
-  int8_t found = -1;
+
+  if(!reass_initialized) {
+    reass_init();
+  }
+
+  if(frag_size == 0) {
+    /* A zero length marks a free context */
+    LOG_WARN("reassembly: invalid datagram size - tag: %d\n", tag);
+    SICSLOWPAN_REASS_STAT(sicslowpan_reass_stat.invalid++);
+    return -1;
+  }
+
+  /* Free the contexts that have run out of time, and with them their
+     fragment buffers */
+  timeout_fragments();
+
+  i = find_context(tag, frag_size, &sender_contexts, &sender_buffers);
 
   if(offset == 0) {
     /* This is a first fragment - check if we can add this */
-    for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
-      /* clear all fragment info with expired timer to free all fragment buffers */
-      if(frag_info[i].len > 0 && timer_expired(&frag_info[i].reass_timer)) {
-        clear_fragments(i);
-      }
+    if(i != REASS_NONE) {
+      /* The sender restarted the datagram */
+      clear_fragments(i);
+      sender_contexts--;
+    }
 
-      /* We use len as indication on used or not used */
-      if(found < 0 && frag_info[i].len == 0) {
-        /* We remember the first free fragment info but must continue
-           the loop to free any other expired fragment buffers. */
-        found = i;
-      }
+    if(sender_contexts >= SICSLOWPAN_REASS_SENDER_CONTEXTS) {
+      LOG_WARN("reassembly: sender over its context quota - tag: %d\n", tag);
+      SICSLOWPAN_REASS_STAT(sicslowpan_reass_stat.over_quota++);
+      return -1;
     }
 
-    if(found < 0) {
+    i = free_contexts;
+    if(i == REASS_NONE) {
       LOG_WARN("reassembly: failed to store new fragment session - tag: %d\n", tag);
+      SICSLOWPAN_REASS_STAT(sicslowpan_reass_stat.no_context++);
       return -1;
     }
+    info = &frag_info[i];
+    free_contexts = info->next;
 
     /* Found a free fragment info to store data in */
-    frag_info[found].len = frag_size;
-    frag_info[found].tag = tag;
-    linkaddr_copy(&frag_info[found].sender,
-                  packetbuf_addr(PACKETBUF_ADDR_SENDER));
-    timer_set(&frag_info[found].reass_timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
+    info->len = frag_size;
+    info->tag = tag;
+    info->reassembled_len = 0;
+    info->first_frag_len = 0;
+    info->first_buf = REASS_NONE;
+    info->buffers = 0;
+    linkaddr_copy(&info->sender, packetbuf_addr(PACKETBUF_ADDR_SENDER));
+    timer_set(&info->reass_timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
+
+    bucket = sender_bucket(&info->sender);
+    info->next = *bucket;
+    *bucket = i;
+
+    info->age_next = REASS_NONE;
+    info->age_prev = reass_newest;
+    if(reass_newest == REASS_NONE) {
+      reass_oldest = i;
+    } else {
+      frag_info[reass_newest].age_next = i;
+    }
+    reass_newest = i;
+
+    SICSLOWPAN_REASS_STAT(sicslowpan_reass_stat.started++);
     /* first fragment can not be stored immediately but is moved into
        the buffer while uncompressing */
-    return found;
+    return i;
   }
 
   /* This is a N-fragment - should find the info */
-  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
-    if(frag_info[i].tag == tag && frag_info[i].len > 0 &&
-       linkaddr_cmp(&frag_info[i].sender, packetbuf_addr(PACKETBUF_ADDR_SENDER))) {
-      /* Tag and Sender match - this must be the correct info to store in */
-      found = i;
-      break;
-    }
-  }
-
-  if(found < 0) {
+  if(i == REASS_NONE) {
     /* no entry found for storing the new fragment */
     LOG_WARN("reassembly: failed to store N-fragment - could not find session - tag: %d offset: %d\n", tag, offset);
+    SICSLOWPAN_REASS_STAT(sicslowpan_reass_stat.no_context++);
     return -1;
   }
 
-  /* i is the index of the reassembly context */
-  len = store_fragment(i, offset);
-  if(len < 0 && timeout_fragments(i) > 0) {
+  if(sender_buffers >= SICSLOWPAN_REASS_SENDER_BUFFERS) {
+    LOG_WARN("reassembly: sender over its buffer quota - tag: %d\n", tag);
+    SICSLOWPAN_REASS_STAT(sicslowpan_reass_stat.over_quota++);
+    len = -1;
+  } else {
     len = store_fragment(i, offset);
   }
+
   if(len > 0) {
     frag_info[i].reassembled_len += len;
     return i;
   } else {
-    /* should we also clear all fragments since we failed to store
-       this fragment? */
+    /* The datagram cannot be completed any more, so release what it
+       holds for the other reassemblies */
     LOG_WARN("reassembly: failed to store fragment - packet reassembly will fail tag:%d l\n", frag_info[i].tag);
+    clear_fragments(i);
     return -1;
   }
 }
@@ -411,12 +606,13 @@ add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
 static bool
 copy_frags2uip(int context)
 {
-  int i;
+  uint8_t b;
 
   /* Check length fields before proceeding. */
   if(frag_info[context].len < frag_info[context].first_frag_len ||
      frag_info[context].len > sizeof(uip_buf)) {
     LOG_WARN("input: invalid total size of fragments\n");
+    SICSLOWPAN_REASS_STAT(sicslowpan_reass_stat.invalid++);
     clear_fragments(context);
     return false;
   }
@@ -429,21 +625,21 @@ copy_frags2uip(int context)
   memset((uint8_t *)UIP_IP_BUF + frag_info[context].first_frag_len, 0,
          frag_info[context].len - frag_info[context].first_frag_len);
 
-  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    /* And also copy all matching fragments */
-    if(frag_buf[i].len > 0 && frag_buf[i].index == context) {
-      if(((size_t)frag_buf[i].offset << 3) + frag_buf[i].len > sizeof(uip_buf)) {
-        LOG_WARN("input: invalid fragment offset\n");
-        clear_fragments(context);
-        return false;
-      }
-      memcpy((uint8_t *)UIP_IP_BUF + (uint16_t)(frag_buf[i].offset << 3),
-             (uint8_t *)frag_buf[i].data, frag_buf[i].len);
+  for(b = frag_info[context].first_buf; b != REASS_NONE; b = frag_buf[b].next) {
+    /* And also copy all fragments of this context */
+    if(((size_t)frag_buf[b].offset << 3) + frag_buf[b].len > sizeof(uip_buf)) {
+      LOG_WARN("input: invalid fragment offset\n");
+      SICSLOWPAN_REASS_STAT(sicslowpan_reass_stat.invalid++);
+      clear_fragments(context);
+      return false;
     }
+    memcpy((uint8_t *)UIP_IP_BUF + (uint16_t)(frag_buf[b].offset << 3),
+           (uint8_t *)frag_buf[b].data, frag_buf[b].len);
   }
   /* deallocate all the fragments for this context */
   clear_fragments(context);
 
+  SICSLOWPAN_REASS_STAT(sicslowpan_reass_stat.reassembled++);
   return true;
 }
 #endif /* SICSLOWPAN_CONF_FRAG */
@@ -1562,6 +1758,12 @@ packet_sent(void *ptr, int status, int transmissions)
 static void
 send_packet(void)
 {
+#if ENERGEST_WITH_CONTEXTS
+  /* The MAC layer charges the transmission to the sender's context */
+  packetbuf_set_attr(PACKETBUF_ATTR_ENERGEST_CONTEXT,
+                     ENERGEST_CONTEXT_CURRENT());
+#endif /* ENERGEST_WITH_CONTEXTS */
+
   /* Provide a callback function to receive the result of
      a packet transmission. */
   NETSTACK_MAC.send(&packet_sent, NULL);
@@ -1613,6 +1815,57 @@ fragment_copy_payload_and_send(uint16_t uip_offset)
 }
 #endif /* SICSLOWPAN_CONF_FRAG */
 /*--------------------------------------------------------------------*/
+/** \brief Set the packetbuf attributes of an outgoing packet from the
+ *  uipbuf attributes.
+ *  \param localdest The MAC address of the destination
+ */
+static void
+set_output_attrs(const linkaddr_t *localdest)
+{
+  /* copy over the retransmission count from uipbuf attributes */
+  packetbuf_set_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS,
+                     uipbuf_get_attr(UIPBUF_ATTR_MAX_MAC_TRANSMISSIONS));
+
+  /* Copy destination address to packetbuf */
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER,
+      localdest ? localdest : &linkaddr_null);
+
+#if LLSEC802154_USES_AUX_HEADER
+  /* copy LLSEC level */
+  packetbuf_set_attr(PACKETBUF_ATTR_SECURITY_LEVEL,
+    uipbuf_get_attr(UIPBUF_ATTR_LLSEC_LEVEL));
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  packetbuf_set_attr(PACKETBUF_ATTR_KEY_INDEX,
+    uipbuf_get_attr(UIPBUF_ATTR_LLSEC_KEY_ID));
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /*  LLSEC802154_USES_AUX_HEADER */
+}
+/*--------------------------------------------------------------------*/
+/** \brief Compress the headers of the packet in uip_buf into packetbuf.
+ *  \return 1 if success, 0 otherwise
+ */
+static int
+compress_hdr(void)
+{
+#if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPV6
+  compress_hdr_ipv6();
+#endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPV6 */
+#if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_6LORH
+  /* Add 6LoRH headers before IPHC. Only needed on routed traffic
+  (non link-local). */
+  if(!uip_is_addr_linklocal(&UIP_IP_BUF->destipaddr)) {
+    add_paging_dispatch(1);
+    add_6lorh_hdr();
+  }
+#endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_6LORH */
+#if SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC
+  if(compress_hdr_iphc() == 0) {
+    return 0;
+  }
+#endif /* SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC */
+  return 1;
+}
+/*--------------------------------------------------------------------*/
 /** \brief Take an IP packet and format it to be sent on an 802.15.4
  *  network using 6lowpan.
  *  \param localdest The MAC address of the destination
@@ -1643,23 +1896,7 @@ output(const linkaddr_t *localdest)
 
   LOG_INFO("output: sending IPv6 packet with len %d\n", uip_len);
 
-  /* copy over the retransmission count from uipbuf attributes */
-  packetbuf_set_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS,
-                     uipbuf_get_attr(UIPBUF_ATTR_MAX_MAC_TRANSMISSIONS));
-
-  /* Copy destination address to packetbuf */
-  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER,
-      localdest ? localdest : &linkaddr_null);
-
-#if LLSEC802154_USES_AUX_HEADER
-  /* copy LLSEC level */
-  packetbuf_set_attr(PACKETBUF_ATTR_SECURITY_LEVEL,
-    uipbuf_get_attr(UIPBUF_ATTR_LLSEC_LEVEL));
-#if LLSEC802154_USES_EXPLICIT_KEYS
-  packetbuf_set_attr(PACKETBUF_ATTR_KEY_INDEX,
-    uipbuf_get_attr(UIPBUF_ATTR_LLSEC_KEY_ID));
-#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
-#endif /*  LLSEC802154_USES_AUX_HEADER */
+  set_output_attrs(localdest);
 
   /* Calculate NETSTACK_FRAMER's header length, that will be added in the NETSTACK_MAC */
   mac_max_payload = NETSTACK_MAC.max_payload();
@@ -1671,23 +1908,10 @@ output(const linkaddr_t *localdest)
   }
 
   /* Try to compress the headers */
-#if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPV6
-  compress_hdr_ipv6();
-#endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPV6 */
-#if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_6LORH
-  /* Add 6LoRH headers before IPHC. Only needed on routed traffic
-  (non link-local). */
-  if(!uip_is_addr_linklocal(&UIP_IP_BUF->destipaddr)) {
-    add_paging_dispatch(1);
-    add_6lorh_hdr();
-  }
-#endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_6LORH */
-#if SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC
-  if(compress_hdr_iphc() == 0) {
+  if(compress_hdr() == 0) {
     /* Warning should already be issued by function above */
     return 0;
   }
-#endif /* SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC */
 
   /* Use the mac_max_payload to understand what is the max payload in a MAC
    * packet. We calculate it here only to make a better decision of whether
@@ -1837,6 +2061,235 @@ output(const linkaddr_t *localdest)
   return 1;
 }
 
+#if SICSLOWPAN_FRAG_FORWARDING
+/* ----------------------------------------------------------------- */
+/* Fragment forwarding (RFC 8930)                                    */
+/* ----------------------------------------------------------------- */
+
+/* A virtual reassembly buffer: maps the fragments of a datagram from
+   the previous hop to the next hop and the tag they are sent with */
+struct sicslowpan_vrb {
+  /** Previous hop and tag of the datagram */
+  linkaddr_t prev_hop;
+  uint16_t prev_tag;
+  /** Size of the datagram (if zero this entry is free) */
+  uint16_t size;
+  /** Next hop and the tag of the forwarded fragments */
+  linkaddr_t next_hop;
+  uint16_t next_tag;
+  /** Number of bytes of the datagram forwarded so far */
+  uint16_t forwarded_len;
+  /** Entry lifetime, the same as for a reassembly */
+  struct timer timer;
+  /** Link-layer attributes the fragments are sent with */
+  uint8_t max_transmissions;
+#if LLSEC802154_USES_AUX_HEADER
+  uint8_t security_level;
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  uint8_t key_index;
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /* LLSEC802154_USES_AUX_HEADER */
+};
+
+static struct sicslowpan_vrb vrb[SICSLOWPAN_VRB_ENTRIES];
+
+/*---------------------------------------------------------------------------*/
+static struct sicslowpan_vrb *
+vrb_lookup(uint16_t tag, uint16_t frag_size)
+{
+  const linkaddr_t *sender = packetbuf_addr(PACKETBUF_ADDR_SENDER);
+  struct sicslowpan_vrb *e;
+
+  if(frag_size == 0) {
+    return NULL;
+  }
+
+  for(e = vrb; e < &vrb[SICSLOWPAN_VRB_ENTRIES]; e++) {
+    if(e->size == frag_size && e->prev_tag == tag &&
+       linkaddr_cmp(&e->prev_hop, sender)) {
+      if(timer_expired(&e->timer)) {
+        e->size = 0;
+        return NULL;
+      }
+      return e;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static struct sicslowpan_vrb *
+vrb_alloc(void)
+{
+  struct sicslowpan_vrb *e;
+
+  for(e = vrb; e < &vrb[SICSLOWPAN_VRB_ENTRIES]; e++) {
+    if(e->size == 0 || timer_expired(&e->timer)) {
+      return e;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Set the packetbuf attributes of a fragment sent through a VRB entry.
+   Every fragment is sent with the security level of the first one
+   received, as the whole datagram would be after reassembly. */
+static void
+vrb_set_output_attrs(const struct sicslowpan_vrb *e)
+{
+  packetbuf_set_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS,
+                     e->max_transmissions);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &e->next_hop);
+#if LLSEC802154_USES_AUX_HEADER
+  packetbuf_set_attr(PACKETBUF_ATTR_SECURITY_LEVEL, e->security_level);
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  packetbuf_set_attr(PACKETBUF_ATTR_KEY_INDEX, e->key_index);
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /* LLSEC802154_USES_AUX_HEADER */
+}
+/*---------------------------------------------------------------------------*/
+/* Forward the first fragment of a datagram, uncompressed in its
+   reassembly context, to the next hop of the datagram. The rest of
+   the fragments then follow through the VRB entry set up here. If
+   the datagram cannot be forwarded this way, it is reassembled as
+   usual. */
+static bool
+vrb_forward_first(int context)
+{
+  struct sicslowpan_frag_info *info = &frag_info[context];
+  struct sicslowpan_vrb *e;
+  const linkaddr_t *next_hop;
+  int payload_len;
+
+  /* A restarted datagram replaces its old entry */
+  e = vrb_lookup(info->tag, info->len);
+  if(e != NULL) {
+    e->size = 0;
+  }
+
+  e = vrb_alloc();
+  if(e == NULL || info->first_frag_len >= info->len) {
+    return false;
+  }
+
+  /* The received frame is still in packetbuf */
+#if LLSEC802154_USES_AUX_HEADER
+  e->security_level = packetbuf_attr(PACKETBUF_ATTR_SECURITY_LEVEL);
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  e->key_index = packetbuf_attr(PACKETBUF_ATTR_KEY_INDEX);
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /* LLSEC802154_USES_AUX_HEADER */
+
+  /* Let the IP layer and the routing protocol check and update the
+     headers, as when forwarding the whole datagram. Header insertion
+     or removal would shift the offsets of the other fragments. */
+  memcpy(UIP_IP_BUF, info->first_frag, info->first_frag_len);
+  uip_len = info->first_frag_len;
+  if(!uip_forward_headers() || !NETSTACK_ROUTING.ext_header_update() ||
+     uip_len != info->first_frag_len) {
+    goto fail;
+  }
+
+  next_hop = (const linkaddr_t *)tcpip_ipv6_nexthop_lladdr();
+  if(next_hop == NULL || linkaddr_cmp(next_hop, &info->sender)) {
+    goto fail;
+  }
+  linkaddr_copy(&e->next_hop, next_hop);
+  e->max_transmissions = uipbuf_get_attr(UIPBUF_ATTR_MAX_MAC_TRANSMISSIONS);
+
+  /* Compress the headers anew, as what can be elided depends on the
+     link-layer addresses */
+  uncomp_hdr_len = 0;
+  packetbuf_hdr_len = 0;
+  packetbuf_clear();
+  packetbuf_ptr = packetbuf_dataptr();
+  vrb_set_output_attrs(e);
+  mac_max_payload = NETSTACK_MAC.max_payload();
+  if(mac_max_payload <= 0 || compress_hdr() == 0) {
+    goto fail;
+  }
+
+  payload_len = (int)uip_len - (int)uncomp_hdr_len;
+  if(payload_len < 0 ||
+     packetbuf_hdr_len + SICSLOWPAN_FRAG1_HDR_LEN + payload_len > mac_max_payload) {
+    LOG_WARN("forward: first fragment does not fit the next hop frame\n");
+    goto fail;
+  }
+
+  memmove(packetbuf_ptr + SICSLOWPAN_FRAG1_HDR_LEN, packetbuf_ptr, packetbuf_hdr_len);
+  packetbuf_hdr_len += SICSLOWPAN_FRAG1_HDR_LEN;
+  e->next_tag = my_tag++;
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE,
+        ((SICSLOWPAN_DISPATCH_FRAG1 << 8) | info->len));
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_TAG, e->next_tag);
+  memcpy(packetbuf_ptr + packetbuf_hdr_len, (uint8_t *)UIP_IP_BUF + uncomp_hdr_len,
+         payload_len);
+  packetbuf_set_datalen(packetbuf_hdr_len + payload_len);
+
+  linkaddr_copy(&e->prev_hop, &info->sender);
+  e->prev_tag = info->tag;
+  e->size = info->len;
+  e->forwarded_len = info->first_frag_len;
+  timer_set(&e->timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
+
+  LOG_INFO("forward: datagram (tag %d, len %d) to ", info->tag, info->len);
+  LOG_INFO_LLADDR(next_hop);
+  LOG_INFO_(" with tag %d\n", e->next_tag);
+
+  send_packet();
+  UIP_STAT(++uip_stat.ip.forwarded);
+  SICSLOWPAN_REASS_STAT(sicslowpan_reass_stat.forwarded++);
+
+  clear_fragments(context);
+  uipbuf_clear();
+  return true;
+
+fail:
+  uipbuf_clear();
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+/* Forward a non-first fragment if its datagram has a VRB entry */
+static bool
+vrb_forward_fragment(uint16_t tag, uint16_t frag_size)
+{
+  struct sicslowpan_vrb *e;
+  uint8_t *data;
+  int len;
+
+  e = vrb_lookup(tag, frag_size);
+  if(e == NULL) {
+    return false;
+  }
+
+  /* Send the fragment as is, only with the attributes of the next hop
+     and its tag */
+  data = packetbuf_ptr;
+  len = packetbuf_datalen();
+  packetbuf_clear();
+  packetbuf_ptr = packetbuf_dataptr();
+  memmove(packetbuf_ptr, data, len);
+  packetbuf_set_datalen(len);
+  vrb_set_output_attrs(e);
+
+  if(len > NETSTACK_MAC.max_payload()) {
+    LOG_WARN("forward: fragment does not fit the next hop frame (tag %d)\n", tag);
+    e->size = 0;
+    return true;
+  }
+
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_TAG, e->next_tag);
+  send_packet();
+  SICSLOWPAN_REASS_STAT(sicslowpan_reass_stat.forwarded_frags++);
+
+  /* The entry is done once the whole datagram has been forwarded */
+  e->forwarded_len += len - SICSLOWPAN_FRAGN_HDR_LEN;
+  if(e->forwarded_len >= e->size) {
+    e->size = 0;
+  }
+  return true;
+}
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
+
 /*--------------------------------------------------------------------*/
 /** \brief Process a received 6lowpan packet.
  *
@@ -1861,7 +2314,7 @@ input(void)
 
 #if SICSLOWPAN_CONF_FRAG
   uint8_t is_fragment = 0;
-  int8_t frag_context = 0;
+  int frag_context = 0;
 
   /* tag of the fragment */
   uint16_t frag_tag = 0;
@@ -1935,6 +2388,14 @@ input(void)
       frag_size = GET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE) & 0x07ff;
       packetbuf_hdr_len += SICSLOWPAN_FRAGN_HDR_LEN;
 
+#if SICSLOWPAN_FRAG_FORWARDING
+      /* Switch the fragment to the next hop if its datagram is being
+         forwarded */
+      if(vrb_forward_fragment(frag_tag, frag_size)) {
+        return;
+      }
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
+
       /* Add the fragment to the fragmentation context (this will also
          copy the payload) */
       frag_context = add_fragment(frag_tag, frag_size, frag_offset);
@@ -2034,7 +2495,10 @@ input(void)
           packetbuf_payload_len, req_size, (unsigned)sizeof(uip_buf));
       /* Discard all fragments for this contex, as reassembling this particular fragment would
        * cause an overflow in uipbuf */
-      clear_fragments(frag_context);
+      if(is_fragment) {
+        SICSLOWPAN_REASS_STAT(sicslowpan_reass_stat.invalid++);
+        clear_fragments(frag_context);
+      }
 #endif /* SICSLOWPAN_CONF_FRAG */
       return;
     }
@@ -2058,6 +2522,11 @@ input(void)
     if(first_fragment != 0) {
       frag_info[frag_context].reassembled_len = uncomp_hdr_len + packetbuf_payload_len;
       frag_info[frag_context].first_frag_len = uncomp_hdr_len + packetbuf_payload_len;
+#if SICSLOWPAN_FRAG_FORWARDING
+      if(vrb_forward_first(frag_context)) {
+        return;
+      }
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
     }
     /* For the last fragment, we are OK if there is extrenous bytes at
        the end of the packet. */
@@ -294,6 +294,32 @@ struct sicslowpan_nh_compressor {
 
 };
 
+/**
+ * The 6LoWPAN reassembly statistics.
+ */
+struct sicslowpan_reass_stats {
+  uint32_t started;         /**< Reassemblies started by a first fragment. */
+  uint32_t reassembled;     /**< Datagrams reassembled and passed up. */
+  uint32_t timed_out;       /**< Reassemblies dropped when they timed out. */
+  uint32_t no_context;      /**< Fragments dropped for lack of a context. */
+  uint32_t no_buffer;       /**< Fragments dropped for lack of a buffer. */
+  uint32_t over_quota;      /**< Fragments dropped by the per-sender quotas. */
+  uint32_t invalid;         /**< Datagrams dropped because of invalid fragments. */
+  uint32_t forwarded;       /**< Datagrams forwarded fragment by fragment. */
+  uint32_t forwarded_frags; /**< Non-first fragments forwarded. */
+};
+
+#if SICSLOWPAN_REASS_STATS
+/**
+ * The 6LoWPAN reassembly statistics, kept when SICSLOWPAN_REASS_STATS
+ * is set.
+ */
+extern struct sicslowpan_reass_stats sicslowpan_reass_stat;
+#define SICSLOWPAN_REASS_STAT(s) s
+#else
+#define SICSLOWPAN_REASS_STAT(s)
+#endif /* SICSLOWPAN_REASS_STATS */
+
 extern const struct network_driver sicslowpan_driver;
 
 #endif /* SICSLOWPAN_H_ */
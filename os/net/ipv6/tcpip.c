@@ -479,7 +479,7 @@ annotate_transmission(const uip_ipaddr_t *nexthop)
 }
 /*---------------------------------------------------------------------------*/
 static const uip_ipaddr_t*
-get_nexthop(uip_ipaddr_t *addr)
+get_nexthop(uip_ipaddr_t *addr, bool use_fallback)
 {
   const uip_ipaddr_t *nexthop;
   uip_ds6_route_t *route;
@@ -512,7 +512,9 @@ get_nexthop(uip_ipaddr_t *addr)
   if(route == NULL) {
     nexthop = uip_ds6_defrt_choose();
     if(nexthop == NULL) {
-      output_fallback();
+      if(use_fallback) {
+        output_fallback();
+      }
     } else {
       LOG_INFO("output: no route found, using default route: ");
       LOG_INFO_6ADDR(nexthop);
@@ -659,7 +661,7 @@ tcpip_ipv6_output(void)
   }
 
   /* Look for a next hop */
-  if((nexthop = get_nexthop(&ipaddr)) == NULL) {
+  if((nexthop = get_nexthop(&ipaddr, true)) == NULL) {
     LOG_WARN("output: No next-hop found, dropping packet\n");
     goto exit;
   }
@@ -734,6 +736,31 @@ exit:
   return;
 }
 /*---------------------------------------------------------------------------*/
+const uip_lladdr_t *
+tcpip_ipv6_nexthop_lladdr(void)
+{
+  uip_ipaddr_t ipaddr;
+  uip_ds6_nbr_t *nbr;
+  const uip_ipaddr_t *nexthop;
+
+  if((nexthop = get_nexthop(&ipaddr, false)) == NULL) {
+    return NULL;
+  }
+
+  nbr = uip_ds6_nbr_lookup(nexthop);
+  if(nbr == NULL) {
+    return NULL;
+  }
+#if UIP_ND6_SEND_NS
+  if(nbr->state == NBR_INCOMPLETE) {
+    return NULL;
+  }
+#endif /* UIP_ND6_SEND_NS */
+
+  annotate_transmission(nexthop);
+  return uip_ds6_nbr_get_ll(nbr);
+}
+/*---------------------------------------------------------------------------*/
 #if UIP_UDP
 void
 tcpip_poll_udp(struct uip_udp_conn *conn)
@@ -799,6 +826,8 @@ PROCESS_THREAD(tcpip_process, ev, data)
 {
   PROCESS_BEGIN();
 
+  process_set_priority(&tcpip_process, PROCESS_PRIORITY_HIGH);
+
 #if UIP_TCP
   memset(s.listenports, 0, UIP_LISTENPORTS*sizeof(*(s.listenports)));
   s.p = PROCESS_CURRENT();
@@ -345,6 +345,17 @@ uint8_t tcpip_output(const uip_lladdr_t *);
  */
 void tcpip_ipv6_output(void);
 
+/**
+ * \brief Look up the link-layer address of the next hop of the packet
+ * in uip_buf
+ *
+ * Unlike tcpip_ipv6_output(), this neither starts neighbor discovery
+ * nor uses the fallback interface.
+ *
+ * \return The address, or NULL if the next hop is not a known neighbor
+ */
+const uip_lladdr_t *tcpip_ipv6_nexthop_lladdr(void);
+
 /**
  * \brief Is forwarding generally enabled?
  */
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \addtogroup uip
+ * @{
+ *
+ * \file
+ *         Internet checksum computation and incremental update
+ */
+
+#include "net/ipv6/uip-chksum.h"
+#include "net/ipv6/uip.h"
+
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_bytes(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint16_t t;
+  const uint8_t *dataptr;
+  const uint8_t *last_byte;
+
+  dataptr = data;
+  last_byte = data + len - 1;
+
+  while(dataptr < last_byte) {   /* At least two more bytes */
+    t = (dataptr[0] << 8) + dataptr[1];
+    sum += t;
+    if(sum < t) {
+      sum++;      /* carry */
+    }
+    dataptr += 2;
+  }
+
+  if(dataptr == last_byte) {
+    t = (dataptr[0] << 8) + 0;
+    sum += t;
+    if(sum < t) {
+      sum++;      /* carry */
+    }
+  }
+
+  /* Return sum in host byte order. */
+  return sum;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_words(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  const uint32_t *words;
+  uint64_t acc = 0;
+  uint8_t odd;
+  uint16_t result;
+
+  /*
+   * The ones' complement sum is independent of byte order (RFC 1071),
+   * so the data is summed as native words and the result is swapped
+   * to big endian at the end. An odd start address is handled as if
+   * the data started one byte earlier with a zero byte, which swaps
+   * the bytes of the sum once more.
+   */
+  odd = (uintptr_t)data & 1;
+  if(odd && len > 0) {
+#if UIP_BYTE_ORDER == UIP_LITTLE_ENDIAN
+    acc = (uint16_t)data[0] << 8;
+#else
+    acc = data[0];
+#endif
+    data++;
+    len--;
+  }
+  if(((uintptr_t)data & 2) && len >= 2) {
+    acc += *(const uint16_t *)data;
+    data += 2;
+    len -= 2;
+  }
+
+  words = (const uint32_t *)data;
+  for(; len >= 16; len -= 16) {
+    acc += (uint64_t)words[0] + words[1] + words[2] + words[3];
+    words += 4;
+  }
+  for(; len >= 4; len -= 4) {
+    acc += *words++;
+  }
+  data = (const uint8_t *)words;
+  if(len >= 2) {
+    acc += *(const uint16_t *)data;
+    data += 2;
+    len -= 2;
+  }
+  if(len > 0) {
+#if UIP_BYTE_ORDER == UIP_LITTLE_ENDIAN
+    acc += data[0];
+#else
+    acc += (uint16_t)data[0] << 8;
+#endif
+  }
+
+  result = uip_chksum_fold(acc);
+#if UIP_BYTE_ORDER == UIP_LITTLE_ENDIAN
+  if(!odd) {
+#else
+  if(odd) {
+#endif
+    result = (result << 8) | (result >> 8);
+  }
+
+  result += sum;
+  if(result < sum) {
+    result++;      /* carry */
+  }
+  return result;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_update16(uint16_t chksum, uint16_t old_word, uint16_t new_word)
+{
+  uint32_t sum;
+
+  /* HC' = ~(~HC + ~m + m') */
+  sum = (uint16_t)~chksum + (uint16_t)~old_word + (uint32_t)new_word;
+  sum = (sum >> 16) + (sum & 0xffff);
+  sum += sum >> 16;
+  return ~sum;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_update(uint16_t chksum, const void *old_data,
+                  const void *new_data, uint16_t len)
+{
+  return uip_chksum_update16(chksum,
+                             uip_htons(UIP_CHKSUM_IMPL(0, old_data, len)),
+                             uip_htons(UIP_CHKSUM_IMPL(0, new_data, len)));
+}
+/*---------------------------------------------------------------------------*/
+
+/** @} */
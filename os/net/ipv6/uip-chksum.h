@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \addtogroup uip
+ * @{
+ *
+ * \file
+ *         Internet checksum (RFC 1071) computation and incremental
+ *         update (RFC 1624)
+ *
+ * Checksums are computed by UIP_CHKSUM_IMPL. Platforms select it with
+ * UIP_CHKSUM_CONF_IMPL, which names a function with the signature of
+ * uip_chksum_bytes(). The default, uip_chksum_words(), adds 32 bits at
+ * a time into a 64-bit accumulator. 8- and 16-bit CPUs are better
+ * served by uip_chksum_bytes().
+ */
+
+#ifndef UIP_CHKSUM_H_
+#define UIP_CHKSUM_H_
+
+#include "contiki.h"
+
+#ifdef UIP_CHKSUM_CONF_IMPL
+#define UIP_CHKSUM_IMPL UIP_CHKSUM_CONF_IMPL
+#else
+#define UIP_CHKSUM_IMPL uip_chksum_words
+#endif
+
+/**
+ * \brief      Adds data to a checksum, 16 bits at a time.
+ * \param sum  The sum of the preceding data, in host byte order
+ * \param data The data, as a sequence of big-endian 16-bit words
+ * \param len  The length of the data. If it is odd, the last byte is
+ *             padded with a zero.
+ * \return     The ones' complement sum, not complemented, in host
+ *             byte order.
+ *
+ *             This is the reference implementation, which all
+ *             others must match.
+ */
+uint16_t uip_chksum_bytes(uint16_t sum, const uint8_t *data, uint16_t len);
+
+/**
+ * \brief      Adds data to a checksum, 32 bits at a time.
+ *
+ *             The same as uip_chksum_bytes(), with aligned 32-bit
+ *             loads summed into a 64-bit accumulator.
+ */
+uint16_t uip_chksum_words(uint16_t sum, const uint8_t *data, uint16_t len);
+
+/**
+ * \brief      Adds data to a checksum with the configured implementation.
+ */
+uint16_t UIP_CHKSUM_IMPL(uint16_t sum, const uint8_t *data, uint16_t len);
+
+/**
+ * \brief      Folds a wide ones' complement sum to 16 bits.
+ * \param acc  The sum of 16-bit words, added as plain integers
+ * \return     The 16-bit ones' complement sum
+ */
+static inline uint16_t
+uip_chksum_fold(uint64_t acc)
+{
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  return acc;
+}
+
+/**
+ * \brief          Updates a checksum field for a changed 16-bit word.
+ * \param chksum   The checksum field
+ * \param old_word The old value of the word
+ * \param new_word The new value of the word
+ * \return         The new checksum field
+ *
+ *                 Implements equation 3 of RFC 1624. The arguments may
+ *                 be in either byte order, as long as all three are in
+ *                 the same, e.g. as they are stored in the packet.
+ */
+uint16_t uip_chksum_update16(uint16_t chksum, uint16_t old_word,
+                             uint16_t new_word);
+
+/**
+ * \brief          Updates a checksum field for changed data.
+ * \param chksum   The checksum field, in network byte order
+ * \param old_data The old data
+ * \param new_data The new data
+ * \param len      The length of the data, which must be even
+ * \return         The new checksum field, in network byte order
+ *
+ *                 The data must start at an even offset within the
+ *                 checksummed data, as addresses and ports do.
+ */
+uint16_t uip_chksum_update(uint16_t chksum, const void *old_data,
+                           const void *new_data, uint16_t len);
+
+#endif /* UIP_CHKSUM_H_ */
+
+/** @} */
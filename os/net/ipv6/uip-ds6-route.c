@@ -85,6 +85,24 @@ MEMB(routememb, uip_ds6_route_t, UIP_DS6_ROUTE_NB);
 static int num_routes = 0;
 static void rm_routelist_callback(nbr_table_item_t *ptr);
 
+#if UIP_DS6_ROUTE_LPM_TRIE
+/* The routes are also indexed by a path-compressed binary trie for
+   longest-prefix-match lookups. Nodes are either keyed by a route
+   prefix or are branching points where two prefixes diverge, so a
+   trie holding N prefixes never needs more than 2N - 1 nodes. */
+struct lpm_node {
+  struct lpm_node *child[2];
+  uip_ds6_route_t *route;
+  uip_ipaddr_t prefix;
+  uint8_t length;
+};
+MEMB(lpm_nodememb, struct lpm_node, 2 * UIP_DS6_ROUTE_NB);
+static struct lpm_node *lpm_root;
+/* Number of routes that share their trie key with another route and
+   are therefore not referenced from the trie. */
+static int lpm_shadowed;
+#endif /* UIP_DS6_ROUTE_LPM_TRIE */
+
 #endif /* (UIP_MAX_ROUTES != 0) */
 
 /* Default routes are held on the defaultrouterlist and their
@@ -168,6 +186,11 @@ uip_ds6_route_init(void)
 #if (UIP_MAX_ROUTES != 0)
   memb_init(&routememb);
   list_init(routelist);
+#if UIP_DS6_ROUTE_LPM_TRIE
+  memb_init(&lpm_nodememb);
+  lpm_root = NULL;
+  lpm_shadowed = 0;
+#endif /* UIP_DS6_ROUTE_LPM_TRIE */
   nbr_table_register(nbr_routes,
                      (nbr_table_callback *)rm_routelist_callback);
 #endif /* (UIP_MAX_ROUTES != 0) */
@@ -270,14 +293,217 @@ uip_ds6_route_num_routes(void)
   return 0;
 #endif /* (UIP_MAX_ROUTES != 0) */
 }
+#if (UIP_MAX_ROUTES != 0) && UIP_DS6_ROUTE_LPM_TRIE
+/*---------------------------------------------------------------------------*/
+/* uip_ipaddr_prefixcmp() only compares whole bytes, so a route only
+   constrains the first (length & ~7) bits of the destination. The
+   trie is keyed on that many bits to return the same routes as the
+   linear scan. */
+static uint8_t
+lpm_key_length(const uip_ds6_route_t *r)
+{
+  return (r->length > 128 ? 128 : r->length) & ~7;
+}
+/*---------------------------------------------------------------------------*/
+static int
+lpm_bit(const uip_ipaddr_t *addr, uint8_t bit)
+{
+  return (addr->u8[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the number of leading bits, at most max, shared by a and b,
+   given that the first from bits are already known to be equal. */
+static uint8_t
+lpm_common_bits(const uip_ipaddr_t *a, const uip_ipaddr_t *b,
+                uint8_t from, uint8_t max)
+{
+  uint8_t bits;
+  uint8_t diff;
+
+  for(bits = from & ~7; bits < max; bits += 8) {
+    diff = a->u8[bits >> 3] ^ b->u8[bits >> 3];
+    if(diff != 0) {
+      while((diff & 0x80) == 0) {
+        diff <<= 1;
+        bits++;
+      }
+      break;
+    }
+  }
+  return bits < max ? bits : max;
+}
+/*---------------------------------------------------------------------------*/
+static struct lpm_node *
+lpm_node_alloc(const uip_ipaddr_t *prefix, uint8_t length,
+               uip_ds6_route_t *route)
+{
+  struct lpm_node *n;
+
+  n = memb_alloc(&lpm_nodememb);
+  if(n == NULL) {
+    LOG_ERR("Trie: could not allocate node\n");
+    return NULL;
+  }
+  n->child[0] = n->child[1] = NULL;
+  n->route = route;
+  n->length = length;
+  uip_ipaddr_copy(&n->prefix, prefix);
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static void
+lpm_insert(uip_ds6_route_t *route)
+{
+  struct lpm_node **link;
+  struct lpm_node *n;
+  struct lpm_node *leaf;
+  struct lpm_node *branch;
+  uint8_t length;
+  uint8_t common;
+
+  length = lpm_key_length(route);
+  for(link = &lpm_root; (n = *link) != NULL;
+      link = &n->child[lpm_bit(&route->ipaddr, n->length)]) {
+    common = lpm_common_bits(&n->prefix, &route->ipaddr, 0,
+                             MIN(n->length, length));
+    if(common < n->length) {
+      /* The new prefix diverges from, or is a prefix of, this node:
+         splice in a node above it. */
+      if(common == length) {
+        leaf = lpm_node_alloc(&route->ipaddr, length, route);
+        if(leaf == NULL) {
+          return;
+        }
+        leaf->child[lpm_bit(&n->prefix, length)] = n;
+        *link = leaf;
+        return;
+      }
+      branch = lpm_node_alloc(&route->ipaddr, common, NULL);
+      if(branch == NULL) {
+        return;
+      }
+      leaf = lpm_node_alloc(&route->ipaddr, length, route);
+      if(leaf == NULL) {
+        memb_free(&lpm_nodememb, branch);
+        return;
+      }
+      branch->child[lpm_bit(&n->prefix, common)] = n;
+      branch->child[lpm_bit(&route->ipaddr, common)] = leaf;
+      *link = branch;
+      return;
+    }
+    if(n->length == length) {
+      if(n->route == NULL) {
+        n->route = route;
+      } else {
+        /* Another route has the same key; keep the longer one, as the
+           linear scan would. */
+        if(route->length > n->route->length) {
+          n->route = route;
+        }
+        lpm_shadowed++;
+      }
+      return;
+    }
+  }
+
+  *link = lpm_node_alloc(&route->ipaddr, length, route);
+}
+/*---------------------------------------------------------------------------*/
+static void
+lpm_remove(uip_ds6_route_t *route)
+{
+  struct lpm_node **link;
+  struct lpm_node **parent_link;
+  struct lpm_node *n;
+  struct lpm_node *parent;
+  uip_ds6_route_t *r;
+  uint8_t length;
+
+  length = lpm_key_length(route);
+  parent_link = NULL;
+  for(link = &lpm_root; (n = *link) != NULL && n->length < length;
+      link = &n->child[lpm_bit(&route->ipaddr, n->length)]) {
+    parent_link = link;
+  }
+  if(n == NULL || n->length != length ||
+     lpm_common_bits(&n->prefix, &route->ipaddr, 0, length) != length) {
+    return;
+  }
+
+  if(n->route != route) {
+    /* A shadowed route */
+    lpm_shadowed--;
+    return;
+  }
+
+  n->route = NULL;
+  if(lpm_shadowed > 0) {
+    /* Let another route with the same key take over this node */
+    for(r = list_head(routelist); r != NULL; r = list_item_next(r)) {
+      if(r != route && lpm_key_length(r) == length &&
+         lpm_common_bits(&r->ipaddr, &n->prefix, 0, length) == length &&
+         (n->route == NULL || r->length > n->route->length)) {
+        n->route = r;
+      }
+    }
+    if(n->route != NULL) {
+      lpm_shadowed--;
+      return;
+    }
+  }
+
+  /* Collapse nodes that no longer hold a route or branch. */
+  if(n->child[0] != NULL && n->child[1] != NULL) {
+    return;
+  }
+  *link = n->child[0] != NULL ? n->child[0] : n->child[1];
+  memb_free(&lpm_nodememb, n);
+
+  if(*link == NULL && parent_link != NULL) {
+    parent = *parent_link;
+    if(parent->route == NULL) {
+      *parent_link = parent->child[0] != NULL ?
+        parent->child[0] : parent->child[1];
+      memb_free(&lpm_nodememb, parent);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t *
+lpm_lookup(const uip_ipaddr_t *addr)
+{
+  struct lpm_node *n;
+  uip_ds6_route_t *found_route;
+  uint8_t matched;
+
+  found_route = NULL;
+  matched = 0;
+  for(n = lpm_root; n != NULL; n = n->child[lpm_bit(addr, matched)]) {
+    if(lpm_common_bits(&n->prefix, addr, matched, n->length) != n->length) {
+      break;
+    }
+    matched = n->length;
+    if(n->route != NULL) {
+      found_route = n->route;
+    }
+    if(matched == 128) {
+      break;
+    }
+  }
+  return found_route;
+}
+#endif /* (UIP_MAX_ROUTES != 0) && UIP_DS6_ROUTE_LPM_TRIE */
 /*---------------------------------------------------------------------------*/
 uip_ds6_route_t *
 uip_ds6_route_lookup(const uip_ipaddr_t *addr)
 {
 #if (UIP_MAX_ROUTES != 0)
-  uip_ds6_route_t *r;
   uip_ds6_route_t *found_route;
+#if !UIP_DS6_ROUTE_LPM_TRIE
+  uip_ds6_route_t *r;
   uint8_t longestmatch;
+#endif /* !UIP_DS6_ROUTE_LPM_TRIE */
 
   LOG_INFO("Looking up route for ");
   LOG_INFO_6ADDR(addr);
@@ -287,6 +513,9 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     return NULL;
   }
 
+#if UIP_DS6_ROUTE_LPM_TRIE
+  found_route = lpm_lookup(addr);
+#else /* UIP_DS6_ROUTE_LPM_TRIE */
   found_route = NULL;
   longestmatch = 0;
   for(r = uip_ds6_route_head();
@@ -302,6 +531,7 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
       }
     }
   }
+#endif /* UIP_DS6_ROUTE_LPM_TRIE */
 
   if(found_route != NULL) {
     LOG_INFO("Found route: ");
@@ -313,6 +543,8 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     LOG_INFO("No route found\n");
   }
 
+#if !UIP_DS6_ROUTE_LPM_TRIE || UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+  /* With the trie, the list order only matters for LRU eviction. */
   if(found_route != NULL && found_route != list_head(routelist)) {
     /* If we found a route, we put it at the start of the routeslist
        list. The list is ordered by how recently we looked them up:
@@ -322,6 +554,7 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     list_remove(routelist, found_route);
     list_push(routelist, found_route);
   }
+#endif /* !UIP_DS6_ROUTE_LPM_TRIE || UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED */
 
   return found_route;
 #else /* (UIP_MAX_ROUTES != 0) */
@@ -464,6 +697,9 @@ uip_ds6_route_add(const uip_ipaddr_t *ipaddr, uint8_t length,
 
   uip_ipaddr_copy(&(r->ipaddr), ipaddr);
   r->length = length;
+#if UIP_DS6_ROUTE_LPM_TRIE
+  lpm_insert(r);
+#endif /* UIP_DS6_ROUTE_LPM_TRIE */
 
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   memset(&r->state, 0, sizeof(UIP_DS6_ROUTE_STATE_TYPE));
@@ -509,6 +745,9 @@ uip_ds6_route_rm(uip_ds6_route_t *route)
 
     /* Remove the route from the route list */
     list_remove(routelist, route);
+#if UIP_DS6_ROUTE_LPM_TRIE
+    lpm_remove(route);
+#endif /* UIP_DS6_ROUTE_LPM_TRIE */
 
     /* Find the corresponding neighbor_route and remove it. */
     for(neighbor_route = list_head(route->neighbor_routes->route_list);
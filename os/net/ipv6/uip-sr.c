@@ -42,7 +42,9 @@
 #include "contiki.h"
 #include "net/ipv6/uip-sr.h"
 #include "net/ipv6/uiplib.h"
+#include "net/ipv6/uipbuf.h"
 #include "net/routing/routing.h"
+#include "lib/heapmem.h"
 #include "lib/list.h"
 #include "lib/memb.h"
 
@@ -58,6 +60,45 @@ static int num_nodes;
 LIST(nodelist);
 MEMB(nodememb, uip_sr_node_t, UIP_SR_LINK_NUM);
 
+#if UIP_SR_HEAPMEM_NODES && !defined(HEAPMEM_CONF_ARENA_SIZE)
+#error UIP_SR_CONF_HEAPMEM_NODES requires HEAPMEM_CONF_ARENA_SIZE
+#endif
+
+#if UIP_SR_HASH_INDEX
+#if UIP_SR_HASH_SIZE & (UIP_SR_HASH_SIZE - 1)
+#error UIP_SR_CONF_HASH_SIZE must be a power of two
+#endif
+static uip_sr_node_t *initial_buckets[UIP_SR_HASH_SIZE];
+static uip_sr_node_t **buckets = initial_buckets;
+static unsigned bucket_count = UIP_SR_HASH_SIZE;
+#endif /* UIP_SR_HASH_INDEX */
+
+#if UIP_SR_SRH_CACHE_SIZE
+/* The cache is four-way set associative if its size allows */
+#if UIP_SR_SRH_CACHE_SIZE % 4 == 0
+#define SRH_CACHE_WAYS 4
+#else
+#define SRH_CACHE_WAYS 1
+#endif
+#define SRH_CACHE_SETS (UIP_SR_SRH_CACHE_SIZE / SRH_CACHE_WAYS)
+
+struct srh_cache_entry {
+  const void *graph;
+  /* The entry is only valid in the generation it was added in */
+  uint32_t generation;
+  /* The time of the last hit, for LRU replacement within a set */
+  uint32_t last_used;
+  uip_ipaddr_t dest;
+  uip_ipaddr_t next_hop;
+  uint8_t len;
+  uint8_t hdr[UIP_SR_SRH_CACHE_HDR_LEN];
+};
+static struct srh_cache_entry srh_cache[UIP_SR_SRH_CACHE_SIZE];
+static uint32_t srh_cache_generation = 1;
+static uint32_t srh_cache_clock;
+static uip_sr_srh_cache_stats_t srh_cache_stats;
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+
 /*---------------------------------------------------------------------------*/
 int
 uip_sr_num_nodes(void)
@@ -65,6 +106,257 @@ uip_sr_num_nodes(void)
   return num_nodes;
 }
 /*---------------------------------------------------------------------------*/
+static uip_sr_node_t *
+node_alloc(void)
+{
+  uip_sr_node_t *node;
+
+  node = memb_alloc(&nodememb);
+#if UIP_SR_HEAPMEM_NODES
+  if(node == NULL && num_nodes < UIP_SR_MAX_NODES) {
+    node = heapmem_alloc(sizeof(uip_sr_node_t));
+  }
+#endif /* UIP_SR_HEAPMEM_NODES */
+  return node;
+}
+/*---------------------------------------------------------------------------*/
+static void
+node_free(uip_sr_node_t *node)
+{
+#if UIP_SR_HEAPMEM_NODES
+  if(!memb_inmemb(&nodememb, node)) {
+    heapmem_free(node);
+    return;
+  }
+#endif /* UIP_SR_HEAPMEM_NODES */
+  memb_free(&nodememb, node);
+}
+#if UIP_SR_HASH_INDEX || UIP_SR_SRH_CACHE_SIZE
+/*---------------------------------------------------------------------------*/
+static uint32_t
+hash_key(const void *graph, const unsigned char *link_identifier)
+{
+  uintptr_t g = (uintptr_t)graph;
+  uint32_t h = 2166136261UL;
+  unsigned i;
+
+  /* FNV-1a over the link identifier and the graph pointer */
+  for(i = 0; i < 8; i++) {
+    h = (h ^ link_identifier[i]) * 16777619UL;
+  }
+  for(i = 0; i < sizeof(g); i++) {
+    h = (h ^ (uint8_t)g) * 16777619UL;
+    g >>= 8;
+  }
+  return h ^ (h >> 16);
+}
+#endif /* UIP_SR_HASH_INDEX || UIP_SR_SRH_CACHE_SIZE */
+#if UIP_SR_HASH_INDEX
+/*---------------------------------------------------------------------------*/
+static uip_sr_node_t **
+hash_bucket(const void *graph, const unsigned char *link_identifier)
+{
+  return &buckets[hash_key(graph, link_identifier) & (bucket_count - 1)];
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_insert(uip_sr_node_t *node)
+{
+  uip_sr_node_t **bucket = hash_bucket(node->graph, node->link_identifier);
+
+  node->hash_next = *bucket;
+  *bucket = node;
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_remove(uip_sr_node_t *node)
+{
+  uip_sr_node_t **link;
+
+  for(link = hash_bucket(node->graph, node->link_identifier);
+      *link != NULL; link = &(*link)->hash_next) {
+    if(*link == node) {
+      *link = node->hash_next;
+      return;
+    }
+  }
+}
+#if UIP_SR_HEAPMEM_NODES
+/*---------------------------------------------------------------------------*/
+/* Doubles the number of buckets once the chains grow long. If heapmem
+   cannot provide a larger array, the current one is kept. */
+static void
+hash_grow(void)
+{
+  uip_sr_node_t **new_buckets;
+  uip_sr_node_t *l;
+
+  if(num_nodes <= 2 * bucket_count) {
+    return;
+  }
+
+  new_buckets = heapmem_calloc(2 * bucket_count, sizeof(uip_sr_node_t *));
+  if(new_buckets == NULL) {
+    return;
+  }
+  if(buckets != initial_buckets) {
+    heapmem_free(buckets);
+  }
+  buckets = new_buckets;
+  bucket_count *= 2;
+
+  for(l = list_head(nodelist); l != NULL; l = list_item_next(l)) {
+    hash_insert(l);
+  }
+  LOG_INFO("NS: resized hash index to %u buckets\n", bucket_count);
+}
+#endif /* UIP_SR_HEAPMEM_NODES */
+/*---------------------------------------------------------------------------*/
+static void
+hash_reset(void)
+{
+#if UIP_SR_HEAPMEM_NODES
+  if(buckets != initial_buckets) {
+    heapmem_free(buckets);
+    buckets = initial_buckets;
+    bucket_count = UIP_SR_HASH_SIZE;
+  }
+#endif /* UIP_SR_HEAPMEM_NODES */
+  memset(initial_buckets, 0, sizeof(initial_buckets));
+}
+#endif /* UIP_SR_HASH_INDEX */
+#if UIP_SR_SRH_CACHE_SIZE
+/*---------------------------------------------------------------------------*/
+static struct srh_cache_entry *
+srh_cache_set(const void *graph, const uip_ipaddr_t *dest)
+{
+  return &srh_cache[(hash_key(graph, dest->u8 + 8) % SRH_CACHE_SETS) *
+                    SRH_CACHE_WAYS];
+}
+/*---------------------------------------------------------------------------*/
+static int
+srh_cache_entry_matches(const struct srh_cache_entry *e, const void *graph,
+                        const uip_ipaddr_t *dest)
+{
+  return e->generation == srh_cache_generation && e->graph == graph &&
+    uip_ipaddr_cmp(&e->dest, dest);
+}
+/*---------------------------------------------------------------------------*/
+int
+uip_sr_srh_cache_lookup(const void *graph, const uip_ipaddr_t *dest,
+                        uip_ipaddr_t *next_hop, const uint8_t **hdr)
+{
+  struct srh_cache_entry *e = srh_cache_set(graph, dest);
+  int i;
+
+  for(i = 0; i < SRH_CACHE_WAYS; i++, e++) {
+    if(srh_cache_entry_matches(e, graph, dest)) {
+      srh_cache_stats.hits++;
+      e->last_used = ++srh_cache_clock;
+      uip_ipaddr_copy(next_hop, &e->next_hop);
+      *hdr = e->hdr;
+      return e->len;
+    }
+  }
+  srh_cache_stats.misses++;
+  return -1;
+}
+/*---------------------------------------------------------------------------*/
+int
+uip_sr_insert_cached_srh(const uint8_t *hdr, uint8_t len,
+                         const uip_ipaddr_t *next_hop)
+{
+  struct uip_routing_hdr *rh_hdr = (struct uip_routing_hdr *)UIP_IP_PAYLOAD(0);
+
+  if(len == 0) {
+    /* The destination is a child of the root */
+    return 1;
+  }
+
+  if(uip_len + len > UIP_LINK_MTU) {
+    LOG_ERR("packet too long: impossible to add source routing header (%u bytes)\n",
+            len);
+    return 0;
+  }
+
+  memmove(uip_buf + UIP_IPH_LEN + uip_ext_len + len,
+          uip_buf + UIP_IPH_LEN + uip_ext_len, uip_len - UIP_IPH_LEN);
+  memcpy(rh_hdr, hdr, len);
+
+  rh_hdr->next = UIP_IP_BUF->proto;
+  UIP_IP_BUF->proto = UIP_PROTO_ROUTING;
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, next_hop);
+
+  uipbuf_add_ext_hdr(len);
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_sr_srh_cache_add(const void *graph, const uip_ipaddr_t *dest,
+                     const uip_ipaddr_t *next_hop,
+                     const uint8_t *hdr, uint8_t len)
+{
+  struct srh_cache_entry *set;
+  struct srh_cache_entry *e;
+  int i;
+
+  if(len > UIP_SR_SRH_CACHE_HDR_LEN) {
+    return;
+  }
+
+  /* Replace an entry for the same destination, a stale entry, or the
+     least recently used one, in that order. */
+  set = srh_cache_set(graph, dest);
+  e = set;
+  for(i = 0; i < SRH_CACHE_WAYS; i++) {
+    if(srh_cache_entry_matches(&set[i], graph, dest)) {
+      e = &set[i];
+      break;
+    }
+    if(e->generation == srh_cache_generation &&
+       (set[i].generation != srh_cache_generation ||
+        (int32_t)(set[i].last_used - e->last_used) < 0)) {
+      e = &set[i];
+    }
+  }
+
+  e->graph = graph;
+  e->generation = srh_cache_generation;
+  e->last_used = ++srh_cache_clock;
+  uip_ipaddr_copy(&e->dest, dest);
+  uip_ipaddr_copy(&e->next_hop, next_hop);
+  e->len = len;
+  if(len > 0) {
+    memcpy(e->hdr, hdr, len);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_sr_srh_cache_flush(void)
+{
+  if(++srh_cache_generation == 0) {
+    /* Entries from the previous wrap-around must not become valid again */
+    memset(srh_cache, 0, sizeof(srh_cache));
+    srh_cache_generation = 1;
+  }
+  srh_cache_stats.flushes++;
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_sr_srh_cache_stats(uip_sr_srh_cache_stats_t *stats)
+{
+  *stats = srh_cache_stats;
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_sr_srh_cache_stats_reset(void)
+{
+  memset(&srh_cache_stats, 0, sizeof(srh_cache_stats));
+}
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+/*---------------------------------------------------------------------------*/
 static int
 node_matches_address(const void *graph, const uip_sr_node_t *node,
                      const uip_ipaddr_t *addr)
@@ -82,19 +374,32 @@ uip_sr_node_t *
 uip_sr_get_node(const void *graph, const uip_ipaddr_t *addr)
 {
   uip_sr_node_t *l;
+#if UIP_SR_HASH_INDEX
+  if(addr == NULL) {
+    return NULL;
+  }
+  for(l = *hash_bucket(graph, addr->u8 + 8); l != NULL; l = l->hash_next) {
+    /* Only rebuild the address of nodes with this identifier */
+    if(memcmp(l->link_identifier, addr->u8 + 8, 8) == 0 &&
+       node_matches_address(graph, l, addr)) {
+      return l;
+    }
+  }
+#else /* UIP_SR_HASH_INDEX */
   for(l = list_head(nodelist); l != NULL; l = list_item_next(l)) {
     /* Compare prefix and node identifier */
     if(node_matches_address(graph, l, addr)) {
       return l;
     }
   }
+#endif /* UIP_SR_HASH_INDEX */
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
 int
 uip_sr_is_addr_reachable(const void *graph, const uip_ipaddr_t *addr)
 {
-  int max_depth = UIP_SR_LINK_NUM;
+  int max_depth = UIP_SR_MAX_NODES;
   uip_ipaddr_t root_ipaddr;
   uip_sr_node_t *node;
   uip_sr_node_t *root_node;
@@ -119,6 +424,9 @@ uip_sr_expire_parent(const void *graph, const uip_ipaddr_t *child,
   if(l != NULL && node_matches_address(graph, l->parent, parent)) {
     if(l->lifetime > UIP_SR_REMOVAL_DELAY) {
       l->lifetime = UIP_SR_REMOVAL_DELAY;
+#if UIP_SR_SRH_CACHE_SIZE
+      uip_sr_srh_cache_flush();
+#endif /* UIP_SR_SRH_CACHE_SIZE */
     }
   }
 }
@@ -144,7 +452,7 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child,
 
   /* No node for this child, add one */
   if(child_node == NULL) {
-    child_node = memb_alloc(&nodememb);
+    child_node = node_alloc();
     /* No space left, abort */
     if(child_node == NULL) {
       LOG_ERR("NS: no space left for child ");
@@ -153,18 +461,24 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child,
       return NULL;
     }
     child_node->parent = NULL;
-    list_add(nodelist, child_node);
+    child_node->graph = graph;
+    memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
+    list_push(nodelist, child_node);
     num_nodes++;
+#if UIP_SR_HASH_INDEX
+    hash_insert(child_node);
+#if UIP_SR_HEAPMEM_NODES
+    hash_grow();
+#endif /* UIP_SR_HEAPMEM_NODES */
+#endif /* UIP_SR_HASH_INDEX */
   }
 
   /* Initialize node */
-  child_node->graph = graph;
   child_node->lifetime = lifetime;
-  memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
+  old_parent_node = child_node->parent;
 
   /* Is the node reachable before the update? */
   if(uip_sr_is_addr_reachable(graph, child)) {
-    old_parent_node = child_node->parent;
     /* Update node */
     child_node->parent = parent_node;
     /* Has the node become unreachable? May happen if we create a loop. */
@@ -178,6 +492,12 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child,
     child_node->parent = parent_node;
   }
 
+#if UIP_SR_SRH_CACHE_SIZE
+  if(child_node->parent != old_parent_node) {
+    uip_sr_srh_cache_flush();
+  }
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+
   LOG_INFO("NS: updating link, child ");
   LOG_INFO_6ADDR(child);
   LOG_INFO_(", parent ");
@@ -193,6 +513,12 @@ uip_sr_init(void)
   num_nodes = 0;
   memb_init(&nodememb);
   list_init(nodelist);
+#if UIP_SR_HASH_INDEX
+  hash_reset();
+#endif /* UIP_SR_HASH_INDEX */
+#if UIP_SR_SRH_CACHE_SIZE
+  uip_sr_srh_cache_flush();
+#endif /* UIP_SR_SRH_CACHE_SIZE */
 }
 /*---------------------------------------------------------------------------*/
 uip_sr_node_t *
@@ -235,7 +561,13 @@ uip_sr_periodic(unsigned seconds)
           LOG_INFO_("\n");
         }
         list_remove(nodelist, l);
-        memb_free(&nodememb, l);
+#if UIP_SR_HASH_INDEX
+        hash_remove(l);
+#endif /* UIP_SR_HASH_INDEX */
+#if UIP_SR_SRH_CACHE_SIZE
+        uip_sr_srh_cache_flush();
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+        node_free(l);
         num_nodes--;
       }
     } else if(l->lifetime != UIP_SR_INFINITE_LIFETIME) {
@@ -252,9 +584,15 @@ uip_sr_free_all(void)
   for(l = list_head(nodelist); l != NULL; l = next) {
     next = list_item_next(l);
     list_remove(nodelist, l);
-    memb_free(&nodememb, l);
+    node_free(l);
     num_nodes--;
   }
+#if UIP_SR_HASH_INDEX
+  hash_reset();
+#endif /* UIP_SR_HASH_INDEX */
+#if UIP_SR_SRH_CACHE_SIZE
+  uip_sr_srh_cache_flush();
+#endif /* UIP_SR_SRH_CACHE_SIZE */
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -83,6 +83,55 @@
 #define UIP_SR_REMOVAL_DELAY          60
 #endif /* UIP_SR_CONF_REMOVAL_DELAY */
 
+/* The number of nodes that may be allocated from heapmem once all
+   UIP_SR_LINK_NUM statically allocated nodes are in use */
+#ifdef UIP_SR_CONF_HEAPMEM_NODES
+#define UIP_SR_HEAPMEM_NODES          UIP_SR_CONF_HEAPMEM_NODES
+#else /* UIP_SR_CONF_HEAPMEM_NODES */
+#define UIP_SR_HEAPMEM_NODES          0
+#endif /* UIP_SR_CONF_HEAPMEM_NODES */
+
+#define UIP_SR_MAX_NODES (UIP_SR_LINK_NUM + UIP_SR_HEAPMEM_NODES)
+
+/* Index the nodes by link identifier and graph in a hash table, so
+   that looking up a node does not rebuild the address of every node */
+#ifdef UIP_SR_CONF_HASH_INDEX
+#define UIP_SR_HASH_INDEX             UIP_SR_CONF_HASH_INDEX
+#else /* UIP_SR_CONF_HASH_INDEX */
+#define UIP_SR_HASH_INDEX             0
+#endif /* UIP_SR_CONF_HASH_INDEX */
+
+/* The initial number of hash buckets, which must be a power of two. The
+   bucket array is reallocated from heapmem as heapmem nodes are added. */
+#ifdef UIP_SR_CONF_HASH_SIZE
+#define UIP_SR_HASH_SIZE              UIP_SR_CONF_HASH_SIZE
+#elif UIP_SR_LINK_NUM <= 32
+#define UIP_SR_HASH_SIZE              16
+#elif UIP_SR_LINK_NUM <= 128
+#define UIP_SR_HASH_SIZE              64
+#elif UIP_SR_LINK_NUM <= 512
+#define UIP_SR_HASH_SIZE              256
+#elif UIP_SR_LINK_NUM <= 2048
+#define UIP_SR_HASH_SIZE              1024
+#else
+#define UIP_SR_HASH_SIZE              4096
+#endif /* UIP_SR_CONF_HASH_SIZE */
+
+/* The number of source routing headers cached per destination at the
+   root. The cache is flushed whenever the topology changes. */
+#ifdef UIP_SR_CONF_SRH_CACHE_SIZE
+#define UIP_SR_SRH_CACHE_SIZE         UIP_SR_CONF_SRH_CACHE_SIZE
+#else /* UIP_SR_CONF_SRH_CACHE_SIZE */
+#define UIP_SR_SRH_CACHE_SIZE         0
+#endif /* UIP_SR_CONF_SRH_CACHE_SIZE */
+
+/* The longest source routing header that can be cached */
+#ifdef UIP_SR_CONF_SRH_CACHE_HDR_LEN
+#define UIP_SR_SRH_CACHE_HDR_LEN      UIP_SR_CONF_SRH_CACHE_HDR_LEN
+#else /* UIP_SR_CONF_SRH_CACHE_HDR_LEN */
+#define UIP_SR_SRH_CACHE_HDR_LEN      64
+#endif /* UIP_SR_CONF_SRH_CACHE_HDR_LEN */
+
 #define UIP_SR_INFINITE_LIFETIME           0xFFFFFFFF
 
 /********** Data Structures  **********/
@@ -98,8 +147,22 @@ typedef struct uip_sr_node {
   us with the prefix */
   unsigned char link_identifier[8];
   struct uip_sr_node *parent;
+#if UIP_SR_HASH_INDEX
+  /* The next node in the same hash bucket */
+  struct uip_sr_node *hash_next;
+#endif /* UIP_SR_HASH_INDEX */
 } uip_sr_node_t;
 
+#if UIP_SR_SRH_CACHE_SIZE
+/** \brief Statistics of the source routing header cache */
+typedef struct uip_sr_srh_cache_stats {
+  uint32_t hits;
+  uint32_t misses;
+  /* The number of times the topology changed and the cache was flushed */
+  uint32_t flushes;
+} uip_sr_srh_cache_stats_t;
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+
 /********** Public functions **********/
 
 /**
@@ -194,6 +257,65 @@ void uip_sr_free_all(void);
 */
 int uip_sr_link_snprint(char *buf, int buflen, const uip_sr_node_t *link);
 
+#if UIP_SR_SRH_CACHE_SIZE
+/**
+ * Looks up the cached source routing header towards a destination
+ *
+ * \param graph The graph the destination belongs to
+ * \param dest The final destination of the packet
+ * \param next_hop Set to the first hop of the source route on a hit
+ * \param hdr Set to point to the cached routing header on a hit
+ * \return The length of the cached header, which is 0 if no header
+ * is needed, or -1 if there is no valid cache entry
+ */
+int uip_sr_srh_cache_lookup(const void *graph, const uip_ipaddr_t *dest,
+                            uip_ipaddr_t *next_hop, const uint8_t **hdr);
+
+/**
+ * Inserts a cached source routing header as the first extension header
+ * of the packet in uip_buf, and sets the IPv6 destination to the first
+ * hop. A header length of 0 leaves the packet unchanged.
+ *
+ * \param hdr The routing header, as returned by uip_sr_srh_cache_lookup()
+ * \param len The length of the routing header
+ * \param next_hop The first hop of the source route
+ * \return 1 on success, 0 if the header does not fit the packet
+ */
+int uip_sr_insert_cached_srh(const uint8_t *hdr, uint8_t len,
+                             const uip_ipaddr_t *next_hop);
+
+/**
+ * Caches the source routing header towards a destination. Headers
+ * longer than UIP_SR_SRH_CACHE_HDR_LEN are not cached.
+ *
+ * \param graph The graph the destination belongs to
+ * \param dest The final destination of the packet
+ * \param next_hop The first hop of the source route
+ * \param hdr The routing header, or NULL if no header is needed
+ * \param len The length of the routing header
+ */
+void uip_sr_srh_cache_add(const void *graph, const uip_ipaddr_t *dest,
+                          const uip_ipaddr_t *next_hop,
+                          const uint8_t *hdr, uint8_t len);
+
+/**
+ * Invalidates all cached source routing headers
+ */
+void uip_sr_srh_cache_flush(void);
+
+/**
+ * Reads the source routing header cache statistics
+ *
+ * \param stats The structure to fill in
+ */
+void uip_sr_srh_cache_stats(uip_sr_srh_cache_stats_t *stats);
+
+/**
+ * Resets the source routing header cache statistics
+ */
+void uip_sr_srh_cache_stats_reset(void);
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+
 /** @} */
 
 #endif /* UIP_SR_H */
@@ -1484,6 +1484,23 @@ extern uint8_t uip_flags;
  */
 void uip_process(uint8_t flag);
 
+#if UIP_CONF_ROUTER
+/* uip_forward_headers():
+ *
+ * Applies the checks and header updates of the forwarding path of
+ * uip_process() to a datagram of which only the first uip_len bytes,
+ * holding its headers, are in uip_buf. Used by link layers that
+ * forward the fragments of a datagram as they arrive. Returns false
+ * if the datagram is to be reassembled and processed in full instead,
+ * e.g. because it is for this node, has a routing header, or calls
+ * for an ICMP error. Hop-by-Hop options other than padding are left
+ * to the full processing too, so that none of them is processed
+ * twice. The caller counts the datagram as forwarded once it has
+ * been sent.
+ */
+bool uip_forward_headers(void);
+#endif /* UIP_CONF_ROUTER */
+
   /* The following flags are passed as an argument to the uip_process()
    function. They are used to distinguish between the two cases where
    uip_process() is called. It can be called either because we have
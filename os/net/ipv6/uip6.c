@@ -74,6 +74,7 @@
 #include "sys/cc.h"
 #include "net/ipv6/uip.h"
 #include "net/ipv6/uip-arch.h"
+#include "net/ipv6/uip-chksum.h"
 #include "net/ipv6/uipopt.h"
 #include "net/ipv6/uip-icmp6.h"
 #include "net/ipv6/uip-nd6.h"
@@ -281,32 +282,8 @@ uip_add32(uint8_t *op32, uint16_t op16)
 static uint16_t
 chksum(uint16_t sum, const uint8_t *data, uint16_t len)
 {
-  uint16_t t;
-  const uint8_t *dataptr;
-  const uint8_t *last_byte;
-
-  dataptr = data;
-  last_byte = data + len - 1;
-
-  while(dataptr < last_byte) {   /* At least two more bytes */
-    t = (dataptr[0] << 8) + dataptr[1];
-    sum += t;
-    if(sum < t) {
-      sum++;      /* carry */
-    }
-    dataptr += 2;
-  }
-
-  if(dataptr == last_byte) {
-    t = (dataptr[0] << 8) + 0;
-    sum += t;
-    if(sum < t) {
-      sum++;      /* carry */
-    }
-  }
-
-  /* Return sum in host byte order. */
-  return sum;
+  /* Sum in host byte order */
+  return UIP_CHKSUM_IMPL(sum, data, len);
 }
 /*---------------------------------------------------------------------------*/
 uint16_t
@@ -992,6 +969,81 @@ uip_update_ttl(void)
   }
 }
 /*---------------------------------------------------------------------------*/
+#if UIP_CONF_ROUTER
+/* Check, without processing them, that the options of a Hop-by-Hop
+   header are all well-formed padding. */
+static bool
+ext_hdr_options_padding_only(const uint8_t *ext_buf)
+{
+  const struct uip_hbho_hdr *ext_hdr = (const struct uip_hbho_hdr *)ext_buf;
+  uint16_t ext_hdr_len = (ext_hdr->len << 3) + 8;
+  uint16_t opt_offset = 2;
+
+  while(opt_offset < ext_hdr_len) {
+    const struct uip_ext_hdr_opt *opt_hdr =
+      (const struct uip_ext_hdr_opt *)(ext_buf + opt_offset);
+
+    if(opt_hdr->type == UIP_EXT_HDR_OPT_PAD1) {
+      opt_offset += 1;
+    } else if(opt_hdr->type == UIP_EXT_HDR_OPT_PADN &&
+              opt_offset + 2 <= ext_hdr_len &&
+              opt_offset + opt_hdr->len + 2 <= ext_hdr_len) {
+      opt_offset += opt_hdr->len + 2;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+bool
+uip_forward_headers(void)
+{
+  uint8_t *next_header;
+  uint8_t protocol;
+
+  if(uip_ds6_is_my_addr(&UIP_IP_BUF->destipaddr) ||
+     uip_ds6_is_my_maddr(&UIP_IP_BUF->destipaddr) ||
+     uip_is_addr_mcast(&UIP_IP_BUF->destipaddr) ||
+     uip_is_addr_linklocal(&UIP_IP_BUF->destipaddr) ||
+     uip_is_addr_linklocal(&UIP_IP_BUF->srcipaddr) ||
+     uip_is_addr_unspecified(&UIP_IP_BUF->srcipaddr) ||
+     uip_is_addr_mcast(&UIP_IP_BUF->srcipaddr) ||
+     uip_is_addr_loopback(&UIP_IP_BUF->destipaddr)) {
+    return false;
+  }
+
+  /* Leave the ICMP errors to the full forwarding path */
+  if(UIP_IP_BUF->ttl <= 1 ||
+     UIP_IPH_LEN + uipbuf_get_len_field(UIP_IP_BUF) > UIP_LINK_MTU) {
+    return false;
+  }
+
+  next_header = uipbuf_get_next_header(uip_buf, uip_len, &protocol, true);
+  if(next_header != NULL && protocol == UIP_PROTO_HBHO) {
+    /* Other options, such as the RPL one, are processed with the whole
+       datagram: their processing has side effects, or sends ICMP
+       errors, that would be repeated if the datagram were reassembled
+       after all. */
+    if(!ext_hdr_options_padding_only(next_header)) {
+      return false;
+    }
+    next_header = uipbuf_get_next_header(next_header,
+                                         uip_len - (next_header - uip_buf),
+                                         &protocol, false);
+  }
+
+  /* Other extension headers, such as a routing header, are processed
+     with the whole datagram */
+  if(next_header == NULL || uip_is_proto_ext_hdr(protocol)) {
+    return false;
+  }
+
+  UIP_IP_BUF->ttl = UIP_IP_BUF->ttl - 1;
+  return true;
+}
+#endif /* UIP_CONF_ROUTER */
+/*---------------------------------------------------------------------------*/
 void
 uip_process(uint8_t flag)
 {
@@ -462,6 +462,16 @@
 #define SICSLOWPAN_CONF_FRAG  1
 #endif
 
+/**
+ * Determines whether the 6LoWPAN layer keeps reassembly statistics,
+ * see struct sicslowpan_reass_stats. Follows UIP_STATISTICS by default.
+ */
+#ifdef SICSLOWPAN_CONF_REASS_STATS
+#define SICSLOWPAN_REASS_STATS SICSLOWPAN_CONF_REASS_STATS
+#else
+#define SICSLOWPAN_REASS_STATS UIP_STATISTICS
+#endif
+
 /** @} */
 
 /*------------------------------------------------------------------------------*/
@@ -47,6 +47,7 @@
 #include "dev/watchdog.h"
 #include "sys/ctimer.h"
 #include "sys/clock.h"
+#include "sys/energest.h"
 #include "lib/random.h"
 #include "net/netstack.h"
 #include "lib/list.h"
@@ -268,7 +269,14 @@ transmit_from_queue(void *ptr)
         n->transmissions, list_length(n->packet_queue));
       /* Send first packet in the neighbor queue */
       queuebuf_to_packetbuf(q->buf);
+#if ENERGEST_WITH_CONTEXTS
+      /* Account the transmission to the context that sent the packet */
+      energest_context_push(packetbuf_attr(PACKETBUF_ATTR_ENERGEST_CONTEXT));
       send_one_packet(n, q);
+      energest_context_pop();
+#else /* ENERGEST_WITH_CONTEXTS */
+      send_one_packet(n, q);
+#endif /* ENERGEST_WITH_CONTEXTS */
     }
   }
 }
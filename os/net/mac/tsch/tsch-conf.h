@@ -314,6 +314,24 @@
 #define TSCH_QUEUE_MAX_NEIGHBOR_QUEUES ((NBR_TABLE_CONF_MAX_NEIGHBORS) + 2)
 #endif
 
+/* Keep a list of the unicast neighbors that have packets queued, so that
+ * shared Tx slots do not scan the whole neighbor table, and serve them
+ * round-robin */
+#ifdef TSCH_QUEUE_CONF_WITH_ACTIVE_LIST
+#define TSCH_QUEUE_WITH_ACTIVE_LIST TSCH_QUEUE_CONF_WITH_ACTIVE_LIST
+#else
+#define TSCH_QUEUE_WITH_ACTIVE_LIST 0
+#endif
+
+/* The number of neighbors that may become active between two shared Tx
+ * slots before the active list is rebuilt from the neighbor table.
+ * Must be power of two (at most 128) */
+#ifdef TSCH_QUEUE_CONF_ACTIVE_PENDING_SIZE
+#define TSCH_QUEUE_ACTIVE_PENDING_SIZE TSCH_QUEUE_CONF_ACTIVE_PENDING_SIZE
+#else
+#define TSCH_QUEUE_ACTIVE_PENDING_SIZE 16
+#endif
+
 /******** Configuration: scheduling  *******/
 
 /* Initializes TSCH with a 6TiSCH minimal schedule */
@@ -353,6 +371,16 @@
 #define TSCH_SCHEDULE_MAX_LINKS 32
 #endif
 
+/* Keep the links of each slotframe sorted by timeslot, so that the next
+ * active link is found with a binary search per slotframe rather than
+ * by scanning all links. Costs TSCH_SCHEDULE_MAX_LINKS pointers per
+ * slotframe. */
+#ifdef TSCH_SCHEDULE_CONF_INDEXED
+#define TSCH_SCHEDULE_INDEXED TSCH_SCHEDULE_CONF_INDEXED
+#else
+#define TSCH_SCHEDULE_INDEXED 0
+#endif
+
 /* To include Sixtop Implementation */
 #ifdef TSCH_CONF_WITH_SIXTOP
 #define TSCH_WITH_SIXTOP TSCH_CONF_WITH_SIXTOP
@@ -75,6 +75,113 @@ NBR_TABLE(struct tsch_neighbor, tsch_neighbors);
 struct tsch_neighbor *n_broadcast;
 struct tsch_neighbor *n_eb;
 
+#if TSCH_QUEUE_WITH_ACTIVE_LIST
+#if (TSCH_QUEUE_ACTIVE_PENDING_SIZE & (TSCH_QUEUE_ACTIVE_PENDING_SIZE - 1)) != 0
+#error TSCH_QUEUE_ACTIVE_PENDING_SIZE must be power of two
+#endif
+
+/* The unicast neighbors with queued packets, as a circular list owned by
+ * the slot operation. Its head, i.e. the next neighbor to be served in a
+ * shared slot, is active_tail->next_active. Neighbors are only removed
+ * lazily, once their queue is found empty. */
+static struct tsch_neighbor *active_tail;
+/* Neighbors that got a packet outside of the slot operation, to be added
+ * to the active list at the next shared slot. Same lockfree ringbuf as
+ * the neighbor queues. */
+static struct tsch_neighbor *active_pending_array[TSCH_QUEUE_ACTIVE_PENDING_SIZE];
+static struct ringbufindex active_pending_ringbuf;
+/* Set when the active list must be rebuilt from the neighbor table */
+static volatile uint8_t active_list_rebuild;
+#endif /* TSCH_QUEUE_WITH_ACTIVE_LIST */
+
+
+#if TSCH_QUEUE_WITH_ACTIVE_LIST
+/*---------------------------------------------------------------------------*/
+/* Empty the active list. Only from the slot operation, or with the lock */
+static void
+active_list_clear(void)
+{
+  if(active_tail != NULL) {
+    struct tsch_neighbor *n = active_tail;
+    do {
+      struct tsch_neighbor *next = n->next_active;
+      n->is_active = 0;
+      n->next_active = NULL;
+      n = next;
+    } while(n != active_tail);
+    active_tail = NULL;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Append a neighbor to the active list, i.e. it is served last */
+static void
+active_list_add(struct tsch_neighbor *n)
+{
+  if(!n->is_active) {
+    n->is_active = 1;
+    if(active_tail == NULL) {
+      n->next_active = n;
+    } else {
+      n->next_active = active_tail->next_active;
+      active_tail->next_active = n;
+    }
+    active_tail = n;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Bring the active list up to date, from the slot operation */
+static void
+active_list_update(void)
+{
+  int16_t get_index;
+
+  if(active_list_rebuild) {
+    struct tsch_neighbor *n;
+    active_list_rebuild = 0;
+    active_list_clear();
+    /* Drop the pending neighbors, the scan below covers them */
+    while(ringbufindex_get(&active_pending_ringbuf) != -1) {
+    }
+    n = (struct tsch_neighbor *)nbr_table_head(tsch_neighbors);
+    while(n != NULL) {
+      if(!n->is_broadcast && !ringbufindex_empty(&n->tx_ringbuf)) {
+        active_list_add(n);
+      }
+      n = (struct tsch_neighbor *)nbr_table_next(tsch_neighbors, n);
+    }
+  } else {
+    while((get_index = ringbufindex_get(&active_pending_ringbuf)) != -1) {
+      active_list_add(active_pending_array[get_index]);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Notify that a packet was queued to a unicast neighbor */
+static void
+active_list_notify(struct tsch_neighbor *n)
+{
+  /* The slot operation may only remove n from the active list after seeing
+   * its queue empty, which it no longer is */
+  if(!n->is_active) {
+    int16_t put_index = ringbufindex_peek_put(&active_pending_ringbuf);
+    if(put_index != -1) {
+      active_pending_array[put_index] = n;
+      ringbufindex_put(&active_pending_ringbuf);
+    } else {
+      active_list_rebuild = 1;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Forget all neighbors, e.g. before one of them is removed. With the lock */
+static void
+active_list_reset(void)
+{
+  active_list_clear();
+  ringbufindex_init(&active_pending_ringbuf, TSCH_QUEUE_ACTIVE_PENDING_SIZE);
+  active_list_rebuild = 1;
+}
+#endif /* TSCH_QUEUE_WITH_ACTIVE_LIST */
 /*---------------------------------------------------------------------------*/
 /* Add a TSCH neighbor */
 struct tsch_neighbor *
@@ -211,15 +318,23 @@ static void
 tsch_queue_remove_nbr(struct tsch_neighbor *n)
 {
   if(n != NULL) {
-    if(tsch_get_lock()) {
-
-      tsch_release_lock();
+    /* Flush queue. This needs the lock to be free, so it is done
+     * first; the neighbor is then freed with the lock held. If the
+     * lock cannot be taken, the neighbor is kept, with its queue empty,
+     * until the next call. */
+    tsch_queue_flush_nbr_queue(n);
 
-      /* Flush queue */
-      tsch_queue_flush_nbr_queue(n);
+    if(tsch_get_lock()) {
+#if TSCH_QUEUE_WITH_ACTIVE_LIST
+      /* Make sure the slot operation no longer refers to the neighbor.
+       * Its queue is now empty, so it will not be added back. */
+      active_list_reset();
+#endif /* TSCH_QUEUE_WITH_ACTIVE_LIST */
 
       /* Free neighbor */
       nbr_table_remove(tsch_neighbors, n);
+
+      tsch_release_lock();
     }
   }
 }
@@ -260,6 +375,11 @@ tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
             /* Add to ringbuf (actual add committed through atomic operation) */
             n->tx_array[put_index] = p;
             ringbufindex_put(&n->tx_ringbuf);
+#if TSCH_QUEUE_WITH_ACTIVE_LIST
+            if(!n->is_broadcast) {
+              active_list_notify(n);
+            }
+#endif /* TSCH_QUEUE_WITH_ACTIVE_LIST */
             LOG_DBG("packet is added put_index %u, packet %p\n",
                    put_index, p);
             return p;
@@ -463,6 +583,55 @@ tsch_queue_get_packet_for_dest_addr(const linkaddr_t *addr, struct tsch_link *li
 struct tsch_packet *
 tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link *link)
 {
+#if TSCH_QUEUE_WITH_ACTIVE_LIST
+  if(!tsch_is_locked()) {
+    struct tsch_neighbor *prev;
+    struct tsch_neighbor *last;
+    struct tsch_neighbor *curr_nbr;
+    struct tsch_packet *p;
+
+    active_list_update();
+    if(active_tail == NULL) {
+      return NULL;
+    }
+
+    /* Visit each active neighbor once, starting from the head */
+    prev = active_tail;
+    last = active_tail;
+    do {
+      curr_nbr = prev->next_active;
+      if(ringbufindex_empty(&curr_nbr->tx_ringbuf)) {
+        /* Nothing left to send: remove from the active list */
+        curr_nbr->is_active = 0;
+        if(curr_nbr == prev) {
+          curr_nbr->next_active = NULL;
+          active_tail = NULL;
+          break;
+        }
+        prev->next_active = curr_nbr->next_active;
+        curr_nbr->next_active = NULL;
+        if(curr_nbr == active_tail) {
+          active_tail = prev;
+        }
+      } else {
+        /* Only look up for neighbors we do not have a tx link to */
+        if(curr_nbr->tx_links_count == 0) {
+          p = tsch_queue_get_packet_for_nbr(curr_nbr, link);
+          if(p != NULL) {
+            /* Round-robin: the next neighbor is served first next time */
+            active_tail = curr_nbr;
+            if(n != NULL) {
+              *n = curr_nbr;
+            }
+            return p;
+          }
+        }
+        prev = curr_nbr;
+      }
+    } while(curr_nbr != last);
+  }
+  return NULL;
+#else /* TSCH_QUEUE_WITH_ACTIVE_LIST */
   if(!tsch_is_locked()) {
     struct tsch_neighbor *curr_nbr = (struct tsch_neighbor *)nbr_table_head(tsch_neighbors);
     struct tsch_packet *p = NULL;
@@ -481,6 +650,7 @@ tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link
     }
   }
   return NULL;
+#endif /* TSCH_QUEUE_WITH_ACTIVE_LIST */
 }
 /*---------------------------------------------------------------------------*/
 /* May the neighbor transmit over a shared link? */
@@ -539,6 +709,11 @@ tsch_queue_init(void)
 {
   nbr_table_register(tsch_neighbors, NULL);
   memb_init(&packet_memb);
+#if TSCH_QUEUE_WITH_ACTIVE_LIST
+  active_tail = NULL;
+  ringbufindex_init(&active_pending_ringbuf, TSCH_QUEUE_ACTIVE_PENDING_SIZE);
+  active_list_rebuild = 0;
+#endif /* TSCH_QUEUE_WITH_ACTIVE_LIST */
   /* Add virtual EB and the broadcast neighbors */
   n_eb = tsch_queue_add_nbr(&tsch_eb_address);
   n_broadcast = tsch_queue_add_nbr(&tsch_broadcast_address);
@@ -68,6 +68,55 @@ MEMB(slotframe_memb, struct tsch_slotframe, TSCH_SCHEDULE_MAX_SLOTFRAMES);
 /* List of slotframes (each slotframe holds its own list of links) */
 LIST(slotframe_list);
 
+#if TSCH_SCHEDULE_INDEXED
+/* Returns the position of the first link in the slotframe index with a
+ * timeslot larger than the given one (or equal, if inclusive is set) */
+static uint16_t
+index_search(const struct tsch_slotframe *sf, uint16_t timeslot, int inclusive)
+{
+  uint16_t low = 0;
+  uint16_t high = sf->links_count;
+
+  while(low < high) {
+    uint16_t mid = low + (high - low) / 2;
+    uint16_t t = sf->links_by_timeslot[mid]->timeslot;
+    if(t < timeslot || (!inclusive && t == timeslot)) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_add(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  /* After any link with the same timeslot, as in links_list */
+  uint16_t pos = index_search(sf, l->timeslot, 0);
+
+  memmove(&sf->links_by_timeslot[pos + 1], &sf->links_by_timeslot[pos],
+          (sf->links_count - pos) * sizeof(struct tsch_link *));
+  sf->links_by_timeslot[pos] = l;
+  sf->links_count++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_remove(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  uint16_t pos;
+
+  for(pos = index_search(sf, l->timeslot, 1); pos < sf->links_count; pos++) {
+    if(sf->links_by_timeslot[pos] == l) {
+      sf->links_count--;
+      memmove(&sf->links_by_timeslot[pos], &sf->links_by_timeslot[pos + 1],
+              (sf->links_count - pos) * sizeof(struct tsch_link *));
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+#endif /* TSCH_SCHEDULE_INDEXED */
 /* Adds and returns a slotframe (NULL if failure) */
 struct tsch_slotframe *
 tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
@@ -88,6 +137,9 @@ tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
       sf->handle = handle;
       TSCH_ASN_DIVISOR_INIT(sf->size, size);
       LIST_STRUCT_INIT(sf, links_list);
+#if TSCH_SCHEDULE_INDEXED
+      sf->links_count = 0;
+#endif /* TSCH_SCHEDULE_INDEXED */
       /* Add the slotframe to the global list */
       list_add(slotframe_list, sf);
     }
@@ -256,6 +308,9 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
         l->link_type = link_type;
         l->slotframe_handle = slotframe->handle;
         l->timeslot = timeslot;
+#if TSCH_SCHEDULE_INDEXED
+        index_add(slotframe, l);
+#endif /* TSCH_SCHEDULE_INDEXED */
         l->channel_offset = channel_offset;
         l->data = NULL;
         if(address == NULL) {
@@ -315,6 +370,9 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
       LOG_INFO_("\n");
 
       list_remove(slotframe->links_list, l);
+#if TSCH_SCHEDULE_INDEXED
+      index_remove(slotframe, l);
+#endif /* TSCH_SCHEDULE_INDEXED */
       memb_free(&link_memb, l);
 
       /* Release the lock before we update the neighbor (will take the lock) */
@@ -394,6 +452,14 @@ tsch_schedule_get_link_by_timeslot(struct tsch_slotframe *slotframe,
 {
   if(!tsch_is_locked()) {
     if(slotframe != NULL) {
+#if TSCH_SCHEDULE_INDEXED
+      uint16_t pos = index_search(slotframe, timeslot, 1);
+      if(pos < slotframe->links_count &&
+         slotframe->links_by_timeslot[pos]->timeslot == timeslot) {
+        return slotframe->links_by_timeslot[pos];
+      }
+      return NULL;
+#else /* TSCH_SCHEDULE_INDEXED */
       struct tsch_link *l = list_head(slotframe->links_list);
       /* Loop over all items. Assume there is max one link per timeslot */
       while(l != NULL) {
@@ -403,6 +469,7 @@ tsch_schedule_get_link_by_timeslot(struct tsch_slotframe *slotframe,
         l = list_item_next(l);
       }
       return l;
+#endif /* TSCH_SCHEDULE_INDEXED */
     }
   }
   return NULL;
@@ -430,6 +497,59 @@ default_tsch_link_comparator(struct tsch_link *a, struct tsch_link *b)
   return a;
 }
 
+/*---------------------------------------------------------------------------*/
+/* Compares a link occurring time_to_timeslot slots from now against the
+ * current best and backup links, and updates them */
+static void
+select_link(struct tsch_link *l, uint16_t time_to_timeslot,
+            struct tsch_link **curr_best, uint16_t *time_to_curr_best,
+            struct tsch_link **curr_backup)
+{
+  if(*curr_best == NULL || time_to_timeslot < *time_to_curr_best) {
+    *time_to_curr_best = time_to_timeslot;
+    *curr_best = l;
+    *curr_backup = NULL;
+  } else if(time_to_timeslot == *time_to_curr_best) {
+    struct tsch_link *new_best = NULL;
+    /* Two links are overlapping, we need to select one of them.
+     * By standard: prioritize Tx links first, second by lowest handle */
+    if(((*curr_best)->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
+      /* Both or neither links have Tx, select the one with lowest handle */
+      if(l->slotframe_handle != (*curr_best)->slotframe_handle) {
+        if(l->slotframe_handle < (*curr_best)->slotframe_handle) {
+          new_best = l;
+        }
+      } else {
+        /* compare the link against the current best link and return the newly selected one */
+        new_best = TSCH_LINK_COMPARATOR(*curr_best, l);
+      }
+    } else {
+      /* Select the link that has the Tx option */
+      if(l->link_options & LINK_OPTION_TX) {
+        new_best = l;
+      }
+    }
+
+    /* Maintain backup_link */
+    /* Check if 'l' best can be used as backup */
+    if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
+      if(*curr_backup == NULL || l->slotframe_handle < (*curr_backup)->slotframe_handle) {
+        *curr_backup = l;
+      }
+    }
+    /* Check if curr_best can be used as backup */
+    if(new_best != *curr_best && ((*curr_best)->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
+      if(*curr_backup == NULL || (*curr_best)->slotframe_handle < (*curr_backup)->slotframe_handle) {
+        *curr_backup = *curr_best;
+      }
+    }
+
+    /* Maintain curr_best */
+    if(new_best != NULL) {
+      *curr_best = new_best;
+    }
+  }
+}
 /*---------------------------------------------------------------------------*/
 /* Returns the next active link after a given ASN, and a backup link (for the same ASN, with Rx flag) */
 struct tsch_link *
@@ -448,59 +568,40 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
     while(sf != NULL) {
       /* Get timeslot from ASN, given the slotframe length */
       uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
+#if TSCH_SCHEDULE_INDEXED
+      if(sf->links_count > 0) {
+        /* Only the links at the first timeslot after the current one can
+         * be selected. If there are none left in this slotframe
+         * iteration, wrap around to the first link of the next one. */
+        uint16_t pos = index_search(sf, timeslot, 0);
+        uint16_t next_timeslot;
+        uint16_t time_to_timeslot;
+        if(pos == sf->links_count) {
+          pos = 0;
+        }
+        next_timeslot = sf->links_by_timeslot[pos]->timeslot;
+        time_to_timeslot =
+          next_timeslot > timeslot ?
+          next_timeslot - timeslot :
+          sf->size.val + next_timeslot - timeslot;
+        for(; pos < sf->links_count &&
+              sf->links_by_timeslot[pos]->timeslot == next_timeslot; pos++) {
+          select_link(sf->links_by_timeslot[pos], time_to_timeslot,
+                      &curr_best, &time_to_curr_best, &curr_backup);
+        }
+      }
+#else /* TSCH_SCHEDULE_INDEXED */
       struct tsch_link *l = list_head(sf->links_list);
       while(l != NULL) {
         uint16_t time_to_timeslot =
           l->timeslot > timeslot ?
           l->timeslot - timeslot :
           sf->size.val + l->timeslot - timeslot;
-        if(curr_best == NULL || time_to_timeslot < time_to_curr_best) {
-          time_to_curr_best = time_to_timeslot;
-          curr_best = l;
-          curr_backup = NULL;
-        } else if(time_to_timeslot == time_to_curr_best) {
-          struct tsch_link *new_best = NULL;
-          /* Two links are overlapping, we need to select one of them.
-           * By standard: prioritize Tx links first, second by lowest handle */
-          if((curr_best->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
-            /* Both or neither links have Tx, select the one with lowest handle */
-            if(l->slotframe_handle != curr_best->slotframe_handle) {
-              if(l->slotframe_handle < curr_best->slotframe_handle) {
-                new_best = l;
-              }
-            } else {
-              /* compare the link against the current best link and return the newly selected one */
-              new_best = TSCH_LINK_COMPARATOR(curr_best, l);
-            }
-          } else {
-            /* Select the link that has the Tx option */
-            if(l->link_options & LINK_OPTION_TX) {
-              new_best = l;
-            }
-          }
-
-          /* Maintain backup_link */
-          /* Check if 'l' best can be used as backup */
-          if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
-            if(curr_backup == NULL || l->slotframe_handle < curr_backup->slotframe_handle) {
-              curr_backup = l;
-            }
-          }
-          /* Check if curr_best can be used as backup */
-          if(new_best != curr_best && (curr_best->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
-            if(curr_backup == NULL || curr_best->slotframe_handle < curr_backup->slotframe_handle) {
-              curr_backup = curr_best;
-            }
-          }
-
-          /* Maintain curr_best */
-          if(new_best != NULL) {
-            curr_best = new_best;
-          }
-        }
-
+        select_link(l, time_to_timeslot,
+                    &curr_best, &time_to_curr_best, &curr_backup);
         l = list_item_next(l);
       }
+#endif /* TSCH_SCHEDULE_INDEXED */
       sf = list_item_next(sf);
     }
     if(time_offset != NULL) {
@@ -174,6 +174,13 @@ PT_THREAD(tsch_scan(struct pt *pt));
  * and scheduled from tsch_schedule_slot_operation */
 static PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr));
 static struct pt slot_operation_pt;
+#if ENERGEST_WITH_CONTEXTS
+static void slot_operation_callback(struct rtimer *t, void *ptr);
+#define SLOT_OPERATION_CALLBACK slot_operation_callback
+#else /* ENERGEST_WITH_CONTEXTS */
+#define SLOT_OPERATION_CALLBACK \
+  ((void (*)(struct rtimer *, void *))tsch_slot_operation)
+#endif /* ENERGEST_WITH_CONTEXTS */
 /* Sub-protothreads of tsch_slot_operation */
 static PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t));
 static PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t));
@@ -313,7 +320,9 @@ tsch_schedule_slot_operation(struct rtimer *tm, rtimer_clock_t ref_time, rtimer_
                         str, (int)(now-ref_time), (int)offset);
     );
   } else {
-    r = rtimer_set(tm, ref_time + offset, 1, (void (*)(struct rtimer *, void *))tsch_slot_operation, NULL);
+    /* Slot timing goes first when other rtimers are due */
+    rtimer_set_priority(tm, RTIMER_PRIORITY_HIGH);
+    r = rtimer_set(tm, ref_time + offset, 1, SLOT_OPERATION_CALLBACK, NULL);
     if(r == RTIMER_OK) {
       return 1;
     }
@@ -612,6 +621,11 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
           /* delay before TX */
           TSCH_SCHEDULE_AND_YIELD(pt, t, current_slot_start, tsch_timing[tsch_ts_tx_offset] - RADIO_DELAY_BEFORE_TX, "TxBeforeTx");
           TSCH_DEBUG_TX_EVENT();
+#if ENERGEST_WITH_CONTEXTS
+          /* Charge the transmission to the context the packet comes from */
+          energest_context_set(queuebuf_attr(current_packet->qb,
+                                             PACKETBUF_ATTR_ENERGEST_CONTEXT));
+#endif /* ENERGEST_WITH_CONTEXTS */
           /* send packet already in radio tx buffer */
           mac_tx_status = NETSTACK_RADIO.transmit(packet_len);
           tx_count++;
@@ -1191,6 +1205,17 @@ PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
   PT_END(&slot_operation_pt);
 }
 /*---------------------------------------------------------------------------*/
+#if ENERGEST_WITH_CONTEXTS
+/* Run each step of the slot operation in the MAC energy context */
+static void
+slot_operation_callback(struct rtimer *t, void *ptr)
+{
+  energest_context_push(ENERGEST_CONTEXT_MAC);
+  tsch_slot_operation(t, ptr);
+  energest_context_pop();
+}
+#endif /* ENERGEST_WITH_CONTEXTS */
+/*---------------------------------------------------------------------------*/
 /* Set global time before starting slot operation,
  * with a rtimer time and an ASN */
 void
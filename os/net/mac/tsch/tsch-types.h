@@ -91,6 +91,12 @@ struct tsch_slotframe {
   struct tsch_asn_divisor_t size;
   /* List of links belonging to this slotframe */
   LIST_STRUCT(links_list);
+#if TSCH_SCHEDULE_INDEXED
+  /* The same links sorted by timeslot, and within a timeslot in the
+   * order of links_list */
+  struct tsch_link *links_by_timeslot[TSCH_SCHEDULE_MAX_LINKS];
+  uint16_t links_count;
+#endif /* TSCH_SCHEDULE_INDEXED */
 };
 
 /** \brief TSCH packet information */
@@ -118,6 +124,11 @@ struct tsch_neighbor {
   struct tsch_packet *tx_array[TSCH_QUEUE_NUM_PER_NEIGHBOR];
   /* Circular buffer of pointers to packet. */
   struct ringbufindex tx_ringbuf;
+#if TSCH_QUEUE_WITH_ACTIVE_LIST
+  /* Next neighbor in the circular list of neighbors with queued packets */
+  struct tsch_neighbor *next_active;
+  uint8_t is_active; /* is this neighbor in the active list? */
+#endif /* TSCH_QUEUE_WITH_ACTIVE_LIST */
 };
 
 /** \brief TSCH timeslot timing elements. Used to index timeslot timing
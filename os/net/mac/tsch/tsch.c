@@ -319,6 +319,10 @@ keepalive_send(void *ptr)
         /* Simply send an empty packet */
         packetbuf_clear();
         packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, destination);
+#if ENERGEST_WITH_CONTEXTS
+        packetbuf_set_attr(PACKETBUF_ATTR_ENERGEST_CONTEXT,
+                           ENERGEST_CONTEXT_MAC);
+#endif /* ENERGEST_WITH_CONTEXTS */
         NETSTACK_MAC.send(keepalive_packet_sent, NULL);
         LOG_INFO("sending KA to ");
         LOG_INFO_LLADDR(destination);
@@ -870,6 +874,8 @@ PROCESS_THREAD(tsch_process, ev, data)
 
   PROCESS_BEGIN();
 
+  process_set_priority(&tsch_process, PROCESS_PRIORITY_HIGH);
+
   while(1) {
 
     while(!tsch_is_associated) {
@@ -944,6 +950,10 @@ PROCESS_THREAD(tsch_send_eb_process, ev, data)
       /* Prepare the EB packet and schedule it to be sent */
       if(tsch_packet_create_eb(&hdr_len, &tsch_sync_ie_offset) > 0) {
         struct tsch_packet *p;
+#if ENERGEST_WITH_CONTEXTS
+        packetbuf_set_attr(PACKETBUF_ATTR_ENERGEST_CONTEXT,
+                           ENERGEST_CONTEXT_MAC_BEACON);
+#endif /* ENERGEST_WITH_CONTEXTS */
         /* Enqueue EB packet, for a single transmission only */
         if(!(p = tsch_queue_add_packet(&tsch_eb_address, 1, NULL, NULL))) {
           LOG_ERR("! could not enqueue EB packet\n");
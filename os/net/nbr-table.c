@@ -70,6 +70,41 @@ static unsigned num_tables;
 MEMB(neighbor_addr_mem, nbr_table_key_t, NBR_TABLE_MAX_NEIGHBORS);
 LIST(nbr_table_keys);
 
+#if NBR_TABLE_HASH_INDEX
+/* The number of slots in the hash index, which must be a power of two.
+ * By default, it is at least twice the number of neighbors to keep the
+ * probe sequences short. */
+#ifdef NBR_TABLE_CONF_HASH_SIZE
+#define HASH_SIZE NBR_TABLE_CONF_HASH_SIZE
+#elif NBR_TABLE_MAX_NEIGHBORS <= 8
+#define HASH_SIZE 16
+#elif NBR_TABLE_MAX_NEIGHBORS <= 16
+#define HASH_SIZE 32
+#elif NBR_TABLE_MAX_NEIGHBORS <= 32
+#define HASH_SIZE 64
+#elif NBR_TABLE_MAX_NEIGHBORS <= 64
+#define HASH_SIZE 128
+#elif NBR_TABLE_MAX_NEIGHBORS <= 128
+#define HASH_SIZE 256
+#elif NBR_TABLE_MAX_NEIGHBORS <= 256
+#define HASH_SIZE 512
+#elif NBR_TABLE_MAX_NEIGHBORS <= 512
+#define HASH_SIZE 1024
+#else
+#error Set NBR_TABLE_CONF_HASH_SIZE for this number of neighbors
+#endif
+
+#if HASH_SIZE <= NBR_TABLE_MAX_NEIGHBORS || (HASH_SIZE & (HASH_SIZE - 1))
+#error NBR_TABLE_CONF_HASH_SIZE must be a power of two larger than NBR_TABLE_MAX_NEIGHBORS
+#endif
+
+/* Each slot holds a neighbor index plus one, so that zero marks an
+ * empty slot. Linear probing is used, and removals shift the following
+ * entries backward instead of leaving tombstones. */
+static uint16_t hash_slots[HASH_SIZE];
+static nbr_table_hash_stats_t hash_stats;
+#endif /* NBR_TABLE_HASH_INDEX */
+
 /*---------------------------------------------------------------------------*/
 static void remove_key(nbr_table_key_t *key, bool do_free);
 /*---------------------------------------------------------------------------*/
@@ -115,24 +150,115 @@ key_from_item(const nbr_table_t *table, const nbr_table_item_t *item)
   return key_from_index(index_from_item(table, item));
 }
 /*---------------------------------------------------------------------------*/
+#if NBR_TABLE_HASH_INDEX
+/* Get the home slot of a link-layer address in the hash index */
+static unsigned
+hash_home(const linkaddr_t *lladdr)
+{
+  uint32_t h = 2166136261UL;
+  int i;
+
+  /* FNV-1a */
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    h = (h ^ lladdr->u8[i]) * 16777619UL;
+  }
+  return (h ^ (h >> 16)) & (HASH_SIZE - 1);
+}
+/*---------------------------------------------------------------------------*/
+/* Get the slot that holds a link-layer address, or the empty slot where
+ * it would be inserted */
+static unsigned
+hash_find_slot(const linkaddr_t *lladdr, uint16_t *probes)
+{
+  unsigned slot;
+
+  *probes = 0;
+  for(slot = hash_home(lladdr); hash_slots[slot] != 0;
+      slot = (slot + 1) & (HASH_SIZE - 1)) {
+    (*probes)++;
+    if(linkaddr_cmp(lladdr, &key_from_index(hash_slots[slot] - 1)->lladdr)) {
+      break;
+    }
+  }
+  return slot;
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_insert(const nbr_table_key_t *key)
+{
+  uint16_t probes;
+
+  hash_slots[hash_find_slot(&key->lladdr, &probes)] = index_from_key(key) + 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_remove(const nbr_table_key_t *key)
+{
+  unsigned hole, slot, home;
+  uint16_t probes;
+
+  hole = hash_find_slot(&key->lladdr, &probes);
+  if(hash_slots[hole] == 0) {
+    return;
+  }
+
+  /* Shift back the entries of the probe sequence that follows the hole,
+   * unless their home slot lies cyclically within (hole, slot]. */
+  for(slot = (hole + 1) & (HASH_SIZE - 1); hash_slots[slot] != 0;
+      slot = (slot + 1) & (HASH_SIZE - 1)) {
+    home = hash_home(&key_from_index(hash_slots[slot] - 1)->lladdr);
+    if(hole < slot ? (home <= hole || home > slot)
+                   : (home <= hole && home > slot)) {
+      hash_slots[hole] = hash_slots[slot];
+      hole = slot;
+    }
+  }
+  hash_slots[hole] = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+nbr_table_hash_stats(nbr_table_hash_stats_t *stats)
+{
+  *stats = hash_stats;
+}
+/*---------------------------------------------------------------------------*/
+void
+nbr_table_hash_stats_reset(void)
+{
+  memset(&hash_stats, 0, sizeof(hash_stats));
+}
+#endif /* NBR_TABLE_HASH_INDEX */
+/*---------------------------------------------------------------------------*/
 /* Get the index of a neighbor from its link-layer address */
 static int
 index_from_lladdr(const linkaddr_t *lladdr)
 {
-  nbr_table_key_t *key;
   /* Allow lladdr-free insertion, useful e.g. for IPv6 ND.
    * Only one such entry is possible at a time, indexed by linkaddr_null. */
   if(lladdr == NULL) {
     lladdr = &linkaddr_null;
   }
+#if NBR_TABLE_HASH_INDEX
+  uint16_t probes;
+  unsigned slot = hash_find_slot(lladdr, &probes);
+
+  hash_stats.lookups++;
+  hash_stats.probes += probes;
+  if(probes > hash_stats.max_probes) {
+    hash_stats.max_probes = probes;
+  }
+  return (int)hash_slots[slot] - 1;
+#else /* NBR_TABLE_HASH_INDEX */
+  nbr_table_key_t *key;
   key = list_head(nbr_table_keys);
   while(key != NULL) {
-    if(lladdr && linkaddr_cmp(lladdr, &key->lladdr)) {
+    if(linkaddr_cmp(lladdr, &key->lladdr)) {
       return index_from_key(key);
     }
     key = list_item_next(key);
   }
   return -1;
+#endif /* NBR_TABLE_HASH_INDEX */
 }
 /*---------------------------------------------------------------------------*/
 /* Get bit from "used" or "locked" bitmap */
@@ -183,6 +309,9 @@ remove_key(nbr_table_key_t *key, bool do_free)
   locked_map[index_from_key(key)] = 0;
   /* Remove neighbor from list */
   list_remove(nbr_table_keys, key);
+#if NBR_TABLE_HASH_INDEX
+  hash_remove(key);
+#endif /* NBR_TABLE_HASH_INDEX */
   if(do_free) {
     /* Release the memory */
     memb_free(&neighbor_addr_mem, key);
@@ -430,6 +559,9 @@ nbr_table_add_lladdr(const nbr_table_t *table, const linkaddr_t *lladdr,
 
     /* Set link-layer address */
     linkaddr_copy(&key->lladdr, lladdr);
+#if NBR_TABLE_HASH_INDEX
+    hash_insert(key);
+#endif /* NBR_TABLE_HASH_INDEX */
   }
 
   /* Get item in the current table */
@@ -55,6 +55,14 @@ typedef enum {
 
 #define NBR_TABLE_MAX_NEIGHBORS NBR_TABLE_CONF_MAX_NEIGHBORS
 
+/* Index the neighbor keys with an open-addressing hash table, so that
+ * link-layer address lookups do not have to walk the key list. */
+#ifdef NBR_TABLE_CONF_HASH_INDEX
+#define NBR_TABLE_HASH_INDEX NBR_TABLE_CONF_HASH_INDEX
+#else /* NBR_TABLE_CONF_HASH_INDEX */
+#define NBR_TABLE_HASH_INDEX 0
+#endif /* NBR_TABLE_CONF_HASH_INDEX */
+
 #ifdef NBR_TABLE_CONF_GC_GET_WORST
 #define NBR_TABLE_GC_GET_WORST NBR_TABLE_CONF_GC_GET_WORST
 #else /* NBR_TABLE_CONF_GC_GET_WORST */
@@ -151,4 +159,22 @@ nbr_table_key_t *nbr_table_key_next(const nbr_table_key_t *key);
 int nbr_table_count_entries(void);
 
 /** @} */
+
+#if NBR_TABLE_HASH_INDEX
+/** \brief Statistics of the link-layer address hash index */
+typedef struct nbr_table_hash_stats {
+  /* The number of lookups by link-layer address */
+  uint32_t lookups;
+  /* The total number of hash slots probed by the lookups */
+  uint32_t probes;
+  /* The longest probe sequence of a single lookup */
+  uint16_t max_probes;
+} nbr_table_hash_stats_t;
+
+/** \name Neighbor tables: hash index statistics */
+/** @{ */
+void nbr_table_hash_stats(nbr_table_hash_stats_t *stats);
+void nbr_table_hash_stats_reset(void);
+/** @} */
+#endif /* NBR_TABLE_HASH_INDEX */
 #endif /* NBR_TABLE_H_ */
@@ -93,6 +93,10 @@ output(const linkaddr_t *dest)
     packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &linkaddr_null);
   }
   packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
+#if ENERGEST_WITH_CONTEXTS
+  packetbuf_set_attr(PACKETBUF_ATTR_ENERGEST_CONTEXT,
+                     ENERGEST_CONTEXT_CURRENT());
+#endif /* ENERGEST_WITH_CONTEXTS */
   LOG_INFO("sending %u bytes to ", packetbuf_datalen());
   LOG_INFO_LLADDR(packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
   LOG_INFO_("\n");
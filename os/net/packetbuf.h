@@ -57,6 +57,7 @@
 #include "net/mac/llsec802154.h"
 #include "net/mac/csma/csma-security.h"
 #include "net/mac/tsch/tsch-conf.h"
+#include "sys/energest.h"
 
 /**
  * \brief      The size of the packetbuf, in bytes
@@ -217,6 +218,9 @@ enum {
   PACKETBUF_ATTR_MAC_METADATA,
   PACKETBUF_ATTR_MAC_NO_SRC_ADDR,
   PACKETBUF_ATTR_MAC_NO_DEST_ADDR,
+#if ENERGEST_WITH_CONTEXTS
+  PACKETBUF_ATTR_ENERGEST_CONTEXT,
+#endif /* ENERGEST_WITH_CONTEXTS */
 #if TSCH_WITH_LINK_SELECTOR
   PACKETBUF_ATTR_TSCH_SLOTFRAME,
   PACKETBUF_ATTR_TSCH_TIMESLOT,
@@ -390,6 +390,10 @@ insert_srh_header(void)
   uip_sr_node_t *node;
   rpl_dag_t *dag;
   uip_ipaddr_t node_addr;
+#if UIP_SR_SRH_CACHE_SIZE
+  const uint8_t *cached_hdr;
+  int cached_len;
+#endif /* UIP_SR_SRH_CACHE_SIZE */
 
   /* Always insert the SRH as the first extension header. */
   struct uip_routing_hdr *rh_hdr = (struct uip_routing_hdr *)UIP_IP_PAYLOAD(0);
@@ -409,6 +413,14 @@ insert_srh_header(void)
     return 0;
   }
 
+#if UIP_SR_SRH_CACHE_SIZE
+  cached_len = uip_sr_srh_cache_lookup(dag, &UIP_IP_BUF->destipaddr,
+                                       &node_addr, &cached_hdr);
+  if(cached_len >= 0) {
+    return uip_sr_insert_cached_srh(cached_hdr, cached_len, &node_addr);
+  }
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+
   dest_node = uip_sr_get_node(dag, &UIP_IP_BUF->destipaddr);
   if(dest_node == NULL) {
     /* The destination was not found, skip SRH insertion. */
@@ -435,6 +447,10 @@ insert_srh_header(void)
 
   if(node == root_node) {
     LOG_DBG("SRH no need to insert SRH\n");
+#if UIP_SR_SRH_CACHE_SIZE
+    uip_sr_srh_cache_add(dag, &UIP_IP_BUF->destipaddr,
+                         &UIP_IP_BUF->destipaddr, NULL, 0);
+#endif /* UIP_SR_SRH_CACHE_SIZE */
     return 1;
   }
 
@@ -508,6 +524,10 @@ insert_srh_header(void)
   /* The next hop (i.e. node whose parent is the root) is placed as
      the current IPv6 destination. */
   NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
+#if UIP_SR_SRH_CACHE_SIZE
+  uip_sr_srh_cache_add(dag, &UIP_IP_BUF->destipaddr, &node_addr,
+                       (const uint8_t *)rh_hdr, ext_len);
+#endif /* UIP_SR_SRH_CACHE_SIZE */
   uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &node_addr);
 
   /* Update the IPv6 length field. */
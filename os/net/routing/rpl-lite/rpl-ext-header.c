@@ -260,6 +260,10 @@ insert_srh_header(void)
   uip_sr_node_t *root_node;
   uip_sr_node_t *node;
   uip_ipaddr_t node_addr;
+#if UIP_SR_SRH_CACHE_SIZE
+  const uint8_t *cached_hdr;
+  int cached_len;
+#endif /* UIP_SR_SRH_CACHE_SIZE */
 
   /* Always insest SRH as first extension header */
   struct uip_routing_hdr *rh_hdr = (struct uip_routing_hdr *)UIP_IP_PAYLOAD(0);
@@ -279,6 +283,14 @@ insert_srh_header(void)
     return 1;
   }
 
+#if UIP_SR_SRH_CACHE_SIZE
+  cached_len = uip_sr_srh_cache_lookup(NULL, &UIP_IP_BUF->destipaddr,
+                                       &node_addr, &cached_hdr);
+  if(cached_len >= 0) {
+    return uip_sr_insert_cached_srh(cached_hdr, cached_len, &node_addr);
+  }
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+
   dest_node = uip_sr_get_node(NULL, &UIP_IP_BUF->destipaddr);
   if(dest_node == NULL) {
     /* The destination is not found, skip SRH insertion */
@@ -374,6 +386,10 @@ insert_srh_header(void)
 
   /* The next hop (i.e. node whose parent is the root) is placed as the current IPv6 destination */
   NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
+#if UIP_SR_SRH_CACHE_SIZE
+  uip_sr_srh_cache_add(NULL, &UIP_IP_BUF->destipaddr, &node_addr,
+                       (const uint8_t *)rh_hdr, ext_len);
+#endif /* UIP_SR_SRH_CACHE_SIZE */
   uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &node_addr);
 
   /* Update the IPv6 length field */
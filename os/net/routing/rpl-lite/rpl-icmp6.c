@@ -48,6 +48,7 @@
 #include "net/ipv6/uip-icmp6.h"
 #include "net/packetbuf.h"
 #include "lib/random.h"
+#include "sys/energest.h"
 
 #include <inttypes.h>
 #include <limits.h>
@@ -69,16 +70,43 @@ static void dio_input(void);
 static void dao_input(void);
 
 /*---------------------------------------------------------------------------*/
+#if ENERGEST_WITH_CONTEXTS
+/* Account the processing of incoming RPL messages to the RPL context */
+#define RPL_ICMP6_HANDLER(name, code, input)                    \
+  static void                                                   \
+  input##_energest(void)                                        \
+  {                                                             \
+    energest_context_push(ENERGEST_CONTEXT_RPL);                \
+    input();                                                    \
+    energest_context_pop();                                     \
+  }                                                             \
+  UIP_ICMP6_HANDLER(name, ICMP6_RPL, code, input##_energest)
+#else /* ENERGEST_WITH_CONTEXTS */
+#define RPL_ICMP6_HANDLER(name, code, input)                    \
+  UIP_ICMP6_HANDLER(name, ICMP6_RPL, code, input)
+#endif /* ENERGEST_WITH_CONTEXTS */
+
 /* Initialize RPL ICMPv6 message handlers */
-UIP_ICMP6_HANDLER(dis_handler, ICMP6_RPL, RPL_CODE_DIS, dis_input);
-UIP_ICMP6_HANDLER(dio_handler, ICMP6_RPL, RPL_CODE_DIO, dio_input);
-UIP_ICMP6_HANDLER(dao_handler, ICMP6_RPL, RPL_CODE_DAO, dao_input);
+RPL_ICMP6_HANDLER(dis_handler, RPL_CODE_DIS, dis_input);
+RPL_ICMP6_HANDLER(dio_handler, RPL_CODE_DIO, dio_input);
+RPL_ICMP6_HANDLER(dao_handler, RPL_CODE_DAO, dao_input);
 
 #if RPL_WITH_DAO_ACK
 static void dao_ack_input(void);
-UIP_ICMP6_HANDLER(dao_ack_handler, ICMP6_RPL, RPL_CODE_DAO_ACK, dao_ack_input);
+RPL_ICMP6_HANDLER(dao_ack_handler, RPL_CODE_DAO_ACK, dao_ack_input);
 #endif /* RPL_WITH_DAO_ACK */
 
+/*---------------------------------------------------------------------------*/
+static void
+rpl_icmp6_send(const uip_ipaddr_t *dest, int code, int payload_len)
+{
+  /* The packet is handed to the MAC layer with the current energest
+   * context, so that its transmission is accounted to RPL */
+  energest_context_push(ENERGEST_CONTEXT_RPL);
+  uip_icmp6_send(dest, ICMP6_RPL, code, payload_len);
+  energest_context_pop();
+}
+
 /*---------------------------------------------------------------------------*/
 static uint32_t
 get32(uint8_t *buffer, int pos)
@@ -166,7 +194,7 @@ rpl_icmp6_dis_output(uip_ipaddr_t *addr)
   LOG_INFO_6ADDR(addr);
   LOG_INFO_("\n");
 
-  uip_icmp6_send(addr, ICMP6_RPL, RPL_CODE_DIS, 2);
+  rpl_icmp6_send(addr, RPL_CODE_DIS, 2);
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -467,7 +495,7 @@ rpl_icmp6_dio_output(uip_ipaddr_t *uc_addr)
   LOG_INFO_6ADDR(addr);
   LOG_INFO_("\n");
 
-  uip_icmp6_send(addr, ICMP6_RPL, RPL_CODE_DIO, pos);
+  rpl_icmp6_send(addr, RPL_CODE_DIO, pos);
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -666,7 +694,7 @@ rpl_icmp6_dao_output(uint8_t lifetime)
   LOG_INFO_("\n");
 
   /* Send DAO to root (IPv6 address is DAG ID) */
-  uip_icmp6_send(&curr_instance.dag.dag_id, ICMP6_RPL, RPL_CODE_DAO, pos);
+  rpl_icmp6_send(&curr_instance.dag.dag_id, RPL_CODE_DAO, pos);
 }
 #if RPL_WITH_DAO_ACK
 /*---------------------------------------------------------------------------*/
@@ -720,7 +748,7 @@ rpl_icmp6_dao_ack_output(uip_ipaddr_t *dest, uint8_t sequence, uint8_t status)
   LOG_INFO_6ADDR(dest);
   LOG_INFO_(" with status %d\n", status);
 
-  uip_icmp6_send(dest, ICMP6_RPL, RPL_CODE_DAO_ACK, 4);
+  rpl_icmp6_send(dest, RPL_CODE_DAO_ACK, 4);
 }
 #endif /* RPL_WITH_DAO_ACK */
 /*---------------------------------------------------------------------------*/
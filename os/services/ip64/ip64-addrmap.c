@@ -32,7 +32,6 @@
 #include "ip64/ip64-addrmap.h"
 #include "ip64/ip64.h"
 #include "lib/memb.h"
-#include "lib/list.h"
 #include "ip64-conf.h"
 #include "lib/random.h"
 
@@ -52,77 +51,226 @@
 #define NUM_ENTRIES 32
 #endif /* IP64_ADDRMAP_CONF_ENTRIES */
 
-MEMB(entrymemb, struct ip64_addrmap_entry, NUM_ENTRIES);
-LIST(entrylist);
+/* Mappings are found through two hash tables: one by the tuple seen
+   from the IPv6 network, and one by the mapped port. */
+#ifdef IP64_ADDRMAP_CONF_BUCKETS
+#define NUM_BUCKETS IP64_ADDRMAP_CONF_BUCKETS
+#else /* IP64_ADDRMAP_CONF_BUCKETS */
+#define NUM_BUCKETS ((NUM_ENTRIES + 1) / 2)
+#endif /* IP64_ADDRMAP_CONF_BUCKETS */
+
+/* Mappings are aged on a timer wheel. Each slot covers WHEEL_TICK
+   clock ticks, and holds the mappings that expire during them, in
+   this or a later turn of the wheel. */
+#ifdef IP64_ADDRMAP_CONF_WHEEL_SLOTS
+#define WHEEL_SLOTS IP64_ADDRMAP_CONF_WHEEL_SLOTS
+#else /* IP64_ADDRMAP_CONF_WHEEL_SLOTS */
+#define WHEEL_SLOTS 64
+#endif /* IP64_ADDRMAP_CONF_WHEEL_SLOTS */
+
+#ifdef IP64_ADDRMAP_CONF_WHEEL_TICK
+#define WHEEL_TICK IP64_ADDRMAP_CONF_WHEEL_TICK
+#else /* IP64_ADDRMAP_CONF_WHEEL_TICK */
+#define WHEEL_TICK CLOCK_SECOND
+#endif /* IP64_ADDRMAP_CONF_WHEEL_TICK */
 
 #define FIRST_MAPPED_PORT 10000
 #define LAST_MAPPED_PORT  20000
+
+#if NUM_ENTRIES >= LAST_MAPPED_PORT - FIRST_MAPPED_PORT
+#error IP64_ADDRMAP_CONF_ENTRIES exceeds the number of mapped ports
+#endif
+
+MEMB(entrymemb, struct ip64_addrmap_entry, NUM_ENTRIES);
+
+static struct ip64_addrmap_entry *tuple_table[NUM_BUCKETS];
+static struct ip64_addrmap_entry *port_table[NUM_BUCKETS];
+static struct ip64_addrmap_entry *wheel[WHEEL_SLOTS];
+
+/* The first wheel tick that has not been aged yet */
+static clock_time_t wheel_time;
+
 static uint16_t mapped_port = FIRST_MAPPED_PORT;
 
+/*---------------------------------------------------------------------------*/
+static uint16_t
+tuple_hash(const uip_ip6addr_t *ip6addr, uint16_t ip6port,
+           const uip_ip4addr_t *ip4addr, uint16_t ip4port,
+           uint8_t protocol)
+{
+  uint32_t h;
+  int i;
+
+  h = protocol;
+  for(i = 0; i < 8; i++) {
+    h = h * 31 + ip6addr->u16[i];
+  }
+  h = h * 31 + ip4addr->u16[0];
+  h = h * 31 + ip4addr->u16[1];
+  h = h * 31 + ip6port;
+  h = h * 31 + ip4port;
+
+  /* Mix the high bits into the low ones */
+  h ^= h >> 16;
+  h *= 0x45d9f3b;
+  h ^= h >> 16;
+  return h % NUM_BUCKETS;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+entry_tuple_hash(const struct ip64_addrmap_entry *m)
+{
+  return tuple_hash(&m->ip6addr, m->ip6port, &m->ip4addr, m->ip4port,
+                    m->protocol);
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+expiry_slot(struct timer *t)
+{
+  return ((t->start + t->interval) / WHEEL_TICK) % WHEEL_SLOTS;
+}
+/*---------------------------------------------------------------------------*/
+static void
+wheel_add(struct ip64_addrmap_entry *m)
+{
+  m->slot = expiry_slot(&m->timer);
+  m->prev = NULL;
+  m->next = wheel[m->slot];
+  if(m->next != NULL) {
+    m->next->prev = m;
+  }
+  wheel[m->slot] = m;
+}
+/*---------------------------------------------------------------------------*/
+static void
+wheel_remove(struct ip64_addrmap_entry *m)
+{
+  if(m->prev != NULL) {
+    m->prev->next = m->next;
+  } else {
+    wheel[m->slot] = m->next;
+  }
+  if(m->next != NULL) {
+    m->next->prev = m->prev;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_entry(struct ip64_addrmap_entry *m)
+{
+  struct ip64_addrmap_entry **p;
+
+  wheel_remove(m);
+  for(p = &tuple_table[entry_tuple_hash(m)]; *p != m; p = &(*p)->tuple_next);
+  *p = m->tuple_next;
+  for(p = &port_table[m->mapped_port % NUM_BUCKETS]; *p != m;
+      p = &(*p)->port_next);
+  *p = m->port_next;
+  memb_free(&entrymemb, m);
+}
 /*---------------------------------------------------------------------------*/
 struct ip64_addrmap_entry *
 ip64_addrmap_list(void)
 {
-  return list_head(entrylist);
+  int i;
+
+  for(i = 0; i < WHEEL_SLOTS; i++) {
+    if(wheel[i] != NULL) {
+      return wheel[i];
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+struct ip64_addrmap_entry *
+ip64_addrmap_next(struct ip64_addrmap_entry *e)
+{
+  int i;
+
+  if(e->next != NULL) {
+    return e->next;
+  }
+  for(i = e->slot + 1; i < WHEEL_SLOTS; i++) {
+    if(wheel[i] != NULL) {
+      return wheel[i];
+    }
+  }
+  return NULL;
 }
 /*---------------------------------------------------------------------------*/
 void
 ip64_addrmap_init(void)
 {
   memb_init(&entrymemb);
-  list_init(entrylist);
+  memset(tuple_table, 0, sizeof(tuple_table));
+  memset(port_table, 0, sizeof(port_table));
+  memset(wheel, 0, sizeof(wheel));
+  wheel_time = clock_time() / WHEEL_TICK;
   mapped_port = FIRST_MAPPED_PORT;
 }
 /*---------------------------------------------------------------------------*/
 static void
 check_age(void)
 {
-  struct ip64_addrmap_entry *m;
+  struct ip64_addrmap_entry *m, *next;
+  clock_time_t now;
+  int n;
 
-  /* Walk through the list of address mappings, throw away the ones
-     that are too old. */
-  m = list_head(entrylist);
-  while(m != NULL) {
-    if(timer_expired(&m->timer)) {
-      list_remove(entrylist, m);
-      memb_free(&entrymemb, m);
-      m = list_head(entrylist);
-    } else {
-      m = list_item_next(m);
+  /* Throw away the mappings that are too old. Only the slots of the
+     wheel ticks that have passed since the last time are visited, at
+     most one turn of the wheel. */
+  now = clock_time() / WHEEL_TICK;
+  for(n = 0; wheel_time != now && n < WHEEL_SLOTS; n++, wheel_time++) {
+    for(m = wheel[wheel_time % WHEEL_SLOTS]; m != NULL; m = next) {
+      next = m->next;
+      if(timer_expired(&m->timer)) {
+        remove_entry(m);
+      }
     }
   }
+  wheel_time = now;
+}
+/*---------------------------------------------------------------------------*/
+static clock_time_t
+remaining(struct ip64_addrmap_entry *m)
+{
+  return timer_expired(&m->timer) ? 0 : timer_remaining(&m->timer);
 }
 /*---------------------------------------------------------------------------*/
 static int
 recycle(void)
 {
   /* Find the oldest recyclable mapping and remove it. */
-  struct ip64_addrmap_entry *m, *oldest;
-
-  /* Walk through the list of address mappings, throw away the ones
-     that are too old. */
+  struct ip64_addrmap_entry *m, *oldest, *later;
+  int i;
 
+  /* The wheel orders the mappings by their expiry time, so walk it
+     from the current slot on until a slot has a recyclable mapping
+     that expires during this turn. Mappings of later turns are only
+     used if there is no such mapping. */
   oldest = NULL;
-  for(m = list_head(entrylist);
-      m != NULL;
-      m = list_item_next(m)) {
-    if(m->flags & FLAGS_RECYCLABLE) {
-      if(oldest == NULL) {
-        oldest = m;
-      } else {
-        if(timer_remaining(&m->timer) <
-           timer_remaining(&oldest->timer)) {
-          oldest = m;
+  later = NULL;
+  for(i = 0; i < WHEEL_SLOTS && oldest == NULL; i++) {
+    for(m = wheel[(wheel_time + i) % WHEEL_SLOTS]; m != NULL; m = m->next) {
+      if(m->flags & FLAGS_RECYCLABLE) {
+        if(remaining(m) < (clock_time_t)WHEEL_SLOTS * WHEEL_TICK) {
+          if(oldest == NULL || remaining(m) < remaining(oldest)) {
+            oldest = m;
+          }
+        } else if(later == NULL || remaining(m) < remaining(later)) {
+          later = m;
         }
       }
     }
   }
+  if(oldest == NULL) {
+    oldest = later;
+  }
 
   /* If we found an oldest recyclable entry, remove it and return
      non-zero. */
   if(oldest != NULL) {
-    list_remove(entrylist, oldest);
-    memb_free(&entrymemb, oldest);
+    remove_entry(oldest);
     return 1;
   }
 
@@ -141,18 +289,19 @@ ip64_addrmap_lookup(const uip_ip6addr_t *ip6addr,
   LOG_DBG("lookup ip4port %d ip6port %d\n", uip_htons(ip4port),
 	 uip_htons(ip6port));
   check_age();
-  for(m = list_head(entrylist); m != NULL; m = list_item_next(m)) {
-    LOG_DBG("protocol %d %d, ip4port %d %d, ip6port %d %d, ip4 %d ip6 %d\n",
-	   m->protocol, protocol,
-	   m->ip4port, ip4port,
-	   m->ip6port, ip6port,
-	   uip_ip4addr_cmp(&m->ip4addr, ip4addr),
-	   uip_ip6addr_cmp(&m->ip6addr, ip6addr));
+  for(m = tuple_table[tuple_hash(ip6addr, ip6port, ip4addr, ip4port,
+                                 protocol)];
+      m != NULL; m = m->tuple_next) {
     if(m->protocol == protocol &&
        m->ip4port == ip4port &&
        m->ip6port == ip6port &&
        uip_ip4addr_cmp(&m->ip4addr, ip4addr) &&
        uip_ip6addr_cmp(&m->ip6addr, ip6addr)) {
+      if(timer_expired(&m->timer)) {
+        /* Expired during the current wheel tick */
+        remove_entry(m);
+        return NULL;
+      }
       m->ip6to4++;
       return m;
     }
@@ -166,12 +315,17 @@ ip64_addrmap_lookup_port(uint16_t mapped_port, uint8_t protocol)
   struct ip64_addrmap_entry *m;
 
   check_age();
-  for(m = list_head(entrylist); m != NULL; m = list_item_next(m)) {
+  for(m = port_table[mapped_port % NUM_BUCKETS]; m != NULL;
+      m = m->port_next) {
     LOG_DBG("mapped port %d %d, protocol %d %d\n",
 	   m->mapped_port, mapped_port,
 	   m->protocol, protocol);
     if(m->mapped_port == mapped_port &&
        m->protocol == protocol) {
+      if(timer_expired(&m->timer)) {
+        remove_entry(m);
+        return NULL;
+      }
       m->ip4to6++;
       return m;
     }
@@ -179,6 +333,19 @@ ip64_addrmap_lookup_port(uint16_t mapped_port, uint8_t protocol)
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+static int
+port_in_use(uint16_t port)
+{
+  struct ip64_addrmap_entry *m;
+
+  for(m = port_table[port % NUM_BUCKETS]; m != NULL; m = m->port_next) {
+    if(m->mapped_port == port) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
 static void
 increase_mapped_port(void)
 {
@@ -194,6 +361,7 @@ ip64_addrmap_create(const uip_ip6addr_t *ip6addr,
 		    uint8_t protocol)
 {
   struct ip64_addrmap_entry *m;
+  uint16_t h;
 
   check_age();
   m = memb_alloc(&entrymemb);
@@ -218,22 +386,18 @@ ip64_addrmap_create(const uip_ip6addr_t *ip6addr,
     /* Pick a new, unused local port. First make sure that the
        mapped_port number does not belong to any active connection. If
        so, we keep increasing the mapped_port until we're free. */
-    {
-      struct ip64_addrmap_entry *n;
-      n = list_head(entrylist);
-      while(n != NULL) {
-	if(n->mapped_port == mapped_port) {
-	  increase_mapped_port();
-	  n = list_head(entrylist);
-	} else {
-	  n = list_item_next(m);
-	}
-      }
+    while(port_in_use(mapped_port)) {
+      increase_mapped_port();
     }
     m->mapped_port = mapped_port;
     increase_mapped_port();
 
-    list_add(entrylist, m);
+    h = tuple_hash(ip6addr, ip6port, ip4addr, ip4port, protocol);
+    m->tuple_next = tuple_table[h];
+    tuple_table[h] = m;
+    m->port_next = port_table[m->mapped_port % NUM_BUCKETS];
+    port_table[m->mapped_port % NUM_BUCKETS] = m;
+    wheel_add(m);
     return m;
   }
   return NULL;
@@ -245,6 +409,10 @@ ip64_addrmap_set_lifetime(struct ip64_addrmap_entry *e,
 {
   if(e != NULL) {
     timer_set(&e->timer, time);
+    if(expiry_slot(&e->timer) != e->slot) {
+      wheel_remove(e);
+      wheel_add(e);
+    }
   }
 }
 /*---------------------------------------------------------------------------*/
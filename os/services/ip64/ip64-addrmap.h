@@ -37,7 +37,9 @@
 #include "net/ipv6/uip.h"
 
 struct ip64_addrmap_entry {
-  struct ip64_addrmap_entry *next;
+  /* Links in the timer wheel slot and the two hash chains */
+  struct ip64_addrmap_entry *next, *prev;
+  struct ip64_addrmap_entry *tuple_next, *port_next;
   struct timer timer;
   uip_ip6addr_t ip6addr;
   uip_ip4addr_t ip4addr;
@@ -45,6 +47,7 @@ struct ip64_addrmap_entry {
   uint16_t mapped_port;
   uint16_t ip6port;
   uint16_t ip4port;
+  uint16_t slot;
   uint8_t protocol;
   uint8_t flags;
 };
@@ -97,7 +100,13 @@ void ip64_addrmap_set_lifetime(struct ip64_addrmap_entry *e,
 void ip64_addrmap_set_recycleble(struct ip64_addrmap_entry *e);
 
 /**
- * Obtain the list of all address mappings.
+ * Obtain the first of all address mappings, or NULL if there are
+ * none. Iterate over the others with ip64_addrmap_next().
  */
 struct ip64_addrmap_entry *ip64_addrmap_list(void);
+
+/**
+ * Obtain the address mapping after e, or NULL if e is the last one.
+ */
+struct ip64_addrmap_entry *ip64_addrmap_next(struct ip64_addrmap_entry *e);
 #endif /* IP64_ADDRMAP_H */
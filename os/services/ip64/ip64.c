@@ -61,6 +61,7 @@
 #include "ip64/ip64-slip-interface.h"
 #include "ip64/ip64-dns64.h"
 #include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-chksum.h"
 #include "ip64/ip64-ipv4-dhcp.h"
 #include "contiki-net.h"
 
@@ -267,32 +268,8 @@ ip64_set_ipv6_address(const uip_ip6addr_t *addr)
 static uint16_t
 chksum(uint16_t sum, const uint8_t *data, uint16_t len)
 {
-  uint16_t t;
-  const uint8_t *dataptr;
-  const uint8_t *last_byte;
-
-  dataptr = data;
-  last_byte = data + len - 1;
-
-  while(dataptr < last_byte) {	/* At least two more bytes */
-    t = (dataptr[0] << 8) + dataptr[1];
-    sum += t;
-    if(sum < t) {
-      sum++;		/* carry */
-    }
-    dataptr += 2;
-  }
-
-  if(dataptr == last_byte) {
-    t = (dataptr[0] << 8) + 0;
-    sum += t;
-    if(sum < t) {
-      sum++;		/* carry */
-    }
-  }
-
-  /* Return sum in host byte order. */
-  return sum;
+  /* Sum in host byte order */
+  return UIP_CHKSUM_IMPL(sum, data, len);
 }
 /*---------------------------------------------------------------------------*/
 static uint16_t
@@ -354,6 +331,21 @@ ipv6_transport_checksum(const uint8_t *packet, uint16_t len, uint8_t proto)
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
 /*---------------------------------------------------------------------------*/
+/* Sums the fields of a TCP or UDP checksum that translation changes:
+   the pseudo-header addresses, and the first three 16-bit words of the
+   transport header (the port numbers, and the UDP length). The sum is
+   returned in network byte order, for uip_chksum_update16(). */
+static uint16_t
+translated_sum(const void *addrs, uint16_t addrs_len,
+               const uint8_t *transport)
+{
+  uint16_t sum;
+
+  sum = chksum(0, addrs, addrs_len);
+  sum = chksum(sum, transport, 3 * sizeof(uint16_t));
+  return uip_htons(sum);
+}
+/*---------------------------------------------------------------------------*/
 int
 ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
 	  uint8_t *resultpacket)
@@ -366,6 +358,8 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
   struct icmpv6_hdr *icmpv6hdr;
   uint16_t ipv6len, ipv4len;
   struct ip64_addrmap_entry *m;
+  uint8_t incremental;
+  uint16_t old_sum;
 
   v6hdr = (struct ipv6_hdr *)ipv6packet;
   v4hdr = (struct ipv4_hdr *)resultpacket;
@@ -389,6 +383,14 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
   icmpv4hdr = (struct icmpv4_hdr *)&resultpacket[IPV4_HDRLEN];
   icmpv6hdr = (struct icmpv6_hdr *)&ipv6packet[IPV6_HDRLEN];
 
+  /* The payload of TCP and UDP packets is copied unmodified, so their
+     checksum only needs to be updated for the addresses and ports we
+     change (RFC 1624), unless the packet is too short to hold a
+     transport header. A wrong checksum stays wrong when updated, so
+     the packet need not be checked either. */
+  incremental = IP64_INCREMENTAL_CHECKSUM &&
+    ipv6len - IPV6_HDRLEN >= sizeof(struct udp_hdr);
+
   /* Translate the IPv6 header into an IPv4 header. */
 
   /* First the basics: the IPv4 version, header length, type of
@@ -425,7 +427,8 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
     /* Compute and check the TCP checksum - since we're going to
        recompute it ourselves, we must ensure that it was correct in
        the first place. */
-    if(ipv6_transport_checksum(ipv6packet, ipv6len,
+    if(!incremental &&
+       ipv6_transport_checksum(ipv6packet, ipv6len,
                                IP_PROTO_TCP) != 0xffff) {
       LOG_WARN("Bad TCP checksum, dropping\n");
     }
@@ -439,6 +442,7 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
     /* Check if this is a DNS request. If so, we should rewrite it
        with the DNS64 module. */
     if(udphdr->destport == UIP_HTONS(DNS_PORT)) {
+      incremental = 0;
       ip64_dns64_6to4((uint8_t *)v6hdr + IPV6_HDRLEN + sizeof(struct udp_hdr),
                       ipv6len - IPV6_HDRLEN - sizeof(struct udp_hdr),
                       (uint8_t *)udphdr + sizeof(struct udp_hdr),
@@ -447,7 +451,8 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
     /* Compute and check the UDP checksum - since we're going to
        recompute it ourselves, we must ensure that it was correct in
        the first place. */
-    if(ipv6_transport_checksum(ipv6packet, ipv6len,
+    if(!incremental &&
+       ipv6_transport_checksum(ipv6packet, ipv6len,
                                IP_PROTO_UDP) != 0xffff) {
       LOG_WARN("Bad UDP checksum, dropping\n");
     }
@@ -456,6 +461,7 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
   case IP_PROTO_ICMPV6:
     LOG_DBG("6to4: ICMPv6 header\n");
     v4hdr->proto = IP_PROTO_ICMPV4;
+    incremental = 0;
     /* Translate only ECHO_REPLY messages. */
     if(icmpv6hdr->type == ICMP6_ECHO_REPLY) {
       icmpv4hdr->type = ICMP_ECHO_REPLY;
@@ -605,21 +611,36 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
   v4hdr->ipchksum = 0;
   v4hdr->ipchksum = ~(ipv4_checksum(v4hdr));
 
-
+  if(incremental) {
+    old_sum = translated_sum(&v6hdr->srcipaddr, 2 * sizeof(uip_ip6addr_t),
+                             &ipv6packet[IPV6_HDRLEN]);
+  }
 
   /* The checksum is in different places in the different protocol
      headers, so we need to be sure that we update the correct
      field. */
   switch(v4hdr->proto) {
   case IP_PROTO_TCP:
+    if(incremental) {
+      tcphdr->tcpchksum = uip_chksum_update16(tcphdr->tcpchksum, old_sum,
+        translated_sum(&v4hdr->srcipaddr, 2 * sizeof(uip_ip4addr_t),
+                       &resultpacket[IPV4_HDRLEN]));
+      break;
+    }
     tcphdr->tcpchksum = 0;
     tcphdr->tcpchksum = ~(ipv4_transport_checksum(resultpacket, ipv4len,
 						  IP_PROTO_TCP));
     break;
   case IP_PROTO_UDP:
-    udphdr->udpchksum = 0;
-    udphdr->udpchksum = ~(ipv4_transport_checksum(resultpacket, ipv4len,
-						  IP_PROTO_UDP));
+    if(incremental) {
+      udphdr->udpchksum = uip_chksum_update16(udphdr->udpchksum, old_sum,
+        translated_sum(&v4hdr->srcipaddr, 2 * sizeof(uip_ip4addr_t),
+                       &resultpacket[IPV4_HDRLEN]));
+    } else {
+      udphdr->udpchksum = 0;
+      udphdr->udpchksum = ~(ipv4_transport_checksum(resultpacket, ipv4len,
+						    IP_PROTO_UDP));
+    }
     if(udphdr->udpchksum == 0) {
       udphdr->udpchksum = 0xffff;
     }
@@ -652,6 +673,8 @@ ip64_4to6(const uint8_t *ipv4packet, const uint16_t ipv4packet_len,
   struct icmpv6_hdr *icmpv6hdr;
   uint16_t ipv4len, ipv6len, ipv6_packet_len;
   struct ip64_addrmap_entry *m;
+  uint8_t incremental;
+  uint16_t old_sum;
 
   v6hdr = (struct ipv6_hdr *)resultpacket;
   v4hdr = (struct ipv4_hdr *)ipv4packet;
@@ -687,6 +710,11 @@ ip64_4to6(const uint8_t *ipv4packet, const uint16_t ipv4packet_len,
   ipv6len = ipv4len - IPV4_HDRLEN + IPV6_HDRLEN;
   ipv6_packet_len = ipv6len - IPV6_HDRLEN;
 
+  /* As in ip64_6to4(), the checksum of TCP and UDP packets with an
+     unmodified payload is updated rather than recomputed. */
+  incremental = IP64_INCREMENTAL_CHECKSUM &&
+    ipv6_packet_len >= sizeof(struct udp_hdr);
+
   /* Translate the IPv4 header into an IPv6 header. */
 
   /* We first fill in the simple fields: IP header version, traffic
@@ -722,11 +750,18 @@ ip64_4to6(const uint8_t *ipv4packet, const uint16_t ipv4packet_len,
   switch(v4hdr->proto) {
   case IP_PROTO_UDP:
     v6hdr->nxthdr = IP_PROTO_UDP;
+    /* A zero UDP checksum means that the IPv4 sender did not compute
+       one, but IPv6 requires it. */
+    if(udphdr->udpchksum == 0) {
+      incremental = 0;
+    }
     /* Check if this is a DNS request. If so, we should rewrite it
        with the DNS64 module. */
     if(udphdr->srcport == UIP_HTONS(DNS_PORT)) {
       int len;
 
+      incremental = 0;
+
       len = ip64_dns64_4to6((uint8_t *)v4hdr + IPV4_HDRLEN + sizeof(struct udp_hdr),
                             ipv4len - IPV4_HDRLEN - sizeof(struct udp_hdr),
                             (uint8_t *)v6hdr + IPV6_HDRLEN + sizeof(struct udp_hdr),
@@ -748,6 +783,7 @@ ip64_4to6(const uint8_t *ipv4packet, const uint16_t ipv4packet_len,
        local IPv6 host. */
     if(icmpv4hdr->type == ICMP_ECHO) {
       LOG_DBG("4to6: Translating ICMPv4 ECHO packet\n");
+      incremental = 0;
       v6hdr->nxthdr = IP_PROTO_ICMPV6;
       icmpv6hdr->type = ICMP6_ECHO;
       ip64_addr_copy6(&v6hdr->destipaddr, &ipv6_local_address);
@@ -845,20 +881,37 @@ ip64_4to6(const uint8_t *ipv4packet, const uint16_t ipv4packet_len,
   /* The checksum is in different places in the different protocol
      headers, so we need to be sure that we update the correct
      field. */
+  if(incremental) {
+    old_sum = translated_sum(&v4hdr->srcipaddr, 2 * sizeof(uip_ip4addr_t),
+                             &ipv4packet[IPV4_HDRLEN]);
+  }
+
   switch(v6hdr->nxthdr) {
   case IP_PROTO_TCP:
+    if(incremental) {
+      tcphdr->tcpchksum = uip_chksum_update16(tcphdr->tcpchksum, old_sum,
+        translated_sum(&v6hdr->srcipaddr, 2 * sizeof(uip_ip6addr_t),
+                       &resultpacket[IPV6_HDRLEN]));
+      break;
+    }
     tcphdr->tcpchksum = 0;
     tcphdr->tcpchksum = ~(ipv6_transport_checksum(resultpacket,
 						  ipv6len,
 						  IP_PROTO_TCP));
     break;
   case IP_PROTO_UDP:
-    udphdr->udpchksum = 0;
     /* As the udplen might have changed (DNS) we need to update it also */
     udphdr->udplen = uip_htons(ipv6_packet_len);
-    udphdr->udpchksum = ~(ipv6_transport_checksum(resultpacket,
-						  ipv6len,
-						  IP_PROTO_UDP));
+    if(incremental) {
+      udphdr->udpchksum = uip_chksum_update16(udphdr->udpchksum, old_sum,
+        translated_sum(&v6hdr->srcipaddr, 2 * sizeof(uip_ip6addr_t),
+                       &resultpacket[IPV6_HDRLEN]));
+    } else {
+      udphdr->udpchksum = 0;
+      udphdr->udpchksum = ~(ipv6_transport_checksum(resultpacket,
+						    ipv6len,
+						    IP_PROTO_UDP));
+    }
     if(udphdr->udpchksum == 0) {
       udphdr->udpchksum = 0xffff;
     }
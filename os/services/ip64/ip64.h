@@ -88,5 +88,13 @@ extern uint16_t ip64_packet_buffer_maxlen;
 #define IP64_DHCP 1
 #endif /* IP64_CONF_DHCP */
 
+#ifdef IP64_CONF_INCREMENTAL_CHECKSUM
+#define IP64_INCREMENTAL_CHECKSUM IP64_CONF_INCREMENTAL_CHECKSUM
+#else /* IP64_CONF_INCREMENTAL_CHECKSUM */
+/* Update TCP and UDP checksums for the translated fields (RFC 1624)
+   instead of recomputing them over the whole packet */
+#define IP64_INCREMENTAL_CHECKSUM 1
+#endif /* IP64_CONF_INCREMENTAL_CHECKSUM */
+
 #endif /* IP64_H */
 
@@ -59,7 +59,11 @@ tun_input_callback(void)
   /* Optional delay between outgoing packets */
   /* Base delay times number of 6lowpan fragments to be sent */
   if(!slip_config_basedelay || timer_expired(&delay_timer)) {
-    uip_len = tun6_net_input(uip_buf, sizeof(uip_buf));
+    int size = tun6_net_input(uip_buf, sizeof(uip_buf));
+    if(size <= 0) {
+      return;
+    }
+    uip_len = size;
     tcpip_input();
 
     if(slip_config_basedelay) {
@@ -48,6 +48,8 @@
 #include "lib/list.h"
 #include "sys/log.h"
 #include "dev/watchdog.h"
+#include "sys/energest.h"
+#include "sys/stack-check.h"
 #include "net/ipv6/uip.h"
 #include "net/ipv6/uiplib.h"
 #include "net/ipv6/uip-icmp6.h"
@@ -391,6 +393,118 @@ PT_THREAD(cmd_help(struct pt *pt, shell_output_func output, char *args))
 
   PT_END(pt);
 }
+#if PROCESS_CONF_PROFILE
+/*---------------------------------------------------------------------------*/
+static unsigned long
+profile_us(uint32_t ticks)
+{
+  return (unsigned long)((uint64_t)ticks * 1000000 / PROCESS_PROFILE_SECOND);
+}
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_procs(struct pt *pt, shell_output_func output, char *args))
+{
+  struct process *p;
+  char *next_args;
+
+  PT_BEGIN(pt);
+
+  SHELL_ARGS_INIT(args, next_args);
+  SHELL_ARGS_NEXT(args, next_args);
+
+  SHELL_OUTPUT(output, "Process profile (times in us):\n");
+  for(p = PROCESS_LIST(); p != NULL; p = p->next) {
+    const struct process_profile *pr = &p->profile;
+    SHELL_OUTPUT(output,
+                 "-- %-20s calls %lu, run %lu, max %lu, events %lu, avg delay %lu, max delay %lu\n",
+                 PROCESS_NAME_STRING(p), (unsigned long)pr->calls,
+                 profile_us(pr->run_time), profile_us(pr->max_run_time),
+                 (unsigned long)pr->events,
+                 pr->events == 0 ? 0 : profile_us(pr->event_delay / pr->events),
+                 profile_us(pr->max_event_delay));
+  }
+
+  if(args != NULL && !strcmp(args, "reset")) {
+    process_profile_reset();
+    SHELL_OUTPUT(output, "Process profile reset\n");
+  }
+
+  PT_END(pt);
+}
+#endif /* PROCESS_CONF_PROFILE */
+#if STACK_CHECK_ENABLED || STACK_CHECK_WITH_REGIONS
+/*---------------------------------------------------------------------------*/
+static void
+output_stack_usage(shell_output_func output, const char *name,
+                   size_t actual, size_t allowed)
+{
+  if(actual > allowed) {
+    SHELL_OUTPUT(output, "-- %-12s overflow, %u bytes reserved\n",
+                 name, (unsigned)allowed);
+  } else {
+    SHELL_OUTPUT(output, "-- %-12s %u of %u bytes used\n",
+                 name, (unsigned)actual, (unsigned)allowed);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_stacks(struct pt *pt, shell_output_func output, char *args))
+{
+#if STACK_CHECK_WITH_REGIONS
+  struct stack_check_region *region;
+#endif /* STACK_CHECK_WITH_REGIONS */
+
+  PT_BEGIN(pt);
+
+  SHELL_OUTPUT(output, "Stack high-water marks:\n");
+#if STACK_CHECK_ENABLED
+  output_stack_usage(output, "main", stack_check_get_usage(),
+                     stack_check_get_reserved_size());
+#endif /* STACK_CHECK_ENABLED */
+#if STACK_CHECK_WITH_REGIONS
+  for(region = stack_check_region_head(); region != NULL;
+      region = region->next) {
+    output_stack_usage(output, region->name,
+                       stack_check_region_get_usage(region), region->size);
+  }
+#endif /* STACK_CHECK_WITH_REGIONS */
+
+  PT_END(pt);
+}
+#endif /* STACK_CHECK_ENABLED || STACK_CHECK_WITH_REGIONS */
+#if ENERGEST_WITH_CONTEXTS
+/*---------------------------------------------------------------------------*/
+static unsigned long
+energest_ms(uint64_t time)
+{
+  return (unsigned long)(time * 1000 / ENERGEST_SECOND);
+}
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_energest(struct pt *pt, shell_output_func output, char *args))
+{
+  energest_context_t context;
+
+  PT_BEGIN(pt);
+
+  energest_flush();
+
+  SHELL_OUTPUT(output, "Energest per context (times in ms):\n");
+  for(context = 0; context < ENERGEST_CONTEXT_MAX; context++) {
+    SHELL_OUTPUT(output, "-- %-12s cpu %lu, tx %lu, rx %lu\n",
+                 energest_context_name(context),
+                 energest_ms(energest_context_type_time(context, ENERGEST_TYPE_CPU)),
+                 energest_ms(energest_context_type_time(context, ENERGEST_TYPE_TRANSMIT)),
+                 energest_ms(energest_context_type_time(context, ENERGEST_TYPE_LISTEN)));
+  }
+  SHELL_OUTPUT(output, "-- %-12s cpu %lu, tx %lu, rx %lu\n", "Total",
+               energest_ms(energest_type_time(ENERGEST_TYPE_CPU)),
+               energest_ms(energest_type_time(ENERGEST_TYPE_TRANSMIT)),
+               energest_ms(energest_type_time(ENERGEST_TYPE_LISTEN)));
+
+  PT_END(pt);
+}
+#endif /* ENERGEST_WITH_CONTEXTS */
 #if UIP_CONF_IPV6_RPL
 /*---------------------------------------------------------------------------*/
 static
@@ -998,6 +1112,15 @@ const struct shell_command_t builtin_shell_commands[] = {
   { "reboot",               cmd_reboot,               "'> reboot': Reboot the board by watchdog_reboot()" },
   { "log",                  cmd_log,                  "'> log module level': Sets log level (0--4) for a given module (or \"all\"). For module \"mac\", level 4 also enables per-slot logging." },
   { "mac-addr",             cmd_macaddr,               "'> mac-addr': Shows the node's MAC address" },
+#if PROCESS_CONF_PROFILE
+  { "procs",                cmd_procs,                "'> procs [reset]': Shows the run time and event queueing delay of each process, optionally resetting them" },
+#endif /* PROCESS_CONF_PROFILE */
+#if STACK_CHECK_ENABLED || STACK_CHECK_WITH_REGIONS
+  { "stacks",               cmd_stacks,               "'> stacks': Shows the maximal usage of each stack so far" },
+#endif /* STACK_CHECK_ENABLED || STACK_CHECK_WITH_REGIONS */
+#if ENERGEST_WITH_CONTEXTS
+  { "energest",             cmd_energest,             "'> energest': Shows the CPU and radio time spent by each energest context" },
+#endif /* ENERGEST_WITH_CONTEXTS */
 #if NETSTACK_CONF_WITH_IPV6
   { "ip-addr",              cmd_ipaddr,               "'> ip-addr': Shows all IPv6 addresses" },
   { "ip-nbr",               cmd_ip_neighbors,         "'> ip-nbr': Shows all IPv6 neighbors" },
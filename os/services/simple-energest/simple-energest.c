@@ -54,6 +54,11 @@
 #define LOG_LEVEL LOG_LEVEL_INFO
 
 static uint64_t last_tx, last_rx, last_time, last_cpu, last_lpm, last_deep_lpm;
+#if ENERGEST_WITH_CONTEXTS
+static uint64_t last_context_cpu[ENERGEST_CONTEXT_MAX];
+static uint64_t last_context_tx[ENERGEST_CONTEXT_MAX];
+static uint64_t last_context_rx[ENERGEST_CONTEXT_MAX];
+#endif /* ENERGEST_WITH_CONTEXTS */
 
 PROCESS(simple_energest_process, "Simple Energest");
 /*---------------------------------------------------------------------------*/
@@ -70,6 +75,32 @@ log_energest(const char *name, uint64_t delta, uint64_t delta_time)
            name, delta, delta_time, to_permil(delta, delta_time));
 }
 /*---------------------------------------------------------------------------*/
+#if ENERGEST_WITH_CONTEXTS
+static void
+log_energest_contexts(uint64_t delta_time)
+{
+  energest_context_t context;
+  uint64_t curr_cpu, curr_tx, curr_rx;
+
+  LOG_INFO("%-12s  %10s %10s %10s\n", "Context", "CPU", "Radio Tx", "Radio Rx");
+  for(context = 0; context < ENERGEST_CONTEXT_MAX; context++) {
+    curr_cpu = energest_context_type_time(context, ENERGEST_TYPE_CPU);
+    curr_tx = energest_context_type_time(context, ENERGEST_TYPE_TRANSMIT);
+    curr_rx = energest_context_type_time(context, ENERGEST_TYPE_LISTEN);
+    LOG_INFO("%-12s: %10"PRIu64" %10"PRIu64" %10"PRIu64" (%"PRIu64" permil radio)\n",
+             energest_context_name(context),
+             curr_cpu - last_context_cpu[context],
+             curr_tx - last_context_tx[context],
+             curr_rx - last_context_rx[context],
+             to_permil(curr_tx - last_context_tx[context] +
+                       curr_rx - last_context_rx[context], delta_time));
+    last_context_cpu[context] = curr_cpu;
+    last_context_tx[context] = curr_tx;
+    last_context_rx[context] = curr_rx;
+  }
+}
+#endif /* ENERGEST_WITH_CONTEXTS */
+/*---------------------------------------------------------------------------*/
 static void
 simple_energest_step(void)
 {
@@ -98,6 +129,9 @@ simple_energest_step(void)
   log_energest("Radio Rx", curr_rx - last_rx, delta_time);
   log_energest("Radio total", curr_tx - last_tx + curr_rx - last_rx,
                delta_time);
+#if ENERGEST_WITH_CONTEXTS
+  log_energest_contexts(delta_time);
+#endif /* ENERGEST_WITH_CONTEXTS */
 
   last_time = curr_time;
   last_cpu = curr_cpu;
@@ -131,6 +165,16 @@ simple_energest_init(void)
   last_deep_lpm = energest_type_time(ENERGEST_TYPE_DEEP_LPM);
   last_tx = energest_type_time(ENERGEST_TYPE_TRANSMIT);
   last_rx = energest_type_time(ENERGEST_TYPE_LISTEN);
+#if ENERGEST_WITH_CONTEXTS
+  for(energest_context_t context = 0; context < ENERGEST_CONTEXT_MAX; context++) {
+    last_context_cpu[context] =
+      energest_context_type_time(context, ENERGEST_TYPE_CPU);
+    last_context_tx[context] =
+      energest_context_type_time(context, ENERGEST_TYPE_TRANSMIT);
+    last_context_rx[context] =
+      energest_context_type_time(context, ENERGEST_TYPE_LISTEN);
+  }
+#endif /* ENERGEST_WITH_CONTEXTS */
   process_start(&simple_energest_process, NULL);
 }
 
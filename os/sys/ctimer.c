@@ -60,6 +60,9 @@ PROCESS_THREAD(ctimer_process, ev, data)
   struct ctimer *c;
   PROCESS_BEGIN();
 
+  /* The network stack runs on callback timers */
+  process_set_priority(&ctimer_process, PROCESS_PRIORITY_HIGH);
+
   for(c = list_head(ctimer_list); c != NULL; c = c->next) {
     etimer_set(&c->etimer, c->etimer.timer.interval);
   }
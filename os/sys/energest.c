@@ -39,6 +39,9 @@
 
 #include "contiki.h"
 #include "sys/energest.h"
+#include "sys/int-master.h"
+
+#include <string.h>
 
 #if ENERGEST_CONF_ON
 
@@ -46,6 +49,15 @@ uint64_t energest_total_time[ENERGEST_TYPE_MAX];
 ENERGEST_TIME_T energest_current_time[ENERGEST_TYPE_MAX];
 bool energest_current_mode[ENERGEST_TYPE_MAX];
 
+#if ENERGEST_WITH_CONTEXTS
+uint64_t energest_context_time[ENERGEST_CONTEXT_MAX][ENERGEST_TYPE_MAX];
+uint8_t energest_context_owner[ENERGEST_TYPE_MAX];
+uint8_t energest_context_stack[ENERGEST_CONTEXT_DEPTH];
+uint8_t energest_context_depth;
+/* Pushes that did not fit on the stack, and are popped without effect */
+static uint8_t context_overflow;
+#endif /* ENERGEST_WITH_CONTEXTS */
+
 /*---------------------------------------------------------------------------*/
 void
 energest_init(void)
@@ -55,6 +67,12 @@ energest_init(void)
     energest_total_time[i] = energest_current_time[i] = 0;
     energest_current_mode[i] = false;
   }
+#if ENERGEST_WITH_CONTEXTS
+  memset(energest_context_time, 0, sizeof(energest_context_time));
+  energest_context_stack[0] = ENERGEST_CONTEXT_OTHER;
+  energest_context_depth = 0;
+  context_overflow = 0;
+#endif /* ENERGEST_WITH_CONTEXTS */
   ENERGEST_ON(ENERGEST_TYPE_CPU);
 }
 /*---------------------------------------------------------------------------*/
@@ -68,6 +86,7 @@ energest_flush(void)
       now = ENERGEST_CURRENT_TIME();
       energest_total_time[i] +=
         (ENERGEST_TIME_T)(now - energest_current_time[i]);
+      ENERGEST_CONTEXT_ADD(i, (ENERGEST_TIME_T)(now - energest_current_time[i]));
       energest_current_time[i] = now;
     }
   }
@@ -80,4 +99,80 @@ energest_get_total_time(void)
     energest_type_time(ENERGEST_TYPE_LPM) +
     energest_type_time(ENERGEST_TYPE_DEEP_LPM);
 }
+/*---------------------------------------------------------------------------*/
+#if ENERGEST_WITH_CONTEXTS
+/* Charge the CPU time so far to the current context, and hand the CPU
+   over to the context that is on top of the stack after the change */
+static void
+context_settle_cpu(void)
+{
+  ENERGEST_TIME_T now;
+
+  if(energest_current_mode[ENERGEST_TYPE_CPU]) {
+    now = ENERGEST_CURRENT_TIME();
+    energest_total_time[ENERGEST_TYPE_CPU] +=
+      (ENERGEST_TIME_T)(now - energest_current_time[ENERGEST_TYPE_CPU]);
+    ENERGEST_CONTEXT_ADD(ENERGEST_TYPE_CPU,
+      (ENERGEST_TIME_T)(now - energest_current_time[ENERGEST_TYPE_CPU]));
+    energest_current_time[ENERGEST_TYPE_CPU] = now;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+energest_context_push(energest_context_t context)
+{
+  int_master_status_t status = int_master_read_and_disable();
+
+  if(energest_context_depth + 1 < ENERGEST_CONTEXT_DEPTH) {
+    context_settle_cpu();
+    energest_context_stack[++energest_context_depth] = context;
+    ENERGEST_CONTEXT_TAKE(ENERGEST_TYPE_CPU);
+  } else {
+    context_overflow++;
+  }
+  int_master_status_set(status);
+}
+/*---------------------------------------------------------------------------*/
+void
+energest_context_pop(void)
+{
+  int_master_status_t status = int_master_read_and_disable();
+
+  if(context_overflow > 0) {
+    context_overflow--;
+  } else if(energest_context_depth > 0) {
+    context_settle_cpu();
+    energest_context_depth--;
+    ENERGEST_CONTEXT_TAKE(ENERGEST_TYPE_CPU);
+  }
+  int_master_status_set(status);
+}
+/*---------------------------------------------------------------------------*/
+void
+energest_context_set(energest_context_t context)
+{
+  int_master_status_t status = int_master_read_and_disable();
+
+  if(context_overflow == 0 && energest_context_depth > 0 &&
+     energest_context_stack[energest_context_depth] != context) {
+    context_settle_cpu();
+    energest_context_stack[energest_context_depth] = context;
+    ENERGEST_CONTEXT_TAKE(ENERGEST_TYPE_CPU);
+  }
+  int_master_status_set(status);
+}
+/*---------------------------------------------------------------------------*/
+const char *
+energest_context_name(energest_context_t context)
+{
+  static const char *const names[] = {
+    "Other", "MAC", "MAC beacon", "RPL", "App"
+  };
+
+  if(context < sizeof(names) / sizeof(names[0])) {
+    return names[context];
+  }
+  return "Custom";
+}
+#endif /* ENERGEST_WITH_CONTEXTS */
 #endif /* ENERGEST_CONF_ON */
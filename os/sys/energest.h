@@ -110,6 +110,45 @@ typedef enum energest_type {
   ENERGEST_TYPE_MAX
 } energest_type_t;
 
+/*
+ * Energy contexts attribute energest time to the part of the system that
+ * caused it. Code pushes a context before an operation and pops it
+ * afterwards. CPU time is charged to the context on top of the stack while
+ * it runs. All other types are charged to the context that was on top of
+ * the stack when they were switched on, so that a radio transmission is
+ * charged to whoever started it. Packets carry the context they were
+ * created in, see PACKETBUF_ATTR_ENERGEST_CONTEXT, so that the MAC layer
+ * can charge their transmission to that context.
+ *
+ * #define ENERGEST_CONF_CONTEXT_ADDITIONS CONTEXT_NAME1, CONTEXT_NAME2
+ */
+#ifndef ENERGEST_CONF_CONTEXTS
+/* Energy contexts are disabled by default */
+#define ENERGEST_CONF_CONTEXTS 0
+#endif /* ENERGEST_CONF_CONTEXTS */
+
+#define ENERGEST_WITH_CONTEXTS (ENERGEST_CONF_ON && ENERGEST_CONF_CONTEXTS)
+
+#ifdef ENERGEST_CONF_CONTEXT_DEPTH
+#define ENERGEST_CONTEXT_DEPTH ENERGEST_CONF_CONTEXT_DEPTH
+#else /* ENERGEST_CONF_CONTEXT_DEPTH */
+#define ENERGEST_CONTEXT_DEPTH 8
+#endif /* ENERGEST_CONF_CONTEXT_DEPTH */
+
+typedef enum energest_context {
+  ENERGEST_CONTEXT_OTHER,       /* Not attributed to any context */
+  ENERGEST_CONTEXT_MAC,         /* MAC layer operation */
+  ENERGEST_CONTEXT_MAC_BEACON,  /* Beacons, e.g. TSCH EBs */
+  ENERGEST_CONTEXT_RPL,         /* RPL control traffic */
+  ENERGEST_CONTEXT_APP,         /* Application */
+
+#ifdef ENERGEST_CONF_CONTEXT_ADDITIONS
+  ENERGEST_CONF_CONTEXT_ADDITIONS,
+#endif /* ENERGEST_CONF_CONTEXT_ADDITIONS */
+
+  ENERGEST_CONTEXT_MAX
+} energest_context_t;
+
 #if ENERGEST_CONF_ON
 
 void energest_init(void);
@@ -121,6 +160,39 @@ extern uint64_t energest_total_time[ENERGEST_TYPE_MAX];
 extern ENERGEST_TIME_T energest_current_time[ENERGEST_TYPE_MAX];
 extern bool energest_current_mode[ENERGEST_TYPE_MAX];
 
+#if ENERGEST_WITH_CONTEXTS
+extern uint64_t energest_context_time[ENERGEST_CONTEXT_MAX][ENERGEST_TYPE_MAX];
+extern uint8_t energest_context_owner[ENERGEST_TYPE_MAX];
+extern uint8_t energest_context_stack[ENERGEST_CONTEXT_DEPTH];
+extern uint8_t energest_context_depth;
+
+/* The context currently on top of the stack */
+#define ENERGEST_CONTEXT_CURRENT() \
+  ((energest_context_t)energest_context_stack[energest_context_depth])
+/* Charge time of an energest type to the context that owns it */
+#define ENERGEST_CONTEXT_ADD(type, time) \
+  energest_context_time[energest_context_owner[type]][type] += (time)
+#define ENERGEST_CONTEXT_TAKE(type) \
+  energest_context_owner[type] = energest_context_stack[energest_context_depth]
+
+/* Enter a context, until the matching energest_context_pop() */
+void energest_context_push(energest_context_t context);
+void energest_context_pop(void);
+/* Replace the context pushed last. Has no effect if nothing was pushed. */
+void energest_context_set(energest_context_t context);
+const char *energest_context_name(energest_context_t context);
+
+static inline uint64_t
+energest_context_type_time(energest_context_t context, energest_type_t type)
+{
+  return energest_context_time[context][type];
+}
+#else /* ENERGEST_WITH_CONTEXTS */
+#define ENERGEST_CONTEXT_CURRENT() ENERGEST_CONTEXT_OTHER
+#define ENERGEST_CONTEXT_ADD(type, time)
+#define ENERGEST_CONTEXT_TAKE(type)
+#endif /* ENERGEST_WITH_CONTEXTS */
+
 static inline uint64_t
 energest_type_time(energest_type_t type)
 {
@@ -139,6 +211,7 @@ energest_on(energest_type_t type)
   if(!energest_current_mode[type]) {
     energest_current_time[type] = ENERGEST_CURRENT_TIME();
     energest_current_mode[type] = true;
+    ENERGEST_CONTEXT_TAKE(type);
   }
 }
 #define ENERGEST_ON(type) energest_on(type)
@@ -147,8 +220,10 @@ static inline void
 energest_off(energest_type_t type)
 {
  if(energest_current_mode[type]) {
-   energest_total_time[type] +=
-     (ENERGEST_TIME_T)(ENERGEST_CURRENT_TIME() - energest_current_time[type]);
+   ENERGEST_TIME_T energest_local_variable_time =
+     ENERGEST_CURRENT_TIME() - energest_current_time[type];
+   energest_total_time[type] += energest_local_variable_time;
+   ENERGEST_CONTEXT_ADD(type, energest_local_variable_time);
    energest_current_mode[type] = false;
  }
 }
@@ -159,13 +234,16 @@ energest_switch(energest_type_t type_off, energest_type_t type_on)
 {
   ENERGEST_TIME_T energest_local_variable_now = ENERGEST_CURRENT_TIME();
   if(energest_current_mode[type_off]) {
-    energest_total_time[type_off] += (ENERGEST_TIME_T)
-      (energest_local_variable_now - energest_current_time[type_off]);
+    ENERGEST_TIME_T energest_local_variable_time =
+      energest_local_variable_now - energest_current_time[type_off];
+    energest_total_time[type_off] += energest_local_variable_time;
+    ENERGEST_CONTEXT_ADD(type_off, energest_local_variable_time);
     energest_current_mode[type_off] = false;
   }
   if(!energest_current_mode[type_on]) {
     energest_current_time[type_on] = energest_local_variable_now;
     energest_current_mode[type_on] = true;
+    ENERGEST_CONTEXT_TAKE(type_on);
   }
 }
 #define ENERGEST_SWITCH(type_off, type_on) energest_switch(type_off, type_on)
@@ -193,6 +271,16 @@ static inline void energest_switch(energest_type_t type_off,
 #define ENERGEST_OFF(type) do { } while(0)
 #define ENERGEST_SWITCH(type_off, type_on) do { } while(0)
 
+#define ENERGEST_CONTEXT_CURRENT() ENERGEST_CONTEXT_OTHER
+
 #endif /* ENERGEST_CONF_ON */
 
+#if !ENERGEST_WITH_CONTEXTS
+static inline void energest_context_push(energest_context_t context) { }
+
+static inline void energest_context_pop(void) { }
+
+static inline void energest_context_set(energest_context_t context) { }
+#endif /* !ENERGEST_WITH_CONTEXTS */
+
 #endif /* ENERGEST_H_ */
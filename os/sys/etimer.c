@@ -49,10 +49,211 @@
 #include "sys/etimer.h"
 #include "sys/process.h"
 
+PROCESS(etimer_process, "Event timer");
+/*---------------------------------------------------------------------------*/
+#if ETIMER_QUEUE == ETIMER_QUEUE_HEAP
+/*
+ * The pending timers are kept in a pairing heap ordered by expiration
+ * time. The next pointer links siblings, the child pointer points to
+ * the leftmost child, and the prev pointer points to the left sibling,
+ * or to the parent in the case of the leftmost child.
+ *
+ * Heap membership is tracked with the queued pointer, which points to
+ * the timer itself while it is in the heap. Unlike a flag or the link
+ * pointers, this cannot be mistaken for membership when the timer
+ * lives in memory that was not zeroed, as stale contents only match
+ * if the timer at that very address was queued.
+ */
+static struct etimer *timerheap;
+/*---------------------------------------------------------------------------*/
+static inline clock_time_t
+expiration(struct etimer *t)
+{
+  return t->timer.start + t->timer.interval;
+}
+/*---------------------------------------------------------------------------*/
+static inline bool
+queue_contains(struct etimer *t)
+{
+  return t->queued == t;
+}
+/*---------------------------------------------------------------------------*/
+/* Meld two detached heaps and return the root of the resulting heap. */
+static struct etimer *
+meld(struct etimer *a, struct etimer *b)
+{
+  struct etimer *tmp;
+
+  if(a == NULL) {
+    return b;
+  }
+  if(b == NULL) {
+    return a;
+  }
+
+  if(CLOCK_LT(expiration(b), expiration(a))) {
+    tmp = a;
+    a = b;
+    b = tmp;
+  }
+
+  b->prev = a;
+  b->next = a->child;
+  if(a->child != NULL) {
+    a->child->prev = b;
+  }
+  a->child = b;
+
+  return a;
+}
+/*---------------------------------------------------------------------------*/
+/* Meld a list of sibling heaps by using the standard two-pass method. */
+static struct etimer *
+merge_pairs(struct etimer *first)
+{
+  struct etimer *a, *b, *pairs;
+
+  /* First pass: meld pairs from left to right, and push the results
+     onto a stack linked through the next pointers. */
+  pairs = NULL;
+  while(first != NULL) {
+    a = first;
+    b = a->next;
+    first = b != NULL ? b->next : NULL;
+
+    a->next = a->prev = NULL;
+    if(b != NULL) {
+      b->next = b->prev = NULL;
+    }
+    a = meld(a, b);
+    a->next = pairs;
+    pairs = a;
+  }
+
+  /* Second pass: meld the pairs from right to left. */
+  while(pairs != NULL) {
+    a = pairs;
+    pairs = a->next;
+    a->next = NULL;
+    first = meld(first, a);
+  }
+
+  return first;
+}
+/*---------------------------------------------------------------------------*/
+static void
+queue_remove(struct etimer *t)
+{
+  if(!queue_contains(t)) {
+    return;
+  }
+
+  if(t == timerheap) {
+    timerheap = merge_pairs(t->child);
+  } else {
+    if(t->prev->child == t) {
+      t->prev->child = t->next;
+    } else {
+      t->prev->next = t->next;
+    }
+    if(t->next != NULL) {
+      t->next->prev = t->prev;
+    }
+    timerheap = meld(timerheap, merge_pairs(t->child));
+  }
+
+  t->child = t->next = t->prev = NULL;
+  t->queued = NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+queue_add(struct etimer *t)
+{
+  /* The expiration time may have changed, so a timer that is already
+     in the heap has to be reinserted. */
+  queue_remove(t);
+
+  t->child = t->next = t->prev = NULL;
+  t->queued = t;
+  timerheap = meld(timerheap, t);
+}
+/*---------------------------------------------------------------------------*/
+static void
+queue_update(struct etimer *t)
+{
+  if(queue_contains(t)) {
+    queue_remove(t);
+    timerheap = meld(timerheap, t);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+queue_remove_process(struct process *p)
+{
+  struct etimer *head, *tail, *t, *next;
+
+  /* Flatten the heap into a list linked through the next pointers. */
+  head = tail = timerheap;
+  timerheap = NULL;
+  for(t = head; t != NULL; t = t->next) {
+    if(t->child != NULL) {
+      tail->next = t->child;
+      t->child = NULL;
+      while(tail->next != NULL) {
+        tail = tail->next;
+      }
+    }
+  }
+
+  /* Rebuild the heap from the timers that are not owned by p. */
+  for(t = head; t != NULL; t = next) {
+    next = t->next;
+    t->next = t->prev = NULL;
+    if(t->p != p) {
+      timerheap = meld(timerheap, t);
+    } else {
+      t->queued = NULL;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+queue_expire(void)
+{
+  struct etimer *t;
+
+  /* The timers expire in order, so we can stop at the first timer
+     that has not expired. */
+  while(timerheap != NULL && timer_expired(&timerheap->timer)) {
+    t = timerheap;
+    if(process_post(t->p, PROCESS_EVENT_TIMER, t) != PROCESS_ERR_OK) {
+      etimer_request_poll();
+      return;
+    }
+
+    /* Reset the process ID of the event timer, to signal that the
+       etimer has expired. This is later checked in the
+       etimer_expired() function. */
+    queue_remove(t);
+    t->p = PROCESS_NONE;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static inline bool
+queue_is_empty(void)
+{
+  return timerheap == NULL;
+}
+/*---------------------------------------------------------------------------*/
+static inline clock_time_t
+queue_next_expiration(void)
+{
+  return expiration(timerheap);
+}
+/*---------------------------------------------------------------------------*/
+#else /* ETIMER_QUEUE == ETIMER_QUEUE_HEAP */
 static struct etimer *timerlist;
 static clock_time_t next_expiration;
-
-PROCESS(etimer_process, "Event timer");
 /*---------------------------------------------------------------------------*/
 static void
 update_time(void)
@@ -77,64 +278,144 @@ update_time(void)
   }
 }
 /*---------------------------------------------------------------------------*/
-PROCESS_THREAD(etimer_process, ev, data)
+static void
+queue_add(struct etimer *timer)
 {
-  struct etimer *t, *u;
+  struct etimer *t;
 
-  PROCESS_BEGIN();
+  if(timer->p != PROCESS_NONE) {
+    for(t = timerlist; t != NULL; t = t->next) {
+      if(t == timer) {
+        /* Timer already on list, bail out. */
+        update_time();
+        return;
+      }
+    }
+  }
 
-  timerlist = NULL;
+  /* Timer not on list. */
+  timer->next = timerlist;
+  timerlist = timer;
 
-  while(1) {
-    PROCESS_YIELD();
+  update_time();
+}
+/*---------------------------------------------------------------------------*/
+static void
+queue_update(struct etimer *t)
+{
+  update_time();
+}
+/*---------------------------------------------------------------------------*/
+static void
+queue_remove(struct etimer *et)
+{
+  struct etimer *t;
 
-    if(ev == PROCESS_EVENT_EXITED) {
-      struct process *p = data;
+  /* First check if et is the first event timer on the list. */
+  if(et == timerlist) {
+    timerlist = timerlist->next;
+    update_time();
+  } else {
+    /* Else walk through the list and try to find the item before the
+       et timer. */
+    for(t = timerlist; t != NULL && t->next != et; t = t->next) {
+    }
 
-      while(timerlist != NULL && timerlist->p == p) {
-        timerlist = timerlist->next;
-      }
+    if(t != NULL) {
+      /* We've found the item before the event timer that we are about
+         to remove. We point the items next pointer to the event after
+         the removed item. */
+      t->next = et->next;
 
-      if(timerlist != NULL) {
-        t = timerlist;
-        while(t->next != NULL) {
-          if(t->next->p == p) {
-            t->next = t->next->next;
-          } else {
-            t = t->next;
-          }
-        }
-      }
-      continue;
-    } else if(ev != PROCESS_EVENT_POLL) {
-      continue;
+      update_time();
     }
+  }
+
+  /* Remove the next pointer from the item to be removed. */
+  et->next = NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+queue_remove_process(struct process *p)
+{
+  struct etimer *t;
 
-again:
+  while(timerlist != NULL && timerlist->p == p) {
+    timerlist = timerlist->next;
+  }
 
-    u = NULL;
+  if(timerlist != NULL) {
+    t = timerlist;
+    while(t->next != NULL) {
+      if(t->next->p == p) {
+        t->next = t->next->next;
+      } else {
+        t = t->next;
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+queue_expire(void)
+{
+  struct etimer *t, *u;
 
-    for(t = timerlist; t != NULL; t = t->next) {
-      if(timer_expired(&t->timer)) {
-        if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
-
-          /* Reset the process ID of the event timer, to signal that the
-             etimer has expired. This is later checked in the
-             etimer_expired() function. */
-          t->p = PROCESS_NONE;
-          if(u != NULL) {
-            u->next = t->next;
-          } else {
-            timerlist = t->next;
-          }
-          t->next = NULL;
-          update_time();
-          goto again;
+  /* Expire all timers in a single pass. Posting an event does not run
+     the receiving process, so the list cannot change under our feet. */
+  u = NULL;
+  t = timerlist;
+  while(t != NULL) {
+    if(timer_expired(&t->timer)) {
+      if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
+
+        /* Reset the process ID of the event timer, to signal that the
+           etimer has expired. This is later checked in the
+           etimer_expired() function. */
+        t->p = PROCESS_NONE;
+        if(u != NULL) {
+          u->next = t->next;
         } else {
-          etimer_request_poll();
+          timerlist = t->next;
         }
+        t->next = NULL;
+        t = u != NULL ? u->next : timerlist;
+        continue;
+      } else {
+        etimer_request_poll();
       }
-      u = t;
+    }
+    u = t;
+    t = t->next;
+  }
+
+  update_time();
+}
+/*---------------------------------------------------------------------------*/
+static inline bool
+queue_is_empty(void)
+{
+  return timerlist == NULL;
+}
+/*---------------------------------------------------------------------------*/
+static inline clock_time_t
+queue_next_expiration(void)
+{
+  return next_expiration;
+}
+#endif /* ETIMER_QUEUE == ETIMER_QUEUE_HEAP */
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(etimer_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD();
+
+    if(ev == PROCESS_EVENT_EXITED) {
+      queue_remove_process(data);
+    } else if(ev == PROCESS_EVENT_POLL) {
+      queue_expire();
     }
   }
 
@@ -150,27 +431,9 @@ etimer_request_poll(void)
 static void
 add_timer(struct etimer *timer)
 {
-  struct etimer *t;
-
   etimer_request_poll();
-
-  if(timer->p != PROCESS_NONE) {
-    for(t = timerlist; t != NULL; t = t->next) {
-      if(t == timer) {
-        /* Timer already on list, bail out. */
-        timer->p = PROCESS_CURRENT();
-        update_time();
-        return;
-      }
-    }
-  }
-
-  /* Timer not on list. */
+  queue_add(timer);
   timer->p = PROCESS_CURRENT();
-  timer->next = timerlist;
-  timerlist = timer;
-
-  update_time();
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -206,7 +469,7 @@ void
 etimer_adjust(struct etimer *et, int timediff)
 {
   et->timer.start += timediff;
-  update_time();
+  queue_update(et);
 }
 /*---------------------------------------------------------------------------*/
 clock_time_t
@@ -224,42 +487,19 @@ etimer_start_time(struct etimer *et)
 int
 etimer_pending(void)
 {
-  return timerlist != NULL;
+  return !queue_is_empty();
 }
 /*---------------------------------------------------------------------------*/
 clock_time_t
 etimer_next_expiration_time(void)
 {
-  return etimer_pending() ? next_expiration : 0;
+  return etimer_pending() ? queue_next_expiration() : 0;
 }
 /*---------------------------------------------------------------------------*/
 void
 etimer_stop(struct etimer *et)
 {
-  struct etimer *t;
-
-  /* First check if et is the first event timer on the list. */
-  if(et == timerlist) {
-    timerlist = timerlist->next;
-    update_time();
-  } else {
-    /* Else walk through the list and try to find the item before the
-       et timer. */
-    for(t = timerlist; t != NULL && t->next != et; t = t->next) {
-    }
-
-    if(t != NULL) {
-      /* We've found the item before the event timer that we are about
-         to remove. We point the items next pointer to the event after
-         the removed item. */
-      t->next = et->next;
-
-      update_time();
-    }
-  }
-
-  /* Remove the next pointer from the item to be removed. */
-  et->next = NULL;
+  queue_remove(et);
   /* Set the timer as expired */
   et->p = PROCESS_NONE;
 }
@@ -68,6 +68,30 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+/**
+ * \name Event timer queue implementations
+ *
+ * ETIMER_QUEUE_LIST keeps the pending timers in an unsorted linked
+ * list. It has the smallest RAM footprint, but setting, stopping, and
+ * expiring timers is linear in the number of pending timers.
+ *
+ * ETIMER_QUEUE_HEAP keeps the pending timers in a pairing heap. Timers
+ * are inserted in constant time, stopped in logarithmic amortized
+ * time, and the next expiration time is always available at the
+ * root. It costs three extra pointers per event timer and is intended
+ * for systems with a large number of concurrent etimers and ctimers.
+ * @{
+ */
+#define ETIMER_QUEUE_LIST 0
+#define ETIMER_QUEUE_HEAP 1
+
+#ifdef ETIMER_CONF_QUEUE
+#define ETIMER_QUEUE ETIMER_CONF_QUEUE
+#else
+#define ETIMER_QUEUE ETIMER_QUEUE_LIST
+#endif
+/** @} */
+
 /**
  * A timer.
  *
@@ -80,6 +104,12 @@ struct etimer {
   struct timer timer;
   struct etimer *next;
   struct process *p;
+#if ETIMER_QUEUE == ETIMER_QUEUE_HEAP
+  struct etimer *child;
+  struct etimer *prev;
+  /* Points to the timer itself while it is in the heap */
+  struct etimer *queued;
+#endif /* ETIMER_QUEUE == ETIMER_QUEUE_HEAP */
 };
 
 /**
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Binary, deferred logging
+ */
+
+/** \addtogroup log-binary
+ * @{ */
+
+#include "contiki.h"
+#include "sys/log.h"
+#include "sys/log-binary.h"
+#include "sys/int-master.h"
+#include "sys/memory-barrier.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if LOG_WITH_BINARY
+
+#if LOG_BINARY_BUFSIZE & (LOG_BINARY_BUFSIZE - 1)
+#error LOG_BINARY_CONF_BUFSIZE must be a power of two
+#endif
+
+#if LOG_BINARY_RECORD_SIZE > 255
+#error LOG_BINARY_CONF_RECORD_SIZE must fit in a byte
+#endif
+
+#define MASK (LOG_BINARY_BUFSIZE - 1)
+
+/* SLIP framing */
+#define SLIP_END     0300
+#define SLIP_ESC     0333
+#define SLIP_ESC_END 0334
+#define SLIP_ESC_ESC 0335
+
+/* Record header: id and timestamp */
+#define HEADER_SIZE 6
+
+/* An entry of our own makes sure that the section, and with it
+ * __start_log_fmt, always exists */
+extern const char __start_log_fmt[];
+static const char fmt_start[] LOG_BINARY_SECTION = "0\0\0";
+const char log_binary_fmt_lladdr[] LOG_BINARY_SECTION = "0\0\0%L";
+const char log_binary_fmt_6addr[] LOG_BINARY_SECTION = "0\0\0%I";
+const char log_binary_fmt_bytes[] LOG_BINARY_SECTION = "0\0\0%B";
+
+/*
+ * Records are stored in the ring prefixed with their length. Producers,
+ * which may run in interrupt context, serialize on a short critical
+ * section while copying in a finished record. The main loop is the only
+ * consumer and reads without locking: it only advances the tail and
+ * only reads up to the head published by the producers.
+ */
+static uint8_t ring[LOG_BINARY_BUFSIZE];
+static volatile unsigned head;
+static volatile unsigned tail;
+static volatile uint32_t dropped;
+static uint32_t dropped_reported;
+
+/*---------------------------------------------------------------------------*/
+static void
+put_le(uint8_t *p, uint64_t value, uint8_t size)
+{
+  while(size-- > 0) {
+    *p++ = value & 0xff;
+    value >>= 8;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+begin_id(struct log_binary_record *rec, uint16_t id)
+{
+  put_le(rec->data, id, 2);
+  put_le(rec->data + 2, (uint32_t)LOG_BINARY_TIMESTAMP(), 4);
+  rec->len = HEADER_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_begin(struct log_binary_record *rec, const char *fmt)
+{
+  begin_id(rec, (uint16_t)(fmt - __start_log_fmt));
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_put_int(struct log_binary_record *rec, uint64_t value,
+                   uint8_t size)
+{
+  size = size > 4 ? 8 : 4;
+  if(rec->len + 1 + size > LOG_BINARY_RECORD_SIZE) {
+    return;
+  }
+  rec->data[rec->len] = size == 8 ? LOG_BINARY_TAG_INT64 : LOG_BINARY_TAG_INT32;
+  put_le(&rec->data[rec->len + 1], value, size);
+  rec->len += 1 + size;
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_put_double(struct log_binary_record *rec, double value)
+{
+  if(rec->len + 1 + sizeof(value) > LOG_BINARY_RECORD_SIZE) {
+    return;
+  }
+  rec->data[rec->len] = LOG_BINARY_TAG_DOUBLE;
+  memcpy(&rec->data[rec->len + 1], &value, sizeof(value));
+  rec->len += 1 + sizeof(value);
+}
+/*---------------------------------------------------------------------------*/
+static void
+put_bytes(struct log_binary_record *rec, uint8_t tag,
+          const void *data, size_t length)
+{
+  size_t room;
+
+  if(rec->len + 2 > LOG_BINARY_RECORD_SIZE) {
+    return;
+  }
+  room = LOG_BINARY_RECORD_SIZE - rec->len - 2;
+  if(length > room) {
+    length = room;
+  }
+  rec->data[rec->len] = tag;
+  rec->data[rec->len + 1] = length;
+  if(length > 0) {
+    memcpy(&rec->data[rec->len + 2], data, length);
+  }
+  rec->len += 2 + length;
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_put_str(struct log_binary_record *rec, const char *str)
+{
+  if(str == NULL) {
+    str = "(null)";
+  }
+  put_bytes(rec, LOG_BINARY_TAG_STRING, str,
+            strnlen(str, LOG_BINARY_RECORD_SIZE));
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_put_bytes(struct log_binary_record *rec,
+                     const void *data, size_t length)
+{
+  put_bytes(rec, LOG_BINARY_TAG_BYTES, data, data != NULL ? length : 0);
+}
+/*---------------------------------------------------------------------------*/
+static void
+ring_copy_in(unsigned pos, const uint8_t *src, unsigned len)
+{
+  unsigned first = LOG_BINARY_BUFSIZE - (pos & MASK);
+
+  if(first > len) {
+    first = len;
+  }
+  memcpy(&ring[pos & MASK], src, first);
+  memcpy(ring, src + first, len - first);
+}
+/*---------------------------------------------------------------------------*/
+static void
+ring_copy_out(unsigned pos, uint8_t *dst, unsigned len)
+{
+  unsigned first = LOG_BINARY_BUFSIZE - (pos & MASK);
+
+  if(first > len) {
+    first = len;
+  }
+  memcpy(dst, &ring[pos & MASK], first);
+  memcpy(dst + first, ring, len - first);
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_end(struct log_binary_record *rec)
+{
+  int_master_status_t status;
+  unsigned h;
+
+  status = int_master_read_and_disable();
+  h = head;
+  if(LOG_BINARY_BUFSIZE - (h - tail) < (unsigned)rec->len + 1) {
+    dropped++;
+    int_master_status_set(status);
+    return;
+  }
+  ring[h & MASK] = rec->len;
+  ring_copy_in(h + 1, rec->data, rec->len);
+  /* Publish the record only once it is completely written */
+  memory_barrier();
+  head = h + 1 + rec->len;
+  int_master_status_set(status);
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+log_binary_dropped(void)
+{
+  return dropped;
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_record(const uint8_t *data, uint8_t len)
+{
+  uint8_t frame[2 * LOG_BINARY_RECORD_SIZE + 2];
+  unsigned n = 0;
+  uint8_t i;
+
+  frame[n++] = SLIP_END;
+  for(i = 0; i < len; i++) {
+    if(data[i] == SLIP_END) {
+      frame[n++] = SLIP_ESC;
+      frame[n++] = SLIP_ESC_END;
+    } else if(data[i] == SLIP_ESC) {
+      frame[n++] = SLIP_ESC;
+      frame[n++] = SLIP_ESC_ESC;
+    } else {
+      frame[n++] = data[i];
+    }
+  }
+  frame[n++] = SLIP_END;
+  LOG_BINARY_WRITE(frame, n);
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_meta(uint16_t id, uint32_t value)
+{
+  struct log_binary_record rec;
+
+  begin_id(&rec, id);
+  log_binary_put_int(&rec, value, sizeof(value));
+  write_record(rec.data, rec.len);
+}
+/*---------------------------------------------------------------------------*/
+static bool
+drain_one(void)
+{
+  uint8_t data[LOG_BINARY_RECORD_SIZE];
+  unsigned t = tail;
+  uint8_t len;
+
+  if(dropped != dropped_reported) {
+    dropped_reported = dropped;
+    write_meta(LOG_BINARY_ID_DROPPED, dropped_reported);
+  }
+
+  if(t == head) {
+    return false;
+  }
+  /* Read the record only after having seen the head that published it */
+  memory_barrier();
+  len = ring[t & MASK];
+  ring_copy_out(t + 1, data, len);
+  memory_barrier();
+  tail = t + 1 + len;
+
+  write_record(data, len);
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+bool
+log_binary_drain(void)
+{
+  int i;
+
+  for(i = 0; i < LOG_BINARY_DRAIN_RECORDS; i++) {
+    if(!drain_one()) {
+      return false;
+    }
+  }
+  return head != tail;
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_flush(void)
+{
+  while(drain_one());
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_init(void)
+{
+  write_meta(LOG_BINARY_ID_HELLO, LOG_BINARY_TIMESTAMP_SECOND);
+}
+/*---------------------------------------------------------------------------*/
+#endif /* LOG_WITH_BINARY */
+/** @} */
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Header file for binary, deferred logging
+ */
+
+/** \addtogroup log
+ * @{ */
+
+/**
+ * \defgroup log-binary Binary deferred logging
+ * @{
+ *
+ * With LOG_CONF_WITH_BINARY enabled, the LOG_* macros do not format
+ * anything on the device. Each call site instead places its format
+ * string, log level and module name in the log_fmt linker section and
+ * emits a small record holding the offset of that entry, a timestamp
+ * and the raw arguments. Records are queued in a ring buffer and
+ * written out, SLIP framed, from the main loop once the system is idle.
+ *
+ * tools/log-decoder/log-decoder.py reads the format strings from the
+ * ELF file and turns the record stream back into text.
+ *
+ * A record on the wire looks as follows (all fields little endian):
+ *
+ *   id (2 bytes) | timestamp (4 bytes) | argument ... argument
+ *
+ * where each argument starts with a one-byte tag giving its encoding.
+ * Ids from LOG_BINARY_ID_RESERVED upwards carry meta information
+ * (the timestamp resolution and the number of dropped records).
+ */
+
+#ifndef LOG_BINARY_H_
+#define LOG_BINARY_H_
+
+#include "contiki.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Maximum size of one record. Arguments that do not fit are dropped
+ * and strings are truncated. */
+#ifdef LOG_BINARY_CONF_RECORD_SIZE
+#define LOG_BINARY_RECORD_SIZE LOG_BINARY_CONF_RECORD_SIZE
+#else /* LOG_BINARY_CONF_RECORD_SIZE */
+#define LOG_BINARY_RECORD_SIZE 64
+#endif /* LOG_BINARY_CONF_RECORD_SIZE */
+
+/* Size of the record ring buffer in bytes. Must be a power of two. */
+#ifdef LOG_BINARY_CONF_BUFSIZE
+#define LOG_BINARY_BUFSIZE LOG_BINARY_CONF_BUFSIZE
+#else /* LOG_BINARY_CONF_BUFSIZE */
+#define LOG_BINARY_BUFSIZE 1024
+#endif /* LOG_BINARY_CONF_BUFSIZE */
+
+/* Maximum number of records written out per call to log_binary_drain() */
+#ifdef LOG_BINARY_CONF_DRAIN_RECORDS
+#define LOG_BINARY_DRAIN_RECORDS LOG_BINARY_CONF_DRAIN_RECORDS
+#else /* LOG_BINARY_CONF_DRAIN_RECORDS */
+#define LOG_BINARY_DRAIN_RECORDS 8
+#endif /* LOG_BINARY_CONF_DRAIN_RECORDS */
+
+/* Record timestamp and its resolution in ticks per second */
+#ifdef LOG_BINARY_CONF_TIMESTAMP
+#define LOG_BINARY_TIMESTAMP() LOG_BINARY_CONF_TIMESTAMP()
+#define LOG_BINARY_TIMESTAMP_SECOND LOG_BINARY_CONF_TIMESTAMP_SECOND
+#else /* LOG_BINARY_CONF_TIMESTAMP */
+#define LOG_BINARY_TIMESTAMP() RTIMER_NOW()
+#define LOG_BINARY_TIMESTAMP_SECOND RTIMER_SECOND
+#endif /* LOG_BINARY_CONF_TIMESTAMP */
+
+/* Output function for framed records, called from the main loop */
+#ifdef LOG_BINARY_CONF_WRITE
+#define LOG_BINARY_WRITE(buf, len) LOG_BINARY_CONF_WRITE(buf, len)
+#else /* LOG_BINARY_CONF_WRITE */
+#define LOG_BINARY_WRITE(buf, len) fwrite(buf, 1, len, stdout)
+#endif /* LOG_BINARY_CONF_WRITE */
+
+/* Attribute placing a format entry in the format section. The section
+ * name must be a valid C identifier so that the linker provides the
+ * __start_log_fmt symbol the record ids are relative to. */
+#ifdef LOG_BINARY_CONF_SECTION
+#define LOG_BINARY_SECTION LOG_BINARY_CONF_SECTION
+#else /* LOG_BINARY_CONF_SECTION */
+#define LOG_BINARY_SECTION __attribute__((section("log_fmt"), used, aligned(1)))
+#endif /* LOG_BINARY_CONF_SECTION */
+
+/* Reserved record ids. The link fails if the log_fmt section reaches
+ * LOG_BINARY_ID_RESERVED, see the link rule in Makefile.include. */
+#define LOG_BINARY_ID_RESERVED  0xfff0
+#define LOG_BINARY_ID_DROPPED   0xfffe
+#define LOG_BINARY_ID_HELLO     0xffff
+
+/* Argument tags */
+#define LOG_BINARY_TAG_INT32    'i'
+#define LOG_BINARY_TAG_INT64    'l'
+#define LOG_BINARY_TAG_DOUBLE   'd'
+#define LOG_BINARY_TAG_STRING   's'
+#define LOG_BINARY_TAG_BYTES    'b'
+
+/** \brief A record under construction on the stack of the caller */
+struct log_binary_record {
+  uint8_t len;
+  uint8_t data[LOG_BINARY_RECORD_SIZE];
+};
+
+/* Format entries for the address and byte logging macros */
+extern const char log_binary_fmt_lladdr[];
+extern const char log_binary_fmt_6addr[];
+extern const char log_binary_fmt_bytes[];
+
+/**
+ * \brief Start a new record
+ * \param rec The record
+ * \param fmt The format entry of the call site, in the log_fmt section
+ */
+void log_binary_begin(struct log_binary_record *rec, const char *fmt);
+
+/**
+ * \brief Queue a finished record for output
+ * \param rec The record
+ *
+ * This function may be called from interrupt context.
+ */
+void log_binary_end(struct log_binary_record *rec);
+
+/** \brief Append an integer argument of up to 64 bits */
+void log_binary_put_int(struct log_binary_record *rec, uint64_t value,
+                        uint8_t size);
+/** \brief Append a floating point argument */
+void log_binary_put_double(struct log_binary_record *rec, double value);
+/** \brief Append a string argument, truncated to fit the record */
+void log_binary_put_str(struct log_binary_record *rec, const char *str);
+/** \brief Append a raw byte array, truncated to fit the record */
+void log_binary_put_bytes(struct log_binary_record *rec,
+                          const void *data, size_t length);
+
+/** \brief The number of records dropped because the buffer was full */
+uint32_t log_binary_dropped(void);
+
+/**
+ * \brief Write out queued records
+ * \return true if records remain queued
+ *
+ * Called from the main loop when there are no more events to process.
+ * At most LOG_BINARY_DRAIN_RECORDS records are written per call.
+ */
+bool log_binary_drain(void);
+
+/**
+ * \brief Write out all queued records
+ *
+ * Useful before a reboot or when the system is about to halt.
+ */
+void log_binary_flush(void);
+
+/** \brief Announce the timestamp resolution to the decoder */
+void log_binary_init(void);
+
+/* Per-argument encoding. The selector must be valid for every argument
+ * type, so the value passed on is narrowed by a second selection that
+ * only yields the argument itself for the matching types. */
+#define LOG_BINARY_AS_DOUBLE(x) _Generic((x), float: (x), double: (x), \
+                                         default: 0.0)
+#define LOG_BINARY_AS_STR(x) _Generic((x), char *: (x), const char *: (x), \
+                                      default: (const char *)0)
+#define LOG_BINARY_AS_LL(x) _Generic((x), long: (x), unsigned long: (x), \
+                                     long long: (x), \
+                                     unsigned long long: (x), default: 0)
+
+#define LOG_BINARY_PUT(rec, x) _Generic((x), \
+  float: log_binary_put_double((rec), LOG_BINARY_AS_DOUBLE(x)), \
+  double: log_binary_put_double((rec), LOG_BINARY_AS_DOUBLE(x)), \
+  char *: log_binary_put_str((rec), LOG_BINARY_AS_STR(x)), \
+  const char *: log_binary_put_str((rec), LOG_BINARY_AS_STR(x)), \
+  long: log_binary_put_int((rec), LOG_BINARY_AS_LL(x), sizeof(x)), \
+  unsigned long: log_binary_put_int((rec), LOG_BINARY_AS_LL(x), sizeof(x)), \
+  long long: log_binary_put_int((rec), LOG_BINARY_AS_LL(x), sizeof(x)), \
+  unsigned long long: log_binary_put_int((rec), LOG_BINARY_AS_LL(x), \
+                                         sizeof(x)), \
+  default: log_binary_put_int((rec), (uint64_t)(uintptr_t)(x), sizeof(x)))
+
+/* Apply LOG_BINARY_PUT to up to 12 arguments */
+#define LOG_BINARY_NARGS(...) LOG_BINARY_NARGS_(_, ##__VA_ARGS__, \
+                              12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_BINARY_NARGS_(_, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, \
+                          a11, a12, n, ...) n
+#define LOG_BINARY_CAT(a, b) LOG_BINARY_CAT_(a, b)
+#define LOG_BINARY_CAT_(a, b) a##b
+#define LOG_BINARY_PUT_ALL(rec, ...) \
+  LOG_BINARY_CAT(LOG_BINARY_PUT_, LOG_BINARY_NARGS(__VA_ARGS__))(rec, ##__VA_ARGS__)
+#define LOG_BINARY_PUT_0(rec)
+#define LOG_BINARY_PUT_1(rec, x) LOG_BINARY_PUT(rec, x)
+#define LOG_BINARY_PUT_2(rec, x, ...) LOG_BINARY_PUT(rec, x); LOG_BINARY_PUT_1(rec, __VA_ARGS__)
+#define LOG_BINARY_PUT_3(rec, x, ...) LOG_BINARY_PUT(rec, x); LOG_BINARY_PUT_2(rec, __VA_ARGS__)
+#define LOG_BINARY_PUT_4(rec, x, ...) LOG_BINARY_PUT(rec, x); LOG_BINARY_PUT_3(rec, __VA_ARGS__)
+#define LOG_BINARY_PUT_5(rec, x, ...) LOG_BINARY_PUT(rec, x); LOG_BINARY_PUT_4(rec, __VA_ARGS__)
+#define LOG_BINARY_PUT_6(rec, x, ...) LOG_BINARY_PUT(rec, x); LOG_BINARY_PUT_5(rec, __VA_ARGS__)
+#define LOG_BINARY_PUT_7(rec, x, ...) LOG_BINARY_PUT(rec, x); LOG_BINARY_PUT_6(rec, __VA_ARGS__)
+#define LOG_BINARY_PUT_8(rec, x, ...) LOG_BINARY_PUT(rec, x); LOG_BINARY_PUT_7(rec, __VA_ARGS__)
+#define LOG_BINARY_PUT_9(rec, x, ...) LOG_BINARY_PUT(rec, x); LOG_BINARY_PUT_8(rec, __VA_ARGS__)
+#define LOG_BINARY_PUT_10(rec, x, ...) LOG_BINARY_PUT(rec, x); LOG_BINARY_PUT_9(rec, __VA_ARGS__)
+#define LOG_BINARY_PUT_11(rec, x, ...) LOG_BINARY_PUT(rec, x); LOG_BINARY_PUT_10(rec, __VA_ARGS__)
+#define LOG_BINARY_PUT_12(rec, x, ...) LOG_BINARY_PUT(rec, x); LOG_BINARY_PUT_11(rec, __VA_ARGS__)
+
+/**
+ * \brief Emit a binary log record
+ *
+ * The format entry is the newline flag, the level string, the module
+ * name and the format string, separated by NUL characters. The format
+ * must therefore be a string literal.
+ */
+#define LOG_BINARY(newline, levelstr, fmt, ...) do { \
+    static const char log_binary_fmt[] LOG_BINARY_SECTION = \
+      #newline levelstr "\0" LOG_MODULE "\0" fmt; \
+    struct log_binary_record log_binary_rec; \
+    log_binary_begin(&log_binary_rec, log_binary_fmt); \
+    LOG_BINARY_PUT_ALL(&log_binary_rec, ##__VA_ARGS__); \
+    log_binary_end(&log_binary_rec); \
+  } while(0)
+
+/** \brief Emit a record holding a raw byte array */
+#define LOG_BINARY_BYTES(fmt, data, length) do { \
+    struct log_binary_record log_binary_rec; \
+    log_binary_begin(&log_binary_rec, (fmt)); \
+    log_binary_put_bytes(&log_binary_rec, (data), (length)); \
+    log_binary_end(&log_binary_rec); \
+  } while(0)
+
+#endif /* LOG_BINARY_H_ */
+/** @} */
+/** @} */
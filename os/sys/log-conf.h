@@ -75,6 +75,15 @@
 #define LOG_WITH_ANNOTATE 0
 #endif /* LOG_CONF_WITH_ANNOTATE */
 
+/* Emit compact binary records instead of formatting with printf. The
+ * records are decoded on the host with tools/log-decoder, see
+ * sys/log-binary.h */
+#ifdef LOG_CONF_WITH_BINARY
+#define LOG_WITH_BINARY LOG_CONF_WITH_BINARY
+#else /* LOG_CONF_WITH_BINARY */
+#define LOG_WITH_BINARY 0
+#endif /* LOG_CONF_WITH_BINARY */
+
 /* Custom output function -- default is printf */
 #ifdef LOG_CONF_OUTPUT
 #define LOG_OUTPUT(...) LOG_CONF_OUTPUT(__VA_ARGS__)
@@ -54,6 +54,9 @@
 #include <stdio.h>
 #include "net/linkaddr.h"
 #include "sys/log-conf.h"
+#if LOG_WITH_BINARY
+#include "sys/log-binary.h"
+#endif /* LOG_WITH_BINARY */
 #if NETSTACK_CONF_WITH_IPV6
 #include "net/ipv6/uip.h"
 #endif /* NETSTACK_CONF_WITH_IPV6 */
@@ -138,6 +141,38 @@ extern struct log_module all_modules[];
 
 /* Main log function */
 
+#if LOG_WITH_BINARY
+
+#define LOG(newline, level, levelstr, levelcolor, ...) do {  \
+                            if(level <= (LOG_LEVEL)) { \
+                              LOG_BINARY(newline, levelstr, __VA_ARGS__); \
+                            } \
+                          } while (0)
+
+/* Link-layer address */
+#define LOG_LLADDR(level, lladdr) do {  \
+                            if(level <= (LOG_LEVEL)) { \
+                              LOG_BINARY_BYTES(log_binary_fmt_lladdr, \
+                                               lladdr, LINKADDR_SIZE); \
+                            } \
+                        } while (0)
+
+/* IPv6 address */
+#define LOG_6ADDR(level, ipaddr) do {  \
+                           if(level <= (LOG_LEVEL)) { \
+                             LOG_BINARY_BYTES(log_binary_fmt_6addr, ipaddr, 16); \
+                           } \
+                         } while (0)
+
+#define LOG_BYTES(level, data, length) do {  \
+                           if(level <= (LOG_LEVEL)) { \
+                             LOG_BINARY_BYTES(log_binary_fmt_bytes, \
+                                              data, length); \
+                           } \
+                         } while (0)
+
+#else /* LOG_WITH_BINARY */
+
 #define LOG(newline, level, levelstr, levelcolor, ...) do {  \
                             if(level <= (LOG_LEVEL)) { \
                               if(newline) { \
@@ -158,13 +193,6 @@ extern struct log_module all_modules[];
                             } \
                           } while (0)
 
-/* For Cooja annotations */
-#define LOG_ANNOTATE(...) do {  \
-                            if(LOG_WITH_ANNOTATE) { \
-                              LOG_OUTPUT(__VA_ARGS__); \
-                            } \
-                        } while (0)
-
 /* Link-layer address */
 #define LOG_LLADDR(level, lladdr) do {  \
                             if(level <= (LOG_LEVEL)) { \
@@ -193,6 +221,15 @@ extern struct log_module all_modules[];
                            } \
                          } while (0)
 
+#endif /* LOG_WITH_BINARY */
+
+/* For Cooja annotations */
+#define LOG_ANNOTATE(...) do {  \
+                            if(LOG_WITH_ANNOTATE) { \
+                              LOG_OUTPUT(__VA_ARGS__); \
+                            } \
+                        } while (0)
+
 /* More compact versions of LOG macros */
 #define LOG_PRINT(...)         LOG(1, 0, "PRI", LOG_COLOR_PRI, __VA_ARGS__)
 #define LOG_ERR(...)           LOG(1, LOG_LEVEL_ERR, "ERR", LOG_COLOR_ERR, __VA_ARGS__)
@@ -44,9 +44,12 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "contiki.h"
 #include "sys/process.h"
+#include "sys/rtimer.h"
+#include "sys/int-master.h"
 
 #include "sys/log.h"
 #define LOG_MODULE "Process"
@@ -65,6 +68,19 @@ static_assert(PROCESS_CONF_NUMEVENTS > 0 && PROCESS_CONF_NUMEVENTS <= 128,
 static_assert(!(PROCESS_CONF_NUMEVENTS & (PROCESS_CONF_NUMEVENTS - 1)),
   "PROCESS_CONF_NUMEVENTS must be a power of 2.");
 
+#if PROCESS_CONF_WITH_PRIORITY
+static_assert(PROCESS_CONF_NUMEVENTS_HIGH > 0 &&
+              PROCESS_CONF_NUMEVENTS_HIGH <= 64 &&
+              !(PROCESS_CONF_NUMEVENTS_HIGH & (PROCESS_CONF_NUMEVENTS_HIGH - 1)),
+  "PROCESS_CONF_NUMEVENTS_HIGH must be a power of 2 of at most 64.");
+#define PROCESS_QUEUES 2
+#else
+#define PROCESS_QUEUES 1
+#endif /* PROCESS_CONF_WITH_PRIORITY */
+
+static_assert(PROCESS_CONF_DRAIN_EVENTS > 0,
+  "PROCESS_CONF_DRAIN_EVENTS must be positive.");
+
 /*
  * A configurable function called after a process poll been requested.
  */
@@ -90,10 +106,36 @@ struct event_data {
   process_data_t data;
   struct process *p;
   process_event_t ev;
+#if PROCESS_CONF_PROFILE
+  rtimer_clock_t posted;
+#endif /* PROCESS_CONF_PROFILE */
+};
+
+/*
+ * A ring of events, one for each priority. The size is a power of 2.
+ */
+struct event_queue {
+  struct event_data *events;
+  process_num_events_t size;
+  process_num_events_t nevents;
+  process_num_events_t fevent;
+  uint32_t dropped;
 };
 
-static process_num_events_t nevents, fevent;
 static struct event_data events[PROCESS_CONF_NUMEVENTS];
+#if PROCESS_CONF_WITH_PRIORITY
+static struct event_data high_events[PROCESS_CONF_NUMEVENTS_HIGH];
+#endif /* PROCESS_CONF_WITH_PRIORITY */
+
+static struct event_queue queues[PROCESS_QUEUES] = {
+  { events, PROCESS_CONF_NUMEVENTS, 0, 0, 0 },
+#if PROCESS_CONF_WITH_PRIORITY
+  { high_events, PROCESS_CONF_NUMEVENTS_HIGH, 0, 0, 0 },
+#endif /* PROCESS_CONF_WITH_PRIORITY */
+};
+
+/* The total number of events in the queues */
+static process_num_events_t nevents;
 
 #if PROCESS_CONF_STATS
 process_num_events_t process_maxevents;
@@ -101,6 +143,21 @@ process_num_events_t process_maxevents;
 
 static volatile bool poll_requested;
 
+#if PROCESS_CONF_POLL_QUEUE
+/* The processes to poll, in the order of the requests */
+static struct process *poll_head;
+static struct process *poll_tail;
+#endif /* PROCESS_CONF_POLL_QUEUE */
+
+#if PROCESS_CONF_PROFILE
+/* Time spent in nested calls during the current call, to be deducted
+   from the run time of the calling process */
+static uint32_t profile_nested;
+
+#define PROFILE_ELAPSED(start) \
+  ((uint32_t)(rtimer_clock_t)(PROCESS_PROFILE_NOW() - (start)))
+#endif /* PROCESS_CONF_PROFILE */
+
 #define PROCESS_STATE_NONE        0
 #define PROCESS_STATE_RUNNING     1
 #define PROCESS_STATE_CALLED      2
@@ -209,7 +266,22 @@ call_process(struct process *p, process_event_t ev, process_data_t data)
             PROCESS_NAME_STRING(p), ev);
     process_current = p;
     p->state = PROCESS_STATE_CALLED;
+#if PROCESS_CONF_PROFILE
+    uint32_t outer_nested = profile_nested;
+    profile_nested = 0;
+    rtimer_clock_t start = PROCESS_PROFILE_NOW();
+#endif /* PROCESS_CONF_PROFILE */
     int ret = p->thread(&p->pt, ev, data);
+#if PROCESS_CONF_PROFILE
+    uint32_t elapsed = PROFILE_ELAPSED(start);
+    uint32_t self = elapsed > profile_nested ? elapsed - profile_nested : 0;
+    p->profile.calls++;
+    p->profile.run_time += self;
+    if(self > p->profile.max_run_time) {
+      p->profile.max_run_time = self;
+    }
+    profile_nested = outer_nested + elapsed;
+#endif /* PROCESS_CONF_PROFILE */
     if(ret == PT_EXITED || ret == PT_ENDED || ev == PROCESS_EVENT_EXIT) {
       exit_process(p, p);
     } else {
@@ -234,6 +306,32 @@ process_init(void)
  * Call each process' poll handler.
  */
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_POLL_QUEUE
+static void
+do_poll(void)
+{
+  struct process *p;
+  struct process *next;
+
+  /* Take the queue: the processes polled from now on go to a new one,
+     for the next round. */
+  int_master_status_t status = int_master_read_and_disable();
+  poll_requested = false;
+  p = poll_head;
+  poll_head = poll_tail = NULL;
+  int_master_status_set(status);
+
+  for(; p != NULL; p = next) {
+    next = p->next_poll;
+    p->needspoll = false;
+    /* The process may have exited since it was polled */
+    if(process_is_running(p)) {
+      p->state = PROCESS_STATE_RUNNING;
+      call_process(p, PROCESS_EVENT_POLL, NULL);
+    }
+  }
+}
+#else /* PROCESS_CONF_POLL_QUEUE */
 static void
 do_poll(void)
 {
@@ -247,6 +345,18 @@ do_poll(void)
     }
   }
 }
+#endif /* PROCESS_CONF_POLL_QUEUE */
+#if PROCESS_CONF_PROFILE
+static void
+profile_event(struct process *p, uint32_t delay)
+{
+  p->profile.events++;
+  p->profile.event_delay += delay;
+  if(delay > p->profile.max_event_delay) {
+    p->profile.max_event_delay = delay;
+  }
+}
+#endif /* PROCESS_CONF_PROFILE */
 /*---------------------------------------------------------------------------*/
 /*
  * Process the next event in the event queue and deliver it to
@@ -265,14 +375,24 @@ do_event(void)
    */
   if(nevents > 0) {
 
-    /* There are events that we should deliver. */
-    process_event_t ev = events[fevent].ev;
-    process_data_t data = events[fevent].data;
-    struct process *receiver = events[fevent].p;
+    /* There are events that we should deliver. Take them from the
+       highest priority queue that has some. */
+    struct event_queue *q = &queues[PROCESS_QUEUES - 1];
+    while(q->nevents == 0) {
+      q--;
+    }
+    struct event_data *e = &q->events[q->fevent];
+    process_event_t ev = e->ev;
+    process_data_t data = e->data;
+    struct process *receiver = e->p;
+#if PROCESS_CONF_PROFILE
+    uint32_t delay = PROFILE_ELAPSED(e->posted);
+#endif /* PROCESS_CONF_PROFILE */
 
     /* Since we have seen the new event, we move pointer upwards
        and decrease the number of events. */
-    fevent = (fevent + 1) % PROCESS_CONF_NUMEVENTS;
+    q->fevent = (q->fevent + 1) & (q->size - 1);
+    --q->nevents;
     --nevents;
 
     /* If this is a broadcast event, we deliver it to all events, in
@@ -284,6 +404,11 @@ do_event(void)
         if(poll_requested) {
           do_poll();
         }
+#if PROCESS_CONF_PROFILE
+        if(process_is_running(p)) {
+          profile_event(p, delay);
+        }
+#endif /* PROCESS_CONF_PROFILE */
         call_process(p, ev, data);
       }
     } else {
@@ -295,6 +420,12 @@ do_event(void)
         receiver->state = PROCESS_STATE_RUNNING;
       }
 
+#if PROCESS_CONF_PROFILE
+      if(process_is_running(receiver)) {
+        profile_event(receiver, delay);
+      }
+#endif /* PROCESS_CONF_PROFILE */
+
       /* Make sure that the process actually is running. */
       call_process(receiver, ev, data);
     }
@@ -309,8 +440,15 @@ process_run(void)
     do_poll();
   }
 
-  /* Process one event from the queue */
+  /* Process events from the queue, up to the drain limit, and the
+     polls requested meanwhile */
   do_event();
+  for(int i = 1; i < PROCESS_CONF_DRAIN_EVENTS && nevents > 0; i++) {
+    if(poll_requested) {
+      do_poll();
+    }
+    do_event();
+  }
 
   return nevents + poll_requested;
 }
@@ -324,7 +462,16 @@ process_nevents(void)
 int
 process_post(struct process *p, process_event_t ev, process_data_t data)
 {
-  if(nevents == PROCESS_CONF_NUMEVENTS) {
+#if PROCESS_CONF_WITH_PRIORITY
+  struct event_queue *q = &queues[p != PROCESS_BROADCAST &&
+                                  p->priority == PROCESS_PRIORITY_HIGH];
+#else
+  struct event_queue *q = &queues[0];
+#endif /* PROCESS_CONF_WITH_PRIORITY */
+
+  if(q->nevents == q->size) {
+    /* Drop the new event: the queued ones keep their order */
+    q->dropped++;
     LOG_WARN("Cannot post event %d to %s from %s because the queue is full\n",
              ev,
              p == PROCESS_BROADCAST ? "<broadcast>" : PROCESS_NAME_STRING(p),
@@ -338,10 +485,14 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
           nevents);
 
   process_num_events_t snum =
-    (process_num_events_t)(fevent + nevents) % PROCESS_CONF_NUMEVENTS;
-  events[snum].ev = ev;
-  events[snum].data = data;
-  events[snum].p = p;
+    (process_num_events_t)(q->fevent + q->nevents) & (q->size - 1);
+  q->events[snum].ev = ev;
+  q->events[snum].data = data;
+  q->events[snum].p = p;
+#if PROCESS_CONF_PROFILE
+  q->events[snum].posted = PROCESS_PROFILE_NOW();
+#endif /* PROCESS_CONF_PROFILE */
+  ++q->nevents;
   ++nevents;
 
 #if PROCESS_CONF_STATS
@@ -367,8 +518,24 @@ process_poll(struct process *p)
 {
   if(p != NULL &&
      (p->state == PROCESS_STATE_RUNNING || p->state == PROCESS_STATE_CALLED)) {
+#if PROCESS_CONF_POLL_QUEUE
+    int_master_status_t status = int_master_read_and_disable();
+    if(!p->needspoll) {
+      p->next_poll = NULL;
+      if(poll_tail != NULL) {
+        poll_tail->next_poll = p;
+      } else {
+        poll_head = p;
+      }
+      poll_tail = p;
+    }
+    p->needspoll = true;
+    poll_requested = true;
+    int_master_status_set(status);
+#else /* PROCESS_CONF_POLL_QUEUE */
     p->needspoll = true;
     poll_requested = true;
+#endif /* PROCESS_CONF_POLL_QUEUE */
     PROCESS_POLL_REQUESTED();
   }
 }
@@ -379,4 +546,20 @@ process_is_running(struct process *p)
   return p->state != PROCESS_STATE_NONE;
 }
 /*---------------------------------------------------------------------------*/
+uint32_t
+process_dropped_events(uint8_t priority)
+{
+  return priority < PROCESS_QUEUES ? queues[priority].dropped : 0;
+}
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_PROFILE
+void
+process_profile_reset(void)
+{
+  for(struct process *p = process_list; p != NULL; p = p->next) {
+    memset(&p->profile, 0, sizeof(p->profile));
+  }
+}
+#endif /* PROCESS_CONF_PROFILE */
+/*---------------------------------------------------------------------------*/
 /** @} */
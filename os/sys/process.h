@@ -86,10 +86,66 @@ typedef uint8_t       process_num_events_t;
 
 #define PROCESS_NONE          NULL
 
+/**
+ * \name Process priorities
+ * @{
+ */
+#define PROCESS_PRIORITY_NORMAL 0
+#define PROCESS_PRIORITY_HIGH   1
+/** @} */
+
 #ifndef PROCESS_CONF_NUMEVENTS
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+/*
+ * Give events posted to high priority processes (see
+ * process_set_priority()) their own queue, which process_run() always
+ * serves first. Its size must be a power of 2.
+ */
+#ifndef PROCESS_CONF_WITH_PRIORITY
+#define PROCESS_CONF_WITH_PRIORITY 0
+#endif /* PROCESS_CONF_WITH_PRIORITY */
+
+#ifndef PROCESS_CONF_NUMEVENTS_HIGH
+#define PROCESS_CONF_NUMEVENTS_HIGH 16
+#endif /* PROCESS_CONF_NUMEVENTS_HIGH */
+
+/*
+ * The maximum number of events that one process_run() call delivers,
+ * calling the poll handlers in between.
+ */
+#ifndef PROCESS_CONF_DRAIN_EVENTS
+#define PROCESS_CONF_DRAIN_EVENTS 1
+#endif /* PROCESS_CONF_DRAIN_EVENTS */
+
+/*
+ * Keep the polled processes in a queue, so that the poll handlers are
+ * called in the order of the requests without walking the whole
+ * process list. The queue is updated with interrupts disabled.
+ */
+#ifndef PROCESS_CONF_POLL_QUEUE
+#define PROCESS_CONF_POLL_QUEUE 0
+#endif /* PROCESS_CONF_POLL_QUEUE */
+
+/*
+ * Enable the process profiler, which records the time spent in each
+ * process and how long events wait in the event queue. The time
+ * source defaults to the rtimer; platforms where it is too coarse can
+ * set PROCESS_CONF_PROFILE_NOW() and PROCESS_CONF_PROFILE_SECOND.
+ */
+#ifndef PROCESS_CONF_PROFILE
+#define PROCESS_CONF_PROFILE 0
+#endif /* PROCESS_CONF_PROFILE */
+
+#ifdef PROCESS_CONF_PROFILE_NOW
+#define PROCESS_PROFILE_NOW()  PROCESS_CONF_PROFILE_NOW()
+#define PROCESS_PROFILE_SECOND PROCESS_CONF_PROFILE_SECOND
+#else
+#define PROCESS_PROFILE_NOW()  RTIMER_NOW()
+#define PROCESS_PROFILE_SECOND RTIMER_SECOND
+#endif /* PROCESS_CONF_PROFILE_NOW */
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -313,6 +369,22 @@ static PT_THREAD(process_thread_##name(struct pt *process_pt,	\
 
 /** @} */
 
+#if PROCESS_CONF_PROFILE
+/**
+ * Profiling counters of a process, with times in
+ * PROCESS_PROFILE_SECOND units. The run time of a process does not
+ * include the processes that it calls synchronously.
+ */
+struct process_profile {
+  uint32_t calls;           /**< Number of calls of the process thread */
+  uint32_t run_time;        /**< Total time spent in the process thread */
+  uint32_t max_run_time;    /**< Longest single call */
+  uint32_t events;          /**< Number of events taken from the queue */
+  uint32_t event_delay;     /**< Total time these events were queued */
+  uint32_t max_event_delay; /**< Longest time an event was queued */
+};
+#endif /* PROCESS_CONF_PROFILE */
+
 struct process {
   struct process *next;
 #if PROCESS_CONF_NO_PROCESS_NAMES
@@ -325,6 +397,15 @@ struct process {
   struct pt pt;
   uint8_t state;
   bool needspoll;
+#if PROCESS_CONF_POLL_QUEUE
+  struct process *next_poll;
+#endif /* PROCESS_CONF_POLL_QUEUE */
+#if PROCESS_CONF_WITH_PRIORITY
+  uint8_t priority;
+#endif /* PROCESS_CONF_WITH_PRIORITY */
+#if PROCESS_CONF_PROFILE
+  struct process_profile profile;
+#endif /* PROCESS_CONF_PROFILE */
 };
 
 /**
@@ -527,6 +608,38 @@ bool process_is_running(struct process *p);
  */
 process_num_events_t process_nevents(void);
 
+/**
+ * Set the priority of a process.
+ *
+ * Events posted to a high priority process are queued separately and
+ * delivered before the events of normal priority processes. Without
+ * PROCESS_CONF_WITH_PRIORITY, all processes have the normal priority.
+ *
+ * \param p The process.
+ * \param priority PROCESS_PRIORITY_NORMAL or PROCESS_PRIORITY_HIGH.
+ */
+#if PROCESS_CONF_WITH_PRIORITY
+#define process_set_priority(p, prio) ((p)->priority = (prio))
+#else
+#define process_set_priority(p, prio)
+#endif /* PROCESS_CONF_WITH_PRIORITY */
+
+/**
+ * Number of events that could not be posted because the queue of
+ * the given priority was full.
+ *
+ * \param priority PROCESS_PRIORITY_NORMAL or PROCESS_PRIORITY_HIGH.
+ * \return The number of events dropped since the system started.
+ */
+uint32_t process_dropped_events(uint8_t priority);
+
+#if PROCESS_CONF_PROFILE
+/**
+ * Clear the profiling counters of all running processes.
+ */
+void process_profile_reset(void);
+#endif /* PROCESS_CONF_PROFILE */
+
 /** @} */
 
 extern struct process *process_list;
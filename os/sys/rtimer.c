@@ -50,6 +50,137 @@
 #define LOG_MODULE "RTimer"
 #define LOG_LEVEL LOG_LEVEL_NONE
 
+#if RTIMER_MULTIPLE
+#include "sys/int-master.h"
+
+/* The pending rtimers, sorted by time. The hardware timer is set for
+   the first one. */
+static struct rtimer *rtimer_list;
+/*---------------------------------------------------------------------------*/
+static bool
+is_due(const struct rtimer *t, rtimer_clock_t now)
+{
+  return !RTIMER_CLOCK_LT(now, t->time);
+}
+/*---------------------------------------------------------------------------*/
+/* To be called with interrupts disabled */
+static bool
+list_remove(struct rtimer *rtimer)
+{
+  struct rtimer **pt;
+
+  for(pt = &rtimer_list; *pt != NULL; pt = &(*pt)->next) {
+    if(*pt == rtimer) {
+      *pt = rtimer->next;
+      rtimer->next = NULL;
+      return true;
+    }
+  }
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+int
+rtimer_set(struct rtimer *rtimer, rtimer_clock_t time,
+	   rtimer_clock_t duration,
+	   rtimer_callback_t func, void *ptr)
+{
+  struct rtimer **pt;
+  int_master_status_t status;
+
+  LOG_DBG("rtimer_set time %lu\n", (unsigned long)time);
+
+  status = int_master_read_and_disable();
+
+  for(pt = &rtimer_list; *pt != NULL; pt = &(*pt)->next) {
+    if(*pt == rtimer) {
+      int_master_status_set(status);
+      return RTIMER_ERR_ALREADY_SCHEDULED;
+    }
+  }
+
+  rtimer->func = func;
+  rtimer->ptr = ptr;
+  rtimer->time = time;
+
+  /* After the timers due at the same time, unless of lower priority */
+  for(pt = &rtimer_list; *pt != NULL; pt = &(*pt)->next) {
+    if(RTIMER_CLOCK_LT(time, (*pt)->time) ||
+       (time == (*pt)->time && rtimer->priority > (*pt)->priority)) {
+      break;
+    }
+  }
+  rtimer->next = *pt;
+  *pt = rtimer;
+
+  if(rtimer_list == rtimer) {
+    rtimer_arch_schedule(time);
+  }
+
+  int_master_status_set(status);
+  return RTIMER_OK;
+}
+/*---------------------------------------------------------------------------*/
+bool
+rtimer_cancel(struct rtimer *rtimer)
+{
+  int_master_status_t status = int_master_read_and_disable();
+  bool was_first = rtimer_list == rtimer;
+  bool removed = list_remove(rtimer);
+
+  /* Nothing to do if the hardware timer fires for nothing */
+  if(was_first && rtimer_list != NULL) {
+    rtimer_arch_schedule(rtimer_list->time);
+  }
+
+  int_master_status_set(status);
+  return removed;
+}
+/*---------------------------------------------------------------------------*/
+bool
+rtimer_is_scheduled(struct rtimer *rtimer)
+{
+  struct rtimer *t;
+  int_master_status_t status = int_master_read_and_disable();
+
+  for(t = rtimer_list; t != NULL && t != rtimer; t = t->next);
+
+  int_master_status_set(status);
+  return t != NULL;
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_run_next(void)
+{
+  struct rtimer *t;
+  struct rtimer *best;
+  int_master_status_t status = int_master_read_and_disable();
+
+  /* Run the due timers, the highest priority first, and those that
+     become due meanwhile */
+  while(rtimer_list != NULL && is_due(rtimer_list, RTIMER_NOW())) {
+    rtimer_clock_t now = RTIMER_NOW();
+    best = rtimer_list;
+    for(t = rtimer_list->next; t != NULL && is_due(t, now); t = t->next) {
+      if(t->priority > best->priority) {
+        best = t;
+      }
+    }
+    list_remove(best);
+
+    /* The callback may set timers */
+    int_master_status_set(status);
+    best->func(best, best->ptr);
+    status = int_master_read_and_disable();
+  }
+
+  if(rtimer_list != NULL) {
+    rtimer_arch_schedule(rtimer_list->time);
+  }
+
+  int_master_status_set(status);
+}
+/*---------------------------------------------------------------------------*/
+#else /* RTIMER_MULTIPLE */
 static struct rtimer *next_rtimer;
 
 /*---------------------------------------------------------------------------*/
@@ -85,6 +216,7 @@ rtimer_run_next(void)
   next_rtimer = NULL;
   t->func(t, t->ptr);
 }
+#endif /* RTIMER_MULTIPLE */
 /*---------------------------------------------------------------------------*/
 
 /** @}*/
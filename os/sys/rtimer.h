@@ -104,6 +104,16 @@ typedef uint64_t rtimer_clock_t;
 #define RTIMER_GUARD_TIME (RTIMER_ARCH_SECOND >> 14)
 #endif /* RTIMER_CONF_GUARD_TIME */
 
+/*
+ * Multiplex any number of rtimers on the single hardware timer. Each
+ * struct rtimer can then be pending independently, and can be canceled.
+ */
+#ifdef RTIMER_CONF_MULTIPLE
+#define RTIMER_MULTIPLE RTIMER_CONF_MULTIPLE
+#else /* RTIMER_CONF_MULTIPLE */
+#define RTIMER_MULTIPLE 0
+#endif /* RTIMER_CONF_MULTIPLE */
+
 /*---------------------------------------------------------------------------*/
 
 /**
@@ -136,8 +146,23 @@ struct rtimer {
   rtimer_clock_t time;
   rtimer_callback_t func;
   void *ptr;
+#if RTIMER_MULTIPLE
+  struct rtimer *next;
+  uint8_t priority;
+#endif /* RTIMER_MULTIPLE */
 };
 
+/**
+ * \name Rtimer priorities
+ *
+ * When several rtimers are due, the ones of the highest priority run
+ * first. Only meaningful with RTIMER_CONF_MULTIPLE.
+ * @{
+ */
+#define RTIMER_PRIORITY_NORMAL 0
+#define RTIMER_PRIORITY_HIGH   1
+/** @} */
+
 /**
  * TODO: we need to document meanings of these symbols.
  */
@@ -165,6 +190,31 @@ enum {
 int rtimer_set(struct rtimer *task, rtimer_clock_t time,
 	       rtimer_clock_t duration, rtimer_callback_t func, void *ptr);
 
+#if RTIMER_MULTIPLE
+/**
+ * \brief      Cancel a real-time task.
+ * \param task The task, which may not be pending.
+ * \return     true if the task was pending.
+ */
+bool rtimer_cancel(struct rtimer *task);
+
+/**
+ * \brief      Check if a real-time task is pending.
+ * \param task The task.
+ * \return     true if the task is scheduled and has not run yet.
+ */
+bool rtimer_is_scheduled(struct rtimer *task);
+
+/**
+ * \brief      Set the priority of a real-time task.
+ * \param task The task.
+ * \param prio RTIMER_PRIORITY_NORMAL or RTIMER_PRIORITY_HIGH.
+ */
+#define rtimer_set_priority(task, prio) ((task)->priority = (prio))
+#else /* RTIMER_MULTIPLE */
+#define rtimer_set_priority(task, prio)
+#endif /* RTIMER_MULTIPLE */
+
 /**
  * \brief      Execute the next real-time task and schedule the next task, if any
  *
@@ -43,6 +43,7 @@
 #include "contiki.h"
 #include "sys/stack-check.h"
 #include "dev/watchdog.h"
+#include "lib/list.h"
 #include <string.h>
 #include <inttypes.h>
 
@@ -51,6 +52,14 @@
 #define LOG_LEVEL LOG_LEVEL_MAIN
 
 /*---------------------------------------------------------------------------*/
+/* The symbol with which the stack memory is initially filled */
+#define STACK_FILL 0xcd
+/*---------------------------------------------------------------------------*/
+#if STACK_CHECK_WITH_REGIONS
+LIST(regions);
+#endif /* STACK_CHECK_WITH_REGIONS */
+/*---------------------------------------------------------------------------*/
+#if STACK_CHECK_ENABLED
 /* linker will provide a symbol for the end of the .bss segment */
 extern uint8_t _stack;
 
@@ -58,9 +67,6 @@ extern uint8_t _stack;
 PROCESS(stack_check_process, "Stack check");
 #endif
 /*---------------------------------------------------------------------------*/
-/* The symbol with which the stack memory is initially filled */
-#define STACK_FILL 0xcd
-/*---------------------------------------------------------------------------*/
 #ifdef STACK_ORIGIN
 /* use the #defined value */
 #define GET_STACK_ORIGIN() STACK_ORIGIN
@@ -136,12 +142,93 @@ stack_check_get_reserved_size(void)
 {
   return (uint8_t *)GET_STACK_ORIGIN() - &_stack;
 }
+#endif /* STACK_CHECK_ENABLED */
 /*---------------------------------------------------------------------------*/
-#if STACK_CHECK_PERIODIC_CHECKS
+#if STACK_CHECK_WITH_REGIONS
+void
+stack_check_region_add(struct stack_check_region *region,
+                       const char *name, void *start, size_t size)
+{
+  memset(start, STACK_FILL, size);
+  region->name = name;
+  region->start = start;
+  region->size = size;
+  list_add(regions, region);
+}
+/*---------------------------------------------------------------------------*/
+void
+stack_check_region_remove(struct stack_check_region *region)
+{
+  list_remove(regions, region);
+}
+/*---------------------------------------------------------------------------*/
+struct stack_check_region *
+stack_check_region_head(void)
+{
+  return list_head(regions);
+}
+/*---------------------------------------------------------------------------*/
+size_t
+stack_check_region_get_usage(const struct stack_check_region *region)
+{
+  const uint8_t *p = region->start;
+  const uint8_t *end = region->start + region->size;
+
+  /* The stack grows downwards: skip the part that was never written */
+  while(p < end && *p == STACK_FILL) {
+    p++;
+  }
+
+  if(p == region->start) {
+    /* Nothing is left of the fill, the stack may have overflowed */
+    return SIZE_MAX;
+  }
+
+  return end - p;
+}
+#endif /* STACK_CHECK_WITH_REGIONS */
+/*---------------------------------------------------------------------------*/
+#if STACK_CHECK_ENABLED || STACK_CHECK_WITH_REGIONS
+static void
+report_usage(const char *name, size_t actual, size_t allowed)
+{
+  if(actual > allowed) {
+    LOG_ERR("%-12s: overflow, %u bytes reserved\n", name, (unsigned)allowed);
+  } else {
+    LOG_INFO("%-12s: %u of %u bytes used\n", name, (unsigned)actual,
+             (unsigned)allowed);
+  }
+}
+#endif /* STACK_CHECK_ENABLED || STACK_CHECK_WITH_REGIONS */
+/*---------------------------------------------------------------------------*/
+void
+stack_check_report(void)
+{
+#if STACK_CHECK_WITH_REGIONS
+  struct stack_check_region *region;
+#endif /* STACK_CHECK_WITH_REGIONS */
+
+#if STACK_CHECK_ENABLED
+  report_usage("main", stack_check_get_usage(),
+               stack_check_get_reserved_size());
+#endif /* STACK_CHECK_ENABLED */
+
+#if STACK_CHECK_WITH_REGIONS
+  for(region = list_head(regions); region != NULL; region = region->next) {
+    report_usage(region->name, stack_check_region_get_usage(region),
+                 region->size);
+  }
+#endif /* STACK_CHECK_WITH_REGIONS */
+}
+/*---------------------------------------------------------------------------*/
+#if STACK_CHECK_ENABLED && STACK_CHECK_PERIODIC_CHECKS
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(stack_check_process, ev, data)
 {
   static struct etimer et;
+#if STACK_CHECK_WITH_REGIONS
+  struct stack_check_region *region;
+#endif /* STACK_CHECK_WITH_REGIONS */
 
   PROCESS_BEGIN();
 
@@ -159,12 +246,21 @@ PROCESS_THREAD(stack_check_process, ev, data)
       LOG_DBG("Check ok: %u vs. %u\n", (unsigned)actual, (unsigned)allowed);
     }
 
+#if STACK_CHECK_WITH_REGIONS
+    for(region = list_head(regions); region != NULL; region = region->next) {
+      if(stack_check_region_get_usage(region) > region->size) {
+        LOG_ERR("Check failed: %s overflowed %u bytes\n", region->name,
+                (unsigned)region->size);
+      }
+    }
+#endif /* STACK_CHECK_WITH_REGIONS */
+
     etimer_reset(&et);
   }
 
   PROCESS_END();
 }
 /*---------------------------------------------------------------------------*/
-#endif /* STACK_CHECK_PERIODIC_CHECKS */
+#endif /* STACK_CHECK_ENABLED && STACK_CHECK_PERIODIC_CHECKS */
 /*---------------------------------------------------------------------------*/
 /** @} */
@@ -46,6 +46,10 @@
  * During execution, the fill can be checked in order to find out
  * the extent to which the stack has been used.
  *
+ * Other stacks, such as those of threads, can be registered as stack
+ * regions. They are painted with the same pattern when registered, and
+ * their high-water mark is reported along with the main stack.
+ *
  * @{
  */
 
@@ -55,6 +59,7 @@
 #include "contiki-conf.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 /* Determine whether stack checking is supported depending on the plaform. */
 #ifdef PLATFORM_CONF_SUPPORTS_STACK_CHECK
@@ -72,6 +77,13 @@
 #define STACK_CHECK_ENABLED 1 /* Enable by default */
 #endif
 
+/* Track stacks other than the main one? */
+#ifdef STACK_CHECK_CONF_WITH_REGIONS
+#define STACK_CHECK_WITH_REGIONS STACK_CHECK_CONF_WITH_REGIONS
+#else
+#define STACK_CHECK_WITH_REGIONS 1 /* Enable by default */
+#endif
+
 /* Perform periodic stack integrity checks? */
 #ifdef STACK_CHECK_CONF_PERIODIC_CHECKS
 #define STACK_CHECK_PERIODIC_CHECKS STACK_CHECK_CONF_PERIODIC_CHECKS
@@ -118,6 +130,59 @@ size_t stack_check_get_usage(void);
  */
 size_t stack_check_get_reserved_size(void);
 
+/**
+ * \brief      A stack other than the main one, growing downwards
+ */
+struct stack_check_region {
+  struct stack_check_region *next;
+  const char *name;
+  uint8_t *start;  /**< The lowest address of the stack */
+  size_t size;
+};
+
+/**
+ * \brief      Register a stack and fill it with the known pattern
+ * \param region The region structure, kept by the caller
+ * \param name  A name for the stack, used when reporting
+ * \param start The lowest address of the stack
+ * \param size  The size of the stack
+ *
+ *             This function must be called before the stack is in use,
+ *             since it overwrites the stack memory.
+ */
+void stack_check_region_add(struct stack_check_region *region,
+                            const char *name, void *start, size_t size);
+
+/**
+ * \brief      Stop tracking a stack
+ * \param region The region passed to stack_check_region_add()
+ */
+void stack_check_region_remove(struct stack_check_region *region);
+
+/**
+ * \brief      The first registered stack region, or NULL
+ *
+ *             Use the next field to iterate over the other regions.
+ */
+struct stack_check_region *stack_check_region_head(void);
+
+/**
+ * \brief      Calculate the maximal usage of a stack region so far.
+ *
+ *             The same assumptions as for stack_check_get_usage() apply.
+ *             Returns SIZE_MAX when no part of the region is left
+ *             untouched, that is, when the stack may have overflowed.
+ */
+size_t stack_check_region_get_usage(const struct stack_check_region *region);
+
+/**
+ * \brief      Log the usage of the main stack and of all stack regions
+ *
+ *             This is meant to be called at runtime as well as when the
+ *             system fails, e.g., on a failed assertion.
+ */
+void stack_check_report(void);
+
 /**
  * \brief      The origin point from which the stack grows (an optional #define)
  *
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      Tests the rtimer multiplexer: several pending rtimers, their
+ *      order, cancellation and priorities. Runs on native and Cooja.
+ */
+
+#include <stdio.h>
+
+#include "contiki.h"
+#include "sys/rtimer.h"
+#include "unit-test/unit-test.h"
+
+PROCESS(test_process, "rtimer test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define TIMERS 8
+#define STEP (RTIMER_SECOND / 100)
+#define PERIODS 5
+
+static struct rtimer timers[TIMERS];
+static int fired_log[TIMERS];
+static rtimer_clock_t fired_time[TIMERS];
+static volatile int fired;
+static int periods;
+/*---------------------------------------------------------------------------*/
+void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->passed == false) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+log_callback(struct rtimer *t, void *ptr)
+{
+  if(fired < TIMERS) {
+    fired_time[fired] = RTIMER_NOW();
+    fired_log[fired++] = t - timers;
+  }
+  process_poll(&test_process);
+}
+/*---------------------------------------------------------------------------*/
+static void
+periodic_callback(struct rtimer *t, void *ptr)
+{
+  if(++periods < PERIODS) {
+    rtimer_set(t, RTIMER_TIME(t) + STEP, 0, periodic_callback, NULL);
+  }
+  process_poll(&test_process);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(order, "Timers run in time order");
+UNIT_TEST(order)
+{
+  static const int delays[TIMERS] = { 5, 2, 7, 1, 8, 3, 6, 4 };
+  static rtimer_clock_t now;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  fired = 0;
+  now = RTIMER_NOW();
+  for(i = 0; i < TIMERS; i++) {
+    UNIT_TEST_ASSERT(rtimer_set(&timers[i], now + delays[i] * STEP, 0,
+                                log_callback, NULL) == RTIMER_OK);
+  }
+  /* Each timer can be pending only once */
+  UNIT_TEST_ASSERT(rtimer_set(&timers[0], now + STEP, 0, log_callback, NULL)
+                   == RTIMER_ERR_ALREADY_SCHEDULED);
+
+  PT_WAIT_UNTIL(&unit_test_pt, fired == TIMERS);
+  for(i = 0; i < TIMERS; i++) {
+    UNIT_TEST_ASSERT(delays[fired_log[i]] == i + 1);
+    /* Never early */
+    UNIT_TEST_ASSERT(!RTIMER_CLOCK_LT(fired_time[i],
+                                      now + delays[fired_log[i]] * STEP));
+    UNIT_TEST_ASSERT(!rtimer_is_scheduled(&timers[i]));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(cancel, "Cancel");
+UNIT_TEST(cancel)
+{
+  static rtimer_clock_t now;
+
+  UNIT_TEST_BEGIN();
+
+  fired = 0;
+  now = RTIMER_NOW();
+  rtimer_set(&timers[0], now + STEP, 0, log_callback, NULL);
+  rtimer_set(&timers[1], now + 2 * STEP, 0, log_callback, NULL);
+  rtimer_set(&timers[2], now + 3 * STEP, 0, log_callback, NULL);
+  UNIT_TEST_ASSERT(rtimer_is_scheduled(&timers[1]));
+
+  /* The first one, and one in the middle */
+  UNIT_TEST_ASSERT(rtimer_cancel(&timers[0]));
+  UNIT_TEST_ASSERT(rtimer_cancel(&timers[1]));
+  UNIT_TEST_ASSERT(!rtimer_cancel(&timers[1]));
+  UNIT_TEST_ASSERT(!rtimer_is_scheduled(&timers[1]));
+
+  PT_WAIT_UNTIL(&unit_test_pt, fired == 1);
+  UNIT_TEST_ASSERT(fired_log[0] == 2);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(priority, "High priority first");
+UNIT_TEST(priority)
+{
+  static rtimer_clock_t now;
+
+  UNIT_TEST_BEGIN();
+
+  /* Due at the same time */
+  fired = 0;
+  now = RTIMER_NOW();
+  rtimer_set_priority(&timers[1], RTIMER_PRIORITY_HIGH);
+  rtimer_set(&timers[0], now + STEP, 0, log_callback, NULL);
+  rtimer_set(&timers[1], now + STEP, 0, log_callback, NULL);
+  rtimer_set(&timers[2], now + STEP, 0, log_callback, NULL);
+  PT_WAIT_UNTIL(&unit_test_pt, fired == 3);
+  UNIT_TEST_ASSERT(fired_log[0] == 1);
+  UNIT_TEST_ASSERT(fired_log[1] == 0);
+  UNIT_TEST_ASSERT(fired_log[2] == 2);
+
+  /* Both already due: the high priority one runs first even though it
+     is later */
+  fired = 0;
+  now = RTIMER_NOW();
+  rtimer_set(&timers[1], now - 1, 0, log_callback, NULL);
+  rtimer_set(&timers[0], now - 2, 0, log_callback, NULL);
+  PT_WAIT_UNTIL(&unit_test_pt, fired == 2);
+  UNIT_TEST_ASSERT(fired_log[0] == 1);
+  UNIT_TEST_ASSERT(fired_log[1] == 0);
+
+  rtimer_set_priority(&timers[1], RTIMER_PRIORITY_NORMAL);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(periodic, "Set from the callback");
+UNIT_TEST(periodic)
+{
+  static rtimer_clock_t start;
+
+  UNIT_TEST_BEGIN();
+
+  /* Alongside another timer */
+  fired = 0;
+  periods = 0;
+  start = RTIMER_NOW();
+  rtimer_set(&timers[0], start + STEP, 0, periodic_callback, NULL);
+  rtimer_set(&timers[1], start + 3 * STEP + STEP / 2, 0, log_callback, NULL);
+  PT_WAIT_UNTIL(&unit_test_pt, periods == PERIODS && fired == 1);
+  UNIT_TEST_ASSERT(RTIMER_TIME(&timers[0]) == start + PERIODS * STEP);
+  UNIT_TEST_ASSERT(!RTIMER_CLOCK_LT(RTIMER_NOW(), start + PERIODS * STEP));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(order);
+  UNIT_TEST_RUN(cancel);
+  UNIT_TEST_RUN(priority);
+  UNIT_TEST_RUN(periodic);
+
+  printf("=check-me= DONE\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
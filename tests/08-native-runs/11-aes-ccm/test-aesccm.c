@@ -32,10 +32,14 @@
 #include "lib/random.h"
 #include "unit-test.h"
 #include "lib/ccm-star.h"
+#include "lib/aes-128.h"
 #include "lib/hexconv.h"
+#include "native-aes-128.h"
+#include <inttypes.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <time.h>
 
 #define MICLEN 8
 
@@ -52,6 +56,141 @@ static const char *testcases[][3] = {
 #define NUM_TESTSCASES (sizeof(testcases)/sizeof(testcases[0]))
 #define MAXLEN 65536
 
+#define BENCH_BLOCKS (1 << 16)
+#define BENCH_FRAMES (1 << 14)
+
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+random_bytes(uint8_t *p, int len)
+{
+  while(len-- > 0) {
+    *p++ = random_rand();
+  }
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(aes_drivers, "AES-128 drivers");
+UNIT_TEST(aes_drivers)
+{
+  /* FIPS-197, appendix C.1 */
+  static const uint8_t fips_key[AES_128_KEY_LENGTH] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+  };
+  static const uint8_t fips_plaintext[AES_128_BLOCK_SIZE] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+  };
+  static const uint8_t fips_ciphertext[AES_128_BLOCK_SIZE] = {
+    0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+    0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+  };
+  static uint8_t keys[AES_128_KEY_CACHE_SIZE + 2][AES_128_KEY_LENGTH];
+  uint8_t block[AES_128_BLOCK_SIZE];
+  uint8_t expected[AES_128_BLOCK_SIZE];
+  int errors = 0;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  printf("TEST: AES-NI %s\n", native_aes_128_accelerated() ? "yes" : "no");
+
+  memcpy(block, fips_plaintext, sizeof(block));
+  aes_128_driver.set_key(fips_key);
+  aes_128_driver.encrypt(block);
+  UNIT_TEST_ASSERT(!memcmp(block, fips_ciphertext, sizeof(block)));
+
+  memcpy(block, fips_plaintext, sizeof(block));
+  AES_128.set_key(fips_key);
+  AES_128.encrypt(block);
+  UNIT_TEST_ASSERT(!memcmp(block, fips_ciphertext, sizeof(block)));
+
+  /* Cycle through more keys than the caches hold */
+  for(i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+    random_bytes(keys[i], AES_128_KEY_LENGTH);
+  }
+  for(i = 0; i < 100; i++) {
+    const uint8_t *key = keys[(i * 7 + i / 5) % (sizeof(keys) / sizeof(keys[0]))];
+
+    random_bytes(expected, sizeof(expected));
+    memcpy(block, expected, sizeof(block));
+    aes_128_driver.set_key(key);
+    aes_128_driver.encrypt(expected);
+    AES_128.set_key(key);
+    AES_128.encrypt(block);
+    errors += memcmp(block, expected, sizeof(block)) != 0;
+  }
+  UNIT_TEST_ASSERT(errors == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(aes_modes, "AES-128 ECB and CTR");
+UNIT_TEST(aes_modes)
+{
+  static uint8_t key[AES_128_KEY_LENGTH];
+  static uint8_t data[20 * AES_128_BLOCK_SIZE];
+  static uint8_t result[sizeof(data)];
+  static uint8_t expected[sizeof(data)];
+  uint8_t counter[AES_128_BLOCK_SIZE];
+  uint8_t expected_counter[AES_128_BLOCK_SIZE];
+  uint8_t block[AES_128_BLOCK_SIZE];
+  int errors = 0;
+  int count;
+  int len;
+  int i;
+  int j;
+
+  UNIT_TEST_BEGIN();
+
+  random_bytes(key, sizeof(key));
+  random_bytes(data, sizeof(data));
+  aes_128_driver.set_key(key);
+  AES_128.set_key(key);
+
+  for(count = 0; count <= 20; count++) {
+    memcpy(expected, data, sizeof(data));
+    for(i = 0; i < count; i++) {
+      aes_128_driver.encrypt(&expected[i * AES_128_BLOCK_SIZE]);
+    }
+    memcpy(result, data, sizeof(data));
+    aes_128_ecb_encrypt(result, count);
+    errors += memcmp(result, expected, sizeof(data)) != 0;
+  }
+
+  for(len = 0; len <= sizeof(data); len += 1 + len / 8) {
+    /* A counter that carries from the low bytes */
+    memset(counter, 0xff, sizeof(counter));
+    counter[0] = 0x42;
+    memcpy(expected_counter, counter, sizeof(counter));
+    memcpy(expected, data, sizeof(data));
+    for(i = 0; i < len; i += AES_128_BLOCK_SIZE) {
+      memcpy(block, expected_counter, sizeof(block));
+      aes_128_driver.encrypt(block);
+      for(j = 0; j < AES_128_BLOCK_SIZE && i + j < len; j++) {
+        expected[i + j] ^= block[j];
+      }
+      aes_128_ctr_increment(expected_counter);
+    }
+    memcpy(result, data, sizeof(data));
+    aes_128_ctr_crypt(counter, result, len);
+    errors += memcmp(result, expected, sizeof(data)) != 0;
+    errors += memcmp(counter, expected_counter, sizeof(counter)) != 0;
+  }
+  UNIT_TEST_ASSERT(counter[0] == 0x43);
+  UNIT_TEST_ASSERT(errors == 0);
+
+  UNIT_TEST_END();
+}
+
 /*---------------------------------------------------------------------------*/
 UNIT_TEST_REGISTER(aesccm_encrypt, "AES-CCM encryption");
 UNIT_TEST(aesccm_encrypt)
@@ -166,6 +305,74 @@ UNIT_TEST(aesccm_decrypt)
   UNIT_TEST_END();
 }
 /*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(aes_bench, "AES-128 and CCM* throughput");
+UNIT_TEST(aes_bench)
+{
+  static uint8_t keys[2 * AES_128_KEY_CACHE_SIZE][AES_128_KEY_LENGTH];
+  static uint8_t blocks[64 * AES_128_BLOCK_SIZE];
+  static uint8_t frame[127];
+  uint8_t nonce[CCM_STAR_NONCE_LENGTH];
+  uint8_t mic[MICLEN];
+  uint64_t start;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  random_bytes(&keys[0][0], sizeof(keys));
+  random_bytes(blocks, sizeof(blocks));
+  random_bytes(frame, sizeof(frame));
+  random_bytes(nonce, sizeof(nonce));
+
+  aes_128_driver.set_key(keys[0]);
+  start = now_ns();
+  for(i = 0; i < BENCH_BLOCKS; i++) {
+    aes_128_driver.encrypt(blocks);
+  }
+  printf("TEST: software encrypt: %"PRIu64" ns/block\n",
+         (now_ns() - start) / BENCH_BLOCKS);
+
+  AES_128.set_key(keys[0]);
+  start = now_ns();
+  for(i = 0; i < BENCH_BLOCKS; i++) {
+    AES_128.encrypt(blocks);
+  }
+  printf("TEST: AES_128 encrypt: %"PRIu64" ns/block\n",
+         (now_ns() - start) / BENCH_BLOCKS);
+
+  start = now_ns();
+  for(i = 0; i < BENCH_BLOCKS; i += 64) {
+    aes_128_ecb_encrypt(blocks, 64);
+  }
+  printf("TEST: AES_128 ECB: %"PRIu64" ns/block\n",
+         (now_ns() - start) / BENCH_BLOCKS);
+
+  /* Two keys in turn stay in the cache, twice the cache size do not */
+  start = now_ns();
+  for(i = 0; i < BENCH_BLOCKS; i++) {
+    AES_128.set_key(keys[i & 1]);
+  }
+  printf("TEST: AES_128 set_key, cached: %"PRIu64" ns\n",
+         (now_ns() - start) / BENCH_BLOCKS);
+  start = now_ns();
+  for(i = 0; i < BENCH_BLOCKS; i++) {
+    AES_128.set_key(keys[i % (2 * AES_128_KEY_CACHE_SIZE)]);
+  }
+  printf("TEST: AES_128 set_key, uncached: %"PRIu64" ns\n",
+         (now_ns() - start) / BENCH_BLOCKS);
+
+  /* A full 802.15.4 frame with a 21-byte header, key set per frame */
+  start = now_ns();
+  for(i = 0; i < BENCH_FRAMES; i++) {
+    CCM_STAR.set_key(keys[i & 1]);
+    CCM_STAR.aead(nonce, frame + 21, sizeof(frame) - 21 - MICLEN,
+                  frame, 21, mic, MICLEN, 1);
+  }
+  printf("TEST: CCM* 127-byte frame: %"PRIu64" ns/frame\n",
+         (now_ns() - start) / BENCH_FRAMES);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(test_process, ev, data)
 {
   PROCESS_BEGIN();
@@ -173,8 +380,20 @@ PROCESS_THREAD(test_process, ev, data)
   printf("Run unit-test\n");
   printf("---\n");
 
+  UNIT_TEST_RUN(aes_drivers);
+  UNIT_TEST_RUN(aes_modes);
   UNIT_TEST_RUN(aesccm_encrypt);
   UNIT_TEST_RUN(aesccm_decrypt);
+  UNIT_TEST_RUN(aes_bench);
+
+  if(!UNIT_TEST_PASSED(aes_drivers) ||
+     !UNIT_TEST_PASSED(aes_modes) ||
+     !UNIT_TEST_PASSED(aesccm_encrypt) ||
+     !UNIT_TEST_PASSED(aesccm_decrypt) ||
+     !UNIT_TEST_PASSED(aes_bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
 
   printf("=check-me= DONE\n");
   printf("---\n");
@@ -269,6 +269,64 @@ UNIT_TEST(zero_init_alloc)
   UNIT_TEST_END();
 }
 /*****************************************************************************/
+static int
+compare_ptrs(const void *a, const void *b)
+{
+  uintptr_t pa = (uintptr_t)*(uint8_t * const *)a;
+  uintptr_t pb = (uintptr_t)*(uint8_t * const *)b;
+
+  return pa < pb ? -1 : pa > pb;
+}
+
+UNIT_TEST_REGISTER(fragmentation, "Heapmem fragmentation");
+UNIT_TEST(fragmentation)
+{
+#define NUM_CHUNKS 100
+#define CHUNK_SIZE 64
+
+  UNIT_TEST_BEGIN();
+
+  static uint8_t *ptrs[NUM_CHUNKS];
+  heapmem_stats_t stats;
+
+  for(size_t i = 0; i < NUM_CHUNKS; i++) {
+    ptrs[i] = heapmem_alloc(CHUNK_SIZE);
+    UNIT_TEST_ASSERT(ptrs[i] != NULL);
+  }
+
+  /* Punch holes into the heap by freeing every other chunk. */
+  for(size_t i = 0; i < NUM_CHUNKS; i += 2) {
+    UNIT_TEST_ASSERT(heapmem_free(ptrs[i]));
+  }
+
+  heapmem_stats(&stats);
+  size_t footprint = stats.footprint;
+  printf("* free chunks %zu\n* largest free %zu\n",
+         stats.free_chunks, stats.largest_free);
+  UNIT_TEST_ASSERT(stats.free_chunks == NUM_CHUNKS / 2);
+  UNIT_TEST_ASSERT(stats.largest_free >= CHUNK_SIZE);
+  UNIT_TEST_ASSERT(stats.largest_free < stats.available);
+
+  /* Allocations that fit in the holes must not extend the heap. */
+  for(size_t i = 0; i < NUM_CHUNKS; i += 2) {
+    ptrs[i] = heapmem_alloc(CHUNK_SIZE);
+    UNIT_TEST_ASSERT(ptrs[i] != NULL);
+  }
+
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.footprint == footprint);
+  UNIT_TEST_ASSERT(stats.free_chunks == 0);
+
+  /* Free the chunks from the end of the heap, so that the whole
+     footprint is released. */
+  qsort(ptrs, NUM_CHUNKS, sizeof(ptrs[0]), compare_ptrs);
+  for(size_t i = NUM_CHUNKS; i > 0; i--) {
+    UNIT_TEST_ASSERT(heapmem_free(ptrs[i - 1]));
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
 UNIT_TEST_REGISTER(stats_check, "Heapmem statistics validation");
 UNIT_TEST(stats_check)
 {
@@ -288,6 +346,8 @@ UNIT_TEST(stats_check)
   UNIT_TEST_ASSERT(stats.footprint == 0);
   UNIT_TEST_ASSERT(stats.max_footprint > stats.available / 2);
   UNIT_TEST_ASSERT(stats.chunks == 0);
+  UNIT_TEST_ASSERT(stats.free_chunks == 0);
+  UNIT_TEST_ASSERT(stats.largest_free < stats.available);
 
   UNIT_TEST_END();
 }
@@ -333,6 +393,7 @@ PROCESS_THREAD(test_heapmem_process, ev, data)
   UNIT_TEST_RUN(invalid_freeing);
   UNIT_TEST_RUN(reallocations);
   UNIT_TEST_RUN(zero_init_alloc);
+  UNIT_TEST_RUN(fragmentation);
   UNIT_TEST_RUN(stats_check);
   UNIT_TEST_RUN(zones);
 
@@ -341,6 +402,7 @@ PROCESS_THREAD(test_heapmem_process, ev, data)
      !UNIT_TEST_PASSED(invalid_freeing) ||
      !UNIT_TEST_PASSED(reallocations) ||
      !UNIT_TEST_PASSED(zero_init_alloc) ||
+     !UNIT_TEST_PASSED(fragmentation) ||
      !UNIT_TEST_PASSED(stats_check) ||
      !UNIT_TEST_PASSED(zones)) {
     printf("=check-me= FAILED\n");
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      Unit tests and a microbenchmark for the event timer queue.
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "unit-test.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define NUM_TIMERS      200
+#define MAX_INTERVAL    (CLOCK_SECOND / 2)
+#define BENCH_MAX_TIMERS 1024
+#define BENCH_ROUNDS    4
+#define DIRTY_TIMERS    32
+
+static struct ctimer ctimers[NUM_TIMERS];
+static clock_time_t fired_at[NUM_TIMERS];
+static unsigned fired_count[NUM_TIMERS];
+static bool stopped[NUM_TIMERS];
+static unsigned pending_count;
+static struct etimer poll_timer;
+
+static struct etimer bench_timers[BENCH_MAX_TIMERS];
+static struct etimer template_timers[2];
+/*---------------------------------------------------------------------------*/
+static void
+ctimer_callback(void *ptr)
+{
+  unsigned i = (uintptr_t)ptr;
+
+  fired_at[i] = clock_time();
+  fired_count[i]++;
+  pending_count--;
+}
+/*---------------------------------------------------------------------------*/
+static clock_time_t
+min_pending_expiration(void)
+{
+  clock_time_t min = 0;
+  bool found = false;
+
+  for(unsigned i = 0; i < NUM_TIMERS; i++) {
+    if(!ctimer_expired(&ctimers[i])) {
+      clock_time_t exp = etimer_expiration_time(&ctimers[i].etimer);
+      if(!found || CLOCK_LT(exp, min)) {
+        min = exp;
+        found = true;
+      }
+    }
+  }
+
+  return min;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(expiration_order, "Timer expiration");
+UNIT_TEST(expiration_order)
+{
+  static unsigned i;
+
+  UNIT_TEST_BEGIN();
+
+  pending_count = 0;
+  for(i = 0; i < NUM_TIMERS; i++) {
+    ctimer_set(&ctimers[i], 1 + (random_rand() % MAX_INTERVAL),
+               ctimer_callback, (void *)(uintptr_t)i);
+    pending_count++;
+  }
+  UNIT_TEST_ASSERT(etimer_pending());
+  UNIT_TEST_ASSERT(etimer_next_expiration_time() == min_pending_expiration());
+
+  /* Stop every third timer, and restart every fifth timer. */
+  for(i = 0; i < NUM_TIMERS; i++) {
+    if(i % 3 == 0) {
+      ctimer_stop(&ctimers[i]);
+      stopped[i] = true;
+      pending_count--;
+    } else if(i % 5 == 0) {
+      ctimer_restart(&ctimers[i]);
+    }
+    UNIT_TEST_ASSERT(etimer_next_expiration_time() ==
+                     min_pending_expiration());
+  }
+
+  while(pending_count > 0) {
+    etimer_set(&poll_timer, CLOCK_SECOND / 32);
+    PT_WAIT_UNTIL(&unit_test_pt, etimer_expired(&poll_timer));
+    if(pending_count > 0) {
+      UNIT_TEST_ASSERT(etimer_next_expiration_time() ==
+                       min_pending_expiration() ||
+                       !CLOCK_LT(etimer_expiration_time(&poll_timer),
+                                 min_pending_expiration()));
+    }
+  }
+
+  for(i = 0; i < NUM_TIMERS; i++) {
+    if(stopped[i]) {
+      UNIT_TEST_ASSERT(fired_count[i] == 0);
+    } else {
+      UNIT_TEST_ASSERT(fired_count[i] == 1);
+      UNIT_TEST_ASSERT(!CLOCK_LT(fired_at[i],
+                                 etimer_expiration_time(&ctimers[i].etimer)));
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+static clock_time_t
+min_dirty_expiration(struct etimer *timers, unsigned n)
+{
+  clock_time_t min = etimer_expiration_time(&template_timers[0]);
+
+  for(unsigned i = 0; i < n; i++) {
+    if(!etimer_expired(&timers[i]) &&
+       CLOCK_LT(etimer_expiration_time(&timers[i]), min)) {
+      min = etimer_expiration_time(&timers[i]);
+    }
+  }
+
+  return min;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(dirty_memory, "Timers in memory that is not zeroed");
+UNIT_TEST(dirty_memory)
+{
+  static struct etimer *timers;
+  unsigned i;
+
+  UNIT_TEST_BEGIN();
+
+  /* Pending timers, one of them below the other in the queue */
+  etimer_set(&template_timers[0], CLOCK_SECOND / 4);
+  etimer_set(&template_timers[1], CLOCK_SECOND / 2);
+
+  /* Half of the timers hold garbage, and the other half stale copies of
+     a pending timer, as after a realloc or on a reused stack frame. */
+  timers = malloc(DIRTY_TIMERS * sizeof(*timers));
+  UNIT_TEST_ASSERT(timers != NULL);
+  for(i = 0; i < DIRTY_TIMERS; i++) {
+    if(i % 2 == 0) {
+      memset(&timers[i], 0xa5, sizeof(timers[i]));
+    } else {
+      memcpy(&timers[i], &template_timers[1], sizeof(timers[i]));
+    }
+  }
+
+  /* Other timers of the system may expire first */
+  for(i = 0; i < DIRTY_TIMERS; i++) {
+    etimer_set(&timers[i], 1 + (random_rand() % (CLOCK_SECOND / 4)));
+    UNIT_TEST_ASSERT(!CLOCK_LT(min_dirty_expiration(timers, i + 1),
+                               etimer_next_expiration_time()));
+  }
+  for(i = 0; i < DIRTY_TIMERS; i += 3) {
+    etimer_stop(&timers[i]);
+  }
+
+  /* Every timer still in the queue expires */
+  etimer_set(&poll_timer, CLOCK_SECOND);
+  PT_WAIT_UNTIL(&unit_test_pt, etimer_expired(&poll_timer));
+  for(i = 0; i < DIRTY_TIMERS; i++) {
+    UNIT_TEST_ASSERT(etimer_expired(&timers[i]));
+  }
+  UNIT_TEST_ASSERT(etimer_expired(&template_timers[0]));
+  UNIT_TEST_ASSERT(etimer_expired(&template_timers[1]));
+
+  free(timers);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "Timer queue microbenchmark");
+UNIT_TEST(benchmark)
+{
+  UNIT_TEST_BEGIN();
+
+  for(unsigned n = 16; n <= BENCH_MAX_TIMERS; n *= 4) {
+    uint64_t start, set_ns, reset_ns, stop_ns;
+    unsigned ops = n * BENCH_ROUNDS;
+
+    start = now_ns();
+    for(unsigned i = 0; i < n; i++) {
+      etimer_set(&bench_timers[i],
+                 10 * CLOCK_SECOND + (random_rand() % CLOCK_SECOND));
+    }
+    set_ns = now_ns() - start;
+
+    start = now_ns();
+    for(unsigned i = 0; i < ops; i++) {
+      etimer_set(&bench_timers[random_rand() % n],
+                 10 * CLOCK_SECOND + (random_rand() % CLOCK_SECOND));
+      UNIT_TEST_ASSERT(etimer_next_expiration_time() != 0);
+    }
+    reset_ns = now_ns() - start;
+
+    start = now_ns();
+    for(unsigned i = 0; i < n; i++) {
+      etimer_stop(&bench_timers[(i * 7) % n]);
+    }
+    stop_ns = now_ns() - start;
+
+    for(unsigned i = 0; i < n; i++) {
+      UNIT_TEST_ASSERT(etimer_expired(&bench_timers[i]));
+    }
+
+    printf("etimer queue %s: %4u timers: set %"PRIu64" ns/op, "
+           "reset %"PRIu64" ns/op, stop %"PRIu64" ns/op\n",
+           ETIMER_QUEUE == ETIMER_QUEUE_HEAP ? "heap" : "list", n,
+           set_ns / n, reset_ns / ops, stop_ns / n);
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(expiration_order);
+  UNIT_TEST_RUN(dirty_memory);
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(expiration_order) ||
+     !UNIT_TEST_PASSED(dirty_memory) ||
+     !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      A benchmark of the memory block allocator at different pool sizes.
+ */
+
+#include "contiki.h"
+#include "lib/memb.h"
+#include "lib/random.h"
+#include "unit-test.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <time.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define BLOCK_SIZE 24
+#define MAX_BLOCKS 1024
+#define CHURN_ROUNDS 16
+
+struct block {
+  uint8_t data[BLOCK_SIZE];
+};
+
+MEMB(pool8, struct block, 8);
+MEMB(pool32, struct block, 32);
+MEMB(pool128, struct block, 128);
+MEMB(pool512, struct block, 512);
+MEMB(pool1024, struct block, 1024);
+
+static struct memb *pools[] = {
+  &pool8, &pool32, &pool128, &pool512, &pool1024
+};
+
+static void *blocks[MAX_BLOCKS];
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "Memory block allocation benchmark");
+UNIT_TEST(benchmark)
+{
+  UNIT_TEST_BEGIN();
+
+  for(unsigned p = 0; p < sizeof(pools) / sizeof(pools[0]); p++) {
+    struct memb *m = pools[p];
+    unsigned n = m->num;
+    unsigned ops = n * CHURN_ROUNDS;
+    uint64_t start, fill_ns, churn_ns, free_ns;
+
+    memb_init(m);
+    UNIT_TEST_ASSERT(memb_numfree(m) == n);
+
+    start = now_ns();
+    for(unsigned i = 0; i < n; i++) {
+      blocks[i] = memb_alloc(m);
+    }
+    fill_ns = now_ns() - start;
+
+    for(unsigned i = 0; i < n; i++) {
+      UNIT_TEST_ASSERT(blocks[i] != NULL);
+    }
+    UNIT_TEST_ASSERT(memb_alloc(m) == NULL);
+    UNIT_TEST_ASSERT(memb_numfree(m) == 0);
+
+    /* Free and reallocate random blocks in an almost full pool. */
+    start = now_ns();
+    for(unsigned i = 0; i < ops; i++) {
+      unsigned j = random_rand() % n;
+      memb_free(m, blocks[j]);
+      blocks[j] = memb_alloc(m);
+    }
+    churn_ns = now_ns() - start;
+
+    start = now_ns();
+    for(unsigned i = 0; i < n; i++) {
+      UNIT_TEST_ASSERT(memb_free(m, blocks[i]) == 0);
+    }
+    free_ns = now_ns() - start;
+
+    UNIT_TEST_ASSERT(memb_numfree(m) == n);
+    UNIT_TEST_ASSERT(memb_free(m, blocks[0]) == -1);
+
+    printf("memb %s: %4u blocks: alloc %"PRIu64" ns/op, "
+           "free+alloc %"PRIu64" ns/op, free %"PRIu64" ns/op\n",
+           MEMB_FREE_STACK ? "free-stack" : "scan", n,
+           fill_ns / n, churn_ns / ops, free_ns / n);
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
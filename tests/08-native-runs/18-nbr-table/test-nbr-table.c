@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      Unit tests and a lookup benchmark for the neighbor table.
+ */
+
+#include "contiki.h"
+#include "net/nbr-table.h"
+#include "unit-test.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define NUM_ADDRS (2 * NBR_TABLE_MAX_NEIGHBORS)
+#define BENCH_LOOKUPS 100000
+
+struct test_item {
+  uint32_t id;
+};
+
+NBR_TABLE(struct test_item, test_table);
+
+static linkaddr_t addrs[NUM_ADDRS];
+static unsigned removed_count;
+/*---------------------------------------------------------------------------*/
+static void
+removed_callback(nbr_table_item_t *item)
+{
+  removed_count++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+make_addr(linkaddr_t *addr, uint32_t id)
+{
+  memset(addr, 0, sizeof(*addr));
+  /* Mimic addresses that share a common prefix. */
+  addr->u8[0] = 0x02;
+  addr->u8[LINKADDR_SIZE - 2] = id >> 8;
+  addr->u8[LINKADDR_SIZE - 1] = id;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+key_list_contains(const linkaddr_t *addr)
+{
+  for(nbr_table_key_t *k = nbr_table_key_head(); k != NULL;
+      k = nbr_table_key_next(k)) {
+    if(linkaddr_cmp(&k->lladdr, addr)) {
+      return true;
+    }
+  }
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(add_lookup, "Neighbor table add and lookup");
+UNIT_TEST(add_lookup)
+{
+  UNIT_TEST_BEGIN();
+
+  nbr_table_clear();
+  UNIT_TEST_ASSERT(nbr_table_register(test_table, removed_callback));
+
+  for(unsigned i = 0; i < NUM_ADDRS; i++) {
+    make_addr(&addrs[i], i * 7 + 1);
+  }
+
+  for(unsigned i = 0; i < NBR_TABLE_MAX_NEIGHBORS; i++) {
+    struct test_item *item = nbr_table_add_lladdr(test_table, &addrs[i],
+                                                  NBR_TABLE_REASON_UNDEFINED,
+                                                  NULL);
+    UNIT_TEST_ASSERT(item != NULL);
+    item->id = i;
+  }
+  UNIT_TEST_ASSERT(nbr_table_count_entries() == NBR_TABLE_MAX_NEIGHBORS);
+
+  for(unsigned i = 0; i < NBR_TABLE_MAX_NEIGHBORS; i++) {
+    struct test_item *item = nbr_table_get_from_lladdr(test_table, &addrs[i]);
+    UNIT_TEST_ASSERT(item != NULL);
+    UNIT_TEST_ASSERT(item->id == i);
+    UNIT_TEST_ASSERT(linkaddr_cmp(nbr_table_get_lladdr(test_table, item),
+                                  &addrs[i]));
+  }
+  for(unsigned i = NBR_TABLE_MAX_NEIGHBORS; i < NUM_ADDRS; i++) {
+    UNIT_TEST_ASSERT(nbr_table_get_from_lladdr(test_table, &addrs[i]) == NULL);
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(remove_gc, "Neighbor table removal and GC");
+UNIT_TEST(remove_gc)
+{
+  UNIT_TEST_BEGIN();
+
+  /* Lock every fourth neighbor, and remove every third. */
+  for(unsigned i = 0; i < NBR_TABLE_MAX_NEIGHBORS; i++) {
+    struct test_item *item = nbr_table_get_from_lladdr(test_table, &addrs[i]);
+    if(i % 4 == 0) {
+      UNIT_TEST_ASSERT(nbr_table_lock(test_table, item));
+    } else if(i % 3 == 0) {
+      UNIT_TEST_ASSERT(nbr_table_remove(test_table, item));
+      UNIT_TEST_ASSERT(nbr_table_get_from_lladdr(test_table,
+                                                 &addrs[i]) == NULL);
+    }
+  }
+
+  /* Adding new neighbors to the full table evicts unlocked ones. */
+  removed_count = 0;
+  for(unsigned i = NBR_TABLE_MAX_NEIGHBORS; i < NUM_ADDRS; i++) {
+    struct test_item *item = nbr_table_add_lladdr(test_table, &addrs[i],
+                                                  NBR_TABLE_REASON_UNDEFINED,
+                                                  NULL);
+    if(item != NULL) {
+      item->id = i;
+    }
+  }
+  printf("Evicted %u neighbors\n", removed_count);
+  UNIT_TEST_ASSERT(removed_count > 0);
+
+  /* The index must agree with the key list for every address. */
+  for(unsigned i = 0; i < NUM_ADDRS; i++) {
+    struct test_item *item = nbr_table_get_from_lladdr(test_table, &addrs[i]);
+    if(i < NBR_TABLE_MAX_NEIGHBORS && i % 4 == 0) {
+      UNIT_TEST_ASSERT(item != NULL);
+    }
+    if(item != NULL) {
+      UNIT_TEST_ASSERT(item->id == i);
+      UNIT_TEST_ASSERT(key_list_contains(&addrs[i]));
+    } else if(i >= NBR_TABLE_MAX_NEIGHBORS) {
+      UNIT_TEST_ASSERT(!key_list_contains(&addrs[i]));
+    }
+  }
+
+  nbr_table_clear();
+  for(unsigned i = 0; i < NUM_ADDRS; i++) {
+    UNIT_TEST_ASSERT(nbr_table_get_from_lladdr(test_table, &addrs[i]) == NULL);
+  }
+  UNIT_TEST_ASSERT(nbr_table_key_head() == NULL);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "Neighbor table lookup benchmark");
+UNIT_TEST(benchmark)
+{
+  UNIT_TEST_BEGIN();
+
+  uint64_t start, hit_ns, miss_ns;
+
+  for(unsigned i = 0; i < NBR_TABLE_MAX_NEIGHBORS; i++) {
+    UNIT_TEST_ASSERT(nbr_table_add_lladdr(test_table, &addrs[i],
+                                          NBR_TABLE_REASON_UNDEFINED,
+                                          NULL) != NULL);
+  }
+
+#if NBR_TABLE_HASH_INDEX
+  nbr_table_hash_stats_reset();
+#endif /* NBR_TABLE_HASH_INDEX */
+
+  start = now_ns();
+  for(unsigned i = 0; i < BENCH_LOOKUPS; i++) {
+    if(nbr_table_get_from_lladdr(test_table,
+                                 &addrs[i % NBR_TABLE_MAX_NEIGHBORS]) == NULL) {
+      UNIT_TEST_FAIL();
+    }
+  }
+  hit_ns = now_ns() - start;
+
+  start = now_ns();
+  for(unsigned i = 0; i < BENCH_LOOKUPS; i++) {
+    if(nbr_table_get_from_lladdr(test_table,
+                                 &addrs[NBR_TABLE_MAX_NEIGHBORS +
+                                        i % NBR_TABLE_MAX_NEIGHBORS]) != NULL) {
+      UNIT_TEST_FAIL();
+    }
+  }
+  miss_ns = now_ns() - start;
+
+  printf("nbr-table %s: %u neighbors: hit %"PRIu64" ns/lookup, "
+         "miss %"PRIu64" ns/lookup\n",
+         NBR_TABLE_HASH_INDEX ? "hash" : "list", NBR_TABLE_MAX_NEIGHBORS,
+         hit_ns / BENCH_LOOKUPS, miss_ns / BENCH_LOOKUPS);
+
+#if NBR_TABLE_HASH_INDEX
+  nbr_table_hash_stats_t stats;
+  nbr_table_hash_stats(&stats);
+  printf("nbr-table hash: %"PRIu32" lookups, %"PRIu32" probes, "
+         "max %u probes\n", stats.lookups, stats.probes, stats.max_probes);
+  UNIT_TEST_ASSERT(stats.lookups == 2 * BENCH_LOOKUPS);
+#endif /* NBR_TABLE_HASH_INDEX */
+
+  nbr_table_clear();
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(add_lookup);
+  UNIT_TEST_RUN(remove_gc);
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(add_lookup) ||
+     !UNIT_TEST_PASSED(remove_gc) ||
+     !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      Unit tests and a lookup benchmark for the IPv6 routing table.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "lib/random.h"
+#include "unit-test.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define NUM_NEXTHOPS 8
+#define NUM_SUBNETS 8
+#define NUM_LINKS 16
+#define HOSTS_PER_LINK 2
+#define NUM_EXTERNAL_HOSTS 64
+#define NUM_QUERIES 4096
+#define BENCH_LOOKUPS 100000
+
+static uip_ipaddr_t nexthops[NUM_NEXTHOPS];
+static uip_ds6_route_t *routes[UIP_DS6_ROUTE_NB];
+static int num_added;
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+/* The linear longest-prefix match that the trie must agree with */
+static int
+reference_match_length(const uip_ipaddr_t *addr)
+{
+  int longest = -1;
+
+  for(uip_ds6_route_t *r = uip_ds6_route_head(); r != NULL;
+      r = uip_ds6_route_next(r)) {
+    if(r->length > longest && uip_ipaddr_prefixcmp(addr, &r->ipaddr,
+                                                   r->length)) {
+      longest = r->length;
+    }
+  }
+  return longest;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+lookup_matches_reference(const uip_ipaddr_t *addr)
+{
+  uip_ds6_route_t *r = uip_ds6_route_lookup(addr);
+  int longest = reference_match_length(addr);
+
+  if(r == NULL) {
+    return longest < 0;
+  }
+  return r->length == longest &&
+    uip_ipaddr_prefixcmp(addr, &r->ipaddr, r->length);
+}
+/*---------------------------------------------------------------------------*/
+static void
+random_query(uip_ipaddr_t *addr)
+{
+  uint16_t words[8];
+
+  for(int i = 0; i < 8; i++) {
+    words[i] = random_rand();
+  }
+  switch(random_rand() % 4) {
+  case 0:
+    /* Within one of the /64 links, possibly a host route */
+    words[4] = words[5] = words[6] = 0;
+    words[7] %= HOSTS_PER_LINK + 2;
+    /* Fall through */
+  case 1:
+    words[3] %= NUM_LINKS + 2;
+    /* Fall through */
+  case 2:
+    words[0] = 0xfd00;
+    words[1] = 0;
+    words[2] %= NUM_SUBNETS + 2;
+    break;
+  default:
+    break;
+  }
+  uip_ip6addr(addr, words[0], words[1], words[2], words[3],
+              words[4], words[5], words[6], words[7]);
+}
+/*---------------------------------------------------------------------------*/
+static bool
+add_route(const uip_ipaddr_t *prefix, uint8_t length)
+{
+  uip_ds6_route_t *r;
+
+  r = uip_ds6_route_add(prefix, length,
+                        &nexthops[num_added % NUM_NEXTHOPS]);
+  if(r == NULL) {
+    return false;
+  }
+  routes[num_added++] = r;
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(add_lookup, "Route add and lookup");
+UNIT_TEST(add_lookup)
+{
+  uip_ipaddr_t addr;
+  uip_lladdr_t lladdr;
+
+  UNIT_TEST_BEGIN();
+
+  for(int i = 0; i < NUM_NEXTHOPS; i++) {
+    memset(&lladdr, 0, sizeof(lladdr));
+    lladdr.addr[0] = 0x02;
+    lladdr.addr[sizeof(lladdr) - 1] = i + 1;
+    uip_create_linklocal_prefix(&nexthops[i]);
+    uip_ds6_set_addr_iid(&nexthops[i], &lladdr);
+    UNIT_TEST_ASSERT(uip_ds6_nbr_add(&nexthops[i], &lladdr, 1, NBR_REACHABLE,
+                                     NBR_TABLE_REASON_UNDEFINED,
+                                     NULL) != NULL);
+  }
+
+  /* Add the most specific routes first, as adding a route replaces
+     any existing route that covers its prefix via another next hop. */
+  for(int s = 1; s <= NUM_SUBNETS; s++) {
+    for(int l = 1; l <= NUM_LINKS; l++) {
+      for(int h = 1; h <= HOSTS_PER_LINK; h++) {
+        uip_ip6addr(&addr, 0xfd00, 0, s, l, 0, 0, 0, h);
+        UNIT_TEST_ASSERT(add_route(&addr, 128));
+      }
+    }
+  }
+  for(int h = 1; h <= NUM_EXTERNAL_HOSTS; h++) {
+    uip_ip6addr(&addr, 0xfd01, 0, 0, 0, 0, 0, h >> 4, h);
+    UNIT_TEST_ASSERT(add_route(&addr, 128));
+  }
+  for(int s = 1; s <= NUM_SUBNETS; s++) {
+    for(int l = 1; l <= NUM_LINKS; l++) {
+      uip_ip6addr(&addr, 0xfd00, 0, s, l, 0, 0, 0, 0);
+      UNIT_TEST_ASSERT(add_route(&addr, 64));
+    }
+  }
+  /* A prefix that does not end on a byte boundary */
+  uip_ip6addr(&addr, 0xfd00, 0, NUM_SUBNETS + 1, 0x1230, 0, 0, 0, 0);
+  UNIT_TEST_ASSERT(add_route(&addr, 60));
+  for(int s = 1; s <= NUM_SUBNETS / 2; s++) {
+    uip_ip6addr(&addr, 0xfd00, 0, s, 0, 0, 0, 0, 0);
+    UNIT_TEST_ASSERT(add_route(&addr, 48));
+  }
+  uip_ip6addr(&addr, 0, 0, 0, 0, 0, 0, 0, 0);
+  UNIT_TEST_ASSERT(add_route(&addr, 0));
+
+  printf("Added %d routes\n", num_added);
+  UNIT_TEST_ASSERT(uip_ds6_route_num_routes() == num_added);
+
+  for(int i = 0; i < num_added; i++) {
+    UNIT_TEST_ASSERT(uip_ds6_route_lookup(&routes[i]->ipaddr) == routes[i]);
+  }
+  for(int i = 0; i < NUM_QUERIES; i++) {
+    random_query(&addr);
+    UNIT_TEST_ASSERT(lookup_matches_reference(&addr));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(remove_lookup, "Route removal and lookup");
+UNIT_TEST(remove_lookup)
+{
+  uip_ipaddr_t addr;
+  int remaining;
+
+  UNIT_TEST_BEGIN();
+
+  /* Remove every third route, including some covering prefixes. */
+  remaining = num_added;
+  for(int i = 0; i < num_added; i += 3) {
+    uip_ds6_route_rm(routes[i]);
+    routes[i] = NULL;
+    remaining--;
+  }
+  UNIT_TEST_ASSERT(uip_ds6_route_num_routes() == remaining);
+
+  for(int i = 0; i < NUM_QUERIES; i++) {
+    random_query(&addr);
+    UNIT_TEST_ASSERT(lookup_matches_reference(&addr));
+  }
+
+  /* Removing a next hop removes all of its routes. */
+  uip_ds6_route_rm_by_nexthop(&nexthops[1]);
+  for(int i = 0; i < NUM_QUERIES; i++) {
+    random_query(&addr);
+    UNIT_TEST_ASSERT(lookup_matches_reference(&addr));
+  }
+
+  /* The routes must be reusable after emptying the table. */
+  while(uip_ds6_route_head() != NULL) {
+    uip_ds6_route_rm(uip_ds6_route_head());
+  }
+  UNIT_TEST_ASSERT(uip_ds6_route_num_routes() == 0);
+  for(int i = 0; i < NUM_QUERIES; i++) {
+    random_query(&addr);
+    UNIT_TEST_ASSERT(uip_ds6_route_lookup(&addr) == NULL);
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "Route lookup benchmark");
+UNIT_TEST(benchmark)
+{
+  uip_ipaddr_t addr;
+  uint64_t start, host_ns, prefix_ns;
+
+  UNIT_TEST_BEGIN();
+
+  num_added = 0;
+  while(num_added < UIP_DS6_ROUTE_NB - 1) {
+    uip_ip6addr(&addr, 0xfd00, 0, 1, num_added >> 6, 0, 0, 0,
+                (num_added & 0x3f) + 1);
+    UNIT_TEST_ASSERT(add_route(&addr, 128));
+  }
+  uip_ip6addr(&addr, 0, 0, 0, 0, 0, 0, 0, 0);
+  UNIT_TEST_ASSERT(add_route(&addr, 0));
+
+  start = now_ns();
+  for(unsigned i = 0; i < BENCH_LOOKUPS; i++) {
+    /* Spread the lookups so that the MRU order does not help. */
+    uip_ds6_route_t *r = routes[(i * 7) % (num_added - 1)];
+    if(uip_ds6_route_lookup(&r->ipaddr) != r) {
+      UNIT_TEST_FAIL();
+    }
+  }
+  host_ns = now_ns() - start;
+
+  uip_ip6addr(&addr, 0xfd02, 0, 0, 0, 0, 0, 0, 1);
+  start = now_ns();
+  for(unsigned i = 0; i < BENCH_LOOKUPS; i++) {
+    if(uip_ds6_route_lookup(&addr) != routes[num_added - 1]) {
+      UNIT_TEST_FAIL();
+    }
+  }
+  prefix_ns = now_ns() - start;
+
+  printf("route lookup %s: %d routes: host %"PRIu64" ns/lookup, "
+         "default %"PRIu64" ns/lookup\n",
+         UIP_DS6_ROUTE_LPM_TRIE ? "trie" : "list", num_added,
+         host_ns / BENCH_LOOKUPS, prefix_ns / BENCH_LOOKUPS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(add_lookup);
+  UNIT_TEST_RUN(remove_lookup);
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(add_lookup) ||
+     !UNIT_TEST_PASSED(remove_lookup) ||
+     !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      Unit tests and a lookup benchmark for the source routing nodes
+ *      kept by a non-storing root.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip-sr.h"
+#include "net/routing/routing.h"
+#include "unit-test.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define NUM_NODES 5000
+#define BRANCHING 4
+#define BENCH_LOOKUPS 5000
+
+static uip_ipaddr_t root_addr;
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+/* Node 0 is the root, and node i > 0 is a child of node (i - 1) / 4 */
+static void
+node_addr(uip_ipaddr_t *addr, unsigned i)
+{
+  if(i == 0) {
+    uip_ipaddr_copy(addr, &root_addr);
+  } else {
+    uip_ipaddr_copy(addr, &root_addr);
+    addr->u16[6] = UIP_HTONS(0xbeef);
+    addr->u16[7] = UIP_HTONS(i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static bool
+node_is_addr(const uip_sr_node_t *node, const uip_ipaddr_t *addr)
+{
+  uip_ipaddr_t node_ipaddr;
+
+  return node != NULL &&
+    NETSTACK_ROUTING.get_sr_node_ipaddr(&node_ipaddr, node) &&
+    uip_ipaddr_cmp(&node_ipaddr, addr);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(update_lookup, "Source routing node update and lookup");
+UNIT_TEST(update_lookup)
+{
+  uip_ipaddr_t child;
+  uip_ipaddr_t parent;
+  uint64_t start, update_ns;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(NETSTACK_ROUTING.root_start() == 0);
+  UNIT_TEST_ASSERT(NETSTACK_ROUTING.get_root_ipaddr(&root_addr));
+  uip_sr_free_all();
+
+  start = now_ns();
+  for(unsigned i = 1; i <= NUM_NODES; i++) {
+    node_addr(&child, i);
+    node_addr(&parent, (i - 1) / BRANCHING);
+    if(uip_sr_update_node(NULL, &child, &parent, 600) == NULL) {
+      UNIT_TEST_FAIL();
+    }
+  }
+  update_ns = now_ns() - start;
+
+  /* The root node is added implicitly. */
+  UNIT_TEST_ASSERT(uip_sr_num_nodes() == NUM_NODES + 1);
+  printf("uip-sr: %u nodes added, %"PRIu64" ns/update\n",
+         NUM_NODES, update_ns / NUM_NODES);
+
+  for(unsigned i = 0; i <= NUM_NODES; i++) {
+    node_addr(&child, i);
+    if(!node_is_addr(uip_sr_get_node(NULL, &child), &child) ||
+       !uip_sr_is_addr_reachable(NULL, &child)) {
+      UNIT_TEST_FAIL();
+    }
+  }
+
+  /* Unknown nodes, and known link identifiers with another prefix */
+  node_addr(&child, NUM_NODES + 1);
+  UNIT_TEST_ASSERT(uip_sr_get_node(NULL, &child) == NULL);
+  UNIT_TEST_ASSERT(!uip_sr_is_addr_reachable(NULL, &child));
+  node_addr(&child, 1);
+  child.u8[0] ^= 0x01;
+  UNIT_TEST_ASSERT(uip_sr_get_node(NULL, &child) == NULL);
+  node_addr(&child, 1);
+  UNIT_TEST_ASSERT(uip_sr_get_node(&child, &child) == NULL);
+
+  /* A parent change that would create a loop is rejected. */
+  node_addr(&child, 1);
+  node_addr(&parent, 5);
+  UNIT_TEST_ASSERT(uip_sr_update_node(NULL, &child, &parent, 600) != NULL);
+  UNIT_TEST_ASSERT(uip_sr_is_addr_reachable(NULL, &parent));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(expire, "Source routing node expiration");
+UNIT_TEST(expire)
+{
+  uip_ipaddr_t child;
+  uip_ipaddr_t parent;
+  unsigned first_leaf = (NUM_NODES - 1) / BRANCHING + 1;
+  unsigned expired = 0;
+
+  UNIT_TEST_BEGIN();
+
+  /* Expire every other leaf; only nodes without children are removed. */
+  for(unsigned i = first_leaf; i <= NUM_NODES; i += 2) {
+    node_addr(&child, i);
+    node_addr(&parent, (i - 1) / BRANCHING);
+    uip_sr_expire_parent(NULL, &child, &parent);
+    expired++;
+  }
+  node_addr(&child, 1);
+  node_addr(&parent, 0);
+  uip_sr_expire_parent(NULL, &child, &parent);
+
+  uip_sr_periodic(UIP_SR_REMOVAL_DELAY);
+  uip_sr_periodic(1);
+  UNIT_TEST_ASSERT(uip_sr_num_nodes() == NUM_NODES + 1 - expired);
+
+  for(unsigned i = 0; i <= NUM_NODES; i++) {
+    node_addr(&child, i);
+    uip_sr_node_t *node = uip_sr_get_node(NULL, &child);
+    if(i >= first_leaf && (i - first_leaf) % 2 == 0) {
+      UNIT_TEST_ASSERT(node == NULL);
+    } else {
+      UNIT_TEST_ASSERT(node_is_addr(node, &child));
+    }
+  }
+
+  /* Expired nodes can be added again. */
+  for(unsigned i = first_leaf; i <= NUM_NODES; i += 2) {
+    node_addr(&child, i);
+    node_addr(&parent, (i - 1) / BRANCHING);
+    UNIT_TEST_ASSERT(uip_sr_update_node(NULL, &child, &parent, 600) != NULL);
+    UNIT_TEST_ASSERT(uip_sr_is_addr_reachable(NULL, &child));
+  }
+  UNIT_TEST_ASSERT(uip_sr_num_nodes() == NUM_NODES + 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "Source routing node lookup benchmark");
+UNIT_TEST(benchmark)
+{
+  uip_ipaddr_t addr;
+  uip_ipaddr_t parent;
+  uint64_t start, lookup_ns, reachable_ns, refresh_ns;
+
+  UNIT_TEST_BEGIN();
+
+  /* DAO refreshes of known links */
+  start = now_ns();
+  for(unsigned i = 1; i <= NUM_NODES; i++) {
+    node_addr(&addr, i);
+    node_addr(&parent, (i - 1) / BRANCHING);
+    if(uip_sr_update_node(NULL, &addr, &parent, 600) == NULL) {
+      UNIT_TEST_FAIL();
+    }
+  }
+  refresh_ns = now_ns() - start;
+
+  start = now_ns();
+  for(unsigned i = 0; i < BENCH_LOOKUPS; i++) {
+    node_addr(&addr, 1 + (i * 7) % NUM_NODES);
+    if(uip_sr_get_node(NULL, &addr) == NULL) {
+      UNIT_TEST_FAIL();
+    }
+  }
+  lookup_ns = now_ns() - start;
+
+  start = now_ns();
+  for(unsigned i = 0; i < BENCH_LOOKUPS; i++) {
+    node_addr(&addr, 1 + (i * 7) % NUM_NODES);
+    if(!uip_sr_is_addr_reachable(NULL, &addr)) {
+      UNIT_TEST_FAIL();
+    }
+  }
+  reachable_ns = now_ns() - start;
+
+  printf("uip-sr %s: %d nodes: lookup %"PRIu64" ns, "
+         "reachability %"PRIu64" ns, refresh %"PRIu64" ns\n",
+         UIP_SR_HASH_INDEX ? "hash" : "list", uip_sr_num_nodes(),
+         lookup_ns / BENCH_LOOKUPS, reachable_ns / BENCH_LOOKUPS,
+         refresh_ns / NUM_NODES);
+
+  uip_sr_free_all();
+  UNIT_TEST_ASSERT(uip_sr_num_nodes() == 0);
+  UNIT_TEST_ASSERT(uip_sr_get_node(NULL, &root_addr) == NULL);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(update_lookup);
+  UNIT_TEST_RUN(expire);
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(update_lookup) ||
+     !UNIT_TEST_PASSED(expire) ||
+     !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
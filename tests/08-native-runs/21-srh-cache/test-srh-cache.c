@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      Tests and a forwarding benchmark for the source routing header
+ *      insertion at an RPL non-storing root.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip-sr.h"
+#include "net/ipv6/uipbuf.h"
+#include "net/routing/routing.h"
+#include "unit-test.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define CHAIN_LEN 8
+#define DETOUR 100
+#define NUM_NODES 1000
+#define BRANCHING 4
+#define NUM_DESTS 32
+#define PAYLOAD_LEN 40
+#define BENCH_PACKETS 200000
+
+static uip_ipaddr_t root_addr;
+static uint8_t packet[UIP_BUFSIZE];
+static uint16_t packet_len;
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+node_addr(uip_ipaddr_t *addr, unsigned i)
+{
+  uip_ipaddr_copy(addr, &root_addr);
+  if(i != 0) {
+    addr->u16[6] = UIP_HTONS(0xbeef);
+    addr->u16[7] = UIP_HTONS(i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_link(unsigned child, unsigned parent)
+{
+  uip_ipaddr_t child_addr;
+  uip_ipaddr_t parent_addr;
+
+  node_addr(&child_addr, child);
+  node_addr(&parent_addr, parent);
+  uip_sr_update_node(NULL, &child_addr, &parent_addr, 600);
+}
+/*---------------------------------------------------------------------------*/
+/* Prepares a UDP packet from the root to a node, as it would be sent */
+static void
+make_packet(unsigned dest)
+{
+  struct uip_ip_hdr *ip = (struct uip_ip_hdr *)packet;
+
+  memset(packet, 0, sizeof(packet));
+  ip->vtc = 0x60;
+  ip->proto = UIP_PROTO_UDP;
+  ip->ttl = 64;
+  uip_ipaddr_copy(&ip->srcipaddr, &root_addr);
+  node_addr(&ip->destipaddr, dest);
+  ip->len[1] = PAYLOAD_LEN;
+  memset(packet + UIP_IPH_LEN, 0x5a, PAYLOAD_LEN);
+  packet_len = UIP_IPH_LEN + PAYLOAD_LEN;
+}
+/*---------------------------------------------------------------------------*/
+static int
+forward_packet(void)
+{
+  uipbuf_clear();
+  memcpy(uip_buf, packet, packet_len);
+  uip_len = packet_len;
+  return NETSTACK_ROUTING.ext_header_update();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(srh, "Source routing header insertion");
+UNIT_TEST(srh)
+{
+  uint8_t first[UIP_BUFSIZE];
+  uint16_t first_len;
+  uip_ipaddr_t addr;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(NETSTACK_ROUTING.root_start() == 0);
+  UNIT_TEST_ASSERT(NETSTACK_ROUTING.get_root_ipaddr(&root_addr));
+  uip_sr_free_all();
+
+  /* A chain below the root, and a node that offers a detour */
+  for(unsigned i = 1; i <= CHAIN_LEN; i++) {
+    add_link(i, i - 1);
+  }
+  add_link(DETOUR, 0);
+
+  /* Repeated packets get identical headers. */
+  for(unsigned dest = 1; dest <= CHAIN_LEN; dest++) {
+    make_packet(dest);
+    UNIT_TEST_ASSERT(forward_packet());
+    UNIT_TEST_ASSERT(UIP_IP_BUF->proto == UIP_PROTO_ROUTING);
+    node_addr(&addr, 1);
+    UNIT_TEST_ASSERT(uip_ipaddr_cmp(&UIP_IP_BUF->destipaddr, &addr));
+    memcpy(first, uip_buf, uip_len);
+    first_len = uip_len;
+
+    for(int i = 0; i < 3; i++) {
+      UNIT_TEST_ASSERT(forward_packet());
+      UNIT_TEST_ASSERT(uip_len == first_len);
+      UNIT_TEST_ASSERT(memcmp(uip_buf, first, first_len) == 0);
+    }
+  }
+
+  /* Moving a node changes the route of its whole subtree. */
+  add_link(2, DETOUR);
+  make_packet(CHAIN_LEN);
+  UNIT_TEST_ASSERT(forward_packet());
+  UNIT_TEST_ASSERT(uip_len == first_len);
+  node_addr(&addr, DETOUR);
+  UNIT_TEST_ASSERT(uip_ipaddr_cmp(&UIP_IP_BUF->destipaddr, &addr));
+
+  /* A removed node no longer gets a header. */
+  node_addr(&addr, CHAIN_LEN);
+  {
+    uip_ipaddr_t parent;
+    node_addr(&parent, CHAIN_LEN - 1);
+    uip_sr_expire_parent(NULL, &addr, &parent);
+  }
+  uip_sr_periodic(UIP_SR_REMOVAL_DELAY);
+  uip_sr_periodic(1);
+  UNIT_TEST_ASSERT(uip_sr_get_node(NULL, &addr) == NULL);
+  UNIT_TEST_ASSERT(forward_packet());
+  UNIT_TEST_ASSERT(UIP_IP_BUF->proto == UIP_PROTO_UDP);
+  UNIT_TEST_ASSERT(uip_ipaddr_cmp(&UIP_IP_BUF->destipaddr, &addr));
+  UNIT_TEST_ASSERT(uip_len == packet_len);
+
+#if UIP_SR_SRH_CACHE_SIZE
+  uip_sr_srh_cache_stats_t stats;
+  uip_sr_srh_cache_stats(&stats);
+  printf("SRH cache: %"PRIu32" hits, %"PRIu32" misses, %"PRIu32" flushes\n",
+         stats.hits, stats.misses, stats.flushes);
+  UNIT_TEST_ASSERT(stats.hits == 3 * CHAIN_LEN);
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "Root forwarding benchmark");
+UNIT_TEST(benchmark)
+{
+  uint64_t start, copy_ns, forward_ns;
+
+  UNIT_TEST_BEGIN();
+
+  uip_sr_free_all();
+  for(unsigned i = 1; i <= NUM_NODES; i++) {
+    add_link(i, (i - 1) / BRANCHING);
+  }
+  UNIT_TEST_ASSERT(uip_sr_num_nodes() == NUM_NODES + 1);
+
+#if UIP_SR_SRH_CACHE_SIZE
+  uip_sr_srh_cache_stats_reset();
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+
+  /* The cost of preparing the packets, without the routing header */
+  start = now_ns();
+  for(unsigned i = 0; i < BENCH_PACKETS; i++) {
+    make_packet(NUM_NODES - i % NUM_DESTS);
+    uipbuf_clear();
+    memcpy(uip_buf, packet, packet_len);
+    uip_len = packet_len;
+  }
+  copy_ns = now_ns() - start;
+
+  start = now_ns();
+  for(unsigned i = 0; i < BENCH_PACKETS; i++) {
+    make_packet(NUM_NODES - i % NUM_DESTS);
+    if(!forward_packet() || UIP_IP_BUF->proto != UIP_PROTO_ROUTING) {
+      UNIT_TEST_FAIL();
+    }
+  }
+  forward_ns = now_ns() - start;
+  forward_ns = forward_ns > copy_ns ? forward_ns - copy_ns : 0;
+
+  printf("SRH %s: %d nodes, %d destinations: %"PRIu64" ns/packet, "
+         "%"PRIu64" packets/s\n",
+         UIP_SR_SRH_CACHE_SIZE ? "cache" : "no cache", NUM_NODES, NUM_DESTS,
+         forward_ns / BENCH_PACKETS,
+         forward_ns ? (uint64_t)BENCH_PACKETS * 1000000000 / forward_ns : 0);
+
+#if UIP_SR_SRH_CACHE_SIZE
+  uip_sr_srh_cache_stats_t stats;
+  uip_sr_srh_cache_stats(&stats);
+  printf("SRH cache: %"PRIu32" hits, %"PRIu32" misses\n",
+         stats.hits, stats.misses);
+  UNIT_TEST_ASSERT(stats.hits + stats.misses == BENCH_PACKETS);
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(srh);
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(srh) ||
+     !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      Tests and a lookup benchmark for the TSCH schedule.
+ */
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "unit-test.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define RANDOM_ROUNDS 20
+#define RANDOM_LOOKUPS 2000
+#define BENCH_LOOKUPS 200000
+
+static const linkaddr_t nbr_addr = {{ 0x01 }};
+/*---------------------------------------------------------------------------*/
+/* The parts of the TSCH MAC that the schedule depends on */
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff, 0xff, 0xff,
+                                              0xff, 0xff, 0xff, 0xff } };
+struct tsch_link *current_link;
+static int locked;
+
+int
+tsch_is_locked(void)
+{
+  return locked;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_get_lock(void)
+{
+  if(locked) {
+    return 0;
+  }
+  locked = 1;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_release_lock(void)
+{
+  locked = 0;
+}
+/*---------------------------------------------------------------------------*/
+struct tsch_neighbor *
+tsch_queue_add_nbr(const linkaddr_t *addr)
+{
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+struct tsch_neighbor *
+tsch_queue_get_nbr(const linkaddr_t *addr)
+{
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+time_to_link(const struct tsch_asn_t *asn, const struct tsch_link *l)
+{
+  struct tsch_slotframe *sf =
+    tsch_schedule_get_slotframe_by_handle(l->slotframe_handle);
+  uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
+
+  return l->timeslot > timeslot ?
+         l->timeslot - timeslot : sf->size.val + l->timeslot - timeslot;
+}
+/*---------------------------------------------------------------------------*/
+/* Checks the result of a lookup against a scan of all links */
+static int
+check_next_active_link(struct tsch_asn_t *asn)
+{
+  struct tsch_slotframe *sf;
+  struct tsch_link *l;
+  struct tsch_link *best;
+  struct tsch_link *backup;
+  uint16_t time_offset;
+  uint16_t min_time = 0xffff;
+
+  for(sf = tsch_schedule_slotframe_head(); sf != NULL;
+      sf = tsch_schedule_slotframe_next(sf)) {
+    for(l = list_head(sf->links_list); l != NULL; l = list_item_next(l)) {
+      uint16_t t = time_to_link(asn, l);
+      if(t < min_time) {
+        min_time = t;
+      }
+    }
+  }
+
+  best = tsch_schedule_get_next_active_link(asn, &time_offset, &backup);
+  if(best == NULL) {
+    return min_time == 0xffff;
+  }
+  if(time_offset != min_time || time_to_link(asn, best) != min_time) {
+    return 0;
+  }
+  if(backup != NULL) {
+    if(time_to_link(asn, backup) != min_time ||
+       !(backup->link_options & LINK_OPTION_RX)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(selection, "Link selection");
+UNIT_TEST(selection)
+{
+  struct tsch_slotframe *sf0;
+  struct tsch_slotframe *sf1;
+  struct tsch_link *rx0;
+  struct tsch_link *tx1;
+  struct tsch_link *l;
+  struct tsch_link *backup;
+  struct tsch_asn_t asn;
+  uint16_t time_offset;
+
+  UNIT_TEST_BEGIN();
+
+  tsch_schedule_init();
+  sf0 = tsch_schedule_add_slotframe(0, 11);
+  sf1 = tsch_schedule_add_slotframe(1, 7);
+  UNIT_TEST_ASSERT(sf0 != NULL && sf1 != NULL);
+
+  rx0 = tsch_schedule_add_link(sf0, LINK_OPTION_RX, LINK_TYPE_NORMAL,
+                               &tsch_broadcast_address, 5, 0, 1);
+  tx1 = tsch_schedule_add_link(sf1, LINK_OPTION_TX, LINK_TYPE_NORMAL,
+                               &nbr_addr, 5, 1, 1);
+  UNIT_TEST_ASSERT(rx0 != NULL && tx1 != NULL);
+  UNIT_TEST_ASSERT(tsch_schedule_get_link_by_timeslot(sf0, 5) == rx0);
+  UNIT_TEST_ASSERT(tsch_schedule_get_link_by_timeslot(sf0, 4) == NULL);
+
+  /* Both links are next at ASN 0: Tx wins, the Rx link is the backup */
+  TSCH_ASN_INIT(asn, 0, 0);
+  l = tsch_schedule_get_next_active_link(&asn, &time_offset, &backup);
+  UNIT_TEST_ASSERT(l == tx1);
+  UNIT_TEST_ASSERT(backup == rx0);
+  UNIT_TEST_ASSERT(time_offset == 5);
+
+  /* Wrapping around: at ASN 5 only sf1 has a link 7 slots later */
+  TSCH_ASN_INIT(asn, 0, 5);
+  l = tsch_schedule_get_next_active_link(&asn, &time_offset, &backup);
+  UNIT_TEST_ASSERT(l == tx1);
+  UNIT_TEST_ASSERT(backup == NULL);
+  UNIT_TEST_ASSERT(time_offset == 7);
+
+  /* Replacing a link keeps a single link in the timeslot */
+  l = tsch_schedule_add_link(sf1, LINK_OPTION_RX, LINK_TYPE_NORMAL,
+                             &tsch_broadcast_address, 5, 2, 1);
+  UNIT_TEST_ASSERT(l != NULL);
+  UNIT_TEST_ASSERT(tsch_schedule_get_link_by_timeslot(sf1, 5) == l);
+  UNIT_TEST_ASSERT(list_length(sf1->links_list) == 1);
+
+  /* Equal options: the lower slotframe handle wins, and is also the
+   * preferred backup */
+  TSCH_ASN_INIT(asn, 0, 0);
+  UNIT_TEST_ASSERT(tsch_schedule_get_next_active_link(&asn, &time_offset,
+                                                      &backup) == rx0);
+  UNIT_TEST_ASSERT(backup == rx0);
+
+  UNIT_TEST_ASSERT(tsch_schedule_remove_link(sf0, rx0));
+  UNIT_TEST_ASSERT(tsch_schedule_get_link_by_timeslot(sf0, 5) == NULL);
+  UNIT_TEST_ASSERT(tsch_schedule_get_next_active_link(&asn, &time_offset,
+                                                      &backup) == l);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(random, "Random schedules");
+UNIT_TEST(random)
+{
+  static const uint16_t sizes[] = { 397, 101, 31, 7 };
+  struct tsch_slotframe *sf[4];
+  struct tsch_asn_t asn;
+
+  UNIT_TEST_BEGIN();
+
+  srand(1);
+  for(int round = 0; round < RANDOM_ROUNDS; round++) {
+    tsch_schedule_remove_all_slotframes();
+    for(int i = 0; i < 4; i++) {
+      sf[i] = tsch_schedule_add_slotframe(i, sizes[i]);
+      UNIT_TEST_ASSERT(sf[i] != NULL);
+    }
+
+    /* Links with random options, some of them replaced or removed */
+    for(int i = 0; i < TSCH_SCHEDULE_MAX_LINKS; i++) {
+      int n = rand() % 4;
+      uint8_t options = 1 + rand() % (LINK_OPTION_TX | LINK_OPTION_RX);
+      uint16_t timeslot = rand() % sizes[n];
+      tsch_schedule_add_link(sf[n], options, LINK_TYPE_NORMAL,
+                             options & LINK_OPTION_TX ?
+                             &nbr_addr : &tsch_broadcast_address,
+                             timeslot, 0, 1);
+      if(rand() % 4 == 0) {
+        tsch_schedule_remove_link_by_offsets(sf[rand() % 4],
+                                             rand() % sizes[n], 0);
+      }
+    }
+
+    for(int i = 0; i < RANDOM_LOOKUPS; i++) {
+      TSCH_ASN_INIT(asn, 0, rand());
+      UNIT_TEST_ASSERT(check_next_active_link(&asn));
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "Next active link benchmark");
+UNIT_TEST(benchmark)
+{
+  static const int link_counts[] = { 4, 16, 64, 256 };
+  struct tsch_slotframe *sf;
+  struct tsch_link *backup;
+  struct tsch_asn_t asn;
+  uint16_t time_offset;
+  uint32_t found = 0;
+
+  UNIT_TEST_BEGIN();
+
+  for(int i = 0; i < sizeof(link_counts) / sizeof(link_counts[0]); i++) {
+    uint64_t start, elapsed;
+    uint16_t size = 4 * link_counts[i] + 1;
+
+    /* One link every four slots, as an autonomous scheduler would do */
+    tsch_schedule_remove_all_slotframes();
+    sf = tsch_schedule_add_slotframe(0, size);
+    UNIT_TEST_ASSERT(sf != NULL);
+    for(int j = 0; j < link_counts[i]; j++) {
+      UNIT_TEST_ASSERT(tsch_schedule_add_link(sf, LINK_OPTION_RX,
+                                              LINK_TYPE_NORMAL,
+                                              &tsch_broadcast_address,
+                                              4 * j, 0, 0) != NULL);
+    }
+
+    TSCH_ASN_INIT(asn, 0, 0);
+    start = now_ns();
+    for(int j = 0; j < BENCH_LOOKUPS; j++) {
+      if(tsch_schedule_get_next_active_link(&asn, &time_offset,
+                                            &backup) != NULL) {
+        found++;
+      }
+      TSCH_ASN_INC(asn, 1);
+    }
+    elapsed = now_ns() - start;
+
+    printf("Next active link (%s): %d links: %"PRIu64" ns\n",
+           TSCH_SCHEDULE_INDEXED ? "indexed" : "list", link_counts[i],
+           elapsed / BENCH_LOOKUPS);
+  }
+  UNIT_TEST_ASSERT(found == 4 * BENCH_LOOKUPS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(selection);
+  UNIT_TEST_RUN(random);
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(selection) ||
+     !UNIT_TEST_PASSED(random) ||
+     !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      Tests and a benchmark for the packet selection in TSCH shared slots.
+ */
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/mac/tsch/tsch.h"
+#include "unit-test.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <time.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define NUM_FAIR 4
+#define PACKETS_PER_NBR 3
+#define NUM_BURST 40
+#define NUM_IDLE 150
+#define NUM_ACTIVE 4
+#define BENCH_LOOKUPS 200000
+
+static struct tsch_link shared_link = {
+  .link_options = LINK_OPTION_TX | LINK_OPTION_SHARED,
+};
+/*---------------------------------------------------------------------------*/
+/* The parts of the TSCH MAC that the queues depend on */
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff, 0xff, 0xff,
+                                              0xff, 0xff, 0xff, 0xff } };
+const linkaddr_t tsch_eb_address = { { 0, 0, 0, 0, 0, 0, 0, 0 } };
+int tsch_is_coordinator;
+static int locked;
+
+int
+tsch_is_locked(void)
+{
+  return locked;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_get_lock(void)
+{
+  if(locked) {
+    return 0;
+  }
+  locked = 1;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_release_lock(void)
+{
+  locked = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_set_ka_timeout(uint32_t timeout)
+{
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+nbr_addr(linkaddr_t *addr, unsigned i)
+{
+  linkaddr_copy(addr, &linkaddr_null);
+  addr->u8[0] = 0x10;
+  addr->u8[6] = i >> 8;
+  addr->u8[7] = i;
+}
+/*---------------------------------------------------------------------------*/
+static struct tsch_neighbor *
+queue_packet(unsigned i)
+{
+  linkaddr_t addr;
+
+  nbr_addr(&addr, i);
+  packetbuf_clear();
+  packetbuf_set_datalen(10);
+  if(tsch_queue_add_packet(&addr, 1, NULL, NULL) == NULL) {
+    return NULL;
+  }
+  return tsch_queue_get_nbr(&addr);
+}
+/*---------------------------------------------------------------------------*/
+/* Sends a packet in a shared slot, returns the neighbor (NULL if none) */
+static struct tsch_neighbor *
+send_shared(void)
+{
+  struct tsch_neighbor *n = NULL;
+  struct tsch_packet *p;
+
+  p = tsch_queue_get_unicast_packet_for_any(&n, &shared_link);
+  if(p == NULL) {
+    return NULL;
+  }
+  tsch_queue_packet_sent(n, p, &shared_link, MAC_TX_OK);
+  tsch_queue_free_packet(p);
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static void
+reset_queues(void)
+{
+  tsch_queue_reset();
+  tsch_queue_free_unused_neighbors();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(selection, "Shared slot packet selection");
+UNIT_TEST(selection)
+{
+  struct tsch_neighbor *nbrs[NUM_FAIR];
+  struct tsch_neighbor *n;
+  int count[NUM_FAIR] = { 0 };
+
+  UNIT_TEST_BEGIN();
+
+  reset_queues();
+  UNIT_TEST_ASSERT(send_shared() == NULL);
+
+  for(int j = 0; j < PACKETS_PER_NBR; j++) {
+    for(int i = 0; i < NUM_FAIR; i++) {
+      nbrs[i] = queue_packet(i + 1);
+      UNIT_TEST_ASSERT(nbrs[i] != NULL);
+    }
+  }
+
+  /* Broadcast packets are never selected */
+  packetbuf_clear();
+  UNIT_TEST_ASSERT(tsch_queue_add_packet(&tsch_broadcast_address, 1,
+                                         NULL, NULL) != NULL);
+
+  /* Neighbors we have a Tx link to are skipped */
+  nbrs[0]->tx_links_count = 1;
+  for(int j = 0; j < PACKETS_PER_NBR * (NUM_FAIR - 1); j++) {
+    n = send_shared();
+    UNIT_TEST_ASSERT(n != NULL && n != nbrs[0]);
+#if TSCH_QUEUE_WITH_ACTIVE_LIST
+    /* Round-robin among the neighbors with packets */
+    UNIT_TEST_ASSERT(n == nbrs[1 + j % (NUM_FAIR - 1)]);
+#endif /* TSCH_QUEUE_WITH_ACTIVE_LIST */
+    for(int i = 0; i < NUM_FAIR; i++) {
+      count[i] += n == nbrs[i];
+    }
+  }
+  UNIT_TEST_ASSERT(send_shared() == NULL);
+  for(int i = 1; i < NUM_FAIR; i++) {
+    UNIT_TEST_ASSERT(count[i] == PACKETS_PER_NBR);
+  }
+
+  /* Back to shared slots once the Tx link is gone */
+  nbrs[0]->tx_links_count = 0;
+  for(int j = 0; j < PACKETS_PER_NBR; j++) {
+    UNIT_TEST_ASSERT(send_shared() == nbrs[0]);
+  }
+  UNIT_TEST_ASSERT(send_shared() == NULL);
+
+  /* A neighbor in backoff is skipped */
+  UNIT_TEST_ASSERT(queue_packet(1) == nbrs[0]);
+  UNIT_TEST_ASSERT(queue_packet(2) == nbrs[1]);
+  nbrs[0]->backoff_window = 1;
+  UNIT_TEST_ASSERT(send_shared() == nbrs[1]);
+  UNIT_TEST_ASSERT(send_shared() == NULL);
+  nbrs[0]->backoff_window = 0;
+  UNIT_TEST_ASSERT(send_shared() == nbrs[0]);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(removal, "Neighbor removal and bursts");
+UNIT_TEST(removal)
+{
+  int sent = 0;
+
+  UNIT_TEST_BEGIN();
+
+  /* Neighbors are removed while in the active list */
+  reset_queues();
+  for(unsigned i = 1; i <= NUM_FAIR; i++) {
+    UNIT_TEST_ASSERT(queue_packet(i) != NULL);
+  }
+  UNIT_TEST_ASSERT(send_shared() != NULL);
+  reset_queues();
+  UNIT_TEST_ASSERT(send_shared() == NULL);
+
+  /* More new neighbors than the pending ones between two shared slots */
+  for(unsigned i = 1; i <= NUM_BURST; i++) {
+    UNIT_TEST_ASSERT(queue_packet(i) != NULL);
+  }
+  while(send_shared() != NULL) {
+    sent++;
+  }
+  UNIT_TEST_ASSERT(sent == NUM_BURST);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "Shared slot selection benchmark");
+UNIT_TEST(benchmark)
+{
+  struct tsch_neighbor *n;
+  uint64_t start, elapsed;
+  uint32_t found = 0;
+
+  UNIT_TEST_BEGIN();
+
+  /* Many neighbors, a few of which have packets */
+  reset_queues();
+  for(unsigned i = 1; i <= NUM_IDLE; i++) {
+    linkaddr_t addr;
+    nbr_addr(&addr, i);
+    UNIT_TEST_ASSERT(tsch_queue_add_nbr(&addr) != NULL);
+  }
+  for(unsigned i = 0; i < NUM_ACTIVE; i++) {
+    UNIT_TEST_ASSERT(queue_packet(NUM_IDLE - i * (NUM_IDLE / NUM_ACTIVE)) != NULL);
+  }
+
+  start = now_ns();
+  for(int i = 0; i < BENCH_LOOKUPS; i++) {
+    if(tsch_queue_get_unicast_packet_for_any(&n, &shared_link) != NULL) {
+      found++;
+    }
+  }
+  elapsed = now_ns() - start;
+  UNIT_TEST_ASSERT(found == BENCH_LOOKUPS);
+
+  printf("Shared slot selection (%s): %d neighbors, %d active: %"PRIu64" ns\n",
+         TSCH_QUEUE_WITH_ACTIVE_LIST ? "active list" : "scan",
+         NUM_IDLE, NUM_ACTIVE, elapsed / BENCH_LOOKUPS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  tsch_queue_init();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(selection);
+  UNIT_TEST_RUN(removal);
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(selection) ||
+     !UNIT_TEST_PASSED(removal) ||
+     !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      Tests and benchmarks for the native platform main loop: etimer
+ *      latency, file descriptors beyond FD_SETSIZE, and packets per
+ *      second received through the tun interface.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/simple-udp.h"
+#include "net/ipv6/uip-ds6.h"
+#include "tun6-net.h"
+#include "unit-test.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* The main loop selected by the platform */
+#ifdef SELECT_CONF_EPOLL
+#define SELECT_EPOLL_TEST SELECT_CONF_EPOLL
+#elif defined(__linux__)
+#define SELECT_EPOLL_TEST 1
+#else
+#define SELECT_EPOLL_TEST 0
+#endif
+
+#define TIMER_ROUNDS 10
+#define TIMER_INTERVAL (CLOCK_SECOND / 50)
+#define NS_PER_TICK (1000000000 / CLOCK_SECOND)
+/* Beyond FD_SETSIZE (1024), as select cannot monitor it */
+#define HIGH_FD 1500
+#define UDP_PORT 5678
+#define UDP_PAYLOAD_LEN 64
+#define BENCH_BURST 256
+#define BENCH_ROUNDS 200
+
+static struct etimer et;
+static volatile int fd_events;
+static int pipe_fds[2];
+static struct simple_udp_connection udp_conn;
+static uint32_t udp_received;
+static uint32_t udp_expected;
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+fd_handler(int fd, int events)
+{
+  char c;
+
+  if((events & SELECT_EVENT_READ) && read(fd, &c, 1) == 1) {
+    fd_events++;
+    process_poll(&test_process);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+udp_rx_callback(struct simple_udp_connection *c,
+                const uip_ipaddr_t *sender_addr, uint16_t sender_port,
+                const uip_ipaddr_t *receiver_addr, uint16_t receiver_port,
+                const uint8_t *data, uint16_t datalen)
+{
+  udp_received++;
+  if(udp_received == udp_expected) {
+    process_poll(&test_process);
+  }
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(timer, "etimer latency");
+UNIT_TEST(timer)
+{
+  static int i;
+  static int64_t deadline;
+  static int64_t late_max;
+  static int64_t late_total;
+  int64_t late;
+
+  UNIT_TEST_BEGIN();
+
+  late_max = 0;
+  late_total = 0;
+  for(i = 0; i < TIMER_ROUNDS; i++) {
+    etimer_set(&et, TIMER_INTERVAL);
+    /* The etimer counts from clock_time(), which is truncated to the
+     * tick, so it may expire up to a tick before now + interval */
+    deadline = (int64_t)(now_ns() / NS_PER_TICK + TIMER_INTERVAL) * NS_PER_TICK;
+    PT_WAIT_UNTIL(&unit_test_pt, etimer_expired(&et));
+    late = (int64_t)now_ns() - deadline;
+    /* A tick may pass between etimer_set() and reading the deadline */
+    if(late < 0) {
+      late = 0;
+    }
+    late_total += late;
+    if(late > late_max) {
+      late_max = late;
+    }
+  }
+
+  printf("etimer latency (%s): average %"PRId64" us, max %"PRId64" us\n",
+         SELECT_EPOLL_TEST ? "epoll" : "select",
+         late_total / TIMER_ROUNDS / 1000, late_max / 1000);
+#if SELECT_EPOLL_TEST
+  /* The loop sleeps until the next expiration, not a fixed timeout */
+  UNIT_TEST_ASSERT(late_max < 20000000);
+#endif /* SELECT_EPOLL_TEST */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(fds, "Event callbacks");
+UNIT_TEST(fds)
+{
+  static int fd;
+  static int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(pipe(pipe_fds) == 0);
+  fd = pipe_fds[0];
+#if SELECT_EPOLL_TEST
+  {
+    struct rlimit rl;
+    UNIT_TEST_ASSERT(getrlimit(RLIMIT_NOFILE, &rl) == 0);
+    if(rl.rlim_cur <= HIGH_FD && rl.rlim_max > HIGH_FD) {
+      rl.rlim_cur = rl.rlim_max;
+      setrlimit(RLIMIT_NOFILE, &rl);
+    }
+    if(dup2(pipe_fds[0], HIGH_FD) == HIGH_FD) {
+      close(pipe_fds[0]);
+      fd = HIGH_FD;
+    }
+  }
+#endif /* SELECT_EPOLL_TEST */
+  printf("Monitoring fd %d\n", fd);
+  UNIT_TEST_ASSERT(select_set_event_callback(fd, SELECT_EVENT_READ,
+                                             fd_handler));
+
+  fd_events = 0;
+  for(i = 1; i <= 3; i++) {
+    UNIT_TEST_ASSERT(write(pipe_fds[1], "x", 1) == 1);
+    etimer_set(&et, CLOCK_SECOND);
+    PT_WAIT_UNTIL(&unit_test_pt, fd_events == i || etimer_expired(&et));
+    UNIT_TEST_ASSERT(fd_events == i);
+  }
+
+  /* No more events once removed */
+  UNIT_TEST_ASSERT(select_set_event_callback(fd, 0, NULL));
+  UNIT_TEST_ASSERT(write(pipe_fds[1], "x", 1) == 1);
+  etimer_set(&et, CLOCK_SECOND / 10);
+  PT_WAIT_UNTIL(&unit_test_pt, etimer_expired(&et));
+  UNIT_TEST_ASSERT(fd_events == 3);
+
+  close(fd);
+  close(pipe_fds[1]);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(tun, "tun input benchmark");
+UNIT_TEST(tun)
+{
+  static int sock;
+  static struct sockaddr_in6 dest;
+  static int round;
+  static uint64_t start;
+  static uint64_t elapsed;
+  char payload[UDP_PAYLOAD_LEN];
+  uip_ds6_addr_t *addr;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  simple_udp_register(&udp_conn, UDP_PORT, NULL, 0, udp_rx_callback);
+  addr = uip_ds6_get_global(ADDR_PREFERRED);
+  UNIT_TEST_ASSERT(addr != NULL);
+
+  memset(&dest, 0, sizeof(dest));
+  dest.sin6_family = AF_INET6;
+  dest.sin6_port = htons(UDP_PORT);
+  memcpy(&dest.sin6_addr, &addr->ipaddr, sizeof(dest.sin6_addr));
+  sock = socket(AF_INET6, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+  UNIT_TEST_ASSERT(sock >= 0);
+  /* In case the prefix is also routed elsewhere */
+  setsockopt(sock, SOL_SOCKET, SO_BINDTODEVICE, tun6_net_get_tun_name(),
+             strlen(tun6_net_get_tun_name()));
+
+  /* The host stack queues bursts of packets in the tun, and the node reads
+   * them as fast as its main loop allows */
+  memset(payload, 0x5a, sizeof(payload));
+  elapsed = 0;
+  udp_received = 0;
+  for(round = 0; round < BENCH_ROUNDS; round++) {
+    udp_expected = udp_received;
+    for(i = 0; i < BENCH_BURST; i++) {
+      if(sendto(sock, payload, sizeof(payload), 0,
+                (struct sockaddr *)&dest, sizeof(dest)) == sizeof(payload)) {
+        udp_expected++;
+      }
+    }
+    start = now_ns();
+    etimer_set(&et, CLOCK_SECOND);
+    PT_WAIT_UNTIL(&unit_test_pt,
+                  udp_received == udp_expected || etimer_expired(&et));
+    elapsed += now_ns() - start;
+    if(udp_received != udp_expected) {
+      break;
+    }
+  }
+  close(sock);
+
+  if(udp_received == 0) {
+    /* No tun, e.g. without the permission to open it */
+    printf("tun input (%s): no packets received, skipped\n",
+           SELECT_EPOLL_TEST ? "epoll" : "select");
+  } else {
+    printf("tun input (%s): %"PRIu32" packets, %"PRIu64" packets/s\n",
+           SELECT_EPOLL_TEST ? "epoll" : "select", udp_received,
+           (uint64_t)udp_received * 1000000000 / elapsed);
+    UNIT_TEST_ASSERT(udp_received == udp_expected);
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(timer);
+  UNIT_TEST_RUN(fds);
+  UNIT_TEST_RUN(tun);
+
+  if(!UNIT_TEST_PASSED(timer) ||
+     !UNIT_TEST_PASSED(fds) ||
+     !UNIT_TEST_PASSED(tun)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      Tests the process profiler, and benchmarks the cost of delivering
+ *      an event with and without it.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <time.h>
+
+PROCESS(test_process, "test");
+PROCESS(busy_process, "busy");
+PROCESS(inner_process, "inner");
+PROCESS(sink_process, "sink");
+AUTOSTART_PROCESSES(&test_process);
+
+#define BUSY_EVENTS 10
+#define BUSY_TIME_NS 2000000
+#define INNER_TIME_NS 1000000
+#define BENCH_EVENTS 100000
+
+static int busy_handled;
+static uint32_t sink_handled;
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_PROFILE
+static uint64_t
+profile_ns(uint32_t time)
+{
+  return (uint64_t)time * 1000000000 / PROCESS_PROFILE_SECOND;
+}
+#endif /* PROCESS_CONF_PROFILE */
+/*---------------------------------------------------------------------------*/
+static void
+spin(uint64_t ns)
+{
+  uint64_t start = now_ns();
+
+  while(now_ns() - start < ns);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(inner_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_CONTINUE);
+    spin(INNER_TIME_NS);
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(busy_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_CONTINUE);
+    spin(BUSY_TIME_NS);
+    /* The time spent in the inner process is not ours */
+    process_post_synch(&inner_process, PROCESS_EVENT_CONTINUE, NULL);
+    if(++busy_handled == BUSY_EVENTS) {
+      process_poll(&test_process);
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(sink_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT();
+    if(ev == PROCESS_EVENT_CONTINUE && ++sink_handled == BENCH_EVENTS) {
+      process_poll(&test_process);
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(profile, "process profile");
+UNIT_TEST(profile)
+{
+  static int i;
+
+  UNIT_TEST_BEGIN();
+
+  process_start(&inner_process, NULL);
+  process_start(&busy_process, NULL);
+#if PROCESS_CONF_PROFILE
+  process_profile_reset();
+#endif /* PROCESS_CONF_PROFILE */
+
+  /* All events are queued at once, so the last one waits for the
+     processing of the others */
+  for(i = 0; i < BUSY_EVENTS; i++) {
+    UNIT_TEST_ASSERT(process_post(&busy_process, PROCESS_EVENT_CONTINUE,
+                                  NULL) == PROCESS_ERR_OK);
+  }
+  PT_WAIT_UNTIL(&unit_test_pt, busy_handled == BUSY_EVENTS);
+
+#if PROCESS_CONF_PROFILE
+  const struct process_profile *busy = &busy_process.profile;
+  const struct process_profile *inner = &inner_process.profile;
+
+  printf("busy: calls %"PRIu32", run %"PRIu64" us, max %"PRIu64" us, "
+         "events %"PRIu32", max delay %"PRIu64" us\n",
+         busy->calls, profile_ns(busy->run_time) / 1000,
+         profile_ns(busy->max_run_time) / 1000, busy->events,
+         profile_ns(busy->max_event_delay) / 1000);
+  printf("inner: calls %"PRIu32", run %"PRIu64" us\n",
+         inner->calls, profile_ns(inner->run_time) / 1000);
+
+  UNIT_TEST_ASSERT(busy->calls == BUSY_EVENTS);
+  UNIT_TEST_ASSERT(busy->events == BUSY_EVENTS);
+  UNIT_TEST_ASSERT(inner->calls == BUSY_EVENTS);
+  UNIT_TEST_ASSERT(inner->events == 0);
+  /* Run times, without the nested calls */
+  UNIT_TEST_ASSERT(profile_ns(busy->run_time) >=
+                   BUSY_EVENTS * BUSY_TIME_NS);
+  UNIT_TEST_ASSERT(profile_ns(busy->run_time) <
+                   BUSY_EVENTS * (BUSY_TIME_NS + INNER_TIME_NS));
+  UNIT_TEST_ASSERT(profile_ns(inner->run_time) >=
+                   BUSY_EVENTS * INNER_TIME_NS);
+  UNIT_TEST_ASSERT(profile_ns(busy->max_run_time) >= BUSY_TIME_NS);
+  /* The last event waited for the others */
+  UNIT_TEST_ASSERT(profile_ns(busy->max_event_delay) >=
+                   (BUSY_EVENTS - 1) * (BUSY_TIME_NS + INNER_TIME_NS));
+  UNIT_TEST_ASSERT(busy->event_delay >= busy->max_event_delay);
+
+  process_profile_reset();
+  UNIT_TEST_ASSERT(busy->calls == 0 && busy->run_time == 0);
+#endif /* PROCESS_CONF_PROFILE */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(overhead, "event delivery overhead");
+UNIT_TEST(overhead)
+{
+  static uint32_t i;
+  static uint64_t start;
+
+  UNIT_TEST_BEGIN();
+
+  process_start(&sink_process, NULL);
+
+  /* Keep the queue half full while the sink takes the events */
+  start = now_ns();
+  for(i = 0; i < BENCH_EVENTS; i++) {
+    if(process_post(&sink_process, PROCESS_EVENT_CONTINUE, NULL)
+       != PROCESS_ERR_OK) {
+      i--;
+    }
+    if(process_nevents() >= PROCESS_CONF_NUMEVENTS / 2) {
+      process_poll(&test_process);
+      PT_YIELD(&unit_test_pt);
+    }
+  }
+  PT_WAIT_UNTIL(&unit_test_pt, sink_handled == BENCH_EVENTS);
+
+  printf("Event delivery (profile %s): %"PRIu64" ns per event\n",
+         PROCESS_CONF_PROFILE ? "on" : "off",
+         (now_ns() - start) / BENCH_EVENTS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(profile);
+  UNIT_TEST_RUN(overhead);
+
+  if(!UNIT_TEST_PASSED(profile) ||
+     !UNIT_TEST_PASSED(overhead)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
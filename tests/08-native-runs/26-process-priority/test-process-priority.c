@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      Tests the event queue priorities and overflow accounting, and
+ *      benchmarks the queueing delay of a high priority event under
+ *      application load and the event throughput of the main loop.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <time.h>
+
+PROCESS(test_process, "test");
+PROCESS(app_process, "app");
+PROCESS(net_process, "net");
+AUTOSTART_PROCESSES(&test_process);
+
+#define ORDER_EVENTS 4
+#define LOAD_TIME_NS 100000
+#define BENCH_DURATION_NS 500000000
+
+static process_event_t order_log[ORDER_EVENTS + 1];
+static int order_len;
+static bool app_load;
+static bool app_flood;
+static uint32_t app_handled;
+static uint64_t net_posted;
+static uint64_t net_delay;
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(app_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_CONTINUE);
+    app_handled++;
+    if(order_len <= ORDER_EVENTS) {
+      order_log[order_len++] = ev;
+    }
+    if(app_load) {
+      uint64_t start = now_ns();
+      while(now_ns() - start < LOAD_TIME_NS);
+    }
+    if(app_flood) {
+      /* Keep the queue busy */
+      process_post(&app_process, PROCESS_EVENT_CONTINUE, NULL);
+    } else {
+      process_poll(&test_process);
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(net_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  process_set_priority(&net_process, PROCESS_PRIORITY_HIGH);
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_MSG);
+    if(order_len <= ORDER_EVENTS) {
+      order_log[order_len++] = ev;
+    }
+    net_delay = now_ns() - net_posted;
+    process_poll(&test_process);
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(order, "delivery order");
+UNIT_TEST(order)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  process_start(&app_process, NULL);
+  process_start(&net_process, NULL);
+
+  /* Application events first, then a network event */
+  order_len = 0;
+  for(i = 0; i < ORDER_EVENTS; i++) {
+    UNIT_TEST_ASSERT(process_post(&app_process, PROCESS_EVENT_CONTINUE,
+                                  NULL) == PROCESS_ERR_OK);
+  }
+  net_posted = now_ns();
+  UNIT_TEST_ASSERT(process_post(&net_process, PROCESS_EVENT_MSG,
+                                NULL) == PROCESS_ERR_OK);
+  PT_WAIT_UNTIL(&unit_test_pt, order_len == ORDER_EVENTS + 1);
+
+#if PROCESS_CONF_WITH_PRIORITY
+  UNIT_TEST_ASSERT(order_log[0] == PROCESS_EVENT_MSG);
+#else
+  UNIT_TEST_ASSERT(order_log[ORDER_EVENTS] == PROCESS_EVENT_MSG);
+#endif /* PROCESS_CONF_WITH_PRIORITY */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(overflow, "queue overflow");
+UNIT_TEST(overflow)
+{
+  static uint32_t dropped;
+  static uint32_t handled;
+  int i;
+  int failed;
+
+  UNIT_TEST_BEGIN();
+
+  /* The queue is empty here: fill it and overflow it */
+  dropped = process_dropped_events(PROCESS_PRIORITY_NORMAL);
+  handled = app_handled;
+  failed = 0;
+  for(i = 0; i < PROCESS_CONF_NUMEVENTS + 5; i++) {
+    if(process_post(&app_process, PROCESS_EVENT_CONTINUE, NULL)
+       != PROCESS_ERR_OK) {
+      failed++;
+    }
+  }
+  UNIT_TEST_ASSERT(failed == 5);
+  UNIT_TEST_ASSERT(process_dropped_events(PROCESS_PRIORITY_NORMAL) ==
+                   dropped + 5);
+
+#if PROCESS_CONF_WITH_PRIORITY
+  /* The network still gets through */
+  UNIT_TEST_ASSERT(process_post(&net_process, PROCESS_EVENT_MSG, NULL)
+                   == PROCESS_ERR_OK);
+  UNIT_TEST_ASSERT(process_dropped_events(PROCESS_PRIORITY_HIGH) == 0);
+#endif /* PROCESS_CONF_WITH_PRIORITY */
+
+  /* The queued events are all delivered, the others are lost */
+  PT_WAIT_UNTIL(&unit_test_pt,
+                app_handled - handled == PROCESS_CONF_NUMEVENTS);
+  UNIT_TEST_ASSERT(process_nevents() <= 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(latency, "network event delay under load");
+UNIT_TEST(latency)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  /* A queue full of slow application events */
+  app_load = true;
+  for(i = 0; i < PROCESS_CONF_NUMEVENTS - 1; i++) {
+    process_post(&app_process, PROCESS_EVENT_CONTINUE, NULL);
+  }
+  net_delay = 0;
+  net_posted = now_ns();
+  UNIT_TEST_ASSERT(process_post(&net_process, PROCESS_EVENT_MSG,
+                                NULL) == PROCESS_ERR_OK);
+  PT_WAIT_UNTIL(&unit_test_pt, net_delay != 0);
+
+  printf("Network event delay (%s): %"PRIu64" us\n",
+         PROCESS_CONF_WITH_PRIORITY ? "priority" : "fifo", net_delay / 1000);
+#if PROCESS_CONF_WITH_PRIORITY
+  UNIT_TEST_ASSERT(net_delay < LOAD_TIME_NS * 4);
+#endif /* PROCESS_CONF_WITH_PRIORITY */
+
+  PT_WAIT_UNTIL(&unit_test_pt, process_nevents() <= 1);
+  app_load = false;
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(throughput, "event throughput");
+UNIT_TEST(throughput)
+{
+  static struct etimer et;
+  static uint32_t handled;
+  static uint64_t start;
+
+  UNIT_TEST_BEGIN();
+
+  /* Self-reposting events, run by the platform main loop */
+  app_flood = true;
+  handled = app_handled;
+  start = now_ns();
+  process_post(&app_process, PROCESS_EVENT_CONTINUE, NULL);
+  etimer_set(&et, BENCH_DURATION_NS / (1000000000 / CLOCK_SECOND));
+  PT_WAIT_UNTIL(&unit_test_pt, etimer_expired(&et));
+  app_flood = false;
+
+  printf("Event throughput (drain %u): %"PRIu64" events/s\n",
+         PROCESS_CONF_DRAIN_EVENTS,
+         (uint64_t)(app_handled - handled) * 1000000000 / (now_ns() - start));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(order);
+  UNIT_TEST_RUN(overflow);
+  UNIT_TEST_RUN(latency);
+  UNIT_TEST_RUN(throughput);
+
+  if(!UNIT_TEST_PASSED(order) ||
+     !UNIT_TEST_PASSED(overflow) ||
+     !UNIT_TEST_PASSED(latency) ||
+     !UNIT_TEST_PASSED(throughput)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
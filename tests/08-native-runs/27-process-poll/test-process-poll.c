@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      Tests the order of the poll handlers, and benchmarks the latency
+ *      from process_poll() to the poll handler against the number of
+ *      processes.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+PROCESS(test_process, "test");
+PROCESS(poll_process, "poll");
+AUTOSTART_PROCESSES(&test_process);
+
+#define ORDER_PROCESSES 3
+#define MAX_IDLE_PROCESSES 128
+#define BENCH_POLLS 20000
+
+static struct process order_procs[ORDER_PROCESSES];
+static struct process idle_procs[MAX_IDLE_PROCESSES];
+static int order_log[ORDER_PROCESSES * 2];
+static int order_len;
+static bool repolled;
+static uint32_t polls;
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(order_thread(struct pt *process_pt, process_event_t ev,
+                       process_data_t data))
+{
+  if(ev == PROCESS_EVENT_POLL) {
+    order_log[order_len++] = PROCESS_CURRENT() - order_procs;
+    if(PROCESS_CURRENT() == &order_procs[0] && !repolled) {
+      /* Polled again while running: served in the next round */
+      repolled = true;
+      process_poll(&order_procs[0]);
+    }
+    process_poll(&test_process);
+  }
+  return PT_YIELDED;
+}
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(idle_thread(struct pt *process_pt, process_event_t ev,
+                      process_data_t data))
+{
+  return PT_YIELDED;
+}
+/*---------------------------------------------------------------------------*/
+static void
+start_procs(struct process *procs, int count,
+            PT_THREAD((*thread)(struct pt *, process_event_t, process_data_t)))
+{
+  for(int i = 0; i < count; i++) {
+    memset(&procs[i], 0, sizeof(procs[i]));
+#if !PROCESS_CONF_NO_PROCESS_NAMES
+    procs[i].name = "dummy";
+#endif /* !PROCESS_CONF_NO_PROCESS_NAMES */
+    procs[i].thread = thread;
+    process_start(&procs[i], NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(poll_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  /* Each poll takes a new round of the poll handlers */
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+    if(++polls < BENCH_POLLS) {
+      process_poll(&poll_process);
+    } else {
+      process_poll(&test_process);
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(order, "poll order");
+UNIT_TEST(order)
+{
+  UNIT_TEST_BEGIN();
+
+  start_procs(order_procs, ORDER_PROCESSES, order_thread);
+
+  /* Poll in an order that differs from the process list */
+  order_len = 0;
+  process_poll(&order_procs[1]);
+  process_poll(&order_procs[0]);
+  process_poll(&order_procs[2]);
+  process_poll(&order_procs[1]);
+  PT_WAIT_UNTIL(&unit_test_pt, order_len == ORDER_PROCESSES + 1);
+
+  /* Each process is called once per round of requests */
+  printf("Poll order: %d %d %d %d\n",
+         order_log[0], order_log[1], order_log[2], order_log[3]);
+  UNIT_TEST_ASSERT(order_log[3] == 0);
+#if PROCESS_CONF_POLL_QUEUE
+  /* In the order of the requests */
+  UNIT_TEST_ASSERT(order_log[0] == 1);
+  UNIT_TEST_ASSERT(order_log[1] == 0);
+  UNIT_TEST_ASSERT(order_log[2] == 2);
+#else
+  /* In the order of the process list, the last started first */
+  UNIT_TEST_ASSERT(order_log[0] == 2);
+  UNIT_TEST_ASSERT(order_log[1] == 1);
+  UNIT_TEST_ASSERT(order_log[2] == 0);
+#endif /* PROCESS_CONF_POLL_QUEUE */
+
+  /* An exited process is not called */
+  order_len = 0;
+  process_poll(&order_procs[2]);
+  process_poll(&order_procs[1]);
+  process_exit(&order_procs[2]);
+  PT_WAIT_UNTIL(&unit_test_pt, order_len == 1);
+  UNIT_TEST_ASSERT(order_log[0] == 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(latency, "poll latency against the number of processes");
+UNIT_TEST(latency)
+{
+  static int idle;
+  static int started;
+  static uint64_t start;
+
+  UNIT_TEST_BEGIN();
+
+  process_start(&poll_process, NULL);
+
+  /* A process that polls itself, with more and more idle processes in
+     the list */
+  started = 0;
+  for(idle = 0; idle <= MAX_IDLE_PROCESSES; idle = idle ? idle * 2 : 16) {
+    start_procs(&idle_procs[started], idle - started, idle_thread);
+    started = idle;
+
+    polls = 0;
+    start = now_ns();
+    process_poll(&poll_process);
+    PT_WAIT_UNTIL(&unit_test_pt, polls == BENCH_POLLS);
+    printf("Poll latency (%s), %3d idle processes: %"PRIu64" ns\n",
+           PROCESS_CONF_POLL_QUEUE ? "queue" : "list", idle,
+           (now_ns() - start) / BENCH_POLLS);
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(order);
+  UNIT_TEST_RUN(latency);
+
+  if(!UNIT_TEST_PASSED(order) ||
+     !UNIT_TEST_PASSED(latency)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
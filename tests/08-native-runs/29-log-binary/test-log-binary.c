@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      Tests the binary log records, and benchmarks the cost of a log line
+ *      with and without LOG_CONF_WITH_BINARY.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "sys/log.h"
+#define LOG_MODULE "Test"
+#define LOG_LEVEL LOG_LEVEL_INFO
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define BENCH_LINES 100000
+#define BENCH_BATCH 16
+
+static int null_fd = -1;
+static size_t text_len;
+static uint8_t captured[4096];
+static size_t captured_len;
+/*---------------------------------------------------------------------------*/
+int
+test_log_output(const char *fmt, ...)
+{
+  char text[256];
+  va_list ap;
+  int n;
+
+  va_start(ap, fmt);
+  n = vsnprintf(text, sizeof(text), fmt, ap);
+  va_end(ap);
+  /* Like the unbuffered native console, without filling the test log */
+  if(null_fd >= 0 && write(null_fd, text, MIN(n, sizeof(text) - 1)) > 0) {
+    text_len += n;
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+void
+test_log_write(const void *buf, size_t len)
+{
+  if(null_fd >= 0 && write(null_fd, buf, len) < 0) {
+    return;
+  }
+  if(captured_len + len <= sizeof(captured)) {
+    memcpy(&captured[captured_len], buf, len);
+    captured_len += len;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+#if LOG_WITH_BINARY
+extern const char __start_log_fmt[];
+extern const char __stop_log_fmt[];
+
+/* Undo the SLIP framing of the n-th captured record */
+static int
+captured_record(int n, uint8_t *out)
+{
+  size_t i;
+  int len = -1;
+
+  for(i = 0; i < captured_len; i++) {
+    if(captured[i] == 0300) {
+      if(len < 0) {
+        len = 0;
+      } else if(n-- == 0) {
+        return len;
+      } else {
+        len = -1;
+      }
+    } else if(len >= 0) {
+      if(captured[i] == 0333) {
+        out[len++] = captured[++i] == 0334 ? 0300 : 0333;
+      } else {
+        out[len++] = captured[i];
+      }
+    }
+  }
+  return -1;
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+get_le32(const uint8_t *p)
+{
+  return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(record, "record encoding");
+UNIT_TEST(record)
+{
+  static const char expected[] = "1INFO\0Test\0%u %s %ld %c\n";
+  uint8_t rec[LOG_BINARY_RECORD_SIZE];
+  uint16_t id;
+  int len;
+
+  UNIT_TEST_BEGIN();
+
+  log_binary_flush();
+  captured_len = 0;
+
+  LOG_INFO("%u %s %ld %c\n", 0x12345678u, "abc", -2L, 'x');
+  LOG_DBG("not logged\n");
+  log_binary_flush();
+
+  len = captured_record(0, rec);
+  UNIT_TEST_ASSERT(len == 6 + 5 + 5 + 1 + sizeof(long) + 5);
+  UNIT_TEST_ASSERT(captured_record(1, rec) < 0);
+
+  /* The id leads to the format entry of the call site */
+  id = rec[0] | rec[1] << 8;
+  UNIT_TEST_ASSERT(id < __stop_log_fmt - __start_log_fmt);
+  UNIT_TEST_ASSERT(!memcmp(&__start_log_fmt[id], expected, sizeof(expected)));
+
+  UNIT_TEST_ASSERT(rec[6] == LOG_BINARY_TAG_INT32);
+  UNIT_TEST_ASSERT(get_le32(&rec[7]) == 0x12345678);
+  UNIT_TEST_ASSERT(rec[11] == LOG_BINARY_TAG_STRING && rec[12] == 3);
+  UNIT_TEST_ASSERT(!memcmp(&rec[13], "abc", 3));
+  UNIT_TEST_ASSERT(rec[16] == (sizeof(long) > 4 ? LOG_BINARY_TAG_INT64
+                               : LOG_BINARY_TAG_INT32));
+  UNIT_TEST_ASSERT(get_le32(&rec[17]) == 0xfffffffe);
+  UNIT_TEST_ASSERT(rec[17 + sizeof(long)] == LOG_BINARY_TAG_INT32);
+  UNIT_TEST_ASSERT(rec[18 + sizeof(long)] == 'x');
+
+  /* Bytes that collide with the framing are escaped */
+  captured_len = 0;
+  LOG_INFO("%x\n", 0xc0dbc0dbu);
+  log_binary_flush();
+  len = captured_record(0, rec);
+  UNIT_TEST_ASSERT(len == 6 + 5);
+  UNIT_TEST_ASSERT(get_le32(&rec[7]) == 0xc0dbc0db);
+
+  /* Addresses are logged as raw bytes */
+  captured_len = 0;
+  LOG_INFO_LLADDR(&linkaddr_node_addr);
+  log_binary_flush();
+  len = captured_record(0, rec);
+  UNIT_TEST_ASSERT(len == 6 + 2 + LINKADDR_SIZE);
+  UNIT_TEST_ASSERT(rec[0] + (rec[1] << 8) ==
+                   log_binary_fmt_lladdr - __start_log_fmt);
+  UNIT_TEST_ASSERT(rec[6] == LOG_BINARY_TAG_BYTES);
+  UNIT_TEST_ASSERT(!memcmp(&rec[8], &linkaddr_node_addr, LINKADDR_SIZE));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(overflow, "full buffer");
+UNIT_TEST(overflow)
+{
+  static uint8_t rec[LOG_BINARY_RECORD_SIZE];
+  uint32_t dropped;
+  int i;
+  int n;
+
+  UNIT_TEST_BEGIN();
+
+  log_binary_flush();
+  dropped = log_binary_dropped();
+
+  for(i = 0; i < LOG_BINARY_BUFSIZE; i++) {
+    LOG_INFO("%d\n", i);
+  }
+  UNIT_TEST_ASSERT(log_binary_dropped() > dropped);
+
+  /* What was kept is written out, followed by the number of drops */
+  captured_len = 0;
+  log_binary_flush();
+  n = 0;
+  while(captured_record(n, rec) > 0) {
+    n++;
+  }
+  UNIT_TEST_ASSERT(n == LOG_BINARY_BUFSIZE / (1 + 6 + 5) + 1);
+  UNIT_TEST_ASSERT(captured_record(0, rec) == 6 + 5);
+  UNIT_TEST_ASSERT(rec[0] == 0xfe && rec[1] == 0xff);
+  UNIT_TEST_ASSERT(get_le32(&rec[7]) == log_binary_dropped());
+
+  UNIT_TEST_END();
+}
+#endif /* LOG_WITH_BINARY */
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(bench, "log line cost");
+UNIT_TEST(bench)
+{
+  static const char str[] = "bench";
+#if LOG_WITH_BINARY
+  uint32_t dropped = log_binary_dropped();
+  uint64_t drain = 0;
+#endif /* LOG_WITH_BINARY */
+  uint64_t elapsed = 0;
+  uint64_t start;
+  uint32_t i;
+  uint32_t j;
+
+  UNIT_TEST_BEGIN();
+
+  null_fd = open("/dev/null", O_WRONLY);
+  UNIT_TEST_ASSERT(null_fd >= 0);
+
+  for(i = 0; i < BENCH_LINES; i += BENCH_BATCH) {
+    start = now_ns();
+    for(j = i; j < i + BENCH_BATCH; j++) {
+      LOG_INFO("line %"PRIu32" of %u: %s\n", j, BENCH_LINES, str);
+    }
+    elapsed += now_ns() - start;
+#if LOG_WITH_BINARY
+    /* Draining is not part of the log call, it happens when idle */
+    start = now_ns();
+    log_binary_flush();
+    drain += now_ns() - start;
+    captured_len = 0;
+#endif /* LOG_WITH_BINARY */
+  }
+  close(null_fd);
+  null_fd = -1;
+
+#if LOG_WITH_BINARY
+  UNIT_TEST_ASSERT(log_binary_dropped() == dropped);
+#else /* LOG_WITH_BINARY */
+  UNIT_TEST_ASSERT(text_len > 0);
+#endif /* LOG_WITH_BINARY */
+
+#if LOG_WITH_BINARY
+  printf("Log line (binary): %"PRIu64" ns, drained in %"PRIu64" ns\n",
+         elapsed / BENCH_LINES, drain / BENCH_LINES);
+#else /* LOG_WITH_BINARY */
+  printf("Log line (printf): %"PRIu64" ns\n", elapsed / BENCH_LINES);
+#endif /* LOG_WITH_BINARY */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+#if LOG_WITH_BINARY
+  UNIT_TEST_RUN(record);
+  UNIT_TEST_RUN(overflow);
+#endif /* LOG_WITH_BINARY */
+  UNIT_TEST_RUN(bench);
+
+  if(
+#if LOG_WITH_BINARY
+     !UNIT_TEST_PASSED(record) ||
+     !UNIT_TEST_PASSED(overflow) ||
+#endif /* LOG_WITH_BINARY */
+     !UNIT_TEST_PASSED(bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
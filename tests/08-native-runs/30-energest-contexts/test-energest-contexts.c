@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      Tests the attribution of energest time to energy contexts, and
+ *      benchmarks the cost of entering and leaving a context.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "sys/energest.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <time.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define BENCH_ROUNDS 1000000
+
+static uint32_t now;
+/*---------------------------------------------------------------------------*/
+uint32_t
+test_energest_now(void)
+{
+  return now;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+#if ENERGEST_WITH_CONTEXTS
+static uint64_t start_time[ENERGEST_CONTEXT_MAX][ENERGEST_TYPE_MAX];
+/*---------------------------------------------------------------------------*/
+static void
+start(void)
+{
+  energest_context_t context;
+  energest_type_t type;
+
+  energest_flush();
+  for(context = 0; context < ENERGEST_CONTEXT_MAX; context++) {
+    for(type = 0; type < ENERGEST_TYPE_MAX; type++) {
+      start_time[context][type] = energest_context_type_time(context, type);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+spent(energest_context_t context, energest_type_t type)
+{
+  energest_flush();
+  return energest_context_type_time(context, type) - start_time[context][type];
+}
+/*---------------------------------------------------------------------------*/
+/* The contexts share the total of each type without loss */
+static bool
+contexts_add_up(void)
+{
+  energest_context_t context;
+  energest_type_t type;
+  uint64_t sum;
+
+  energest_flush();
+  for(type = 0; type < ENERGEST_TYPE_MAX; type++) {
+    sum = 0;
+    for(context = 0; context < ENERGEST_CONTEXT_MAX; context++) {
+      sum += energest_context_type_time(context, type);
+    }
+    if(sum != energest_type_time(type)) {
+      return false;
+    }
+  }
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(cpu, "CPU time follows the context stack");
+UNIT_TEST(cpu)
+{
+  UNIT_TEST_BEGIN();
+
+  start();
+  UNIT_TEST_ASSERT(ENERGEST_CONTEXT_CURRENT() == ENERGEST_CONTEXT_OTHER);
+
+  now += 10;
+  energest_context_push(ENERGEST_CONTEXT_MAC);
+  now += 100;
+  energest_context_push(ENERGEST_CONTEXT_RPL);
+  UNIT_TEST_ASSERT(ENERGEST_CONTEXT_CURRENT() == ENERGEST_CONTEXT_RPL);
+  now += 20;
+  energest_context_set(ENERGEST_CONTEXT_APP);
+  now += 5;
+  energest_context_pop();
+  UNIT_TEST_ASSERT(ENERGEST_CONTEXT_CURRENT() == ENERGEST_CONTEXT_MAC);
+  now += 7;
+  energest_context_pop();
+  now += 3;
+
+  UNIT_TEST_ASSERT(spent(ENERGEST_CONTEXT_OTHER, ENERGEST_TYPE_CPU) == 13);
+  UNIT_TEST_ASSERT(spent(ENERGEST_CONTEXT_MAC, ENERGEST_TYPE_CPU) == 107);
+  UNIT_TEST_ASSERT(spent(ENERGEST_CONTEXT_RPL, ENERGEST_TYPE_CPU) == 20);
+  UNIT_TEST_ASSERT(spent(ENERGEST_CONTEXT_APP, ENERGEST_TYPE_CPU) == 5);
+  UNIT_TEST_ASSERT(contexts_add_up());
+
+  /* Without a pushed context, set does nothing */
+  energest_context_set(ENERGEST_CONTEXT_APP);
+  UNIT_TEST_ASSERT(ENERGEST_CONTEXT_CURRENT() == ENERGEST_CONTEXT_OTHER);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(radio, "radio time goes to the context that switched it on");
+UNIT_TEST(radio)
+{
+  UNIT_TEST_BEGIN();
+
+  start();
+
+  /* Transmission started by the MAC layer, ended in another context */
+  energest_context_push(ENERGEST_CONTEXT_MAC);
+  ENERGEST_ON(ENERGEST_TYPE_TRANSMIT);
+  now += 30;
+  energest_context_pop();
+  now += 10;
+  energest_context_push(ENERGEST_CONTEXT_APP);
+  now += 20;
+  ENERGEST_OFF(ENERGEST_TYPE_TRANSMIT);
+  now += 40;
+  energest_context_pop();
+
+  UNIT_TEST_ASSERT(spent(ENERGEST_CONTEXT_MAC, ENERGEST_TYPE_TRANSMIT) == 60);
+  UNIT_TEST_ASSERT(spent(ENERGEST_CONTEXT_APP, ENERGEST_TYPE_TRANSMIT) == 0);
+
+  /* A switch hands over to the current context */
+  energest_context_push(ENERGEST_CONTEXT_RPL);
+  ENERGEST_ON(ENERGEST_TYPE_LISTEN);
+  now += 15;
+  energest_context_set(ENERGEST_CONTEXT_MAC_BEACON);
+  ENERGEST_SWITCH(ENERGEST_TYPE_LISTEN, ENERGEST_TYPE_TRANSMIT);
+  now += 25;
+  ENERGEST_OFF(ENERGEST_TYPE_TRANSMIT);
+  energest_context_pop();
+
+  UNIT_TEST_ASSERT(spent(ENERGEST_CONTEXT_RPL, ENERGEST_TYPE_LISTEN) == 15);
+  UNIT_TEST_ASSERT(spent(ENERGEST_CONTEXT_MAC_BEACON,
+                         ENERGEST_TYPE_TRANSMIT) == 25);
+
+  /* Time of a type that is still on is accounted when flushing */
+  energest_context_push(ENERGEST_CONTEXT_APP);
+  ENERGEST_ON(ENERGEST_TYPE_LISTEN);
+  energest_context_pop();
+  now += 50;
+  UNIT_TEST_ASSERT(spent(ENERGEST_CONTEXT_APP, ENERGEST_TYPE_LISTEN) == 50);
+  now += 50;
+  UNIT_TEST_ASSERT(spent(ENERGEST_CONTEXT_APP, ENERGEST_TYPE_LISTEN) == 100);
+  ENERGEST_OFF(ENERGEST_TYPE_LISTEN);
+
+  UNIT_TEST_ASSERT(contexts_add_up());
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(overflow, "pushing more contexts than fit");
+UNIT_TEST(overflow)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  start();
+
+  for(i = 0; i < ENERGEST_CONTEXT_DEPTH + 2; i++) {
+    energest_context_push(i & 1 ? ENERGEST_CONTEXT_APP : ENERGEST_CONTEXT_RPL);
+    now++;
+  }
+  /* The contexts that did not fit are charged to the last one that did */
+  UNIT_TEST_ASSERT(ENERGEST_CONTEXT_CURRENT() ==
+                   ((ENERGEST_CONTEXT_DEPTH - 2) & 1 ? ENERGEST_CONTEXT_APP
+                    : ENERGEST_CONTEXT_RPL));
+  for(i = 0; i < ENERGEST_CONTEXT_DEPTH + 2; i++) {
+    energest_context_pop();
+  }
+  UNIT_TEST_ASSERT(ENERGEST_CONTEXT_CURRENT() == ENERGEST_CONTEXT_OTHER);
+
+  /* Unbalanced pops are ignored */
+  energest_context_pop();
+  UNIT_TEST_ASSERT(ENERGEST_CONTEXT_CURRENT() == ENERGEST_CONTEXT_OTHER);
+
+  UNIT_TEST_ASSERT(spent(ENERGEST_CONTEXT_RPL, ENERGEST_TYPE_CPU) +
+                   spent(ENERGEST_CONTEXT_APP, ENERGEST_TYPE_CPU) ==
+                   ENERGEST_CONTEXT_DEPTH + 2);
+  UNIT_TEST_ASSERT(contexts_add_up());
+
+  UNIT_TEST_END();
+}
+#endif /* ENERGEST_WITH_CONTEXTS */
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(bench, "context switch cost");
+UNIT_TEST(bench)
+{
+  uint64_t start_ns;
+  uint64_t push_pop;
+  uint64_t on_off;
+  uint32_t i;
+
+  UNIT_TEST_BEGIN();
+
+  start_ns = now_ns();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    energest_context_push(ENERGEST_CONTEXT_APP);
+    now++;
+    energest_context_pop();
+  }
+  push_pop = now_ns() - start_ns;
+
+  start_ns = now_ns();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    ENERGEST_ON(ENERGEST_TYPE_TRANSMIT);
+    now++;
+    ENERGEST_OFF(ENERGEST_TYPE_TRANSMIT);
+  }
+  on_off = now_ns() - start_ns;
+
+  UNIT_TEST_ASSERT(energest_type_time(ENERGEST_TYPE_TRANSMIT) >= BENCH_ROUNDS);
+
+  printf("Context push/pop: %"PRIu64" ns, radio on/off: %"PRIu64" ns\n",
+         push_pop / BENCH_ROUNDS, on_off / BENCH_ROUNDS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+#if ENERGEST_WITH_CONTEXTS
+  UNIT_TEST_RUN(cpu);
+  UNIT_TEST_RUN(radio);
+  UNIT_TEST_RUN(overflow);
+#endif /* ENERGEST_WITH_CONTEXTS */
+  UNIT_TEST_RUN(bench);
+
+  if(
+#if ENERGEST_WITH_CONTEXTS
+     !UNIT_TEST_PASSED(cpu) ||
+     !UNIT_TEST_PASSED(radio) ||
+     !UNIT_TEST_PASSED(overflow) ||
+#endif /* ENERGEST_WITH_CONTEXTS */
+     !UNIT_TEST_PASSED(bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      Tests the high-water mark of stacks registered with the stack
+ *      checker, using a thread stack of its own.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "sys/stack-check.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <ucontext.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define THREAD_STACK_SIZE 32768
+#define FRAME_SIZE 256
+/* Function call overhead on top of the buffers, generously */
+#define SLACK 4096
+
+static uint8_t thread_stack[THREAD_STACK_SIZE];
+static struct stack_check_region region;
+static ucontext_t main_context;
+static ucontext_t thread_context;
+static size_t thread_depth;
+/*---------------------------------------------------------------------------*/
+static void
+use_stack(size_t bytes)
+{
+  volatile uint8_t buf[FRAME_SIZE];
+
+  memset((uint8_t *)buf, 0, sizeof(buf));
+  if(bytes > FRAME_SIZE) {
+    use_stack(bytes - FRAME_SIZE);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+thread_entry(void)
+{
+  use_stack(thread_depth);
+}
+/*---------------------------------------------------------------------------*/
+static void
+run_thread(size_t depth)
+{
+  thread_depth = depth;
+  getcontext(&thread_context);
+  thread_context.uc_stack.ss_sp = thread_stack;
+  thread_context.uc_stack.ss_size = sizeof(thread_stack);
+  thread_context.uc_link = &main_context;
+  makecontext(&thread_context, thread_entry, 0);
+  swapcontext(&main_context, &thread_context);
+}
+/*---------------------------------------------------------------------------*/
+static bool
+is_registered(const struct stack_check_region *r)
+{
+  struct stack_check_region *p;
+
+  for(p = stack_check_region_head(); p != NULL; p = p->next) {
+    if(p == r) {
+      return true;
+    }
+  }
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(high_water, "high-water mark of a thread stack");
+UNIT_TEST(high_water)
+{
+  size_t usage;
+
+  UNIT_TEST_BEGIN();
+
+  memset(thread_stack, 0, sizeof(thread_stack));
+  stack_check_region_add(&region, "thread", thread_stack,
+                         sizeof(thread_stack));
+  UNIT_TEST_ASSERT(is_registered(&region));
+  UNIT_TEST_ASSERT(stack_check_region_get_usage(&region) == 0);
+
+  run_thread(8 * FRAME_SIZE);
+  usage = stack_check_region_get_usage(&region);
+  UNIT_TEST_ASSERT(usage >= 8 * FRAME_SIZE);
+  UNIT_TEST_ASSERT(usage < 8 * FRAME_SIZE + SLACK);
+
+  /* The mark only goes up */
+  run_thread(FRAME_SIZE);
+  UNIT_TEST_ASSERT(stack_check_region_get_usage(&region) == usage);
+
+  run_thread(64 * FRAME_SIZE);
+  usage = stack_check_region_get_usage(&region);
+  UNIT_TEST_ASSERT(usage >= 64 * FRAME_SIZE);
+  UNIT_TEST_ASSERT(usage < 64 * FRAME_SIZE + SLACK);
+
+  stack_check_report();
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(overflow, "exhausted stack");
+UNIT_TEST(overflow)
+{
+  UNIT_TEST_BEGIN();
+
+  /* Nothing is left of the fill once the whole stack was written */
+  memset(thread_stack, 0, sizeof(thread_stack));
+  UNIT_TEST_ASSERT(stack_check_region_get_usage(&region) == SIZE_MAX);
+
+  stack_check_report();
+
+  stack_check_region_remove(&region);
+  UNIT_TEST_ASSERT(!is_registered(&region));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(high_water);
+  UNIT_TEST_RUN(overflow);
+
+  if(!UNIT_TEST_PASSED(high_water) ||
+     !UNIT_TEST_PASSED(overflow)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,480 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      Tests the bulk ring buffer functions, the single-producer,
+ *      single-consumer ring buffer and the drivers using it, and
+ *      benchmarks them against byte-at-a-time access.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "lib/ringbuf.h"
+#include "lib/ringbuf-spsc.h"
+#include "dev/serial-line.h"
+#include "dev/slip.h"
+#include "net/ipv6/uip.h"
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+PROCESS(test_process, "test");
+PROCESS(line_process, "line listener");
+AUTOSTART_PROCESSES(&test_process, &line_process);
+
+#define BENCH_BYTES (1 << 24)
+#define BENCH_CHUNK 64
+#define STRESS_ELEMENTS 2000000
+
+struct elem {
+  uint32_t seq;
+  uint32_t check;
+};
+
+static char line[256];
+static bool got_line;
+
+static uint8_t slip_out[4096];
+static int slip_out_len;
+static uint8_t slip_in[UIP_BUFSIZE];
+static int slip_in_len;
+static int slip_packets;
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+void
+slip_arch_writeb(unsigned char c)
+{
+  if(slip_out_len < sizeof(slip_out)) {
+    slip_out[slip_out_len++] = c;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+slip_input_callback(void)
+{
+  memcpy(slip_in, uip_buf, uip_len);
+  slip_in_len = uip_len;
+  slip_packets++;
+  /* Keep the packet away from uIP */
+  uip_len = 0;
+  process_poll(&test_process);
+}
+/*---------------------------------------------------------------------------*/
+static void
+slip_loopback(void)
+{
+  int i;
+
+  for(i = 0; i < slip_out_len; i++) {
+    slip_input_byte(slip_out[i]);
+  }
+  slip_out_len = 0;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(bulk, "ringbuf bulk access");
+UNIT_TEST(bulk)
+{
+  static uint8_t data[16];
+  struct ringbuf r;
+  uint8_t in[32];
+  uint8_t out[32];
+  uint8_t *put_span;
+  const uint8_t *get_span;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < sizeof(in); i++) {
+    in[i] = i;
+  }
+  ringbuf_init(&r, data, sizeof(data));
+
+  /* One byte is always kept free */
+  UNIT_TEST_ASSERT(ringbuf_write(&r, in, sizeof(in)) == sizeof(data) - 1);
+  UNIT_TEST_ASSERT(ringbuf_elements(&r) == sizeof(data) - 1);
+  UNIT_TEST_ASSERT(ringbuf_read(&r, out, 10) == 10);
+  UNIT_TEST_ASSERT(!memcmp(out, in, 10));
+
+  /* Wrap around, mixed with byte access */
+  UNIT_TEST_ASSERT(ringbuf_write(&r, &in[15], 10) == 10);
+  UNIT_TEST_ASSERT(ringbuf_get(&r) == 10);
+  UNIT_TEST_ASSERT(ringbuf_read(&r, out, sizeof(out)) == 14);
+  UNIT_TEST_ASSERT(!memcmp(out, &in[11], 14));
+  UNIT_TEST_ASSERT(ringbuf_read(&r, out, sizeof(out)) == 0);
+  UNIT_TEST_ASSERT(ringbuf_get(&r) == -1);
+
+  /* In-place access stops at the end of the array */
+  UNIT_TEST_ASSERT(ringbuf_peek_put(&r, &put_span) == 7);
+  UNIT_TEST_ASSERT(put_span == &data[9]);
+  memcpy(put_span, in, 5);
+  ringbuf_commit_put(&r, 5);
+  UNIT_TEST_ASSERT(ringbuf_peek_get(&r, &get_span) == 5);
+  UNIT_TEST_ASSERT(get_span == &data[9] && !memcmp(get_span, in, 5));
+  ringbuf_commit_get(&r, 2);
+  UNIT_TEST_ASSERT(ringbuf_get(&r) == 2);
+  UNIT_TEST_ASSERT(ringbuf_elements(&r) == 2);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(spsc, "SPSC ring buffer");
+UNIT_TEST(spsc)
+{
+  static struct elem data[8];
+  struct ringbuf_spsc r;
+  struct elem in[12];
+  struct elem out[12];
+  struct elem e;
+  void *put_span;
+  const void *get_span;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < 12; i++) {
+    in[i].seq = i;
+    in[i].check = ~i;
+  }
+  ringbuf_spsc_init(&r, data, sizeof(struct elem), 8);
+  UNIT_TEST_ASSERT(ringbuf_spsc_size(&r) == 8);
+  UNIT_TEST_ASSERT(ringbuf_spsc_empty(&r));
+
+  /* All elements can be used */
+  UNIT_TEST_ASSERT(ringbuf_spsc_write(&r, in, 12) == 8);
+  UNIT_TEST_ASSERT(!ringbuf_spsc_put(&r, &in[8]));
+  UNIT_TEST_ASSERT(ringbuf_spsc_get(&r, &e) && e.seq == 0 && e.check == ~0);
+  UNIT_TEST_ASSERT(ringbuf_spsc_put(&r, &in[8]));
+  UNIT_TEST_ASSERT(ringbuf_spsc_read(&r, out, 12) == 8);
+  UNIT_TEST_ASSERT(!memcmp(out, &in[1], 8 * sizeof(struct elem)));
+  UNIT_TEST_ASSERT(!ringbuf_spsc_get(&r, &e));
+
+  /* Staged elements are invisible until published */
+  UNIT_TEST_ASSERT(ringbuf_spsc_stage(&r, &in[0]));
+  UNIT_TEST_ASSERT(ringbuf_spsc_stage(&r, &in[1]));
+  UNIT_TEST_ASSERT(ringbuf_spsc_staged(&r) == 2);
+  UNIT_TEST_ASSERT(ringbuf_spsc_empty(&r));
+  ringbuf_spsc_discard(&r);
+  UNIT_TEST_ASSERT(ringbuf_spsc_staged(&r) == 0);
+  UNIT_TEST_ASSERT(ringbuf_spsc_stage(&r, &in[2]));
+  ringbuf_spsc_publish(&r);
+  UNIT_TEST_ASSERT(ringbuf_spsc_elements(&r) == 1);
+  UNIT_TEST_ASSERT(ringbuf_spsc_get(&r, &e) && e.seq == 2);
+
+  /* In-place access, across the end of the array */
+  UNIT_TEST_ASSERT(ringbuf_spsc_peek_put(&r, &put_span) == 6);
+  UNIT_TEST_ASSERT(put_span == &data[2]);
+  memcpy(put_span, in, 6 * sizeof(struct elem));
+  ringbuf_spsc_commit_put(&r, 6);
+  UNIT_TEST_ASSERT(ringbuf_spsc_peek_put(&r, &put_span) == 2);
+  UNIT_TEST_ASSERT(put_span == &data[0]);
+  UNIT_TEST_ASSERT(ringbuf_spsc_peek_get(&r, &get_span) == 6);
+  UNIT_TEST_ASSERT(get_span == &data[2]);
+  ringbuf_spsc_commit_get(&r, 6);
+  UNIT_TEST_ASSERT(ringbuf_spsc_empty(&r));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+static struct ringbuf_spsc stress_ringbuf;
+static struct elem stress_data[256];
+/*---------------------------------------------------------------------------*/
+static void *
+stress_producer(void *arg)
+{
+  struct elem chunk[BENCH_CHUNK / sizeof(struct elem)];
+  uint32_t seq = 0;
+  int i;
+  int n;
+
+  while(seq < STRESS_ELEMENTS) {
+    n = MIN(sizeof(chunk) / sizeof(chunk[0]), STRESS_ELEMENTS - seq);
+    for(i = 0; i < n; i++) {
+      chunk[i].seq = seq + i;
+      chunk[i].check = (seq + i) * 2654435761u;
+    }
+    n = ringbuf_spsc_write(&stress_ringbuf, chunk, n);
+    if(n == 0) {
+      sched_yield();
+    }
+    seq += n;
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(stress, "SPSC ring buffer across threads");
+UNIT_TEST(stress)
+{
+  pthread_t producer;
+  const void *span;
+  const struct elem *e;
+  uint32_t seq = 0;
+  uint32_t errors = 0;
+  int i;
+  int n;
+
+  UNIT_TEST_BEGIN();
+
+  ringbuf_spsc_init(&stress_ringbuf, stress_data, sizeof(struct elem),
+                    sizeof(stress_data) / sizeof(stress_data[0]));
+  UNIT_TEST_ASSERT(pthread_create(&producer, NULL, stress_producer, NULL) == 0);
+
+  while(seq < STRESS_ELEMENTS) {
+    n = ringbuf_spsc_peek_get(&stress_ringbuf, &span);
+    if(n == 0) {
+      /* Let the producer run on single-core hosts */
+      sched_yield();
+      continue;
+    }
+    e = span;
+    for(i = 0; i < n; i++) {
+      if(e[i].seq != seq + i || e[i].check != (seq + i) * 2654435761u) {
+        errors++;
+      }
+    }
+    ringbuf_spsc_commit_get(&stress_ringbuf, n);
+    seq += n;
+  }
+  pthread_join(producer, NULL);
+
+  UNIT_TEST_ASSERT(errors == 0);
+  UNIT_TEST_ASSERT(ringbuf_spsc_empty(&stress_ringbuf));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(serial_line, "serial line input");
+UNIT_TEST(serial_line)
+{
+  static struct etimer et;
+  static int i;
+
+  UNIT_TEST_BEGIN();
+
+  got_line = false;
+  for(i = 0; i < 6; i++) {
+    serial_line_input_byte("hello\n"[i]);
+  }
+  PT_WAIT_UNTIL(&unit_test_pt, got_line);
+  UNIT_TEST_ASSERT(!strcmp(line, "hello"));
+
+  /* A line longer than the buffers, arriving in two parts */
+  got_line = false;
+  for(i = 0; i < 100; i++) {
+    serial_line_input_byte('a');
+  }
+  /* Let the serial line process drain the first part */
+  etimer_set(&et, 1);
+  PT_WAIT_UNTIL(&unit_test_pt, etimer_expired(&et));
+  for(i = 0; i < 100; i++) {
+    serial_line_input_byte('b');
+  }
+  serial_line_input_byte('\r');
+  PT_WAIT_UNTIL(&unit_test_pt, got_line);
+  UNIT_TEST_ASSERT(strlen(line) == 127);
+  UNIT_TEST_ASSERT(line[99] == 'a' && line[100] == 'b');
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(slip, "SLIP loopback");
+UNIT_TEST(slip)
+{
+  static uint8_t packet[UIP_BUFSIZE];
+  static int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < sizeof(packet); i++) {
+    packet[i] = i % 7 == 0 ? 0300 : i % 5 == 0 ? 0333 : i;
+  }
+
+  /* Two packets in a row, with bytes to escape */
+  slip_packets = 0;
+  slip_write(packet, 100);
+  slip_write(&packet[100], 200);
+  slip_loopback();
+  PT_WAIT_UNTIL(&unit_test_pt, slip_packets == 1);
+  UNIT_TEST_ASSERT(slip_in_len == 100 && !memcmp(slip_in, packet, 100));
+  PT_WAIT_UNTIL(&unit_test_pt, slip_packets == 2);
+  UNIT_TEST_ASSERT(slip_in_len == 200 && !memcmp(slip_in, &packet[100], 200));
+
+  /* A bad escape sequence drops the packet */
+  slip_write(packet, 10);
+  slip_out[4] = 0333;
+  slip_out[5] = 'x';
+  slip_write(packet, sizeof(packet));
+  slip_loopback();
+  PT_WAIT_UNTIL(&unit_test_pt, slip_packets == 3);
+  UNIT_TEST_ASSERT(slip_in_len == sizeof(packet));
+  UNIT_TEST_ASSERT(!memcmp(slip_in, packet, sizeof(packet)));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(bench, "throughput");
+UNIT_TEST(bench)
+{
+  static uint8_t data[128];
+  static uint8_t spsc_data[1024];
+  static uint8_t chunk[BENCH_CHUNK];
+  static uint8_t frame[2 * UIP_BUFSIZE + 2];
+  static int frame_len;
+  static uint64_t elapsed;
+  static int packets;
+  static int i;
+  struct ringbuf r;
+  struct ringbuf_spsc s;
+  static uint64_t start;
+  uint32_t sum = 0;
+  int j;
+
+  UNIT_TEST_BEGIN();
+
+  ringbuf_init(&r, data, sizeof(data));
+  start = now_ns();
+  for(i = 0; i < BENCH_BYTES; i += BENCH_CHUNK) {
+    for(j = 0; j < BENCH_CHUNK; j++) {
+      ringbuf_put(&r, j);
+    }
+    for(j = 0; j < BENCH_CHUNK; j++) {
+      sum += ringbuf_get(&r);
+    }
+  }
+  elapsed = now_ns() - start;
+  printf("ringbuf put/get: %"PRIu64" ps/byte\n", elapsed * 1000 / BENCH_BYTES);
+
+  start = now_ns();
+  for(i = 0; i < BENCH_BYTES; i += BENCH_CHUNK) {
+    ringbuf_write(&r, chunk, BENCH_CHUNK);
+    ringbuf_read(&r, chunk, BENCH_CHUNK);
+  }
+  elapsed = now_ns() - start;
+  printf("ringbuf write/read: %"PRIu64" ps/byte\n",
+         elapsed * 1000 / BENCH_BYTES);
+
+  ringbuf_spsc_init(&s, spsc_data, 1, sizeof(spsc_data));
+  start = now_ns();
+  for(i = 0; i < BENCH_BYTES; i += BENCH_CHUNK) {
+    ringbuf_spsc_write(&s, chunk, BENCH_CHUNK);
+    ringbuf_spsc_read(&s, chunk, BENCH_CHUNK);
+  }
+  elapsed = now_ns() - start;
+  printf("ringbuf_spsc write/read: %"PRIu64" ps/byte\n",
+         elapsed * 1000 / BENCH_BYTES);
+  UNIT_TEST_ASSERT(sum > 0);
+
+  /* Receiving full-size SLIP packets, from the UART input to uIP */
+  for(i = 0; i < UIP_BUFSIZE; i++) {
+    slip_in[i] = i;
+  }
+  slip_out_len = 0;
+  slip_write(slip_in, UIP_BUFSIZE);
+  memcpy(frame, slip_out, slip_out_len);
+  frame_len = slip_out_len;
+  slip_out_len = 0;
+
+  elapsed = 0;
+  slip_packets = 0;
+  for(packets = 1; packets <= 4096; packets++) {
+    start = now_ns();
+    for(i = 0; i < frame_len; i++) {
+      slip_input_byte(frame[i]);
+    }
+    PT_WAIT_UNTIL(&unit_test_pt, slip_packets == packets);
+    elapsed += now_ns() - start;
+  }
+  UNIT_TEST_ASSERT(slip_in_len == UIP_BUFSIZE);
+  printf("SLIP input: %"PRIu64" ps/byte\n",
+         elapsed * 1000 / (4096 * UIP_BUFSIZE));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(line_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == serial_line_event_message);
+    strncpy(line, data, sizeof(line) - 1);
+    got_line = true;
+    process_poll(&test_process);
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  slip_set_input_callback(slip_input_callback);
+  process_start(&slip_process, NULL);
+  process_start(&line_process, NULL);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(bulk);
+  UNIT_TEST_RUN(spsc);
+  UNIT_TEST_RUN(stress);
+  UNIT_TEST_RUN(serial_line);
+  UNIT_TEST_RUN(slip);
+  UNIT_TEST_RUN(bench);
+
+  if(!UNIT_TEST_PASSED(bulk) ||
+     !UNIT_TEST_PASSED(spsc) ||
+     !UNIT_TEST_PASSED(stress) ||
+     !UNIT_TEST_PASSED(serial_line) ||
+     !UNIT_TEST_PASSED(slip) ||
+     !UNIT_TEST_PASSED(bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "lib/crc16.h"
+#include "lib/crc32.h"
+#include "lib/random.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+PROCESS(test_process, "CRC test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define BENCH_BYTES (1 << 24)
+
+static uint8_t data[4096];
+/*---------------------------------------------------------------------------*/
+static uint16_t
+reference_crc16(const uint8_t *p, int len, uint16_t crc)
+{
+  int i;
+
+  while(len-- > 0) {
+    crc ^= *p++;
+    for(i = 0; i < 8; i++) {
+      crc = (crc >> 1) ^ (crc & 1 ? 0x8408 : 0);
+    }
+  }
+  return crc;
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+reference_crc32(const uint8_t *p, int len, uint32_t crc)
+{
+  int i;
+
+  crc = ~crc;
+  while(len-- > 0) {
+    crc ^= *p++;
+    for(i = 0; i < 8; i++) {
+      crc = (crc >> 1) ^ (crc & 1 ? 0xedb88320 : 0);
+    }
+  }
+  return ~crc;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(vectors, "check values");
+UNIT_TEST(vectors)
+{
+  static const uint8_t check[] = "123456789";
+  static const uint8_t fox[] = "The quick brown fox jumps over the lazy dog";
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(crc16_data(check, 9, 0) == 0x2189);
+  UNIT_TEST_ASSERT(crc32_data(check, 9, 0) == 0xcbf43926);
+  UNIT_TEST_ASSERT(crc32_data(fox, sizeof(fox) - 1, 0) == 0x414fa339);
+  UNIT_TEST_ASSERT(crc16_data(check, 0, 0x1234) == 0x1234);
+  UNIT_TEST_ASSERT(crc32_data(check, 0, 0) == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(blocks, "block, byte-wise and split checksums");
+UNIT_TEST(blocks)
+{
+  int offset;
+  int len;
+  int split;
+  int i;
+  uint16_t c16;
+  uint32_t c32;
+  int errors = 0;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < sizeof(data); i++) {
+    data[i] = random_rand();
+  }
+
+  /* All lengths and alignments around the slice sizes */
+  for(offset = 0; offset < 8; offset++) {
+    for(len = 0; len < 300; len++) {
+      const uint8_t *p = &data[offset];
+
+      c16 = reference_crc16(p, len, 0xffff);
+      c32 = reference_crc32(p, len, 0);
+      errors += crc16_data(p, len, 0xffff) != c16;
+      errors += crc32_data(p, len, 0) != c32;
+
+      split = len ? random_rand() % len : 0;
+      errors += crc16_data(p + split, len - split,
+                           crc16_data(p, split, 0xffff)) != c16;
+      errors += crc32_data(p + split, len - split,
+                           crc32_data(p, split, 0)) != c32;
+
+      if(len == 299) {
+        uint16_t a16 = 0xffff;
+        uint32_t a32 = 0;
+
+        for(i = 0; i < len; i++) {
+          a16 = crc16_add(p[i], a16);
+          a32 = crc32_add(p[i], a32);
+        }
+        errors += a16 != c16;
+        errors += a32 != c32;
+      }
+    }
+  }
+  UNIT_TEST_ASSERT(errors == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(bench, "throughput");
+UNIT_TEST(bench)
+{
+  uint64_t start;
+  uint32_t sum = 0;
+  uint16_t acc = 0;
+  int i;
+  int j;
+
+  UNIT_TEST_BEGIN();
+
+  printf("CRC_SLICES %d\n", CRC16_SLICES);
+
+  start = now_ns();
+  for(i = 0; i < BENCH_BYTES; i += sizeof(data)) {
+    sum += reference_crc16(data, sizeof(data), 0);
+  }
+  printf("crc16 bitwise: %"PRIu64" ps/byte\n",
+         (now_ns() - start) * 1000 / BENCH_BYTES);
+
+  start = now_ns();
+  for(i = 0; i < BENCH_BYTES; i += sizeof(data)) {
+    for(j = 0; j < sizeof(data); j++) {
+      acc = crc16_add(data[j], acc);
+    }
+  }
+  sum += acc;
+  printf("crc16_add: %"PRIu64" ps/byte\n",
+         (now_ns() - start) * 1000 / BENCH_BYTES);
+
+  start = now_ns();
+  for(i = 0; i < BENCH_BYTES; i += sizeof(data)) {
+    sum += crc16_data(data, sizeof(data), 0);
+  }
+  printf("crc16_data: %"PRIu64" ps/byte\n",
+         (now_ns() - start) * 1000 / BENCH_BYTES);
+
+  start = now_ns();
+  for(i = 0; i < BENCH_BYTES; i += sizeof(data)) {
+    sum += reference_crc32(data, sizeof(data), 0);
+  }
+  printf("crc32 bitwise: %"PRIu64" ps/byte\n",
+         (now_ns() - start) * 1000 / BENCH_BYTES);
+
+  start = now_ns();
+  for(i = 0; i < BENCH_BYTES; i += sizeof(data)) {
+    sum += crc32_data(data, sizeof(data), 0);
+  }
+  printf("crc32_data: %"PRIu64" ps/byte\n",
+         (now_ns() - start) * 1000 / BENCH_BYTES);
+
+  /* Keep the loops from being optimized away */
+  UNIT_TEST_ASSERT(sum != 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(vectors);
+  UNIT_TEST_RUN(blocks);
+  UNIT_TEST_RUN(bench);
+
+  if(!UNIT_TEST_PASSED(vectors) ||
+     !UNIT_TEST_PASSED(blocks) ||
+     !UNIT_TEST_PASSED(bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
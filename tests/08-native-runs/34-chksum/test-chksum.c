@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-chksum.h"
+#include "net/native-chksum.h"
+#include "lib/random.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+PROCESS(test_process, "Checksum test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define BENCH_LEN   1280
+#define BENCH_BYTES (1 << 24)
+
+typedef uint16_t (* chksum_fn)(uint16_t sum, const uint8_t *data,
+                               uint16_t len);
+
+static const struct {
+  const char *name;
+  chksum_fn fn;
+  bool (* ok)(void);
+} impls[] = {
+  { "bytes", uip_chksum_bytes, NULL },
+  { "words", uip_chksum_words, NULL },
+  { "sse2", native_chksum_sse2, native_chksum_sse2_ok },
+  { "avx2", native_chksum_avx2, native_chksum_avx2_ok },
+  { "native", native_chksum, NULL },
+};
+#define NUM_IMPLS (sizeof(impls) / sizeof(impls[0]))
+
+static uint8_t data[1600];
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+available(int i)
+{
+  return impls[i].ok == NULL || impls[i].ok();
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill(uint8_t *p, int len)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    p[i] = random_rand();
+  }
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(vectors, "known sums");
+UNIT_TEST(vectors)
+{
+  /* The example of RFC 1071, section 3 */
+  static const uint8_t rfc1071[] = {
+    0x00, 0x01, 0xf2, 0x03, 0xf4, 0xf5, 0xf6, 0xf7
+  };
+  static uint8_t ones[64];
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  memset(ones, 0xff, sizeof(ones));
+  for(i = 0; i < NUM_IMPLS; i++) {
+    if(!available(i)) {
+      continue;
+    }
+    UNIT_TEST_ASSERT(impls[i].fn(0, rfc1071, sizeof(rfc1071)) == 0xddf2);
+    UNIT_TEST_ASSERT(impls[i].fn(0, rfc1071, 0) == 0);
+    UNIT_TEST_ASSERT(impls[i].fn(0, rfc1071, 1) == 0x0000);
+    UNIT_TEST_ASSERT(impls[i].fn(0, rfc1071, 3) == 0xf201);
+    UNIT_TEST_ASSERT(impls[i].fn(0xffff, ones, sizeof(ones)) == 0xffff);
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(fuzz, "all implementations against the reference");
+UNIT_TEST(fuzz)
+{
+  int round;
+  int offset;
+  int len;
+  uint16_t sum;
+  uint16_t expected;
+  int i;
+  int errors = 0;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < NUM_IMPLS; i++) {
+    printf("%s: %s\n", impls[i].name,
+           available(i) ? "available" : "not supported");
+  }
+
+  for(round = 0; round < 20000; round++) {
+    /* Every length around the vector sizes first, then random ones */
+    len = round < 2048 ? round % 256 : random_rand() % 1501;
+    offset = random_rand() % 8;
+    sum = random_rand();
+    fill(&data[offset], len);
+    if(round % 16 == 0) {
+      /* Runs of 0xff provoke the most carries */
+      memset(&data[offset], 0xff, len);
+    }
+
+    expected = uip_chksum_bytes(sum, &data[offset], len);
+    for(i = 1; i < NUM_IMPLS; i++) {
+      if(available(i) && impls[i].fn(sum, &data[offset], len) != expected) {
+        if(errors++ < 10) {
+          printf("%s: len %d offset %d sum %04x\n",
+                 impls[i].name, len, offset, sum);
+        }
+      }
+    }
+  }
+  UNIT_TEST_ASSERT(errors == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(update, "incremental update (RFC 1624)");
+UNIT_TEST(update)
+{
+  static uint8_t old[16];
+  int round;
+  int len;
+  int pos;
+  uint16_t field;
+  uint16_t old_word;
+  uint16_t new_word;
+  int errors = 0;
+
+  UNIT_TEST_BEGIN();
+
+  /* RFC 1624, section 4: 0xdd2f changes to 0x3285 */
+  UNIT_TEST_ASSERT(uip_chksum_update16(0xdd2f, 0x5555, 0x3285) == 0x0000);
+
+  for(round = 0; round < 10000; round++) {
+    len = 2 + 2 * (random_rand() % 200);
+    fill(data, len);
+    if(round % 16 == 0) {
+      memset(data, 0, len);
+    }
+    field = uip_htons(~uip_chksum_bytes(0, data, len));
+
+    if(round & 1) {
+      /* A single word, as for a port or a length field */
+      pos = 2 * (random_rand() % (len / 2));
+      memcpy(&old_word, &data[pos], 2);
+      new_word = random_rand();
+      memcpy(&data[pos], &new_word, 2);
+      field = uip_chksum_update16(field, old_word, new_word);
+    } else if(len >= 16) {
+      /* An address */
+      pos = 2 * (random_rand() % ((len - 16) / 2 + 1));
+      memcpy(old, &data[pos], 16);
+      fill(&data[pos], 16);
+      field = uip_chksum_update(field, old, &data[pos], 16);
+    } else {
+      continue;
+    }
+
+    /*
+     * The updated field may be 0x0000 where a recomputation gives
+     * 0xffff, and vice versa. Both verify, so compare by verifying.
+     */
+    errors += (uint16_t)~UIP_CHKSUM_IMPL(uip_ntohs(field), data, len) != 0;
+    errors += (uint16_t)~uip_chksum_bytes(uip_ntohs(field), data, len) != 0;
+  }
+  UNIT_TEST_ASSERT(errors == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(bench, "throughput");
+UNIT_TEST(bench)
+{
+  uint64_t start;
+  uint32_t sum = 0;
+  int i;
+  int j;
+
+  UNIT_TEST_BEGIN();
+
+  fill(data, BENCH_LEN);
+  for(i = 0; i < NUM_IMPLS; i++) {
+    if(!available(i)) {
+      continue;
+    }
+    start = now_ns();
+    for(j = 0; j < BENCH_BYTES; j += BENCH_LEN) {
+      sum += impls[i].fn(0, data, BENCH_LEN);
+    }
+    printf("%s: %"PRIu64" ps/byte\n", impls[i].name,
+           (now_ns() - start) * 1000 / BENCH_BYTES);
+  }
+
+  /* Keep the loops from being optimized away */
+  UNIT_TEST_ASSERT(sum != 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(vectors);
+  UNIT_TEST_RUN(fuzz);
+  UNIT_TEST_RUN(update);
+  UNIT_TEST_RUN(bench);
+
+  if(!UNIT_TEST_PASSED(vectors) ||
+     !UNIT_TEST_PASSED(fuzz) ||
+     !UNIT_TEST_PASSED(update) ||
+     !UNIT_TEST_PASSED(bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,538 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-chksum.h"
+#include "ip64/ip64.h"
+#include "ip64/ip64-addrmap.h"
+#include "net/ipv6/ip64-addr.h"
+#include "lib/random.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+PROCESS(test_process, "ip64 test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define IPV6_HDRLEN 40
+#define IPV4_HDRLEN 20
+#define TCP_HDRLEN  20
+#define UDP_HDRLEN  8
+
+#define PROTO_TCP   6
+#define PROTO_UDP   17
+
+#define SERVER_PORT 5683
+#define FLOWS       8
+
+#define BENCH_PACKETS 16
+#define BENCH_ROUNDS  20000
+
+#define MAPPINGS      4000
+#define LOOKUPS       200000
+
+static uip_buf_t v6pkt[BENCH_PACKETS];
+static uip_buf_t v4pkt[BENCH_PACKETS];
+static uip_buf_t result;
+
+static const uip_ip4addr_t server = { { 192, 0, 2, 1 } };
+
+static struct ip64_addrmap_entry *mappings[MAPPINGS];
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+get16(const uint8_t *p)
+{
+  return (p[0] << 8) | p[1];
+}
+/*---------------------------------------------------------------------------*/
+static void
+put16(uint8_t *p, uint16_t v)
+{
+  p[0] = v >> 8;
+  p[1] = v & 0xff;
+}
+/*---------------------------------------------------------------------------*/
+/* The offset of the checksum field in the transport header */
+static int
+chksum_offset(uint8_t proto)
+{
+  return proto == PROTO_TCP ? 16 : 6;
+}
+/*---------------------------------------------------------------------------*/
+/* Sums a transport segment and its pseudo-header with the reference
+   implementation. The sum is 0xffff if the checksum is right. */
+static uint16_t
+transport_sum(const uint8_t *addrs, int addrs_len, uint8_t proto,
+              const uint8_t *segment, uint16_t len)
+{
+  uint16_t sum;
+
+  sum = len + proto;
+  sum = uip_chksum_bytes(sum, addrs, addrs_len);
+  return uip_chksum_bytes(sum, segment, len);
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_chksum(uint8_t *field, uint16_t sum)
+{
+  sum = ~sum;
+  put16(field, sum == 0 ? 0xffff : sum);
+}
+/*---------------------------------------------------------------------------*/
+/* Fills in a transport header and a random payload */
+static void
+make_segment(uint8_t *segment, uint8_t proto, uint16_t srcport,
+             uint16_t destport, uint16_t len)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    segment[i] = random_rand();
+  }
+  put16(&segment[0], srcport);
+  put16(&segment[2], destport);
+  if(proto == PROTO_TCP) {
+    segment[12] = (TCP_HDRLEN / 4) << 4;
+    segment[13] = 0x10; /* ACK */
+  } else {
+    put16(&segment[4], len);
+  }
+  put16(&segment[chksum_offset(proto)], 0);
+}
+/*---------------------------------------------------------------------------*/
+/* Builds an IPv6 packet from a local node to the server */
+static uint16_t
+make_v6(uint8_t *pkt, uint8_t proto, int flow, uint16_t len)
+{
+  uip_ip6addr_t *src = (uip_ip6addr_t *)&pkt[8];
+  uip_ip6addr_t *dest = (uip_ip6addr_t *)&pkt[24];
+
+  memset(pkt, 0, IPV6_HDRLEN);
+  pkt[0] = 0x60;
+  put16(&pkt[4], len);
+  pkt[6] = proto;
+  pkt[7] = 64;
+  uip_ip6addr(src, 0xfd00, 0, 0, 0, 0x0212, 0x7400, 0x0001, 0x0100 + flow);
+  ip64_addr_4to6(&server, dest);
+
+  make_segment(&pkt[IPV6_HDRLEN], proto, 2000 + flow, SERVER_PORT, len);
+  set_chksum(&pkt[IPV6_HDRLEN + chksum_offset(proto)],
+             transport_sum(&pkt[8], 32, proto, &pkt[IPV6_HDRLEN], len));
+  return IPV6_HDRLEN + len;
+}
+/*---------------------------------------------------------------------------*/
+/* Builds the IPv4 reply of the server to the mapped port */
+static uint16_t
+make_v4(uint8_t *pkt, uint8_t proto, uint16_t mapped_port, uint16_t len)
+{
+  memset(pkt, 0, IPV4_HDRLEN);
+  pkt[0] = 0x45;
+  put16(&pkt[2], IPV4_HDRLEN + len);
+  pkt[8] = 64;
+  pkt[9] = proto;
+  memcpy(&pkt[12], &server, 4);
+  memcpy(&pkt[16], ip64_get_hostaddr(), 4);
+  set_chksum(&pkt[10], uip_chksum_bytes(0, pkt, IPV4_HDRLEN));
+
+  make_segment(&pkt[IPV4_HDRLEN], proto, SERVER_PORT, mapped_port, len);
+  set_chksum(&pkt[IPV4_HDRLEN + chksum_offset(proto)],
+             transport_sum(&pkt[12], 8, proto, &pkt[IPV4_HDRLEN], len));
+  return IPV4_HDRLEN + len;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+v4_ok(const uint8_t *pkt)
+{
+  uint16_t len = get16(&pkt[2]) - IPV4_HDRLEN;
+
+  return uip_chksum_bytes(0, pkt, IPV4_HDRLEN) == 0xffff &&
+    transport_sum(&pkt[12], 8, pkt[9], &pkt[IPV4_HDRLEN], len) == 0xffff;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+v6_ok(const uint8_t *pkt)
+{
+  return transport_sum(&pkt[8], 32, pkt[6], &pkt[IPV6_HDRLEN],
+                       get16(&pkt[4])) == 0xffff;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+random_len(uint8_t proto)
+{
+  uint16_t hdrlen = proto == PROTO_TCP ? TCP_HDRLEN : UDP_HDRLEN;
+
+  return hdrlen + random_rand() % (UIP_BUFSIZE - IPV6_HDRLEN - hdrlen + 1);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(translate, "checksums of translated packets");
+UNIT_TEST(translate)
+{
+  int round;
+  uint8_t proto;
+  int flow;
+  uint16_t len;
+  uint16_t hdrlen;
+  uint16_t mapped_port;
+  uint8_t *v6 = v6pkt[0].u8;
+  uint8_t *v4 = v4pkt[0].u8;
+  int errors = 0;
+
+  UNIT_TEST_BEGIN();
+
+  for(round = 0; round < 4000; round++) {
+    proto = round & 1 ? PROTO_TCP : PROTO_UDP;
+    flow = random_rand() % FLOWS;
+    len = random_len(proto);
+
+    /* Outgoing */
+    make_v6(v6, proto, flow, len);
+    hdrlen = proto == PROTO_TCP ? TCP_HDRLEN : UDP_HDRLEN;
+    if(ip64_6to4(v6, IPV6_HDRLEN + len, result.u8) != IPV4_HDRLEN + len ||
+       !v4_ok(result.u8) ||
+       memcmp(&result.u8[IPV4_HDRLEN + 2], &v6[IPV6_HDRLEN + 2], 2) ||
+       memcmp(&result.u8[IPV4_HDRLEN + hdrlen],
+              &v6[IPV6_HDRLEN + hdrlen], len - hdrlen)) {
+      errors++;
+      continue;
+    }
+    mapped_port = get16(&result.u8[IPV4_HDRLEN]);
+
+    /* The reply */
+    len = random_len(proto);
+    make_v4(v4, proto, mapped_port, len);
+    if(ip64_4to6(v4, IPV4_HDRLEN + len, result.u8) != IPV6_HDRLEN + len ||
+       !v6_ok(result.u8) ||
+       memcmp(&result.u8[24], &v6[8], 16) ||
+       memcmp(&result.u8[IPV6_HDRLEN + 2], &v6[IPV6_HDRLEN], 2)) {
+      errors++;
+    }
+  }
+  UNIT_TEST_ASSERT(errors == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(special, "UDP without checksum and corrupt packets");
+UNIT_TEST(special)
+{
+  uint8_t *v6 = v6pkt[0].u8;
+  uint8_t *v4 = v4pkt[0].u8;
+  uint16_t mapped_port;
+
+  UNIT_TEST_BEGIN();
+
+  make_v6(v6, PROTO_UDP, 0, 100);
+  UNIT_TEST_ASSERT(ip64_6to4(v6, IPV6_HDRLEN + 100, result.u8) > 0);
+  mapped_port = get16(&result.u8[IPV4_HDRLEN]);
+
+  /* IPv4 UDP may come without a checksum, IPv6 needs one */
+  make_v4(v4, PROTO_UDP, mapped_port, 100);
+  put16(&v4[IPV4_HDRLEN + 6], 0);
+  UNIT_TEST_ASSERT(ip64_4to6(v4, IPV4_HDRLEN + 100, result.u8) > 0);
+  UNIT_TEST_ASSERT(v6_ok(result.u8));
+
+#if IP64_INCREMENTAL_CHECKSUM
+  /* An updated checksum must not hide corruption */
+  make_v6(v6, PROTO_TCP, 1, 200);
+  v6[IPV6_HDRLEN + 100] ^= 0x40;
+  UNIT_TEST_ASSERT(ip64_6to4(v6, IPV6_HDRLEN + 200, result.u8) > 0);
+  UNIT_TEST_ASSERT(!v4_ok(result.u8));
+
+  make_v4(v4, PROTO_UDP, mapped_port, 200);
+  v4[IPV4_HDRLEN + 100] ^= 0x40;
+  UNIT_TEST_ASSERT(ip64_4to6(v4, IPV4_HDRLEN + 200, result.u8) > 0);
+  UNIT_TEST_ASSERT(!v6_ok(result.u8));
+#endif /* IP64_INCREMENTAL_CHECKSUM */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench(uint16_t len)
+{
+  uint16_t v6len[BENCH_PACKETS];
+  uint16_t v4len[BENCH_PACKETS];
+  uint64_t start;
+  uint64_t ns;
+  int i;
+
+  /* Replay a few TCP flows in both directions */
+  for(i = 0; i < BENCH_PACKETS; i++) {
+    v6len[i] = make_v6(v6pkt[i].u8, PROTO_TCP, i % FLOWS, len);
+    ip64_6to4(v6pkt[i].u8, v6len[i], result.u8);
+    v4len[i] = make_v4(v4pkt[i].u8, PROTO_TCP,
+                       get16(&result.u8[IPV4_HDRLEN]), len);
+  }
+
+  start = now_ns();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    ip64_6to4(v6pkt[i % BENCH_PACKETS].u8, v6len[i % BENCH_PACKETS],
+              result.u8);
+  }
+  ns = now_ns() - start;
+  printf("6to4 %4u bytes: %"PRIu64" packets/s\n",
+         len, (uint64_t)BENCH_ROUNDS * 1000000000 / ns);
+
+  start = now_ns();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    ip64_4to6(v4pkt[i % BENCH_PACKETS].u8, v4len[i % BENCH_PACKETS],
+              result.u8);
+  }
+  ns = now_ns() - start;
+  printf("4to6 %4u bytes: %"PRIu64" packets/s\n",
+         len, (uint64_t)BENCH_ROUNDS * 1000000000 / ns);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(replay, "packet replay throughput");
+UNIT_TEST(replay)
+{
+  UNIT_TEST_BEGIN();
+
+  printf("IP64_INCREMENTAL_CHECKSUM %d\n", IP64_INCREMENTAL_CHECKSUM);
+  bench(TCP_HDRLEN + 40);
+  bench(UIP_BUFSIZE - IPV6_HDRLEN);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+/* The IPv6 address of sensor i, with one flow per sensor */
+static void
+sensor_addr(uip_ip6addr_t *addr, int i)
+{
+  uip_ip6addr(addr, 0xfd00, 0, 0, 0, 0x0212, 0x7400, i >> 8, i & 0xff);
+}
+/*---------------------------------------------------------------------------*/
+static int
+count_mappings(void)
+{
+  struct ip64_addrmap_entry *m;
+  int n = 0;
+
+  for(m = ip64_addrmap_list(); m != NULL; m = ip64_addrmap_next(m)) {
+    n++;
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static int
+check_lookups(int step, bool present)
+{
+  uip_ip6addr_t addr;
+  struct ip64_addrmap_entry *m;
+  int errors = 0;
+  int i;
+
+  for(i = 0; i < MAPPINGS; i += step) {
+    sensor_addr(&addr, i);
+    m = ip64_addrmap_lookup(&addr, 2000, &server, SERVER_PORT, PROTO_UDP);
+    if(!present) {
+      errors += m != NULL;
+    } else if(m != mappings[i] ||
+              ip64_addrmap_lookup_port(m->mapped_port, PROTO_UDP) != m ||
+              ip64_addrmap_lookup_port(m->mapped_port, PROTO_TCP) != NULL) {
+      errors++;
+    }
+  }
+  return errors;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(addrmap, "address mapping tables and aging");
+UNIT_TEST(addrmap)
+{
+  static struct etimer et;
+  uip_ip6addr_t addr;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  ip64_addrmap_init();
+  for(i = 0; i < MAPPINGS; i++) {
+    sensor_addr(&addr, i);
+    mappings[i] = ip64_addrmap_create(&addr, 2000, &server, SERVER_PORT,
+                                      PROTO_UDP);
+    UNIT_TEST_ASSERT(mappings[i] != NULL);
+    ip64_addrmap_set_lifetime(mappings[i], CLOCK_SECOND * 60);
+  }
+  UNIT_TEST_ASSERT(count_mappings() == MAPPINGS);
+  UNIT_TEST_ASSERT(check_lookups(1, true) == 0);
+
+  /* Let every other mapping expire */
+  for(i = 0; i < MAPPINGS; i += 2) {
+    ip64_addrmap_set_lifetime(mappings[i], CLOCK_SECOND / 50);
+  }
+  etimer_set(&et, CLOCK_SECOND / 10);
+  PT_WAIT_UNTIL(&unit_test_pt, etimer_expired(&et));
+
+  UNIT_TEST_ASSERT(check_lookups(2, false) == 0);
+  UNIT_TEST_ASSERT(count_mappings() == MAPPINGS / 2);
+  UNIT_TEST_ASSERT(check_lookups(1, false) == MAPPINGS / 2);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(recycle, "recycling of full tables");
+UNIT_TEST(recycle)
+{
+  uip_ip6addr_t addr;
+  struct ip64_addrmap_entry *m;
+  uint16_t shortest = 0;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  ip64_addrmap_init();
+  sensor_addr(&addr, 0);
+  for(i = 0; i < IP64_ADDRMAP_CONF_ENTRIES; i++) {
+    m = ip64_addrmap_create(&addr, 3000 + i, &server, SERVER_PORT,
+                            PROTO_TCP);
+    UNIT_TEST_ASSERT(m != NULL);
+    ip64_addrmap_set_lifetime(m, CLOCK_SECOND * 60);
+    if(i % 3 == 0) {
+      /* Recyclable, the later ones expire first */
+      ip64_addrmap_set_recycleble(m);
+      ip64_addrmap_set_lifetime(m, CLOCK_SECOND * 60 - i);
+      shortest = m->ip6port;
+    }
+  }
+  UNIT_TEST_ASSERT(count_mappings() == IP64_ADDRMAP_CONF_ENTRIES);
+
+  /* The recyclable mapping that expires first makes room */
+  m = ip64_addrmap_create(&addr, 2000, &server, SERVER_PORT, PROTO_TCP);
+  UNIT_TEST_ASSERT(m != NULL);
+  ip64_addrmap_set_lifetime(m, CLOCK_SECOND * 60);
+  UNIT_TEST_ASSERT(ip64_addrmap_lookup(&addr, shortest, &server,
+                                       SERVER_PORT, PROTO_TCP) == NULL);
+  UNIT_TEST_ASSERT(ip64_addrmap_lookup(&addr, shortest - 3, &server,
+                                       SERVER_PORT, PROTO_TCP) != NULL);
+
+  /* Also when it expires within a turn of the wheel */
+  m = ip64_addrmap_lookup(&addr, 3000, &server, SERVER_PORT, PROTO_TCP);
+  ip64_addrmap_set_lifetime(m, CLOCK_SECOND / 5);
+  m = ip64_addrmap_create(&addr, 2001, &server, SERVER_PORT, PROTO_TCP);
+  UNIT_TEST_ASSERT(m != NULL);
+  ip64_addrmap_set_lifetime(m, CLOCK_SECOND * 60);
+  UNIT_TEST_ASSERT(ip64_addrmap_lookup(&addr, 3000, &server,
+                                       SERVER_PORT, PROTO_TCP) == NULL);
+  UNIT_TEST_ASSERT(ip64_addrmap_lookup(&addr, shortest - 3, &server,
+                                       SERVER_PORT, PROTO_TCP) != NULL);
+  UNIT_TEST_ASSERT(count_mappings() == IP64_ADDRMAP_CONF_ENTRIES);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(lookup_bench, "mapping lookup throughput");
+UNIT_TEST(lookup_bench)
+{
+  uip_ip6addr_t addr;
+  uint64_t start;
+  uint32_t found = 0;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  ip64_addrmap_init();
+  for(i = 0; i < MAPPINGS; i++) {
+    sensor_addr(&addr, i);
+    mappings[i] = ip64_addrmap_create(&addr, 2000, &server, SERVER_PORT,
+                                      PROTO_UDP);
+    ip64_addrmap_set_lifetime(mappings[i], CLOCK_SECOND * 60);
+  }
+
+  start = now_ns();
+  for(i = 0; i < LOOKUPS; i++) {
+    sensor_addr(&addr, (i * 7919) % MAPPINGS);
+    found += ip64_addrmap_lookup(&addr, 2000, &server, SERVER_PORT,
+                                 PROTO_UDP) != NULL;
+  }
+  printf("%d mappings, lookup: %"PRIu64" ns\n", MAPPINGS,
+         (now_ns() - start) / LOOKUPS);
+
+  start = now_ns();
+  for(i = 0; i < LOOKUPS; i++) {
+    found += ip64_addrmap_lookup_port(
+      mappings[(i * 7919) % MAPPINGS]->mapped_port, PROTO_UDP) != NULL;
+  }
+  printf("%d mappings, lookup_port: %"PRIu64" ns\n", MAPPINGS,
+         (now_ns() - start) / LOOKUPS);
+
+  UNIT_TEST_ASSERT(found == 2 * LOOKUPS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static const uip_ip4addr_t hostaddr = { { 10, 0, 0, 1 } };
+  static const uip_ip4addr_t netmask = { { 255, 255, 255, 0 } };
+
+  PROCESS_BEGIN();
+
+  ip64_addrmap_init();
+  ip64_set_ipv4_address(&hostaddr, &netmask);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(translate);
+  UNIT_TEST_RUN(special);
+  UNIT_TEST_RUN(replay);
+  UNIT_TEST_RUN(addrmap);
+  UNIT_TEST_RUN(recycle);
+  UNIT_TEST_RUN(lookup_bench);
+
+  if(!UNIT_TEST_PASSED(translate) ||
+     !UNIT_TEST_PASSED(special) ||
+     !UNIT_TEST_PASSED(replay) ||
+     !UNIT_TEST_PASSED(addrmap) ||
+     !UNIT_TEST_PASSED(recycle) ||
+     !UNIT_TEST_PASSED(lookup_bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
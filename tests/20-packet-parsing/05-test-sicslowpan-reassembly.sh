@@ -0,0 +1,58 @@
+#!/bin/bash
+
+# Inject interleaved fragments of several datagrams and check how many
+# of them are reassembled with the contexts, buffers and per-sender
+# quotas set in packet-injector/project-conf.h, and how many are
+# forwarded fragment by fragment. The injector must be built with
+# DEFINES=PACKET_INJECTOR_REASS_TESTS=1.
+
+export TEST_PROTOCOL=sicslowpan
+
+CODE_DIR=packet-injector
+CODE=packet-injector
+PACKET_DIR=$CODE_DIR/sicslowpan-reass-data
+
+FAILED=0
+
+run_case() {
+  echo "Injecting $PACKET_DIR/$1, expecting $2 reassembled and" \
+       "${3:-0} forwarded datagrams"
+  TEST_REASSEMBLED=$2 TEST_FORWARDED=${3:-0} TEST_FORWARDED_FRAGS=${4:-0} \
+    timeout -k 1s 2s "$CODE_DIR/build/native/$CODE.native" "$PACKET_DIR/$1"/*
+  INJECTOR_EXIT_CODE=$?
+  echo "exit code:" $INJECTOR_EXIT_CODE
+  if [ $INJECTOR_EXIT_CODE -eq 0 ]; then
+    echo "Case $1: SUCCESS"
+  else
+    echo "Case $1: FAILURE"
+    FAILED=$((FAILED + 1))
+  fi
+}
+
+# Six senders with one datagram each
+run_case 01-interleaved-senders 6
+# One sender starts four datagrams: two are refused by the context
+# quota and the buffer quota drops one more, while the datagrams of
+# the two other senders get through
+run_case 02-sender-quota 3
+# The same sender and tag with two sizes are two datagrams
+run_case 03-tag-and-size 2
+# Ten senders for eight contexts
+run_case 04-out-of-contexts 8
+# A datagram forwarded as its seven fragments arrive, next to one for
+# us and one with a link-local destination, which is not forwarded
+run_case 05-forwarding 2 1 6
+# A datagram with a multicast source is reassembled, and then dropped
+# instead of forwarded
+run_case 06-forwarding-mcast-src 1
+# A Hop-by-Hop header with padding only does not keep a datagram from
+# being forwarded fragment by fragment, while one with another option
+# is processed with the reassembled datagram
+run_case 07-forwarding-hbh-padding 0 1 6
+run_case 08-forwarding-hbh-option 1
+
+if [ $FAILED -gt 0 ]; then
+  printf "%-32s TEST FAIL\n" "$CODE-sicslowpan-reassembly"
+  echo "Failed: " $FAILED
+  exit 1
+fi
@@ -37,6 +37,7 @@
 #include "contiki.h"
 
 /* Standard C and POSIX headers. */
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -49,8 +50,10 @@
 /* Contiki-NG headers. */
 #include <dev/ble-hal.h>
 #include <net/ipv6/uip.h>
+#include <net/ipv6/uip-ds6.h>
 #include <net/ipv6/uiplib.h>
 #include <net/mac/ble/ble-l2cap.h>
+#include <net/mac/framer/frame802154.h>
 #include <net/netstack.h>
 #include <net/packetbuf.h>
 #include <net/ipv6/sicslowpan.h>
@@ -73,6 +76,19 @@ extern char **contiki_argv;
 
 typedef bool (*protocol_function_t)(char *, int);
 
+#if PACKET_INJECTOR_REASS_TESTS
+/* 127-byte frames, without the FCS */
+#define TEST_MAC_MAX_FRAME 125
+
+/* The neighbor that datagrams not for us are forwarded to */
+static const linkaddr_t forwarding_neighbor =
+  {{ 0x00, 0x12, 0x4b, 0x00, 0x00, 0x00, 0x00, 0xfe }};
+/* Size and tag of the last datagram forwarded to it */
+static uint16_t forwarded_size_and_tag[2];
+/* Number of non-first fragments forwarded to it */
+static uint32_t forwarded_frags;
+#endif /* PACKET_INJECTOR_REASS_TESTS */
+
 /*---------------------------------------------------------------------------*/
 PROCESS(packet_injector_process, "Packet injector process");
 AUTOSTART_PROCESSES(&packet_injector_process);
@@ -159,9 +175,115 @@ inject_ble_l2cap_packet(char *data, int len)
   return true;
 }
 /*---------------------------------------------------------------------------*/
+#if PACKET_INJECTOR_REASS_TESTS
+static void
+add_forwarding_neighbor(void)
+{
+  static bool added;
+  uip_ipaddr_t ipaddr;
+
+  /* A default router to forward the datagrams that are not for us to */
+  if(!added) {
+    uip_ip6addr(&ipaddr, 0xfe80, 0, 0, 0, 0x0212, 0x4b00, 0, 0x00fe);
+    uip_ds6_nbr_add(&ipaddr, (const uip_lladdr_t *)&forwarding_neighbor, 1,
+                    NBR_REACHABLE, NBR_TABLE_REASON_UNDEFINED, NULL);
+    uip_ds6_defrt_add(&ipaddr, 0);
+    added = true;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* A MAC driver that checks the fragments sent to the forwarding
+   neighbor: each must be framed, and the rest of the fragments of a
+   datagram must carry the size and tag of its first fragment. */
+static void
+mac_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static void
+mac_send(mac_callback_t sent, void *ptr)
+{
+  const uint8_t *frag = packetbuf_dataptr();
+  uint16_t size_and_tag[2];
+
+  if(linkaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_RECEIVER),
+                  &forwarding_neighbor) && packetbuf_datalen() >= 4) {
+    size_and_tag[0] = ((frag[0] << 8) | frag[1]) & 0x07ff;
+    size_and_tag[1] = (frag[2] << 8) | frag[3];
+
+    switch(frag[0] & 0xf8) {
+    case 0xc0: /* FRAG1 */
+      memcpy(forwarded_size_and_tag, size_and_tag, sizeof(size_and_tag));
+      break;
+    case 0xe0: /* FRAGN */
+      if(memcmp(forwarded_size_and_tag, size_and_tag, sizeof(size_and_tag))) {
+        LOG_ERR("forwarded fragment with size %u tag %u, expected %u %u\n",
+                size_and_tag[0], size_and_tag[1],
+                forwarded_size_and_tag[0], forwarded_size_and_tag[1]);
+        exit(EXIT_FAILURE);
+      }
+      forwarded_frags++;
+      break;
+    }
+
+    packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, FRAME802154_DATAFRAME);
+    if(NETSTACK_FRAMER.create() < 0) {
+      LOG_ERR("failed to frame a forwarded fragment\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  mac_call_sent_callback(sent, ptr, MAC_TX_OK, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+mac_input(void)
+{
+  NETSTACK_NETWORK.input();
+}
+/*---------------------------------------------------------------------------*/
+static int
+mac_on(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+mac_off(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+mac_max_payload(void)
+{
+  int framer_hdrlen;
+
+  framer_hdrlen = NETSTACK_FRAMER.length();
+  if(framer_hdrlen < 0) {
+    return 0;
+  }
+  return TEST_MAC_MAX_FRAME - framer_hdrlen;
+}
+/*---------------------------------------------------------------------------*/
+const struct mac_driver injector_mac_driver = {
+  "injector-mac",
+  mac_init,
+  mac_send,
+  mac_input,
+  mac_on,
+  mac_off,
+  mac_max_payload,
+};
+#endif /* PACKET_INJECTOR_REASS_TESTS */
+/*---------------------------------------------------------------------------*/
 static bool
 inject_sicslowpan_packet(char *data, int len)
 {
+#if PACKET_INJECTOR_REASS_TESTS
+  add_forwarding_neighbor();
+#endif /* PACKET_INJECTOR_REASS_TESTS */
+
   packetbuf_copyfrom(data, len);
 
   NETSTACK_NETWORK.input();
@@ -221,6 +343,46 @@ process_packet(const char *filename, const char *protocol_name, protocol_functio
   }
 }
 /*---------------------------------------------------------------------------*/
+#if PACKET_INJECTOR_REASS_TESTS
+static void
+check_stat(const char *name, const char *variable, uint32_t value)
+{
+  const char *expected;
+
+  /* Check the statistic if the test expects a value. */
+  expected = getenv(variable);
+  if(expected != NULL && strtoul(expected, NULL, 10) != value) {
+    LOG_ERR("expected %s %s, got %"PRIu32"\n",
+            expected, name, value);
+    exit(EXIT_FAILURE);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_reassembly(void)
+{
+#if SICSLOWPAN_REASS_STATS
+  LOG_INFO("Reassembly: started %"PRIu32" reassembled %"PRIu32
+           " timed out %"PRIu32" no context %"PRIu32" no buffer %"PRIu32
+           " over quota %"PRIu32" invalid %"PRIu32"\n",
+           sicslowpan_reass_stat.started, sicslowpan_reass_stat.reassembled,
+           sicslowpan_reass_stat.timed_out, sicslowpan_reass_stat.no_context,
+           sicslowpan_reass_stat.no_buffer, sicslowpan_reass_stat.over_quota,
+           sicslowpan_reass_stat.invalid);
+  LOG_INFO("Forwarding: datagrams %"PRIu32" fragments %"PRIu32"\n",
+           sicslowpan_reass_stat.forwarded,
+           sicslowpan_reass_stat.forwarded_frags);
+
+  check_stat("reassembled datagrams", "TEST_REASSEMBLED",
+             sicslowpan_reass_stat.reassembled);
+  check_stat("forwarded datagrams", "TEST_FORWARDED",
+             sicslowpan_reass_stat.forwarded);
+  check_stat("forwarded fragments", "TEST_FORWARDED_FRAGS",
+             forwarded_frags);
+#endif /* SICSLOWPAN_REASS_STATS */
+}
+#endif /* PACKET_INJECTOR_REASS_TESTS */
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(packet_injector_process, ev, data)
 {
   static const char *filename;
@@ -246,6 +408,12 @@ PROCESS_THREAD(packet_injector_process, ev, data)
     process_packet(filename, protocol_name, protocol_input);
   }
 
+#if PACKET_INJECTOR_REASS_TESTS
+  if(protocol_input == inject_sicslowpan_packet) {
+    check_reassembly();
+  }
+#endif /* PACKET_INJECTOR_REASS_TESTS */
+
   exit(EXIT_SUCCESS);
 
   PROCESS_END();
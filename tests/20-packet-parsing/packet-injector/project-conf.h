@@ -8,3 +8,19 @@
 #ifndef CONTIKI_TARGET_SIMPLELINK
 #define LOG_CONF_LEVEL_FRAMER                      LOG_LEVEL_DBG
 #endif
+
+/* Several concurrent reassemblies, with per-sender quotas, and
+   fragment forwarding for the tests in sicslowpan-reass-data. Only
+   05-test-sicslowpan-reassembly.sh builds with these, as the other
+   tests cover the default configuration. */
+#if PACKET_INJECTOR_REASS_TESTS
+#define SICSLOWPAN_CONF_REASS_STATS                1
+#define SICSLOWPAN_CONF_REASS_CONTEXTS             8
+#define SICSLOWPAN_CONF_FRAGMENT_BUFFERS           24
+#define SICSLOWPAN_CONF_REASS_SENDER_CONTEXTS      2
+#define SICSLOWPAN_CONF_REASS_SENDER_BUFFERS       8
+#define SICSLOWPAN_CONF_FRAG_FORWARDING            1
+
+/* Check what the stack sends, see packet-injector.c */
+#define NETSTACK_CONF_MAC                          injector_mac_driver
+#endif /* PACKET_INJECTOR_REASS_TESTS */
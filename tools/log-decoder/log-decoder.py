@@ -0,0 +1,252 @@
+#!/usr/bin/env python3
+# Decoder for the binary log records emitted with LOG_CONF_WITH_BINARY.
+#
+# The format strings are read from the log_fmt section of the ELF file the
+# node runs. Records arrive SLIP framed; anything outside a frame is copied
+# to the output unchanged, so regular printf output can be mixed in.
+#
+# Usage: log-decoder.py [-t] [-c] firmware.elf [logfile]
+#        (reads the log from stdin when no file is given)
+
+import argparse
+import ipaddress
+import re
+import struct
+import sys
+
+SLIP_END = 0o300
+SLIP_ESC = 0o333
+SLIP_ESC_END = 0o334
+SLIP_ESC_ESC = 0o335
+
+ID_RESERVED = 0xfff0
+ID_DROPPED = 0xfffe
+ID_HELLO = 0xffff
+
+CONVERSION = re.compile(
+    r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|j|z|t|L)?'
+    r'([diouxXcsfFeEgGpLIB%])')
+
+
+def read_section(path, name):
+    """Return the contents of an ELF section."""
+    with open(path, 'rb') as f:
+        elf = f.read()
+    if elf[:4] != b'\x7fELF':
+        raise ValueError('%s: not an ELF file' % path)
+    is64 = elf[4] == 2
+    endian = '<' if elf[5] == 1 else '>'
+    if is64:
+        shoff, = struct.unpack_from(endian + 'Q', elf, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH',
+                                                        elf, 0x3a)
+        fmt = endian + 'IIQQQQ'
+    else:
+        shoff, = struct.unpack_from(endian + 'I', elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH',
+                                                        elf, 0x2e)
+        fmt = endian + 'IIIIII'
+
+    def header(i):
+        return struct.unpack_from(fmt, elf, shoff + i * shentsize)
+
+    strtab = header(shstrndx)
+    for i in range(shnum):
+        sh_name, _, _, _, offset, size = header(i)
+        start = strtab[4] + sh_name
+        if elf[start:elf.index(b'\0', start)].decode() == name:
+            return elf[offset:offset + size]
+    raise ValueError('%s: no %s section, was the firmware built with '
+                     'LOG_CONF_WITH_BINARY?' % (path, name))
+
+
+class Decoder:
+    def __init__(self, section, timestamps, compact):
+        self.section = section
+        self.timestamps = timestamps
+        self.compact = compact
+        self.second = None
+
+    def entry(self, offset):
+        fields = self.section[offset:].split(b'\0', 3)
+        newline = fields[0][:1] == b'1'
+        return (newline, fields[0][1:].decode(), fields[1].decode(),
+                fields[2].decode(errors='replace'))
+
+    @staticmethod
+    def arguments(data):
+        args = []
+        pos = 0
+        while pos < len(data):
+            tag = chr(data[pos])
+            pos += 1
+            if tag == 'i':
+                args.append(struct.unpack_from('<I', data, pos)[0])
+                pos += 4
+            elif tag == 'l':
+                args.append(struct.unpack_from('<Q', data, pos)[0])
+                pos += 8
+            elif tag == 'd':
+                args.append(struct.unpack_from('<d', data, pos)[0])
+                pos += 8
+            elif tag in 'sb':
+                length = data[pos]
+                raw = bytes(data[pos + 1:pos + 1 + length])
+                args.append(raw.decode(errors='replace') if tag == 's'
+                            else raw)
+                pos += 1 + length
+            else:
+                raise ValueError('unknown argument tag %r' % tag)
+        return args
+
+    def lladdr(self, raw):
+        if not raw:
+            return '(NULL LL addr)'
+        if self.compact:
+            if not any(raw):
+                return 'LL-NULL'
+            return 'LL-%02x%02x' % (raw[-2], raw[-1])
+        return '.'.join(raw[i:i + 2].hex() for i in range(0, len(raw), 2))
+
+    def ip6addr(self, raw):
+        if len(raw) != 16:
+            return '(NULL IP addr)'
+        addr = ipaddress.IPv6Address(raw)
+        if self.compact:
+            if addr.is_multicast:
+                prefix = '6M'
+            elif addr.is_link_local:
+                prefix = '6L'
+            else:
+                prefix = '6G'
+            return '%s-%02x%02x' % (prefix, raw[14], raw[15])
+        return str(addr)
+
+    def format(self, fmt, args):
+        args = iter(args)
+
+        def integer(value, length, conv):
+            if isinstance(value, bytes) or isinstance(value, str):
+                return value
+            bits = {'hh': 8, 'h': 16}.get(length, 64 if value >> 32 else 32)
+            value &= (1 << bits) - 1
+            if conv in 'di' and value >> (bits - 1):
+                value -= 1 << bits
+            return value
+
+        def convert(m):
+            flags, width, precision, length, conv = m.groups()
+            if conv == '%':
+                return '%'
+            if width == '*':
+                width = str(integer(next(args, 0), None, 'd'))
+            if precision == '*':
+                precision = str(integer(next(args, 0), None, 'd'))
+            value = next(args, None)
+            if value is None:
+                return '<missing>'
+            if conv == 'L':
+                return self.lladdr(value)
+            if conv == 'I':
+                return self.ip6addr(value)
+            if conv == 'B':
+                return value.hex()
+            spec = '%' + flags + (width or '')
+            if precision is not None:
+                spec += '.' + precision
+            if conv == 'p':
+                return (spec + 's') % hex(value)
+            if conv == 'c':
+                return (spec + 's') % chr(value & 0xff)
+            if conv == 's':
+                return (spec + 's') % value
+            if conv in 'fFeEgG':
+                return (spec + conv) % float(value)
+            value = integer(value, length, conv)
+            if isinstance(value, (bytes, str)):
+                return (spec + 's') % value
+            return (spec + conv.replace('u', 'd')) % value
+
+        return CONVERSION.sub(convert, fmt)
+
+    def record(self, data):
+        if len(data) < 6:
+            raise ValueError('short record')
+        ident, timestamp = struct.unpack_from('<HI', data)
+        args = self.arguments(data[6:])
+        if ident == ID_HELLO:
+            self.second = args[0]
+            return ''
+        if ident == ID_DROPPED:
+            return '[log: %u records dropped]\n' % args[0]
+        if ident >= ID_RESERVED or ident >= len(self.section):
+            raise ValueError('unknown record id %u' % ident)
+        newline, level, module, fmt = self.entry(ident)
+        text = ''
+        if newline:
+            if self.timestamps:
+                if self.second:
+                    text += '%10.6f ' % (timestamp / self.second)
+                else:
+                    text += '%10u ' % timestamp
+            text += '[%-4s: %-10s] ' % (level, module)
+        return text + self.format(fmt, args)
+
+    def run(self, stream, out):
+        frame = None
+        escaped = False
+        while True:
+            # Decode what has arrived rather than wait for a full
+            # chunk, so that a live log is printed as it is written.
+            chunk = stream.read1(4096)
+            if not chunk:
+                break
+            for c in chunk:
+                if frame is None:
+                    if c == SLIP_END:
+                        frame = bytearray()
+                    else:
+                        out.write(chr(c))
+                elif c == SLIP_END:
+                    if not frame:
+                        # Two ENDs in a row: the first one closed a
+                        # frame we lost the start of.
+                        continue
+                    try:
+                        out.write(self.record(frame))
+                    except (ValueError, IndexError, struct.error) as e:
+                        out.write('[log: bad record: %s]\n' % e)
+                    frame = None
+                elif escaped:
+                    frame.append({SLIP_ESC_END: SLIP_END,
+                                  SLIP_ESC_ESC: SLIP_ESC}.get(c, c))
+                    escaped = False
+                elif c == SLIP_ESC:
+                    escaped = True
+                else:
+                    frame.append(c)
+            out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Decode Contiki-NG binary log records')
+    parser.add_argument('elf', help='firmware the log was produced by')
+    parser.add_argument('log', nargs='?', help='log file (default: stdin)')
+    parser.add_argument('-t', '--timestamps', action='store_true',
+                        help='prefix lines with the record timestamp')
+    parser.add_argument('-c', '--compact', action='store_true',
+                        help='print addresses as with LOG_CONF_WITH_COMPACT_ADDR')
+    args = parser.parse_args()
+
+    decoder = Decoder(read_section(args.elf, 'log_fmt'), args.timestamps,
+                      args.compact)
+    if args.log:
+        with open(args.log, 'rb') as stream:
+            decoder.run(stream, sys.stdout)
+    else:
+        decoder.run(sys.stdin.buffer, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()